@@ -0,0 +1,126 @@
+#include "ansi_screen.h"
+
+#include <algorithm>
+#include <cstdio>
+
+// public
+
+AnsiScreen::AnsiScreen(const int rows, const int columns)
+: _rows{rows},
+  _columns{columns},
+  _current(static_cast<std::size_t>(rows * columns)),
+  _displayed(static_cast<std::size_t>(rows * columns)),
+  _drawnRows(static_cast<std::size_t>(rows), 0)
+{
+}
+
+void AnsiScreen::erase()
+{
+    std::fill(_current.begin(), _current.end(), Cell{});
+    std::fill(_drawnRows.begin(), _drawnRows.end(), 1);
+    return;
+}
+
+void AnsiScreen::draw(const int row, const int column, const char *text, const uint8_t colour)
+{
+    if (row < 0 || row >= _rows)
+    {
+        return;
+    }
+
+    _drawnRows[row] = 1;
+    for (int c = column; *text != '\0' && c < _columns; ++c, ++text)
+    {
+        _current[row * _columns + c] = {*text, colour};
+    }
+    return;
+}
+
+void AnsiScreen::invalidate()
+{
+    _invalid = true;
+    return;
+}
+
+void AnsiScreen::render(std::string &output)
+{
+    if (_invalid)
+    {
+        // reset the colours, clear the terminal and hide the cursor
+        output += "\x1b[0m\x1b[2J\x1b[?25l";
+        std::fill(_displayed.begin(), _displayed.end(), Cell{});
+        std::fill(_drawnRows.begin(), _drawnRows.end(), 1);
+        _invalid = false;
+    }
+
+    // the terminal's cursor and colour are only known within one call
+    int cursor = -1;
+    int colour = -1;
+    char sequence[32];
+    for (int row = 0; row < _rows; ++row)
+    {
+        if (_drawnRows[row] == 0)
+        {
+            continue;
+        }
+
+        _drawnRows[row] = 0;
+        for (int column = 0; column < _columns; ++column)
+        {
+            const int index = row * _columns + column;
+            if (_current[index] == _displayed[index])
+            {
+                continue;
+            }
+
+            if (cursor != index)
+            {
+                std::snprintf(sequence, sizeof(sequence), "\x1b[%d;%dH", row + 1, column + 1);
+                output += sequence;
+            }
+            if (colour != _current[index].colour)
+            {
+                colour = _current[index].colour;
+                if (colour == 0)
+                {
+                    output += "\x1b[0m";
+                }
+                else
+                {
+                    std::snprintf(sequence, sizeof(sequence), "\x1b[3%d;4%dm", colour, colour);
+                    output += sequence;
+                }
+            }
+            output += _current[index].character;
+            _displayed[index] = _current[index];
+            cursor = (column + 1 < _columns) ? index + 1 : -1;
+        }
+    }
+    if (colour > 0)
+    {
+        output += "\x1b[0m";
+    }
+    return;
+}
+
+std::size_t AnsiScreen::get_maximal_render_size() const
+{
+    // the clearing sequence, then per cell a cursor position, a colour and the character, and the final reset
+    constexpr std::size_t clearSize = sizeof("\x1b[0m\x1b[2J\x1b[?25l") - 1;
+    constexpr std::size_t cursorSize = sizeof("\x1b[99999;99999H") - 1;
+    constexpr std::size_t colourSize = sizeof("\x1b[37;47m") - 1;
+    constexpr std::size_t resetSize = sizeof("\x1b[0m") - 1;
+    return clearSize + static_cast<std::size_t>(_rows * _columns) * (cursorSize + colourSize + 1) + resetSize;
+}
+
+// private
+
+bool AnsiScreen::Cell::operator==(const Cell &other) const
+{
+    return character == other.character && colour == other.colour;
+}
+
+bool AnsiScreen::Cell::operator!=(const Cell &other) const
+{
+    return !(*this == other);
+}
@@ -0,0 +1,87 @@
+#ifndef TETRIS_ANSI_SCREEN_H
+#define TETRIS_ANSI_SCREEN_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/*
+ * Character frame buffer of a terminal which is driven with ANSI escape sequences instead of ncurses,
+ * e.g. a remote terminal connected through a socket.
+ * Text is drawn into the current frame, and render() appends the escape sequences which turn the frame the
+ * terminal displays into the current one. Only changed cells are sent, so a frame in which a shape moved down
+ * costs a few dozen bytes instead of a full redraw. Only the rows drawn into since the last render() are
+ * compared, so rendering a large screen of which little is redrawn is cheap as well.
+ */
+class AnsiScreen
+{
+public:
+    /*
+     * Constructor. Creates a blank screen, which is redrawn completely by the first render().
+     *
+     * @param[in] rows number of rows
+     * @param[in] columns number of columns
+     */
+    AnsiScreen(const int rows, const int columns);
+
+    /*
+     * Default destructor.
+     */
+    ~AnsiScreen() = default;
+
+    /*
+     * Blanks the current frame.
+     */
+    void erase();
+
+    /*
+     * Draws text into the current frame. Text beyond the last column is cut off.
+     *
+     * @param[in] row row of the first character
+     * @param[in] column column of the first character
+     * @param[in] text the null-terminated text
+     * @param[in] colour colour of the cells, 0 for the default colours, 1 to 7 for the block colours of the
+     *                   ncurses colour pairs, i.e. red, green, yellow, blue, magenta, cyan and white
+     */
+    void draw(const int row, const int column, const char *text, const uint8_t colour = 0);
+
+    /*
+     * Makes the next render() clear the terminal and send the whole frame, e.g. after connecting.
+     */
+    void invalidate();
+
+    /*
+     * Appends the escape sequences which update the terminal to the current frame.
+     *
+     * @param[in,out] output bytes to send to the terminal
+     */
+    void render(std::string &output);
+
+    /*
+     * Returns the maximal number of bytes one render() can append. Output reserved for that many bytes is never
+     * reallocated by rendering.
+     */
+    std::size_t get_maximal_render_size() const;
+
+private:
+    /*
+     * Cell of the frame.
+     */
+    struct Cell
+    {
+        char character{' '}; ///< displayed character
+        uint8_t colour{0}; ///< colour as passed to draw()
+
+        bool operator==(const Cell &other) const;
+        bool operator!=(const Cell &other) const;
+    };
+
+    int _rows; ///< number of rows
+    int _columns; ///< number of columns
+    std::vector<Cell> _current; ///< frame being drawn
+    std::vector<Cell> _displayed; ///< frame the terminal displays
+    std::vector<uint8_t> _drawnRows; ///< 1 for every row drawn into since the last render()
+    bool _invalid{true}; ///< true if the terminal's content is unknown
+};
+
+#endif //TETRIS_ANSI_SCREEN_H
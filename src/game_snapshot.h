@@ -0,0 +1,33 @@
+#ifndef TETRIS_GAME_SNAPSHOT_H
+#define TETRIS_GAME_SNAPSHOT_H
+
+#include "tetris/gameboard.h"
+
+#include <array>
+#include <cstdint>
+
+/*
+ * Immutable copy of everything a rendered game displays, so a game board can be rendered while it keeps changing.
+ */
+template<SizeType height, SizeType width>
+struct GameSnapshot
+{
+    std::array<CellState, height * width> frame{}; ///< landed blocks and falling shape, see GameBoard::get_frame()
+    std::array<CellState, 4 * 3> nextShape{}; ///< upper left 4x3 cells of the next falling shape
+    uint8_t level{0}; ///< the player's current level
+    uint16_t lineClears{0}; ///< number of cleared rows
+    uint32_t frameVersion{0}; ///< version of the frame, see GameBoard::get_frame_version()
+};
+
+/*
+ * Copies the displayed state of a game board into a snapshot.
+ *
+ * @param[in] gameBoard the current tetris game board
+ * @param[out] snapshot the snapshot to overwrite
+ */
+template<SizeType height, SizeType width>
+void take_snapshot(const GameBoard<height, width> &gameBoard, GameSnapshot<height, width> &snapshot);
+
+#include "game_snapshot.hpp"
+
+#endif //TETRIS_GAME_SNAPSHOT_H
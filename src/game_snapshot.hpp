@@ -0,0 +1,22 @@
+// free functions
+
+template<SizeType height, SizeType width>
+void take_snapshot(const GameBoard<height, width> &gameBoard, GameSnapshot<height, width> &snapshot)
+{
+    snapshot.frame = gameBoard.get_frame();
+
+    const Falling nextFalling = gameBoard.get_next_falling();
+
+    for (SizeType i = 0; i < 4; ++i)
+    {
+        for (SizeType j = 0; j < 3; ++j)
+        {
+            snapshot.nextShape[i * 3 + j] = nextFalling.get_raw_cell_state(i, j);
+        }
+    }
+
+    snapshot.level = gameBoard.get_level();
+    snapshot.lineClears = gameBoard.get_line_clears();
+    snapshot.frameVersion = gameBoard.get_frame_version();
+    return;
+}
@@ -0,0 +1,127 @@
+#include "input_thread.h"
+
+#include <algorithm>
+#include <cerrno>
+
+#include <fcntl.h>
+#include <poll.h>
+
+// public
+
+InputThread::InputThread(const int fileDescriptor)
+: _fileDescriptor{fileDescriptor}
+{
+    if (pipe2(_stopPipe, O_NONBLOCK | O_CLOEXEC) == 0 && pipe2(_wakePipe, O_NONBLOCK | O_CLOEXEC) == 0)
+    {
+        _thread = std::thread(&InputThread::read_loop, this);
+    }
+}
+
+InputThread::~InputThread()
+{
+    if (_thread.joinable())
+    {
+        const char stop = 0;
+        while (write(_stopPipe[1], &stop, 1) < 0 && errno == EINTR)
+        {
+        }
+        _thread.join();
+    }
+
+    for (const int pipeEnd : {_stopPipe[0], _stopPipe[1], _wakePipe[0], _wakePipe[1]})
+    {
+        if (pipeEnd >= 0)
+        {
+            close(pipeEnd);
+        }
+    }
+}
+
+bool InputThread::is_running() const
+{
+    return _thread.joinable();
+}
+
+bool InputThread::pop_event(InputEvent &event)
+{
+    return _events.pop(event);
+}
+
+void InputThread::wait_for_event(const InputClock::time_point deadline)
+{
+    const InputClock::duration remaining = std::max(deadline - InputClock::now(), InputClock::duration::zero());
+    const std::chrono::seconds seconds = std::chrono::duration_cast<std::chrono::seconds>(remaining);
+    const timespec timeout{static_cast<time_t>(seconds.count()),
+                           static_cast<long>(std::chrono::duration_cast<std::chrono::nanoseconds>(remaining - seconds).count())};
+
+    pollfd wake{_wakePipe[0], POLLIN, 0};
+    if (ppoll(&wake, 1, &timeout, nullptr) > 0)
+    {
+        // the events themselves are in the queue, the bytes only signal their arrival
+        char buffer[64];
+        while (read(_wakePipe[0], buffer, sizeof(buffer)) > 0)
+        {
+        }
+    }
+    return;
+}
+
+// private
+
+void InputThread::read_loop()
+{
+    pollfd fileDescriptors[2] = {{_fileDescriptor, POLLIN, 0}, {_stopPipe[0], POLLIN, 0}};
+    while (true)
+    {
+        if (poll(fileDescriptors, 2, -1) < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return;
+        }
+        if (fileDescriptors[1].revents != 0)
+        {
+            return;
+        }
+        if (fileDescriptors[0].revents == 0)
+        {
+            continue;
+        }
+
+        // all bytes of one read arrived at the same time
+        unsigned char buffer[64];
+        const ssize_t size = read(_fileDescriptor, buffer, sizeof(buffer));
+        const InputClock::time_point timestamp = InputClock::now();
+        if (size == 0 || (size < 0 && errno != EINTR && errno != EAGAIN))
+        {
+            return; // the input has been closed
+        }
+
+        for (ssize_t b = 0; b < size; ++b)
+        {
+            decode(buffer[b], timestamp);
+        }
+        if (size > 0)
+        {
+            const char wake = 0;
+            (void) write(_wakePipe[1], &wake, 1); // a full pipe already wakes the consumer
+        }
+    }
+}
+
+void InputThread::decode(const unsigned char byte, const InputClock::time_point timestamp)
+{
+    if (!_decoder.is_in_escape_sequence())
+    {
+        _sequenceStart = timestamp; // the byte may be the ESC of a sequence
+    }
+
+    InputAction action;
+    if (_decoder.decode(byte, action))
+    {
+        _events.push({action, _sequenceStart});
+    }
+    return;
+}
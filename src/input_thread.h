@@ -0,0 +1,98 @@
+#ifndef TETRIS_INPUT_THREAD_H
+#define TETRIS_INPUT_THREAD_H
+
+#include "key_decoder.h"
+#include "tetris/spsc_queue.h"
+
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+#include <unistd.h>
+
+using InputClock = std::chrono::steady_clock; ///< Monotonic clock of input timestamps.
+
+/*
+ * Player action together with the time at which its keystroke was read.
+ */
+struct InputEvent
+{
+    InputAction action{INPUT_QUIT}; ///< triggered action
+    InputClock::time_point timestamp{}; ///< time at which the keystroke arrived
+};
+
+/*
+ * Thread which blocks on a terminal's input, decodes keystrokes into actions and stamps each one with the
+ * time it arrived. The events are handed to the game thread through a lock-free queue, so the game thread
+ * can apply them at their precise times instead of sampling the keyboard once per frame.
+ *
+ * The thread reads raw bytes and decodes the arrow keys' escape sequences with a KeyDecoder, so it does not call into
+ * ncurses, which is not thread-safe. The terminal is expected to be in cbreak mode, e.g. set up by ncurses.
+ */
+class InputThread
+{
+public:
+    static constexpr std::size_t QUEUE_CAPACITY{256}; ///< Maximal number of pending events.
+
+    /*
+     * Constructor. Starts reading from a file descriptor.
+     *
+     * @param[in] fileDescriptor file descriptor of the terminal input
+     */
+    explicit InputThread(const int fileDescriptor = STDIN_FILENO);
+
+    /*
+     * Destructor. Stops and joins the thread.
+     */
+    ~InputThread();
+
+    InputThread(const InputThread&) = delete;
+    InputThread& operator=(const InputThread&) = delete;
+
+    /*
+     * Returns true if the thread has been started successfully.
+     */
+    bool is_running() const;
+
+    /*
+     * Removes the oldest pending event. Only to be called by a single consumer thread.
+     *
+     * @param[out] event the removed event
+     * @return false if no event is pending
+     */
+    bool pop_event(InputEvent &event);
+
+    /*
+     * Blocks until an event may be pending or the deadline has passed, whichever comes first.
+     * Spurious returns are possible, so pop_event() has to be checked afterwards.
+     *
+     * @param[in] deadline latest time to return
+     */
+    void wait_for_event(const InputClock::time_point deadline);
+
+private:
+    /*
+     * Reads and decodes keystrokes until the thread is stopped or the input is closed.
+     */
+    void read_loop();
+
+    /*
+     * Decodes one byte of input. Completed actions are pushed to the queue, those of escape sequences with the
+     * arrival time of the sequence's ESC.
+     *
+     * @param[in] byte the byte read
+     * @param[in] timestamp arrival time of the byte
+     */
+    void decode(const unsigned char byte, const InputClock::time_point timestamp);
+
+private:
+    int _fileDescriptor; ///< terminal input
+    int _stopPipe[2]{-1, -1}; ///< written by the destructor to stop the thread
+    int _wakePipe[2]{-1, -1}; ///< written by the thread after pushing events, waited for by the consumer
+    KeyDecoder _decoder{}; ///< decoder of the keystrokes
+    InputClock::time_point _sequenceStart{}; ///< arrival time of the ESC of the current escape sequence
+    SpscQueue<InputEvent, QUEUE_CAPACITY> _events{}; ///< decoded events waiting for the game thread
+    std::thread _thread{}; ///< the reading thread
+};
+
+#endif //TETRIS_INPUT_THREAD_H
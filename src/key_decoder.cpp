@@ -0,0 +1,61 @@
+#include "key_decoder.h"
+
+// public
+
+bool KeyDecoder::decode(const unsigned char byte, InputAction &action)
+{
+    constexpr unsigned char ESCAPE = 0x1B;
+
+    switch (_state)
+    {
+        case DECODER_ESCAPE:
+            if (byte == '[' || byte == 'O')
+            {
+                _state = DECODER_SEQUENCE;
+                return false;
+            }
+            _state = DECODER_GROUND; // a lone ESC, decode the byte on its own
+            break;
+        case DECODER_SEQUENCE:
+            _state = DECODER_GROUND;
+            switch (byte)
+            {
+                case 'B':
+                    action = INPUT_DOWN;
+                    return true;
+                case 'C':
+                    action = INPUT_RIGHT;
+                    return true;
+                case 'D':
+                    action = INPUT_LEFT;
+                    return true;
+                default:
+                    return false;
+            }
+        case DECODER_GROUND:
+            break;
+    }
+
+    switch (byte)
+    {
+        case ESCAPE:
+            _state = DECODER_ESCAPE;
+            return false;
+        case 'q':
+            action = INPUT_QUIT;
+            return true;
+        case 'r':
+            action = INPUT_ROTATE_CLOCKWISE;
+            return true;
+        case 'u':
+            action = INPUT_ROTATE_COUNTERCLOCKWISE;
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool KeyDecoder::is_in_escape_sequence() const
+{
+    return _state != DECODER_GROUND;
+}
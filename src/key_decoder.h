@@ -0,0 +1,55 @@
+#ifndef TETRIS_KEY_DECODER_H
+#define TETRIS_KEY_DECODER_H
+
+#include <cstdint>
+
+/*
+ * Player actions which can be triggered by keystrokes.
+ */
+enum InputAction : uint8_t
+{
+    INPUT_QUIT, ///< 'q'
+    INPUT_LEFT, ///< left arrow key
+    INPUT_RIGHT, ///< right arrow key
+    INPUT_DOWN, ///< down arrow key
+    INPUT_ROTATE_CLOCKWISE, ///< 'r'
+    INPUT_ROTATE_COUNTERCLOCKWISE ///< 'u'
+};
+
+/*
+ * Decoder of the raw bytes a terminal in cbreak or raw mode sends for keystrokes.
+ * Arrow keys are sent as ESC [ A-D, or as ESC O A-D in keypad transmit mode; all other keys are single bytes.
+ * The decoder keeps the progress of an escape sequence between calls, so the bytes may arrive in any chunks.
+ */
+class KeyDecoder
+{
+public:
+    /*
+     * Decodes one byte of input.
+     *
+     * @param[in] byte the byte read
+     * @param[out] action the completed action, unchanged if the byte does not complete one
+     * @return true if the byte completed an action
+     */
+    bool decode(const unsigned char byte, InputAction &action);
+
+    /*
+     * Returns true if an escape sequence is in progress, i.e. the next byte may complete an arrow key.
+     */
+    bool is_in_escape_sequence() const;
+
+private:
+    /*
+     * State of decoding escape sequences.
+     */
+    enum DecoderState : uint8_t
+    {
+        DECODER_GROUND, ///< no sequence in progress
+        DECODER_ESCAPE, ///< ESC has been read
+        DECODER_SEQUENCE ///< ESC [ or ESC O has been read
+    };
+
+    DecoderState _state{DECODER_GROUND}; ///< progress of the current escape sequence
+};
+
+#endif //TETRIS_KEY_DECODER_H
@@ -1,23 +1,75 @@
 #include "main_auxiliary.h"
 
+#include "input_thread.h"
+#include "render_thread.h"
 #include "tetris/gameboard.h"
+#include "tetris/save_journal.h"
 
 #include <cstdlib>
+#include <iostream>
 
 int main()
 {
+    // the timeline of a game is written at its end if TETRIS_TRACE names a file, see tetris/trace.h
+    const char * const tracePath = std::getenv("TETRIS_TRACE");
+    if (tracePath)
+    {
+        set_tracing_enabled(true);
+        set_trace_thread_name("main");
+    }
+
     initialize_ncurses();
 
+    // resume the saved game, if there is one
     GameBoard<24, 10> gameBoard;
+    const std::string saveDirectory = get_save_directory();
+    if (!saveDirectory.empty())
+    {
+        load_saved_game(saveDirectory, gameBoard);
+    }
+
+    SaveJournal<24, 10> journal(saveDirectory, gameBoard);
+    InputThread input;
+    RenderThread<24, 10> renderer;
+
+    InputClock::time_point nextFrame = InputClock::now() + std::chrono::duration_cast<InputClock::duration>(Frames(1));
+    uint32_t publishedFrameVersion = gameBoard.get_frame_version();
+    renderer.publish(gameBoard);
+
+    // every lock is journaled right after it happened
+    const auto recordLock = [&journal, &gameBoard]() { journal.record(gameBoard); };
 
-    // the main loop exits as soon as the events loop returns true
-    render_game(gameBoard);
-    while (!events(gameBoard) && !gameBoard.is_game_over())
+    // the main loop exits as soon as a quit event arrives
+    bool quit = !input.is_running() || !renderer.is_running();
+    while (!quit && !gameBoard.is_game_over())
     {
-        loop(gameBoard);
-        render_game(gameBoard);
+        input.wait_for_event(nextFrame);
+
+        const TraceScope traceScope("events");
+
+        // every event is applied after exactly the frames which were due before its keystroke
+        InputEvent event;
+        while (!quit && !gameBoard.is_game_over() && input.pop_event(event))
+        {
+            advance_gravity(gameBoard, nextFrame, event.timestamp, recordLock);
+            quit = apply_input(gameBoard, event.action);
+            recordLock();
+        }
+        advance_gravity(gameBoard, nextFrame, InputClock::now(), recordLock);
+
+        // the info window only changes together with the board, when a shape settles
+        if (gameBoard.get_frame_version() != publishedFrameVersion)
+        {
+            const TraceScope publishScope("publish");
+            publishedFrameVersion = gameBoard.get_frame_version();
+            renderer.publish(gameBoard);
+        }
     }
 
+    // ncurses must not be used concurrently with the render thread
+    renderer.stop();
+    journal.stop(gameBoard);
+
     if (gameBoard.is_game_over())
     {
         render_game_over();
@@ -25,5 +77,10 @@ int main()
 
     finalize_ncurses();
 
+    if (tracePath && !write_trace(tracePath))
+    {
+        std::cerr << "Could not write the trace to " << tracePath << "." << std::endl;
+    }
+
     return EXIT_SUCCESS;
 }
@@ -5,8 +5,16 @@
 #include "tetris/gameboard.h"
 #include "tetris/shapes.h"
 #include "tetris/types.h"
+#include "game_snapshot.h"
+#include "input_thread.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
 
 #include <ncurses.h>
+#include <sys/stat.h>
 
 
 using ColourType = short;
@@ -27,20 +35,51 @@ void initialize_colors();
 ColourType convert_state_to_color(const CellState state);
 
 /*
- * Event loop implementatation. Captures key events and reacts accordingly.
+ * Applies a player action to the game board.
  *
  * @param[in] gameBoard the current tetris game board
+ * @param[in] action the action to apply
  * @return bool indicating whether program should be terminated
  */
 template<SizeType height, SizeType width>
-bool events(GameBoard<height, width> &gameBoard);
+bool apply_input(GameBoard<height, width> &gameBoard, const InputAction action);
 
 /*
- * Game loop implementation. Updates the game board in dependence on the current game progress.
+ * Game loop implementation. Advances the game board by all frames which are due up to a given time.
+ * Frames are 1/60 s apart, and each one moves the falling shape according to the gravity of the current level.
+ *
  * @param[in] gameBoard the current tetris game board
+ * @param[in] nextFrame time of the next due frame, advanced past every performed frame
+ * @param[in] until time up to which the frames are performed
+ * @param[in] afterFrame callable invoked after every frame, e.g. for journaling locks
+ */
+template<SizeType height, SizeType width, typename Callback>
+void advance_gravity(GameBoard<height, width> &gameBoard, InputClock::time_point &nextFrame,
+                     const InputClock::time_point until, Callback &&afterFrame);
+
+/*
+ * ncurses windows in which a game is rendered.
+ */
+struct GameWindows
+{
+    WINDOW *gameBoard{nullptr}; ///< window of the game board
+    WINDOW *info{nullptr}; ///< window of the next shape, the level, the line clears and the controls
+};
+
+/*
+ * Creates the windows for rendering a game board of the given size.
+ *
+ * @return the created windows, to be deleted with destroy_game_windows()
  */
 template<SizeType height, SizeType width>
-void loop(GameBoard<height, width> &gameBoard);
+GameWindows create_game_windows();
+
+/*
+ * Deletes windows created by create_game_windows().
+ *
+ * @param[in] windows the windows, reset to nullptr
+ */
+void destroy_game_windows(GameWindows &windows);
 
 /*
  * Draws a fancy horizontal line of specified width in an ncurses window.
@@ -52,16 +91,24 @@ void draw_horizontal_line(WINDOW * const window, const int width);
 /*
  * Render loop implementation for the tetris game.
  * It renders the game board and an information board separately.
- * @param[in] gameBoard the current tetris game board
+ * @param[in] windows windows created by create_game_windows()
+ * @param[in] snapshot snapshot of the current tetris game board
  */
 template<SizeType height, SizeType width>
-void render_game(const GameBoard<height, width> &gameBoard);
+void render_game(const GameWindows &windows, const GameSnapshot<height, width> &snapshot);
 
 /*
  * Displays the "GAME OVER" message.
  */
 void render_game_over();
 
+/*
+ * Returns the directory in which the running game is saved, ~/.tetris. It is created if necessary.
+ *
+ * @return save directory, or an empty string if it is not available
+ */
+std::string get_save_directory();
+
 /*
  * Initializes the ncurses library and the used colors. When using ncurses, proper initialization is necessary.
  */
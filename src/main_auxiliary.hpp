@@ -24,144 +24,180 @@ ColourType convert_state_to_color(const CellState state)
 }
 
 template<SizeType height, SizeType width>
-bool events(GameBoard<height, width> &gameBoard)
+bool apply_input(GameBoard<height, width> &gameBoard, const InputAction action)
 {
     bool quit = false;
 
-    int keystroke = getch();
-
-    switch (keystroke)
+    switch (action)
     {
-        case 'q':
+        case INPUT_QUIT:
             quit = true;
             break;
-        case KEY_LEFT:
+        case INPUT_LEFT:
             gameBoard.move_left_if_valid();
             break;
-        case KEY_RIGHT:
+        case INPUT_RIGHT:
             gameBoard.move_right_if_valid();
             break;
-        case KEY_DOWN:
+        case INPUT_DOWN:
             gameBoard.move_down_if_valid();
             break;
-        case 'r':
+        case INPUT_ROTATE_CLOCKWISE:
             gameBoard.rotate_clockwise_if_valid();
             break;
-        case 'u':
+        case INPUT_ROTATE_COUNTERCLOCKWISE:
             gameBoard.rotate_counterclockwise_if_valid();
             break;
-        default:
-            break;
     }
     return quit;
 }
 
-template<SizeType height, SizeType width>
-void loop(GameBoard<height, width> &gameBoard)
+template<SizeType height, SizeType width, typename Callback>
+void advance_gravity(GameBoard<height, width> &gameBoard, InputClock::time_point &nextFrame,
+                     const InputClock::time_point until, Callback &&afterFrame)
 {
-    static uint8_t cycleCounter = 0;
-
-    // 16ms delay ~= 60 FPS
-    napms(16);
-
-    // Game board gets updated after certain number of cycles
-    // When having 60 FPS, an update cycle threshold of 60
-    // corresponds to one update per second
-    if (cycleCounter == gameBoard.get_update_cycle_threshold())
+    while (!gameBoard.is_game_over() && nextFrame <= until)
     {
-        gameBoard.update();
-        cycleCounter = 0;
+        gameBoard.advance_frame();
+        afterFrame();
+        nextFrame += std::chrono::duration_cast<InputClock::duration>(Frames(1));
     }
-    ++cycleCounter;
+    return;
 }
 
 void draw_horizontal_line(WINDOW * const window, const int width)
 {
-    wprintw(window, "-%s-", std::string(width-2, '=').c_str());
+    waddch(window, '-');
+    for (int column = 2; column < width; ++column)
+    {
+        waddch(window, '=');
+    }
+    waddch(window, '-');
 }
 
 template<SizeType height, SizeType width>
-void render_game(const GameBoard<height, width> &gameBoard)
+GameWindows create_game_windows()
 {
-    // first, render game board window
     constexpr int gameBoardWindowHeight = height + 2;
     constexpr int gameBoardWindowWidth = 2*width + 4;
     constexpr int gameBoardWindowY = 2;
     constexpr int gameBoardWindowX = 5;
 
-    static WINDOW* gameBoardWindow = newwin(gameBoardWindowHeight, gameBoardWindowWidth, gameBoardWindowY, gameBoardWindowX);
+    constexpr int infoWindowHeight = gameBoardWindowHeight;
+    constexpr int infoWindowWidth = 18;
+    constexpr int infoWindowWindowY = gameBoardWindowY;
+    constexpr int infoWindowWindowX = gameBoardWindowX + gameBoardWindowWidth;
+
+    GameWindows windows;
+    windows.gameBoard = newwin(gameBoardWindowHeight, gameBoardWindowWidth, gameBoardWindowY, gameBoardWindowX);
+    windows.info = newwin(infoWindowHeight, infoWindowWidth, infoWindowWindowY, infoWindowWindowX);
+    return windows;
+}
+
+void destroy_game_windows(GameWindows &windows)
+{
+    if (windows.gameBoard)
+    {
+        delwin(windows.gameBoard);
+        windows.gameBoard = nullptr;
+    }
+    if (windows.info)
+    {
+        delwin(windows.info);
+        windows.info = nullptr;
+    }
+}
+
+template<SizeType height, SizeType width>
+void render_game(const GameWindows &windows, const GameSnapshot<height, width> &snapshot)
+{
+    const TraceScope traceScope("render_game");
+
+    // first, render game board window
+    constexpr int gameBoardWindowWidth = 2*width + 4;
+
+    WINDOW * const gameBoardWindow = windows.gameBoard;
     werase(gameBoardWindow);
 
+    const std::array<CellState, height * width> &frame = snapshot.frame;
+
     draw_horizontal_line(gameBoardWindow, gameBoardWindowWidth); // draw upper wall
     for (SizeType i = 0; i < height; ++i)
     {
-        wprintw(gameBoardWindow, "<!");
+        waddstr(gameBoardWindow, "<!");
         for (SizeType j = 0; j < width; ++j)
         {
-            const CellState currentState = gameBoard.get_cell_state(i, j);
+            const CellState currentState = frame[i * width + j];
             const char character = currentState ? '#' : ' '; // print a character in case colors are not available
 
             wattron(gameBoardWindow, convert_state_to_color(currentState));
-            wprintw(gameBoardWindow, "%c%c", character, character); // print twice to make the form more square
+            waddch(gameBoardWindow, character); // print twice to make the form more square
+            waddch(gameBoardWindow, character);
             wattroff(gameBoardWindow, convert_state_to_color(currentState));
         }
-        wprintw(gameBoardWindow, "!>");
+        waddstr(gameBoardWindow, "!>");
     }
     draw_horizontal_line(gameBoardWindow, gameBoardWindowWidth); // draw lower wall
-    wrefresh(gameBoardWindow);
+    {
+        const TraceScope refreshScope("wrefresh");
+        wrefresh(gameBoardWindow);
+    }
 
     // then, render info window
-    constexpr int infoWindowHeight = gameBoardWindowHeight;
     constexpr int infoWindowWidth = 18;
-    constexpr int infoWindowWindowY = gameBoardWindowY;
-    constexpr int infoWindowWindowX = gameBoardWindowX + gameBoardWindowWidth;
 
     static_assert(height >= 24, "ERROR: Game board height must be greater or equal to 24.");
-    static WINDOW* infoWindow = newwin(infoWindowHeight, infoWindowWidth, infoWindowWindowY, infoWindowWindowX);
+    WINDOW * const infoWindow = windows.info;
     werase(infoWindow);
 
     draw_horizontal_line(infoWindow, infoWindowWidth); // draw upper wall
 
-    wprintw(infoWindow, "<!              !>");
-    wprintw(infoWindow, "<!              !>");
-    wprintw(infoWindow, "<!     NEXT:    !>");
-    wprintw(infoWindow, "<!              !>");
-    wprintw(infoWindow, "<!              !>");
+    waddstr(infoWindow, "<!              !>");
+    waddstr(infoWindow, "<!              !>");
+    waddstr(infoWindow, "<!     NEXT:    !>");
+    waddstr(infoWindow, "<!              !>");
+    waddstr(infoWindow, "<!              !>");
 
-    const Falling nextFalling = gameBoard.get_next_falling();
     for (SizeType i = 0; i < 4; ++i)
     {
-        wprintw(infoWindow, "<!    ");
+        waddstr(infoWindow, "<!    ");
         for (SizeType j = 0; j < 3; ++j)
         {
-            const CellState currentState = nextFalling.get_raw_cell_state(i, j);
+            const CellState currentState = snapshot.nextShape[i * 3 + j];
             const char character = currentState ? '#' : ' '; // print character in case no colors are available
 
             wattron(infoWindow, convert_state_to_color(currentState));
-            wprintw(infoWindow, "%c%c", character, character); // print twice to make the form more square
+            waddch(infoWindow, character); // print twice to make the form more square
+            waddch(infoWindow, character);
             wattroff(infoWindow, convert_state_to_color(currentState));
         }
-        wprintw(infoWindow, "    !>");
+        waddstr(infoWindow, "    !>");
     }
     draw_horizontal_line(infoWindow, infoWindowWidth); // draw lower wall
 
-    // render information window and controls info
-    wprintw(infoWindow, "<!              !>");
-    wprintw(infoWindow, "<! LEVEL:       !>");
-    wprintw(infoWindow, "<! %12d !>", gameBoard.get_level());
-    wprintw(infoWindow, "<!              !>");
-    wprintw(infoWindow, "<! LINE CLEARS: !>");
-    wprintw(infoWindow, "<! %12d !>", gameBoard.get_line_clears());
-    wprintw(infoWindow, "<!              !>");
+    // render information window and controls info. The numbers are formatted into a buffer, since wprintw() may allocate
+    char number[32];
+    waddstr(infoWindow, "<!              !>");
+    waddstr(infoWindow, "<! LEVEL:       !>");
+    std::snprintf(number, sizeof(number), "<! %12d !>", snapshot.level);
+    waddstr(infoWindow, number);
+    waddstr(infoWindow, "<!              !>");
+    waddstr(infoWindow, "<! LINE CLEARS: !>");
+    std::snprintf(number, sizeof(number), "<! %12d !>", snapshot.lineClears);
+    waddstr(infoWindow, number);
+    waddstr(infoWindow, "<!              !>");
     draw_horizontal_line(infoWindow, infoWindowWidth); // draw lower wall
-    wprintw(infoWindow, "<! MOVE:        !>");
-    wprintw(infoWindow, "<!   ARROW KEYS !>");
-    wprintw(infoWindow, "<! ROTATE:      !>");
-    wprintw(infoWindow, "<!   R  AND  U  !>");
-    wprintw(infoWindow, "<! QUIT:        !>");
-    wprintw(infoWindow, "<!   Q          !>");
+    waddstr(infoWindow, "<! MOVE:        !>");
+    waddstr(infoWindow, "<!   ARROW KEYS !>");
+    waddstr(infoWindow, "<! ROTATE:      !>");
+    waddstr(infoWindow, "<!   R  AND  U  !>");
+    waddstr(infoWindow, "<! QUIT:        !>");
+    waddstr(infoWindow, "<!   Q          !>");
     draw_horizontal_line(infoWindow, infoWindowWidth); // draw lower wall
-    wrefresh(infoWindow);
+    {
+        const TraceScope refreshScope("wrefresh");
+        wrefresh(infoWindow);
+    }
 
     return;
 }
@@ -180,13 +216,28 @@ void render_game_over()
     napms(5000); // wait 5 seconds
 }
 
+std::string get_save_directory()
+{
+    const char * const home = getenv("HOME");
+    if (home == nullptr)
+    {
+        return "";
+    }
+
+    const std::string directory = std::string(home) + "/.tetris";
+    if (mkdir(directory.c_str(), 0755) != 0 && errno != EEXIST)
+    {
+        return "";
+    }
+    return directory;
+}
+
 void initialize_ncurses()
 {
     initscr(); // initialize ncurses library
     cbreak(); // disable buffering of typed characters and get a character-at-a-time input
     noecho(); // suppress automatic echoing of typed characters
-    nodelay(stdscr, true); // non-blocking getch calls
-    keypad(stdscr, true); // capture special keystrokes
+    keypad(stdscr, true); // let the terminal send arrow keys as escape sequences, decoded by the input thread
     start_color();
 
     initialize_colors();
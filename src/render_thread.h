@@ -0,0 +1,75 @@
+#ifndef TETRIS_RENDER_THREAD_H
+#define TETRIS_RENDER_THREAD_H
+
+#include "main_auxiliary.h"
+#include "tetris/gameboard.h"
+#include "tetris/triple_buffer.h"
+
+#include <atomic>
+#include <thread>
+
+/*
+ * Thread which renders snapshots of a game board, so slow terminal output cannot delay the simulation.
+ * The simulation thread publishes snapshots into a triple buffer, which never blocks it, and the render thread
+ * presents the newest one whenever it is done with the previous frame. Snapshots which are superseded in
+ * the meantime are never drawn.
+ *
+ * While the thread is running, it is the only one allowed to call ncurses output functions.
+ */
+template<SizeType height, SizeType width>
+class RenderThread
+{
+public:
+    /*
+     * Constructor. Starts the thread, which waits for the first snapshot.
+     */
+    RenderThread();
+
+    /*
+     * Destructor. Stops and joins the thread.
+     */
+    ~RenderThread();
+
+    RenderThread(const RenderThread&) = delete;
+    RenderThread& operator=(const RenderThread&) = delete;
+
+    /*
+     * Returns true if the thread has been started successfully and not been stopped yet.
+     */
+    bool is_running() const;
+
+    /*
+     * Publishes a snapshot of a game board for rendering. Only to be called by a single simulation thread.
+     * Never blocks.
+     *
+     * @param[in] gameBoard the current tetris game board
+     */
+    void publish(const GameBoard<height, width> &gameBoard);
+
+    /*
+     * Renders the last published snapshot, if not done yet, and joins the thread.
+     * Afterwards, ncurses may be used by other threads again.
+     */
+    void stop();
+
+private:
+    /*
+     * Renders the newest snapshot each time the thread is woken up, until it is stopped.
+     */
+    void render_loop();
+
+    /*
+     * Wakes the render thread up. Never blocks.
+     */
+    void wake();
+
+private:
+    TripleBuffer<GameSnapshot<height, width>> _snapshots{}; ///< snapshots handed to the render thread
+    std::atomic<bool> _stopping{false}; ///< set to make the thread exit after rendering
+    int _wakePipe[2]{-1, -1}; ///< written after publishing or stopping, waited for by the render thread
+    std::thread _thread{}; ///< the rendering thread
+};
+
+#include "render_thread.hpp"
+
+#endif //TETRIS_RENDER_THREAD_H
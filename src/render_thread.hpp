@@ -0,0 +1,100 @@
+#include <cerrno>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+
+// public:
+
+template<SizeType height, SizeType width>
+RenderThread<height, width>::RenderThread()
+{
+    if (pipe2(_wakePipe, O_NONBLOCK | O_CLOEXEC) == 0)
+    {
+        _thread = std::thread(&RenderThread::render_loop, this);
+    }
+}
+
+template<SizeType height, SizeType width>
+RenderThread<height, width>::~RenderThread()
+{
+    stop();
+
+    for (const int pipeEnd : {_wakePipe[0], _wakePipe[1]})
+    {
+        if (pipeEnd >= 0)
+        {
+            close(pipeEnd);
+        }
+    }
+}
+
+template<SizeType height, SizeType width>
+bool RenderThread<height, width>::is_running() const
+{
+    return _thread.joinable();
+}
+
+template<SizeType height, SizeType width>
+void RenderThread<height, width>::publish(const GameBoard<height, width> &gameBoard)
+{
+    take_snapshot(gameBoard, _snapshots.get_back());
+    _snapshots.publish();
+    wake();
+    return;
+}
+
+template<SizeType height, SizeType width>
+void RenderThread<height, width>::stop()
+{
+    if (_thread.joinable())
+    {
+        _stopping.store(true, std::memory_order_release);
+        wake();
+        _thread.join();
+    }
+    return;
+}
+
+// private:
+
+template<SizeType height, SizeType width>
+void RenderThread<height, width>::render_loop()
+{
+    set_trace_thread_name("render");
+    GameWindows windows = create_game_windows<height, width>();
+    pollfd wakeUp{_wakePipe[0], POLLIN, 0};
+    while (true)
+    {
+        if (poll(&wakeUp, 1, -1) < 0 && errno != EINTR)
+        {
+            break;
+        }
+
+        // consume the wake-ups first, so a snapshot published while rendering wakes the thread again
+        char buffer[64];
+        while (read(_wakePipe[0], buffer, sizeof(buffer)) > 0)
+        {
+        }
+        const bool stopping = _stopping.load(std::memory_order_acquire);
+
+        if (_snapshots.fetch())
+        {
+            render_game(windows, _snapshots.get_front());
+        }
+        if (stopping)
+        {
+            break;
+        }
+    }
+    destroy_game_windows(windows);
+    return;
+}
+
+template<SizeType height, SizeType width>
+void RenderThread<height, width>::wake()
+{
+    const char wakeUp = 0;
+    (void) write(_wakePipe[1], &wakeUp, 1); // a full pipe already wakes the thread
+    return;
+}
@@ -0,0 +1,61 @@
+/*
+ * Multi-player terminal server.
+ *
+ * Usage: tetris_server [-t worker threads] <socket path or TCP port>
+ *
+ * Players connect with a terminal in raw mode, e.g.
+ *     socat -,raw,echo=0 UNIX-CONNECT:<socket path>
+ *     socat -,raw,echo=0 TCP:localhost:<port>
+ * The server runs until it receives SIGINT or SIGTERM.
+ */
+
+#include "terminal_server.h"
+
+#include <csignal>
+#include <cstdlib>
+#include <iostream>
+
+#include <pthread.h>
+#include <unistd.h>
+
+int main(int argc, char *argv[])
+{
+    std::size_t threadCount = 0;
+    int option = 0;
+    while ((option = getopt(argc, argv, "t:")) != -1)
+    {
+        if (option != 't')
+        {
+            optind = argc + 1;
+            break;
+        }
+        threadCount = static_cast<std::size_t>(std::max(0, std::atoi(optarg)));
+    }
+    if (optind >= argc)
+    {
+        std::cerr << "Usage: " << argv[0] << " [-t worker threads = one per core up to 4] <socket path or TCP port>" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // the signals are received by sigwait() only, the worker threads inherit the mask
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+    TerminalServer<24, 10> server;
+    if (!server.start(argv[optind], threadCount))
+    {
+        std::cerr << "Could not listen on " << argv[optind] << "." << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::cout << "Listening on " << argv[optind] << "." << std::endl;
+
+    int signal = 0;
+    sigwait(&signals, &signal);
+
+    std::cout << "Stopping, disconnecting " << server.get_session_count() << " players." << std::endl;
+    server.stop();
+    return EXIT_SUCCESS;
+}
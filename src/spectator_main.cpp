@@ -0,0 +1,281 @@
+/*
+ * Spectator wall of bot games.
+ *
+ * Usage: tetris_wall [-g games] [-s seed] [-f minimal ticks per frame] [-d duration in seconds] [-r rows]
+ *                    [-c columns] [-u]
+ *
+ * As many games as fit into the terminal, see SpectatorWall, are played side by side by a greedy bot, which
+ * chooses the placement with the best evaluate_board() score, presses the controls of its finesse sequence one
+ * after another and then soft drops. Every game has its own pace, so the boards do not move in lockstep. A game
+ * over is shown for two seconds, then the tile starts the next game.
+ * The wall runs until it receives SIGINT or SIGTERM, or for the given duration, and then prints the rendered and
+ * skipped frames and the written bytes to stderr. With -u, the ticks are performed as fast as possible instead of
+ * 60 times per second, e.g. to measure the rendering with the output redirected to a file.
+ */
+
+#include "spectator_wall.h"
+#include "tetris/evaluation.h"
+#include "tetris/finesse.h"
+#include "tetris/gravity.h"
+
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+namespace
+{
+    constexpr SizeType HEIGHT = 24; ///< board height of the games
+    constexpr SizeType WIDTH = 10; ///< board width of the games
+    constexpr uint64_t GAME_OVER_TICKS = 120; ///< number of ticks a game over is shown
+
+    volatile std::sig_atomic_t stopRequested = 0; ///< set by SIGINT and SIGTERM
+
+    /*
+     * Game on the wall together with the state of its bot.
+     */
+    struct SpectatedGame
+    {
+        GameBoard<HEIGHT, WIDTH> gameBoard{1}; ///< the game
+        uint32_t number{0}; ///< number of the game, also its seed
+        uint64_t pace{4}; ///< number of ticks between two controls of the bot
+        InputSequence<WIDTH> sequence{}; ///< controls leading the falling shape to the chosen placement
+        uint8_t pressedInputs{0}; ///< number of pressed controls of the sequence
+        uint32_t plannedLock{std::numeric_limits<uint32_t>::max()}; ///< lock count for which the sequence was chosen
+        uint64_t gameOverTick{0}; ///< tick at which the game has ended
+    };
+
+    /*
+     * Starts a new game.
+     */
+    void start_game(SpectatedGame &game, const uint32_t number)
+    {
+        game = SpectatedGame{};
+        game.gameBoard = GameBoard<HEIGHT, WIDTH>(number);
+        game.number = number;
+        game.pace = 3 + number % 5;
+        return;
+    }
+
+    /*
+     * Chooses the placement of the falling shape with the best evaluation of the resulting board.
+     */
+    void plan_placement(SpectatedGame &game)
+    {
+        const BoardState<HEIGHT, WIDTH> boardState = game.gameBoard.get_board_state();
+        const ShapeType shapeType = game.gameBoard.get_current_falling().get_shape_type();
+        float bestScore = -std::numeric_limits<float>::infinity();
+        game.sequence = InputSequence<WIDTH>{};
+        for (const Placement &placement : generate_placements(boardState, shapeType))
+        {
+            BoardState<HEIGHT, WIDTH> successor = boardState;
+            const uint16_t clearedRows = successor.place(get_piece_mask(shapeType, placement.rotation),
+                                                         placement.row, placement.column);
+            const float score = evaluate_board(successor, clearedRows);
+            if (score > bestScore)
+            {
+                bestScore = score;
+                game.sequence = get_finesse_sequence<WIDTH>(placement);
+            }
+        }
+        game.pressedInputs = 0;
+        game.plannedLock = game.gameBoard.get_lock_count();
+        return;
+    }
+
+    /*
+     * Performs one tick of a game: a control of its bot when its pace is due, then the frame.
+     */
+    void step_game(SpectatedGame &game, const uint64_t tick, uint32_t &nextNumber)
+    {
+        GameBoard<HEIGHT, WIDTH> &gameBoard = game.gameBoard;
+        if (gameBoard.is_game_over())
+        {
+            if (tick >= game.gameOverTick + GAME_OVER_TICKS)
+            {
+                start_game(game, nextNumber++);
+            }
+            return;
+        }
+
+        if (game.plannedLock != gameBoard.get_lock_count())
+        {
+            plan_placement(game);
+        }
+        if (tick % game.pace == 0 && game.pressedInputs < game.sequence.length)
+        {
+            switch (game.sequence.inputs[game.pressedInputs++])
+            {
+                case FINESSE_LEFT:
+                    gameBoard.move_left_if_valid();
+                    break;
+                case FINESSE_RIGHT:
+                    gameBoard.move_right_if_valid();
+                    break;
+                case FINESSE_CLOCKWISE:
+                    gameBoard.rotate_clockwise_if_valid();
+                    break;
+                default:
+                    gameBoard.rotate_counterclockwise_if_valid();
+                    break;
+            }
+        }
+        else if (tick % game.pace == 0)
+        {
+            gameBoard.move_down_if_valid();
+        }
+        gameBoard.advance_frame();
+
+        if (gameBoard.is_game_over())
+        {
+            game.gameOverTick = tick;
+        }
+        return;
+    }
+
+    /*
+     * Requests the wall to stop.
+     */
+    void request_stop(int)
+    {
+        stopRequested = 1;
+        return;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    std::size_t gameCount = 0;
+    uint32_t seed = 1;
+    uint64_t frameInterval = 1;
+    uint64_t durationTicks = 0;
+    int rows = 0;
+    int columns = 0;
+    bool unthrottled = false;
+    bool invalidOption = false;
+    int option = 0;
+    while (!invalidOption && (option = getopt(argc, argv, "g:s:f:d:r:c:u")) != -1)
+    {
+        switch (option)
+        {
+            case 'g':
+                gameCount = static_cast<std::size_t>(std::max(0, std::atoi(optarg)));
+                break;
+            case 's':
+                seed = static_cast<uint32_t>(std::strtoul(optarg, nullptr, 10));
+                break;
+            case 'f':
+                frameInterval = static_cast<uint64_t>(std::max(1, std::atoi(optarg)));
+                break;
+            case 'd':
+                durationTicks = static_cast<uint64_t>(std::max(0, std::atoi(optarg))) * 60;
+                break;
+            case 'r':
+                rows = std::max(0, std::atoi(optarg));
+                break;
+            case 'c':
+                columns = std::max(0, std::atoi(optarg));
+                break;
+            case 'u':
+                unthrottled = true;
+                break;
+            default:
+                invalidOption = true;
+                break;
+        }
+    }
+    if (invalidOption || optind != argc)
+    {
+        std::cerr << "Usage: " << argv[0] << " [-g games = all tiles] [-s seed = 1] [-f minimal ticks per frame = 1]"
+                  << " [-d duration in seconds] [-r rows] [-c columns] [-u]" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // the size of the terminal, unless given or the output is no terminal
+    winsize size{};
+    if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &size) != 0 || size.ws_row == 0)
+    {
+        size.ws_row = 52;
+        size.ws_col = 208;
+    }
+    rows = (rows > 0) ? rows : size.ws_row;
+    columns = (columns > 0) ? columns : size.ws_col;
+
+    const int flags = fcntl(STDOUT_FILENO, F_GETFL);
+    if (flags < 0 || fcntl(STDOUT_FILENO, F_SETFL, flags | O_NONBLOCK) != 0)
+    {
+        std::cerr << "Could not make the output non-blocking." << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    SpectatorWall<HEIGHT, WIDTH> wall(STDOUT_FILENO, rows, columns, frameInterval);
+    gameCount = (gameCount == 0) ? wall.get_tile_count() : std::min(gameCount, wall.get_tile_count());
+    if (gameCount == 0)
+    {
+        fcntl(STDOUT_FILENO, F_SETFL, flags);
+        std::cerr << "The terminal is too small for a game of " << SpectatorWall<HEIGHT, WIDTH>::TILE_ROWS << " rows and "
+                  << SpectatorWall<HEIGHT, WIDTH>::TILE_COLUMNS - 1 << " columns." << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::vector<SpectatedGame> games(gameCount);
+    uint32_t nextNumber = seed;
+    for (SpectatedGame &game : games)
+    {
+        start_game(game, nextNumber++);
+    }
+
+    std::signal(SIGINT, request_stop);
+    std::signal(SIGTERM, request_stop);
+
+    bool written = true;
+    uint64_t tick = 0;
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (; stopRequested == 0 && written && (durationTicks == 0 || tick < durationTicks); ++tick)
+    {
+        for (SpectatedGame &game : games)
+        {
+            step_game(game, tick, nextNumber);
+        }
+        if (wall.is_frame_due(tick))
+        {
+            for (std::size_t g = 0; g < games.size(); ++g)
+            {
+                wall.draw_game(g, games[g].gameBoard, games[g].number);
+            }
+        }
+        written = wall.transmit(tick);
+
+        if (!unthrottled)
+        {
+            std::this_thread::sleep_until(start + Frames(tick + 1));
+        }
+    }
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    // write the rest blocking, then reset the colours, clear the terminal and show the cursor again
+    fcntl(STDOUT_FILENO, F_SETFL, flags);
+    written = written && wall.flush();
+    static const char restore[] = "\x1b[0m\x1b[2J\x1b[H\x1b[?25h";
+    (void) write(STDOUT_FILENO, restore, sizeof(restore) - 1);
+
+    const WallStatistics &statistics = wall.get_statistics();
+    std::fprintf(stderr, "%zu games, %llu ticks in %.2f s, %llu frames rendered, %llu skipped, %llu tiles drawn,"
+                 " %llu bytes written (%.0f per frame), final interval %llu ticks\n", games.size(),
+                 static_cast<unsigned long long>(tick), elapsed.count(),
+                 static_cast<unsigned long long>(statistics.renderedFrames),
+                 static_cast<unsigned long long>(statistics.skippedFrames),
+                 static_cast<unsigned long long>(statistics.drawnTiles),
+                 static_cast<unsigned long long>(statistics.writtenBytes),
+                 statistics.writtenBytes / std::max(1.0, static_cast<double>(statistics.renderedFrames)),
+                 static_cast<unsigned long long>(wall.get_frame_interval()));
+    return written ? EXIT_SUCCESS : EXIT_FAILURE;
+}
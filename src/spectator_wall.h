@@ -0,0 +1,142 @@
+#ifndef TETRIS_SPECTATOR_WALL_H
+#define TETRIS_SPECTATOR_WALL_H
+
+#include "ansi_screen.h"
+#include "tetris/gameboard.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/*
+ * Counters of the output of a SpectatorWall.
+ */
+struct WallStatistics
+{
+    uint64_t renderedFrames{0}; ///< number of rendered frames
+    uint64_t skippedFrames{0}; ///< number of due frames skipped because earlier output was still pending
+    uint64_t drawnTiles{0}; ///< number of tiles redrawn because their game had changed
+    uint64_t writtenBytes{0}; ///< number of bytes written to the terminal
+};
+
+/*
+ * Grid of many games shown side by side in one terminal which is driven with ANSI escape sequences.
+ *
+ * Every game is shown in a tile with the board layout of render_game() at reduced size: one character per cell
+ * instead of two, single walls and, instead of the info window, a header line with the number of the game and
+ * its line clears. The owner draws the games with draw_game() whenever is_frame_due() and calls transmit() every
+ * tick. draw_game() only redraws tiles whose game has changed since it was drawn last, and all tiles share one
+ * AnsiScreen, so a frame is a single write of the changed cells of all games together.
+ *
+ * The frame interval adapts to the bandwidth of the terminal. If a frame is due while the output of the previous
+ * one is still pending, it is skipped and the interval is doubled; once the frames have kept up for
+ * RECOVERY_TICKS, the interval shrinks by one tick again. Ticks count frames of the games, 60 per second.
+ * No method blocks.
+ */
+template<SizeType height, SizeType width>
+class SpectatorWall
+{
+public:
+    static constexpr int TILE_ROWS{height + 2}; ///< Number of rows of a tile, i.e. the header, the board and the lower wall.
+    static constexpr int TILE_COLUMNS{width + 3}; ///< Number of columns of a tile, i.e. the walls, the board and a gap.
+    static constexpr uint64_t MAX_FRAME_INTERVAL{30}; ///< Maximal number of ticks between two frames.
+    static constexpr uint64_t RECOVERY_TICKS{120}; ///< Number of ticks without skipped frames after which the interval shrinks.
+
+    /*
+     * Constructor. Creates a blank wall, which clears the terminal with the first frame.
+     *
+     * @param[in] fileDescriptor non-blocking file descriptor of the terminal, not closed by the wall
+     * @param[in] rows number of rows of the terminal
+     * @param[in] columns number of columns of the terminal
+     * @param[in] frameInterval minimal number of ticks between two frames
+     */
+    SpectatorWall(const int fileDescriptor, const int rows, const int columns, const uint64_t frameInterval = 1);
+
+    /*
+     * Default destructor.
+     */
+    ~SpectatorWall() = default;
+
+    SpectatorWall(const SpectatorWall&) = delete;
+    SpectatorWall& operator=(const SpectatorWall&) = delete;
+
+    /*
+     * Returns the number of tiles which fit into the terminal.
+     */
+    std::size_t get_tile_count() const;
+
+    /*
+     * Returns true if the next frame is due by a tick and the previous one has been written, i.e. if the games
+     * have to be drawn before the following transmit().
+     */
+    bool is_frame_due(const uint64_t tick) const;
+
+    /*
+     * Draws a game into a tile unless the tile already shows the same frame of the same game.
+     *
+     * @param[in] tile index of the tile, tiles beyond get_tile_count() are ignored
+     * @param[in] gameBoard the game
+     * @param[in] number number of the game, shown in the header and distinguishing it from earlier games of the tile
+     */
+    void draw_game(const std::size_t tile, const GameBoard<height, width> &gameBoard, const uint32_t number);
+
+    /*
+     * Renders the drawn tiles if a frame is due by a tick and writes as much output as the terminal accepts.
+     *
+     * @param[in] tick current tick
+     * @return false if writing has failed
+     */
+    bool transmit(const uint64_t tick);
+
+    /*
+     * Writes as much of the rendered output as the terminal accepts, or all of it if the file descriptor blocks.
+     *
+     * @return false if writing has failed
+     */
+    bool flush();
+
+    /*
+     * Returns true if rendered output is waiting for the terminal to become writable.
+     */
+    bool has_pending_output() const;
+
+    /*
+     * Returns the current number of ticks between two frames.
+     */
+    uint64_t get_frame_interval() const;
+
+    /*
+     * Returns the counters of the output so far.
+     */
+    const WallStatistics& get_statistics() const;
+
+private:
+    /*
+     * Content of a tile as drawn last.
+     */
+    struct TileState
+    {
+        uint32_t number{0}; ///< number of the game
+        uint32_t frameVersion{0}; ///< frame version of the game, see GameBoard::get_frame_version()
+        bool gameOver{false}; ///< true if the game was over
+        bool drawn{false}; ///< true once a game has been drawn into the tile
+    };
+
+private:
+    int _fileDescriptor; ///< file descriptor of the terminal
+    int _gridColumns; ///< number of tiles per row of the grid
+    std::size_t _tileCount; ///< number of tiles
+    AnsiScreen _screen; ///< frame buffer of the whole terminal
+    std::vector<TileState> _tiles; ///< content of every tile
+    std::string _output{}; ///< rendered bytes, of which the first _outputOffset have been written
+    std::size_t _outputOffset{0}; ///< number of written bytes of _output
+    uint64_t _minFrameInterval; ///< minimal number of ticks between two frames
+    uint64_t _frameInterval; ///< current number of ticks between two frames
+    uint64_t _nextFrameTick{0}; ///< tick at which the next frame is due
+    uint64_t _keptUpSince{0}; ///< tick of the last skipped frame or change of the interval
+    WallStatistics _statistics{}; ///< counters of the output
+};
+
+#include "spectator_wall.hpp"
+
+#endif //TETRIS_SPECTATOR_WALL_H
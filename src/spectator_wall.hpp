@@ -0,0 +1,157 @@
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+
+#include <unistd.h>
+
+// public:
+
+template<SizeType height, SizeType width>
+SpectatorWall<height, width>::SpectatorWall(const int fileDescriptor, const int rows, const int columns,
+                                            const uint64_t frameInterval)
+: _fileDescriptor{fileDescriptor},
+  _gridColumns{std::max(0, (columns + 1) / TILE_COLUMNS)}, // the last tile needs no gap
+  _tileCount{static_cast<std::size_t>(_gridColumns * std::max(0, rows / TILE_ROWS))},
+  _screen(rows, columns),
+  _tiles(_tileCount),
+  _minFrameInterval{std::clamp<uint64_t>(frameInterval, 1, MAX_FRAME_INTERVAL)},
+  _frameInterval{_minFrameInterval}
+{
+    // rendering never reallocates the output afterwards
+    _output.reserve(_screen.get_maximal_render_size());
+}
+
+template<SizeType height, SizeType width>
+std::size_t SpectatorWall<height, width>::get_tile_count() const
+{
+    return _tileCount;
+}
+
+template<SizeType height, SizeType width>
+bool SpectatorWall<height, width>::is_frame_due(const uint64_t tick) const
+{
+    return tick >= _nextFrameTick && !has_pending_output();
+}
+
+template<SizeType height, SizeType width>
+void SpectatorWall<height, width>::draw_game(const std::size_t tile, const GameBoard<height, width> &gameBoard,
+                                             const uint32_t number)
+{
+    if (tile >= _tileCount)
+    {
+        return;
+    }
+
+    TileState &state = _tiles[tile];
+    const bool gameOver = gameBoard.is_game_over();
+    if (state.drawn && state.number == number && state.frameVersion == gameBoard.get_frame_version()
+        && state.gameOver == gameOver)
+    {
+        return;
+    }
+    state = {number, gameBoard.get_frame_version(), gameOver, true};
+    ++_statistics.drawnTiles;
+
+    // reduced layout of render_game(), the text is drawn from buffers on the stack
+    constexpr int tileWidth = width + 2;
+    const int top = static_cast<int>(tile / _gridColumns) * TILE_ROWS;
+    const int left = static_cast<int>(tile % _gridColumns) * TILE_COLUMNS;
+
+    char text[tileWidth + 1];
+    std::fill(text, text + tileWidth, ' ');
+    text[tileWidth] = '\0';
+    _screen.draw(top, left, text);
+    if (gameOver)
+    {
+        std::snprintf(text, sizeof(text), "%u OVER", number);
+    }
+    else
+    {
+        std::snprintf(text, sizeof(text), "%u:%u", number, static_cast<unsigned>(gameBoard.get_line_clears()));
+    }
+    _screen.draw(top, left, text);
+
+    const std::array<CellState, height * width> &frame = gameBoard.get_frame();
+    for (SizeType i = 0; i < height; ++i)
+    {
+        const int row = top + 1 + i;
+        _screen.draw(row, left, "!");
+        for (SizeType j = 0; j < width; ++j)
+        {
+            const CellState cellState = frame[i * width + j];
+            _screen.draw(row, left + 1 + j, cellState ? "#" : " ", static_cast<uint8_t>(cellState ? cellState % 7 + 1 : 0));
+        }
+        _screen.draw(row, left + 1 + width, "!");
+    }
+
+    std::fill(text, text + tileWidth, '=');
+    text[0] = '-';
+    text[tileWidth - 1] = '-';
+    _screen.draw(top + 1 + height, left, text); // draw lower wall
+    return;
+}
+
+template<SizeType height, SizeType width>
+bool SpectatorWall<height, width>::transmit(const uint64_t tick)
+{
+    if (tick >= _nextFrameTick && has_pending_output())
+    {
+        // the terminal does not keep up, so the frame is skipped and frames become rarer
+        ++_statistics.skippedFrames;
+        _frameInterval = std::min(2 * _frameInterval, MAX_FRAME_INTERVAL);
+        _nextFrameTick = tick + _frameInterval;
+        _keptUpSince = tick;
+    }
+    else if (tick >= _nextFrameTick)
+    {
+        if (_frameInterval > _minFrameInterval && tick >= _keptUpSince + RECOVERY_TICKS)
+        {
+            --_frameInterval;
+            _keptUpSince = tick;
+        }
+        ++_statistics.renderedFrames;
+        _nextFrameTick = tick + _frameInterval;
+        _output.clear();
+        _outputOffset = 0;
+        _screen.render(_output);
+    }
+    return flush();
+}
+
+template<SizeType height, SizeType width>
+bool SpectatorWall<height, width>::flush()
+{
+    while (has_pending_output())
+    {
+        const ssize_t size = write(_fileDescriptor, _output.data() + _outputOffset, _output.size() - _outputOffset);
+        if (size < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (size < 0)
+        {
+            return errno == EAGAIN || errno == EWOULDBLOCK;
+        }
+        _outputOffset += static_cast<std::size_t>(size);
+        _statistics.writtenBytes += static_cast<uint64_t>(size);
+    }
+    return true;
+}
+
+template<SizeType height, SizeType width>
+bool SpectatorWall<height, width>::has_pending_output() const
+{
+    return _outputOffset < _output.size();
+}
+
+template<SizeType height, SizeType width>
+uint64_t SpectatorWall<height, width>::get_frame_interval() const
+{
+    return _frameInterval;
+}
+
+template<SizeType height, SizeType width>
+const WallStatistics& SpectatorWall<height, width>::get_statistics() const
+{
+    return _statistics;
+}
@@ -0,0 +1,147 @@
+#ifndef TETRIS_TERMINAL_SERVER_H
+#define TETRIS_TERMINAL_SERVER_H
+
+#include "terminal_session.h"
+#include "tetris/timer_wheel.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace terminal_server_detail
+{
+    constexpr uint64_t LISTENER_TOKEN{~uint64_t{0}}; ///< epoll data of the listening socket
+    constexpr uint64_t FRAME_TOKEN{~uint64_t{0} - 1}; ///< epoll data of the frame timer
+    constexpr uint64_t STOP_TOKEN{~uint64_t{0} - 2}; ///< epoll data of the stop event
+}
+
+/*
+ * Server which lets many players connect with their terminals and play in one process.
+ *
+ * Clients connect to a Unix-domain socket or a loopback TCP port. The sessions are spread over a few worker
+ * threads, each of which waits for all of its sockets with one epoll instance, so there is no thread per
+ * player. A worker ticks at the frame rate, but instead of visiting every session each frame, each session is
+ * kept in the worker's timer wheel at the tick of its next gravity step and is only woken then or when input
+ * arrives. Every session renders into its own AnsiScreen and only sends the changed cells.
+ */
+template<SizeType height, SizeType width>
+class TerminalServer
+{
+public:
+    /*
+     * Constructor. Creates a stopped server.
+     */
+    TerminalServer() = default;
+
+    /*
+     * Destructor. Stops the server.
+     */
+    ~TerminalServer();
+
+    TerminalServer(const TerminalServer&) = delete;
+    TerminalServer& operator=(const TerminalServer&) = delete;
+
+    /*
+     * Listens for clients and starts the worker threads.
+     *
+     * @param[in] address path of a Unix-domain socket, which is replaced if it exists, or a TCP port number,
+     *                    which is bound to the loopback interface
+     * @param[in] threadCount number of worker threads, 0 means one per hardware thread up to four
+     * @return false if the socket cannot be bound or the threads cannot be started
+     */
+    bool start(const std::string &address, const std::size_t threadCount = 0);
+
+    /*
+     * Stops the worker threads and disconnects all players.
+     */
+    void stop();
+
+    /*
+     * Returns the number of connected players.
+     */
+    std::size_t get_session_count() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+    using Session = TerminalSession<height, width>;
+
+    static constexpr std::size_t WHEEL_SLOTS{1024}; ///< slots of the timer wheels, about 17 seconds of frames
+
+    /*
+     * Wake-up of a session in a timer wheel.
+     */
+    struct SessionTimer
+    {
+        uint32_t slot; ///< index of the session in Worker::sessions
+        uint32_t generation; ///< generation of the slot when the timer was scheduled
+        uint64_t tick; ///< tick for which the timer was scheduled
+    };
+
+    /*
+     * Session together with its bookkeeping in a worker.
+     */
+    struct SessionSlot
+    {
+        std::unique_ptr<Session> session{}; ///< the session, nullptr if the slot is free
+        uint32_t generation{0}; ///< incremented whenever the slot is freed, invalidates its pending timers
+        uint64_t scheduledTick{0}; ///< tick of the session's current timer
+        bool writing{false}; ///< true if the socket is watched for writability
+    };
+
+    /*
+     * Worker thread with its own epoll instance, frame timer and sessions.
+     */
+    struct Worker
+    {
+        int epoll{-1}; ///< epoll instance
+        int frameTimer{-1}; ///< timerfd expiring every frame
+        int stopEvent{-1}; ///< eventfd signalled to stop the thread
+        std::vector<SessionSlot> sessions{}; ///< sessions, indexed by slot
+        std::vector<uint32_t> freeSlots{}; ///< indices of free entries of sessions
+        TimerWheel<SessionTimer, WHEEL_SLOTS> wheel{}; ///< next wake-up of every session
+        std::thread thread{}; ///< the thread
+    };
+
+    /*
+     * Creates the listening socket.
+     */
+    bool listen(const std::string &address);
+
+    /*
+     * Event loop of a worker.
+     */
+    void run(Worker &worker);
+
+    /*
+     * Accepts all pending connections and starts a session for each.
+     */
+    void accept_sessions(Worker &worker, const uint64_t tick);
+
+    /*
+     * Sends a session's output and schedules its next wake-up, or closes it if it has ended or failed.
+     *
+     * @param[in] alive false if the session has already failed
+     */
+    void update_session(Worker &worker, const uint32_t slot, const uint64_t tick, bool alive);
+
+    /*
+     * Returns the current tick, i.e. the number of frames since the server started.
+     */
+    uint64_t get_tick() const;
+
+private:
+    int _listener{-1}; ///< listening socket, shared by all workers
+    std::string _socketPath{}; ///< path of the Unix-domain socket, removed on stop()
+    Clock::time_point _start{}; ///< time of tick 0
+    std::vector<std::unique_ptr<Worker>> _workers{}; ///< worker threads
+    std::atomic<std::size_t> _sessionCount{0}; ///< number of connected players
+    std::atomic<uint32_t> _nextSeed{0}; ///< seed of the next game
+};
+
+#include "terminal_server.hpp"
+
+#endif //TETRIS_TERMINAL_SERVER_H
@@ -0,0 +1,312 @@
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <ctime>
+
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/timerfd.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// public:
+
+template<SizeType height, SizeType width>
+TerminalServer<height, width>::~TerminalServer()
+{
+    stop();
+}
+
+template<SizeType height, SizeType width>
+bool TerminalServer<height, width>::start(const std::string &address, const std::size_t threadCount)
+{
+    using namespace terminal_server_detail;
+
+    stop();
+    if (!listen(address))
+    {
+        stop();
+        return false;
+    }
+    _start = Clock::now();
+    _nextSeed.store(static_cast<uint32_t>(time(nullptr)), std::memory_order_relaxed);
+
+    const std::size_t workerCount = threadCount ? threadCount
+                                                : std::clamp<std::size_t>(std::thread::hardware_concurrency(), 1, 4);
+    const long frameNanoseconds = static_cast<long>(std::chrono::duration_cast<std::chrono::nanoseconds>(Frames(1)).count());
+    const itimerspec frameInterval{{0, frameNanoseconds}, {0, frameNanoseconds}};
+    for (std::size_t w = 0; w < workerCount; ++w)
+    {
+        _workers.push_back(std::make_unique<Worker>());
+        Worker &worker = *_workers.back();
+        worker.epoll = epoll_create1(EPOLL_CLOEXEC);
+        worker.frameTimer = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+        worker.stopEvent = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (worker.epoll < 0 || worker.frameTimer < 0 || worker.stopEvent < 0
+            || timerfd_settime(worker.frameTimer, 0, &frameInterval, nullptr) != 0)
+        {
+            stop();
+            return false;
+        }
+
+        // every worker accepts connections, EPOLLEXCLUSIVE wakes only one of them per connection
+        epoll_event listenerEvent{EPOLLIN | EPOLLEXCLUSIVE, {}};
+        listenerEvent.data.u64 = LISTENER_TOKEN;
+        epoll_event frameEvent{EPOLLIN, {}};
+        frameEvent.data.u64 = FRAME_TOKEN;
+        epoll_event stopEvent{EPOLLIN, {}};
+        stopEvent.data.u64 = STOP_TOKEN;
+        if (epoll_ctl(worker.epoll, EPOLL_CTL_ADD, _listener, &listenerEvent) != 0
+            || epoll_ctl(worker.epoll, EPOLL_CTL_ADD, worker.frameTimer, &frameEvent) != 0
+            || epoll_ctl(worker.epoll, EPOLL_CTL_ADD, worker.stopEvent, &stopEvent) != 0)
+        {
+            stop();
+            return false;
+        }
+        worker.thread = std::thread(&TerminalServer::run, this, std::ref(worker));
+    }
+    return true;
+}
+
+template<SizeType height, SizeType width>
+void TerminalServer<height, width>::stop()
+{
+    for (const std::unique_ptr<Worker> &worker : _workers)
+    {
+        if (worker->thread.joinable())
+        {
+            const uint64_t increment = 1;
+            (void) write(worker->stopEvent, &increment, sizeof(increment));
+            worker->thread.join();
+        }
+    }
+
+    for (const std::unique_ptr<Worker> &worker : _workers)
+    {
+        for (SessionSlot &slot : worker->sessions)
+        {
+            if (slot.session)
+            {
+                slot.session.reset(); // disconnects the player
+                _sessionCount.fetch_sub(1, std::memory_order_relaxed);
+            }
+        }
+        for (const int fileDescriptor : {worker->epoll, worker->frameTimer, worker->stopEvent})
+        {
+            if (fileDescriptor >= 0)
+            {
+                close(fileDescriptor);
+            }
+        }
+    }
+    _workers.clear();
+
+    if (_listener >= 0)
+    {
+        close(_listener);
+        _listener = -1;
+    }
+    if (!_socketPath.empty())
+    {
+        unlink(_socketPath.c_str());
+        _socketPath.clear();
+    }
+    return;
+}
+
+template<SizeType height, SizeType width>
+std::size_t TerminalServer<height, width>::get_session_count() const
+{
+    return _sessionCount.load(std::memory_order_relaxed);
+}
+
+// private:
+
+template<SizeType height, SizeType width>
+bool TerminalServer<height, width>::listen(const std::string &address)
+{
+    const bool isPort = !address.empty() && std::all_of(address.begin(), address.end(), [](const char c) { return c >= '0' && c <= '9'; });
+    if (isPort)
+    {
+        const unsigned long port = std::strtoul(address.c_str(), nullptr, 10);
+        _listener = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        const int reuse = 1;
+        sockaddr_in socketAddress{};
+        socketAddress.sin_family = AF_INET;
+        socketAddress.sin_port = htons(static_cast<uint16_t>(port));
+        socketAddress.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        if (port > 65535 || _listener < 0
+            || setsockopt(_listener, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse)) != 0
+            || bind(_listener, reinterpret_cast<const sockaddr*>(&socketAddress), sizeof(socketAddress)) != 0)
+        {
+            return false;
+        }
+    }
+    else
+    {
+        sockaddr_un socketAddress{};
+        socketAddress.sun_family = AF_UNIX;
+        if (address.empty() || address.size() >= sizeof(socketAddress.sun_path))
+        {
+            return false;
+        }
+        std::copy(address.begin(), address.end(), socketAddress.sun_path);
+
+        _listener = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        unlink(address.c_str()); // a socket left behind by a previous run
+        if (_listener < 0 || bind(_listener, reinterpret_cast<const sockaddr*>(&socketAddress), sizeof(socketAddress)) != 0)
+        {
+            return false;
+        }
+        _socketPath = address;
+    }
+    return ::listen(_listener, SOMAXCONN) == 0;
+}
+
+template<SizeType height, SizeType width>
+void TerminalServer<height, width>::run(Worker &worker)
+{
+    using namespace terminal_server_detail;
+
+    epoll_event events[64];
+    while (true)
+    {
+        const int eventCount = epoll_wait(worker.epoll, events, 64, -1);
+        if (eventCount < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (eventCount < 0)
+        {
+            return;
+        }
+
+        const uint64_t tick = get_tick();
+        for (int e = 0; e < eventCount; ++e)
+        {
+            const uint64_t token = events[e].data.u64;
+            if (token == STOP_TOKEN)
+            {
+                return;
+            }
+            if (token == LISTENER_TOKEN)
+            {
+                accept_sessions(worker, tick);
+                continue;
+            }
+            if (token == FRAME_TOKEN)
+            {
+                uint64_t expirations = 0;
+                (void) read(worker.frameTimer, &expirations, sizeof(expirations));
+
+                // only sessions whose gravity step or end is due are woken
+                worker.wheel.advance(tick, [this, &worker, tick](const SessionTimer &timer) {
+                    SessionSlot &slot = worker.sessions[timer.slot];
+                    if (!slot.session || slot.generation != timer.generation || slot.scheduledTick != timer.tick)
+                    {
+                        return; // the session has ended or has been rescheduled
+                    }
+                    slot.session->advance(tick);
+                    update_session(worker, timer.slot, tick, true);
+                });
+                continue;
+            }
+
+            const uint32_t slot = static_cast<uint32_t>(token);
+            if (!worker.sessions[slot].session)
+            {
+                continue; // closed earlier in this batch
+            }
+            bool alive = true;
+            if ((events[e].events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) != 0)
+            {
+                alive = worker.sessions[slot].session->receive(tick);
+            }
+            update_session(worker, slot, tick, alive);
+        }
+    }
+}
+
+template<SizeType height, SizeType width>
+void TerminalServer<height, width>::accept_sessions(Worker &worker, const uint64_t tick)
+{
+    while (true)
+    {
+        const int fileDescriptor = accept4(_listener, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fileDescriptor < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (fileDescriptor < 0)
+        {
+            return; // no pending connection, or another worker has taken it
+        }
+
+        const int noDelay = 1;
+        (void) setsockopt(fileDescriptor, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay)); // fails for Unix-domain sockets
+
+        uint32_t slot = 0;
+        if (worker.freeSlots.empty())
+        {
+            slot = static_cast<uint32_t>(worker.sessions.size());
+            worker.sessions.emplace_back();
+        }
+        else
+        {
+            slot = worker.freeSlots.back();
+            worker.freeSlots.pop_back();
+        }
+
+        SessionSlot &sessionSlot = worker.sessions[slot];
+        sessionSlot.session = std::make_unique<Session>(fileDescriptor, _nextSeed.fetch_add(1, std::memory_order_relaxed), tick);
+        sessionSlot.writing = false;
+        sessionSlot.scheduledTick = 0;
+        _sessionCount.fetch_add(1, std::memory_order_relaxed);
+
+        epoll_event event{EPOLLIN | EPOLLRDHUP, {}};
+        event.data.u64 = slot;
+        update_session(worker, slot, tick, epoll_ctl(worker.epoll, EPOLL_CTL_ADD, fileDescriptor, &event) == 0);
+    }
+}
+
+template<SizeType height, SizeType width>
+void TerminalServer<height, width>::update_session(Worker &worker, const uint32_t slot, const uint64_t tick, bool alive)
+{
+    SessionSlot &sessionSlot = worker.sessions[slot];
+    alive = alive && !sessionSlot.session->is_finished(tick) && sessionSlot.session->transmit();
+    if (!alive)
+    {
+        sessionSlot.session.reset(); // closing the socket also removes it from the epoll instance
+        ++sessionSlot.generation;
+        worker.freeSlots.push_back(slot);
+        _sessionCount.fetch_sub(1, std::memory_order_relaxed);
+        return;
+    }
+
+    // writability is only of interest while output is pending
+    const bool writing = sessionSlot.session->has_pending_output();
+    if (writing != sessionSlot.writing)
+    {
+        epoll_event event{EPOLLIN | EPOLLRDHUP | (writing ? static_cast<uint32_t>(EPOLLOUT) : 0u), {}};
+        event.data.u64 = slot;
+        epoll_ctl(worker.epoll, EPOLL_CTL_MOD, sessionSlot.session->get_file_descriptor(), &event);
+        sessionSlot.writing = writing;
+    }
+
+    const uint64_t wakeTick = sessionSlot.session->get_wake_tick();
+    if (wakeTick != sessionSlot.scheduledTick)
+    {
+        sessionSlot.scheduledTick = wakeTick;
+        worker.wheel.schedule(wakeTick, {slot, sessionSlot.generation, wakeTick});
+    }
+    return;
+}
+
+template<SizeType height, SizeType width>
+uint64_t TerminalServer<height, width>::get_tick() const
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<Frames>(Clock::now() - _start).count());
+}
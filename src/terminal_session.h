@@ -0,0 +1,115 @@
+#ifndef TETRIS_TERMINAL_SESSION_H
+#define TETRIS_TERMINAL_SESSION_H
+
+#include "ansi_screen.h"
+#include "game_snapshot.h"
+#include "key_decoder.h"
+#include "tetris/gameboard.h"
+
+#include <cstdint>
+#include <string>
+
+/*
+ * Game of a player connected through a socket, e.g. by "socat -,raw,echo=0 UNIX-CONNECT:<path>".
+ *
+ * The session is driven by its owner: receive() when the connection is readable, advance() when the tick of
+ * get_wake_tick() has come and transmit() afterwards. Ticks count frames, 60 per second. Between two gravity
+ * steps nothing visible happens, so the session asks to be woken only for the next step instead of every frame.
+ * The screen is drawn into an AnsiScreen, so only the changed cells are sent. No method blocks.
+ */
+template<SizeType height, SizeType width>
+class TerminalSession
+{
+    static_assert(height >= 24, "ERROR: Game board height must be greater or equal to 24.");
+
+public:
+    static constexpr uint64_t GAME_OVER_TICKS{300}; ///< Number of frames the "GAME OVER" message is shown.
+    static constexpr int SCREEN_ROWS{height + 4}; ///< Number of rows of the drawn screen.
+    static constexpr int SCREEN_COLUMNS{2 * width + 27}; ///< Number of columns of the drawn screen.
+
+    /*
+     * Constructor. Starts a new game.
+     *
+     * @param[in] fileDescriptor connected non-blocking socket, closed by the destructor
+     * @param[in] seed seed of the game
+     * @param[in] tick current tick, the first frame is performed at the following one
+     */
+    TerminalSession(const int fileDescriptor, const uint32_t seed, const uint64_t tick);
+
+    /*
+     * Destructor. Restores the client's terminal as far as possible and closes the connection.
+     */
+    ~TerminalSession();
+
+    TerminalSession(const TerminalSession&) = delete;
+    TerminalSession& operator=(const TerminalSession&) = delete;
+
+    /*
+     * Returns the socket of the session.
+     */
+    int get_file_descriptor() const;
+
+    /*
+     * Reads all available input. The decoded actions are applied after the frames which are due by the tick.
+     *
+     * @param[in] tick current tick
+     * @return false if the connection has been closed or the player has quit
+     */
+    bool receive(const uint64_t tick);
+
+    /*
+     * Performs all frames which are due by a tick.
+     *
+     * @param[in] tick current tick
+     */
+    void advance(const uint64_t tick);
+
+    /*
+     * Returns the tick at which advance() has to be called next, i.e. the tick of the next gravity step or,
+     * once the game is over, the tick at which the session ends.
+     */
+    uint64_t get_wake_tick() const;
+
+    /*
+     * Returns true if the session has ended by the tick.
+     */
+    bool is_finished(const uint64_t tick) const;
+
+    /*
+     * Renders the game if it has changed and sends as much output as the socket accepts.
+     * Nothing is rendered while earlier output is pending, so a slow client skips frames instead of
+     * accumulating them.
+     *
+     * @return false if the connection has failed
+     */
+    bool transmit();
+
+    /*
+     * Returns true if rendered output is waiting for the socket to become writable.
+     */
+    bool has_pending_output() const;
+
+private:
+    /*
+     * Draws the game or the "GAME OVER" message into the screen, with the layout of render_game().
+     */
+    void draw();
+
+private:
+    int _fileDescriptor; ///< connected socket
+    GameBoard<height, width> _gameBoard; ///< the game
+    KeyDecoder _decoder{}; ///< decoder of the received keystrokes
+    AnsiScreen _screen{SCREEN_ROWS, SCREEN_COLUMNS}; ///< frame buffer of the client's terminal
+    GameSnapshot<height, width> _snapshot{}; ///< displayed state of the game
+    std::string _output{}; ///< rendered bytes, of which the first _outputOffset have been sent
+    std::size_t _outputOffset{0}; ///< number of sent bytes of _output
+    uint64_t _nextFrame; ///< tick of the next frame to perform
+    uint64_t _endTick{0}; ///< tick at which the session ends once the game is over
+    uint32_t _drawnFrameVersion{0}; ///< frame version of the last drawn game
+    bool _drawn{false}; ///< true once the game has been drawn
+    bool _gameOverDrawn{false}; ///< true once the "GAME OVER" message has been drawn
+};
+
+#include "terminal_session.hpp"
+
+#endif //TETRIS_TERMINAL_SESSION_H
@@ -0,0 +1,260 @@
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+// public:
+
+template<SizeType height, SizeType width>
+TerminalSession<height, width>::TerminalSession(const int fileDescriptor, const uint32_t seed, const uint64_t tick)
+: _fileDescriptor{fileDescriptor},
+  _gameBoard(seed),
+  _nextFrame{tick + 1}
+{
+    // rendering never reallocates the output afterwards
+    _output.reserve(_screen.get_maximal_render_size());
+}
+
+template<SizeType height, SizeType width>
+TerminalSession<height, width>::~TerminalSession()
+{
+    // reset the colours, clear the terminal and show the cursor again
+    static const char restore[] = "\x1b[0m\x1b[2J\x1b[H\x1b[?25h";
+    (void) send(_fileDescriptor, restore, sizeof(restore) - 1, MSG_NOSIGNAL | MSG_DONTWAIT);
+    close(_fileDescriptor);
+}
+
+template<SizeType height, SizeType width>
+int TerminalSession<height, width>::get_file_descriptor() const
+{
+    return _fileDescriptor;
+}
+
+template<SizeType height, SizeType width>
+bool TerminalSession<height, width>::receive(const uint64_t tick)
+{
+    unsigned char buffer[256];
+    while (true)
+    {
+        const ssize_t size = recv(_fileDescriptor, buffer, sizeof(buffer), MSG_DONTWAIT);
+        if (size < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (size < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+        {
+            return true;
+        }
+        if (size <= 0)
+        {
+            return false; // the client has disconnected
+        }
+
+        advance(tick);
+        for (ssize_t b = 0; b < size; ++b)
+        {
+            InputAction action;
+            if (!_decoder.decode(buffer[b], action))
+            {
+                continue;
+            }
+            if (action == INPUT_QUIT)
+            {
+                return false;
+            }
+            if (_gameBoard.is_game_over())
+            {
+                continue;
+            }
+
+            switch (action)
+            {
+                case INPUT_LEFT:
+                    _gameBoard.move_left_if_valid();
+                    break;
+                case INPUT_RIGHT:
+                    _gameBoard.move_right_if_valid();
+                    break;
+                case INPUT_DOWN:
+                    _gameBoard.move_down_if_valid();
+                    break;
+                case INPUT_ROTATE_CLOCKWISE:
+                    _gameBoard.rotate_clockwise_if_valid();
+                    break;
+                default:
+                    _gameBoard.rotate_counterclockwise_if_valid();
+                    break;
+            }
+        }
+        if (_gameBoard.is_game_over() && _endTick == 0)
+        {
+            _endTick = tick + GAME_OVER_TICKS;
+        }
+    }
+}
+
+template<SizeType height, SizeType width>
+void TerminalSession<height, width>::advance(const uint64_t tick)
+{
+    while (_nextFrame <= tick && !_gameBoard.is_game_over())
+    {
+        _gameBoard.advance_frame();
+        ++_nextFrame;
+    }
+    if (_gameBoard.is_game_over() && _endTick == 0)
+    {
+        _endTick = tick + GAME_OVER_TICKS;
+    }
+    return;
+}
+
+template<SizeType height, SizeType width>
+uint64_t TerminalSession<height, width>::get_wake_tick() const
+{
+    if (_gameBoard.is_game_over())
+    {
+        return _endTick;
+    }
+    return _nextFrame + _gameBoard.get_frames_until_drop() - 1;
+}
+
+template<SizeType height, SizeType width>
+bool TerminalSession<height, width>::is_finished(const uint64_t tick) const
+{
+    return _gameBoard.is_game_over() && tick >= _endTick;
+}
+
+template<SizeType height, SizeType width>
+bool TerminalSession<height, width>::transmit()
+{
+    const bool changed = !_drawn || _gameBoard.get_frame_version() != _drawnFrameVersion
+                         || (_gameBoard.is_game_over() && !_gameOverDrawn);
+    if (!has_pending_output() && changed)
+    {
+        draw();
+        _output.clear();
+        _outputOffset = 0;
+        _screen.render(_output);
+    }
+
+    while (has_pending_output())
+    {
+        const ssize_t size = send(_fileDescriptor, _output.data() + _outputOffset, _output.size() - _outputOffset,
+                                  MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (size < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (size < 0)
+        {
+            return errno == EAGAIN || errno == EWOULDBLOCK;
+        }
+        _outputOffset += static_cast<std::size_t>(size);
+    }
+    return true;
+}
+
+template<SizeType height, SizeType width>
+bool TerminalSession<height, width>::has_pending_output() const
+{
+    return _outputOffset < _output.size();
+}
+
+// private:
+
+template<SizeType height, SizeType width>
+void TerminalSession<height, width>::draw()
+{
+    // same layout as render_game(), with the windows at fixed offsets
+    constexpr int gameBoardWindowWidth = 2*width + 4;
+    constexpr int gameBoardWindowY = 2;
+    constexpr int gameBoardWindowX = 5;
+    constexpr int infoWindowWidth = 18;
+    constexpr int infoWindowX = gameBoardWindowX + gameBoardWindowWidth;
+
+    const auto colourOf = [](const CellState state) { return static_cast<uint8_t>(state ? state % 7 + 1 : 0); };
+    const auto cellText = [](const CellState state) { return state ? "##" : "  "; };
+    const auto fillWall = [](char *wall, const int wallWidth) {
+        std::fill(wall, wall + wallWidth, '=');
+        wall[0] = '-';
+        wall[wallWidth - 1] = '-';
+        wall[wallWidth] = '\0';
+    };
+
+    // the text is drawn from buffers on the stack, so drawing does not allocate
+    char gameBoardWall[gameBoardWindowWidth + 1];
+    fillWall(gameBoardWall, gameBoardWindowWidth);
+    char infoWall[infoWindowWidth + 1];
+    fillWall(infoWall, infoWindowWidth);
+
+    _screen.erase();
+    _drawn = true;
+    _drawnFrameVersion = _gameBoard.get_frame_version();
+
+    if (_gameBoard.is_game_over())
+    {
+        _screen.draw(3, 0, "         ==================== ");
+        _screen.draw(4, 0, "         =   GAME IS OVER   = ");
+        _screen.draw(5, 0, "         ==================== ");
+        _gameOverDrawn = true;
+        return;
+    }
+
+    take_snapshot(_gameBoard, _snapshot);
+
+    // first, draw the game board window
+    int row = gameBoardWindowY;
+    _screen.draw(row++, gameBoardWindowX, gameBoardWall); // draw upper wall
+    for (SizeType i = 0; i < height; ++i, ++row)
+    {
+        _screen.draw(row, gameBoardWindowX, "<!");
+        for (SizeType j = 0; j < width; ++j)
+        {
+            const CellState state = _snapshot.frame[i * width + j];
+            _screen.draw(row, gameBoardWindowX + 2 + 2 * j, cellText(state), colourOf(state));
+        }
+        _screen.draw(row, gameBoardWindowX + gameBoardWindowWidth - 2, "!>");
+    }
+    _screen.draw(row, gameBoardWindowX, gameBoardWall); // draw lower wall
+
+    // then, draw the info window
+    char number[32];
+    row = gameBoardWindowY;
+    _screen.draw(row++, infoWindowX, infoWall); // draw upper wall
+    _screen.draw(row++, infoWindowX, "<!              !>");
+    _screen.draw(row++, infoWindowX, "<!              !>");
+    _screen.draw(row++, infoWindowX, "<!     NEXT:    !>");
+    _screen.draw(row++, infoWindowX, "<!              !>");
+    _screen.draw(row++, infoWindowX, "<!              !>");
+    for (SizeType i = 0; i < 4; ++i, ++row)
+    {
+        _screen.draw(row, infoWindowX, "<!    ");
+        for (SizeType j = 0; j < 3; ++j)
+        {
+            const CellState state = _snapshot.nextShape[i * 3 + j];
+            _screen.draw(row, infoWindowX + 6 + 2 * j, cellText(state), colourOf(state));
+        }
+        _screen.draw(row, infoWindowX + 12, "    !>");
+    }
+    _screen.draw(row++, infoWindowX, infoWall); // draw lower wall
+    _screen.draw(row++, infoWindowX, "<!              !>");
+    _screen.draw(row++, infoWindowX, "<! LEVEL:       !>");
+    std::snprintf(number, sizeof(number), "<! %12d !>", _snapshot.level);
+    _screen.draw(row++, infoWindowX, number);
+    _screen.draw(row++, infoWindowX, "<!              !>");
+    _screen.draw(row++, infoWindowX, "<! LINE CLEARS: !>");
+    std::snprintf(number, sizeof(number), "<! %12d !>", _snapshot.lineClears);
+    _screen.draw(row++, infoWindowX, number);
+    _screen.draw(row++, infoWindowX, "<!              !>");
+    _screen.draw(row++, infoWindowX, infoWall); // draw lower wall
+    _screen.draw(row++, infoWindowX, "<! MOVE:        !>");
+    _screen.draw(row++, infoWindowX, "<!   ARROW KEYS !>");
+    _screen.draw(row++, infoWindowX, "<! ROTATE:      !>");
+    _screen.draw(row++, infoWindowX, "<!   R  AND  U  !>");
+    _screen.draw(row++, infoWindowX, "<! QUIT:        !>");
+    _screen.draw(row++, infoWindowX, "<!   Q          !>");
+    _screen.draw(row, infoWindowX, infoWall); // draw lower wall
+    return;
+}
@@ -0,0 +1,62 @@
+#ifndef ARENA_H_
+#define ARENA_H_
+
+#include <cstddef>
+#include <memory>
+
+/*
+ * Bump allocator for objects which are all discarded at once.
+ * Memory is only requested in reserve(); allocate() hands out consecutive slices of it and reset() makes the
+ * whole memory available again. Hence, once the arena is large enough, allocating neither calls new nor delete.
+ * T must be default constructible. Objects are not destroyed on reset(), they are overwritten on reuse.
+ */
+template<typename T>
+class Arena
+{
+public:
+    /*
+     * Constructor.
+     *
+     * @param[in] capacity number of objects the arena can hold
+     */
+    explicit Arena(const std::size_t capacity = 0);
+
+    /*
+     * Default destructor.
+     */
+    ~Arena() = default;
+
+    /*
+     * Makes sure that the arena can hold at least capacity objects. Must only be called after reset(),
+     * because growing invalidates previously allocated objects.
+     */
+    void reserve(const std::size_t capacity);
+
+    /*
+     * Returns a contiguous block of count objects, or nullptr if the arena is exhausted.
+     */
+    T* allocate(const std::size_t count);
+
+    /*
+     * Makes the whole memory available again. Previously allocated objects must not be used anymore.
+     */
+    void reset();
+
+    /*
+     * Returns the number of objects the arena can hold.
+     */
+    std::size_t get_capacity() const;
+
+    /*
+     * Returns the number of currently allocated objects.
+     */
+    std::size_t get_size() const;
+
+private:
+    std::unique_ptr<T[]> _storage{}; ///< memory of the arena
+    std::size_t _capacity{0}; ///< number of objects the storage can hold
+    std::size_t _size{0}; ///< number of currently allocated objects
+};
+
+#include "arena.hpp"
+#endif /* ARENA_H_ */
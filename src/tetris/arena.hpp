@@ -0,0 +1,51 @@
+// public:
+
+template<typename T>
+Arena<T>::Arena(const std::size_t capacity)
+{
+    reserve(capacity);
+}
+
+template<typename T>
+void Arena<T>::reserve(const std::size_t capacity)
+{
+    if (capacity > _capacity)
+    {
+        _storage = std::make_unique<T[]>(capacity);
+        _capacity = capacity;
+        _size = 0;
+    }
+    return;
+}
+
+template<typename T>
+T* Arena<T>::allocate(const std::size_t count)
+{
+    if (_size + count > _capacity)
+    {
+        return nullptr;
+    }
+
+    T *block = _storage.get() + _size;
+    _size += count;
+    return block;
+}
+
+template<typename T>
+void Arena<T>::reset()
+{
+    _size = 0;
+    return;
+}
+
+template<typename T>
+std::size_t Arena<T>::get_capacity() const
+{
+    return _capacity;
+}
+
+template<typename T>
+std::size_t Arena<T>::get_size() const
+{
+    return _size;
+}
@@ -0,0 +1,113 @@
+#ifndef BEAM_SEARCH_H_
+#define BEAM_SEARCH_H_
+
+#include "arena.h"
+#include "evaluation.h"
+#include "placement.h"
+#include "thread_pool.h"
+
+constexpr uint8_t MAX_BEAM_DEPTH{3}; ///< Current shape, next shape and one unknown shape.
+
+/*
+ * Settings of the beam search. They can be changed between moves with BeamSearch::set_settings().
+ */
+struct BeamSettings
+{
+    std::size_t beamWidth{16}; ///< Number of boards kept per depth.
+    uint8_t depth{2}; ///< Number of placed shapes per line, between 1 and MAX_BEAM_DEPTH.
+    EvaluationWeights weights{}; ///< Weights of the board evaluation.
+};
+
+/*
+ * Beam search over placements of the current and the next shape.
+ *
+ * Depth 1 places the current shape, depth 2 additionally places the next shape on the best beamWidth boards
+ * of depth 1. Depth 3 rates each of the best beamWidth boards of depth 2 by the average over all shape types
+ * of the best placement of that shape type, since the shape following the next one is unknown.
+ * The first placement of the best line is returned.
+ *
+ * The boards of each depth are expanded in parallel on a thread pool. All nodes are taken from an arena which
+ * is reset at the beginning of every search, so after set_settings() searching does not allocate memory.
+ */
+template<SizeType height, SizeType width>
+class BeamSearch
+{
+public:
+    /*
+     * Constructor.
+     *
+     * @param[in] threadPool thread pool used for expanding boards, must outlive the search
+     * @param[in] settings search settings
+     */
+    explicit BeamSearch(ThreadPool &threadPool, const BeamSettings &settings = BeamSettings{});
+
+    /*
+     * Default destructor.
+     */
+    ~BeamSearch() = default;
+
+    /*
+     * Returns the search settings.
+     */
+    const BeamSettings& get_settings() const;
+
+    /*
+     * Changes the search settings and resizes the arena accordingly.
+     * The depth is clamped to 1 <= depth <= MAX_BEAM_DEPTH and the beam width to at least 1.
+     */
+    void set_settings(const BeamSettings &settings);
+
+    /*
+     * Searches the best placement of the current shape.
+     * If the current shape cannot be placed at all (i.e. the game is over), a placement at the spawn position
+     * is returned.
+     *
+     * @param[in] boardState occupancy of the landed blocks
+     * @param[in] currentShape type of the currently falling shape
+     * @param[in] nextShape type of the shape falling after the current one
+     * @return best placement of the current shape
+     */
+    Placement find_best_placement(const BoardState<height, width> &boardState, const ShapeType currentShape,
+                                  const ShapeType nextShape);
+
+private:
+    /*
+     * Node of the beam. Represents the board state after a line of placements.
+     */
+    struct Node
+    {
+        BoardState<height, width> boardState{}; ///< occupancy after the placements
+        float score{0}; ///< evaluation of the board state
+        uint16_t completedLines{0}; ///< number of rows cleared along the line
+        uint16_t rootIndex{0}; ///< index of the line's first placement in _rootPlacements
+        uint16_t childCount{0}; ///< number of children created by the last expansion
+    };
+
+    /*
+     * Creates a child of node for each placement of shapeType. The children are written to children,
+     * which must provide room for PlacementList<width>::capacity nodes.
+     */
+    void expand(Node &node, const ShapeType shapeType, Node *children) const;
+
+    /*
+     * Returns the average over all shape types of the best score reachable by placing that shape type on node.
+     */
+    float evaluate_expected(const Node &node) const;
+
+    /*
+     * Collects the children of all beam nodes as candidates and keeps the best beamWidth of them in the beam.
+     */
+    void select_beam(Node * const children);
+
+private:
+    ThreadPool &_threadPool; ///< thread pool for expanding boards in parallel
+    BeamSettings _settings; ///< search settings
+
+    Arena<Node> _arena{}; ///< storage of all nodes of a search
+    std::vector<Node*> _beam{}; ///< best nodes of the current depth
+    std::vector<Node*> _candidates{}; ///< all children of the current depth
+    PlacementList<width> _rootPlacements{}; ///< placements of the current shape
+};
+
+#include "beam_search.hpp"
+#endif /* BEAM_SEARCH_H_ */
@@ -0,0 +1,173 @@
+// public:
+
+template<SizeType height, SizeType width>
+BeamSearch<height, width>::BeamSearch(ThreadPool &threadPool, const BeamSettings &settings)
+: _threadPool{threadPool}
+{
+    set_settings(settings);
+}
+
+template<SizeType height, SizeType width>
+const BeamSettings& BeamSearch<height, width>::get_settings() const
+{
+    return _settings;
+}
+
+template<SizeType height, SizeType width>
+void BeamSearch<height, width>::set_settings(const BeamSettings &settings)
+{
+    _settings = settings;
+    _settings.beamWidth = std::max<std::size_t>(_settings.beamWidth, 1);
+    _settings.depth = std::min(std::max<uint8_t>(_settings.depth, 1), MAX_BEAM_DEPTH);
+
+    // the root, its children and the children of the beam after depth 1
+    constexpr std::size_t childCapacity = PlacementList<width>::capacity;
+    const std::size_t nodeCount = 1 + childCapacity + (_settings.depth >= 2 ? _settings.beamWidth * childCapacity : 0);
+    _arena.reset();
+    _arena.reserve(nodeCount);
+
+    _beam.reserve(_settings.beamWidth);
+    _candidates.reserve(_settings.beamWidth * childCapacity);
+    return;
+}
+
+template<SizeType height, SizeType width>
+Placement BeamSearch<height, width>::find_best_placement(const BoardState<height, width> &boardState,
+                                                         const ShapeType currentShape, const ShapeType nextShape)
+{
+    constexpr std::size_t childCapacity = PlacementList<width>::capacity;
+
+    _arena.reset();
+    Node * const root = _arena.allocate(1);
+    *root = Node{};
+    root->boardState = boardState;
+
+    // depth 1: place the current shape. Every child remembers which placement it stems from
+    _rootPlacements = generate_placements(boardState, currentShape);
+    if (_rootPlacements.empty())
+    {
+        return {currentShape, ROT_0, 0, get_spawn_column<width>()};
+    }
+
+    Node * const rootChildren = _arena.allocate(childCapacity);
+    expand(*root, currentShape, rootChildren);
+    for (uint16_t c = 0; c < root->childCount; ++c)
+    {
+        rootChildren[c].rootIndex = c;
+    }
+    _beam.assign(1, root);
+    select_beam(rootChildren);
+    const Node *best = _beam.front();
+
+    // depth 2: place the next shape on every board of the beam
+    if (_settings.depth >= 2)
+    {
+        Node * const children = _arena.allocate(_beam.size() * childCapacity);
+        _threadPool.parallel_for(_beam.size(), [this, children, nextShape](const std::size_t index) {
+            expand(*_beam[index], nextShape, children + index * childCapacity);
+        });
+        select_beam(children);
+        if (!_beam.empty())
+        {
+            best = _beam.front();
+        }
+    }
+
+    // depth 3: rate the boards of the beam by their expected value for the unknown shape afterwards
+    if (_settings.depth >= 3 && !_beam.empty())
+    {
+        _threadPool.parallel_for(_beam.size(), [this](const std::size_t index) {
+            _beam[index]->score = evaluate_expected(*_beam[index]);
+        });
+        best = *std::max_element(_beam.begin(), _beam.end(), [](const Node *lhs, const Node *rhs) {
+            return lhs->score < rhs->score;
+        });
+    }
+
+    return _rootPlacements[best->rootIndex];
+}
+
+// private:
+
+template<SizeType height, SizeType width>
+void BeamSearch<height, width>::expand(Node &node, const ShapeType shapeType, Node *children) const
+{
+    constexpr std::size_t childCapacity = PlacementList<width>::capacity;
+
+    const PlacementList<width> placements = generate_placements(node.boardState, shapeType);
+    std::array<BoardState<height, width>, childCapacity> boardStates;
+    for (std::size_t c = 0; c < placements.size(); ++c)
+    {
+        const Placement &placement = placements[c];
+        Node &child = children[c];
+        child.boardState = node.boardState;
+        const uint8_t clearedRows = child.boardState.place(get_piece_mask(placement.shapeType, placement.rotation),
+                                                           placement.row, placement.column);
+        child.completedLines = node.completedLines + clearedRows;
+        child.rootIndex = node.rootIndex;
+        child.childCount = 0;
+        boardStates[c] = child.boardState;
+    }
+
+    // all children are rated in one batch
+    std::array<BoardFeatures<width>, childCapacity> features;
+    extract_board_features(boardStates.data(), placements.size(), features.data());
+    for (std::size_t c = 0; c < placements.size(); ++c)
+    {
+        children[c].score = evaluate_features(features[c], children[c].completedLines, _settings.weights);
+    }
+    node.childCount = static_cast<uint16_t>(placements.size());
+    return;
+}
+
+template<SizeType height, SizeType width>
+float BeamSearch<height, width>::evaluate_expected(const Node &node) const
+{
+    constexpr std::size_t childCapacity = PlacementList<width>::capacity;
+
+    float sum = 0;
+    for (uint8_t s = 0; s < _SHAPE_COUNT; ++s)
+    {
+        const PlacementList<width> placements = generate_placements(node.boardState, static_cast<ShapeType>(s));
+        std::array<BoardState<height, width>, childCapacity> boardStates;
+        std::array<uint8_t, childCapacity> clearedRows;
+        for (std::size_t c = 0; c < placements.size(); ++c)
+        {
+            const Placement &placement = placements[c];
+            boardStates[c] = node.boardState;
+            clearedRows[c] = boardStates[c].place(get_piece_mask(placement.shapeType, placement.rotation),
+                                                  placement.row, placement.column);
+        }
+
+        std::array<BoardFeatures<width>, childCapacity> features;
+        extract_board_features(boardStates.data(), placements.size(), features.data());
+        float best = GAME_OVER_SCORE;
+        for (std::size_t c = 0; c < placements.size(); ++c)
+        {
+            best = std::max(best, evaluate_features(features[c], node.completedLines + clearedRows[c], _settings.weights));
+        }
+        sum += best;
+    }
+    return sum / _SHAPE_COUNT;
+}
+
+template<SizeType height, SizeType width>
+void BeamSearch<height, width>::select_beam(Node * const children)
+{
+    constexpr std::size_t childCapacity = PlacementList<width>::capacity;
+
+    _candidates.clear();
+    for (std::size_t b = 0; b < _beam.size(); ++b)
+    {
+        for (uint16_t c = 0; c < _beam[b]->childCount; ++c)
+        {
+            _candidates.push_back(children + b * childCapacity + c);
+        }
+    }
+
+    const std::size_t beamSize = std::min(_settings.beamWidth, _candidates.size());
+    std::partial_sort(_candidates.begin(), _candidates.begin() + beamSize, _candidates.end(),
+                      [](const Node *lhs, const Node *rhs) { return lhs->score > rhs->score; });
+    _beam.assign(_candidates.begin(), _candidates.begin() + beamSize);
+    return;
+}
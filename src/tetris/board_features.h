@@ -0,0 +1,63 @@
+#ifndef BOARD_FEATURES_H_
+#define BOARD_FEATURES_H_
+
+#include "board_state.h"
+#include "gameboard.h"
+
+constexpr std::size_t BOARD_FEATURE_LANES{16}; ///< Number of boards processed side by side by the batch kernel.
+
+/*
+ * Standard evaluation features of the landed blocks of a board.
+ * A hole is an empty cell with an occupied cell somewhere above it in the same column.
+ */
+template<SizeType width>
+struct BoardFeatures
+{
+    std::array<SizeType, width> columnHeights{}; ///< Height of each column, see BoardState::get_column_height().
+    SizeType maxHeight{0}; ///< Maximal column height.
+    uint16_t aggregateHeight{0}; ///< Sum of all column heights.
+    uint16_t holes{0}; ///< Number of holes.
+    uint16_t coveredCells{0}; ///< Number of occupied cells with a hole somewhere below them.
+    uint16_t rowTransitions{0}; ///< Changes between occupied and empty along the rows of the stack, walls count as occupied.
+    uint16_t columnTransitions{0}; ///< Changes between occupied and empty along the columns, the floor counts as occupied.
+    uint16_t wellDepths{0}; ///< Sum of the depths of all wells, i.e. open cells whose left and right neighbours are occupied.
+    uint16_t bumpiness{0}; ///< Sum of height differences of neighbouring columns.
+};
+
+/*
+ * Computes all features of a board state in a single pass over its packed rows, from the top to the bottom.
+ * Per-column quantities like the column heights are kept as bit-sliced counters (bit j of slice k is bit k
+ * of the counter of column j), so every row is handled with a few logical operations on whole rows
+ * instead of a loop over its cells.
+ *
+ * @param[in] boardState occupancy of the landed blocks
+ * @return features of the board state
+ */
+template<SizeType height, SizeType width>
+constexpr BoardFeatures<width> extract_board_features(const BoardState<height, width> &boardState);
+
+/*
+ * Computes the features of the landed blocks of a game board.
+ *
+ * @param[in] gameBoard the game board
+ * @return features of the landed blocks
+ */
+template<SizeType height, SizeType width>
+constexpr BoardFeatures<width> extract_board_features(const GameBoard<height, width> &gameBoard);
+
+/*
+ * Computes the features of a batch of board states.
+ * The boards are transposed into groups of BOARD_FEATURE_LANES, and every operation of the kernel is applied
+ * to all boards of a group in a plain loop over the lanes, which the compiler turns into SIMD instructions
+ * where the target supports them.
+ *
+ * @param[in] boardStates array of count board states
+ * @param[in] count number of board states
+ * @param[out] features array of count features, in the order of the board states
+ */
+template<SizeType height, SizeType width>
+void extract_board_features(const BoardState<height, width> *boardStates, const std::size_t count,
+                            BoardFeatures<width> *features);
+
+#include "board_features.hpp"
+#endif /* BOARD_FEATURES_H_ */
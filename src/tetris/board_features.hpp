@@ -0,0 +1,207 @@
+namespace board_features_detail
+{
+    /*
+     * Returns the number of bits necessary to store values from 0 to height.
+     */
+    constexpr uint8_t get_slice_count(const SizeType height)
+    {
+        uint8_t sliceCount = 1;
+        while ((1 << sliceCount) <= height)
+        {
+            ++sliceCount;
+        }
+        return sliceCount;
+    }
+
+    /*
+     * Counts the set bits of a row. Without a popcount instruction, only shifts, masks and additions are used,
+     * so the loops over the lanes of the kernel can still be vectorised.
+     */
+    template<typename RowType>
+    constexpr uint16_t count_bits(const RowType row)
+    {
+#ifdef __POPCNT__
+        return static_cast<uint16_t>(__builtin_popcount(row));
+#else
+        uint32_t bits = row;
+        bits = bits - ((bits >> 1) & 0x55555555u);
+        bits = (bits & 0x33333333u) + ((bits >> 2) & 0x33333333u);
+        bits = (bits + (bits >> 4)) & 0x0F0F0F0Fu;
+        bits = bits + (bits >> 8);
+        bits = bits + (bits >> 16);
+        return static_cast<uint16_t>(bits & 0x3Fu);
+#endif
+    }
+
+    /*
+     * Packed rows of several boards, rows[i][l] is row i of the board in lane l.
+     */
+    template<SizeType height, SizeType width, std::size_t lanes>
+    using LaneRows = std::array<std::array<typename BoardState<height, width>::RowType, lanes>, height>;
+
+    /*
+     * Computes the features of the boards in all lanes. Every step is a separate loop over the lanes.
+     */
+    template<SizeType height, SizeType width, std::size_t lanes>
+    constexpr void extract_lanes(const LaneRows<height, width, lanes> &rows, std::array<BoardFeatures<width>, lanes> &features)
+    {
+        using RowType = typename BoardState<height, width>::RowType;
+        constexpr RowType fullRow = BoardState<height, width>::FULL_ROW;
+        constexpr RowType leftWall = 1;
+        constexpr RowType rightWall = static_cast<RowType>(RowType{1} << (width - 1));
+        constexpr uint8_t sliceCount = get_slice_count(height);
+
+        std::array<RowType, lanes> covering{}; // columns with an occupied cell in the current row or above
+        std::array<RowType, lanes> previous{}; // row above the current row
+        std::array<RowType, lanes> holeColumns{}; // columns with a hole in the current row or above
+        std::array<uint16_t, lanes> holes{};
+        std::array<uint16_t, lanes> rowTransitions{};
+        std::array<uint16_t, lanes> columnTransitions{};
+        std::array<uint16_t, lanes> wellDepths{};
+
+        // bit-sliced values per column: the column height, written in the row of the uppermost occupied cell,
+        // and the number of rows below the lowest hole, overwritten in every row containing a hole
+        std::array<std::array<RowType, lanes>, sliceCount> heightSlices{};
+        std::array<std::array<RowType, lanes>, sliceCount> belowHoleSlices{};
+        std::array<RowType, lanes> topMasks{};
+        std::array<RowType, lanes> holeMasks{};
+
+        for (SizeType i = 0; i < height; ++i)
+        {
+            const std::array<RowType, lanes> &row = rows[i];
+
+            for (std::size_t l = 0; l < lanes; ++l)
+            {
+                const RowType empty = static_cast<RowType>(~row[l] & fullRow);
+                const RowType leftOccupied = static_cast<RowType>((row[l] << 1) | leftWall);
+                const RowType rightOccupied = static_cast<RowType>((row[l] >> 1) | rightWall);
+                topMasks[l] = static_cast<RowType>(row[l] & ~covering[l]);
+                holeMasks[l] = static_cast<RowType>(empty & covering[l]);
+                holeColumns[l] |= holeMasks[l];
+                holes[l] += count_bits(holeMasks[l]);
+                wellDepths[l] += count_bits(static_cast<RowType>(empty & ~covering[l] & leftOccupied & rightOccupied));
+                columnTransitions[l] += count_bits(static_cast<RowType>(row[l] ^ previous[l]));
+                previous[l] = row[l];
+                covering[l] |= row[l];
+
+                // rows above the stack are not counted
+                const RowType inner = static_cast<RowType>((row[l] ^ (row[l] >> 1)) & (fullRow >> 1));
+                const uint16_t transitions = count_bits(inner) + (empty & leftWall) + ((empty >> (width - 1)) & 1);
+                rowTransitions[l] += transitions * (covering[l] != 0);
+            }
+
+            // the written values only depend on the row, so each slice needs a single operation per lane
+            for (uint8_t k = 0; k < sliceCount; ++k)
+            {
+                if (((height - i) >> k) & 1)
+                {
+                    for (std::size_t l = 0; l < lanes; ++l)
+                    {
+                        heightSlices[k][l] |= topMasks[l];
+                    }
+                }
+
+                if (((height - 1 - i) >> k) & 1)
+                {
+                    for (std::size_t l = 0; l < lanes; ++l)
+                    {
+                        belowHoleSlices[k][l] |= holeMasks[l];
+                    }
+                }
+                else
+                {
+                    for (std::size_t l = 0; l < lanes; ++l)
+                    {
+                        belowHoleSlices[k][l] &= static_cast<RowType>(~holeMasks[l]);
+                    }
+                }
+            }
+        }
+
+        for (std::size_t l = 0; l < lanes; ++l)
+        {
+            BoardFeatures<width> &result = features[l];
+            result.holes = holes[l];
+            result.rowTransitions = rowTransitions[l];
+            result.columnTransitions = columnTransitions[l] + count_bits(static_cast<RowType>(~previous[l] & fullRow));
+            result.wellDepths = wellDepths[l];
+
+            // a column with holes covers all occupied cells above its lowest hole, i.e. its height minus
+            // its holes minus the rows below the lowest hole
+            uint16_t holeColumnHeights = 0;
+            uint16_t rowsBelowHoles = 0;
+            result.aggregateHeight = 0;
+            for (uint8_t k = 0; k < sliceCount; ++k)
+            {
+                result.aggregateHeight += count_bits(heightSlices[k][l]) << k;
+                holeColumnHeights += count_bits(static_cast<RowType>(heightSlices[k][l] & holeColumns[l])) << k;
+                rowsBelowHoles += count_bits(belowHoleSlices[k][l]) << k;
+            }
+            result.coveredCells = holeColumnHeights - rowsBelowHoles - holes[l];
+
+            result.maxHeight = 0;
+            result.bumpiness = 0;
+            for (SizeType j = 0; j < width; ++j)
+            {
+                SizeType columnHeight = 0;
+                for (uint8_t k = 0; k < sliceCount; ++k)
+                {
+                    columnHeight |= ((heightSlices[k][l] >> j) & 1) << k;
+                }
+                result.columnHeights[j] = columnHeight;
+                result.maxHeight = std::max(result.maxHeight, columnHeight);
+                if (j > 0)
+                {
+                    const int difference = columnHeight - result.columnHeights[j - 1];
+                    result.bumpiness += (difference < 0) ? -difference : difference;
+                }
+            }
+        }
+        return;
+    }
+}
+
+template<SizeType height, SizeType width>
+constexpr BoardFeatures<width> extract_board_features(const BoardState<height, width> &boardState)
+{
+    board_features_detail::LaneRows<height, width, 1> rows{};
+    for (SizeType i = 0; i < height; ++i)
+    {
+        rows[i][0] = boardState.get_row(i);
+    }
+
+    std::array<BoardFeatures<width>, 1> features{};
+    board_features_detail::extract_lanes<height, width, 1>(rows, features);
+    return features[0];
+}
+
+template<SizeType height, SizeType width>
+constexpr BoardFeatures<width> extract_board_features(const GameBoard<height, width> &gameBoard)
+{
+    return extract_board_features(gameBoard.get_board_state());
+}
+
+template<SizeType height, SizeType width>
+void extract_board_features(const BoardState<height, width> *boardStates, const std::size_t count,
+                            BoardFeatures<width> *features)
+{
+    for (std::size_t first = 0; first < count; first += BOARD_FEATURE_LANES)
+    {
+        const std::size_t laneCount = std::min(BOARD_FEATURE_LANES, count - first);
+
+        // transpose the group, unused lanes stay empty
+        board_features_detail::LaneRows<height, width, BOARD_FEATURE_LANES> rows{};
+        for (SizeType i = 0; i < height; ++i)
+        {
+            for (std::size_t l = 0; l < laneCount; ++l)
+            {
+                rows[i][l] = boardStates[first + l].get_row(i);
+            }
+        }
+
+        std::array<BoardFeatures<width>, BOARD_FEATURE_LANES> groupFeatures{};
+        board_features_detail::extract_lanes<height, width, BOARD_FEATURE_LANES>(rows, groupFeatures);
+        std::copy(groupFeatures.begin(), groupFeatures.begin() + laneCount, features + first);
+    }
+    return;
+}
@@ -0,0 +1,114 @@
+#ifndef BOARD_STATE_H_
+#define BOARD_STATE_H_
+
+#include "piece_mask.h"
+
+#include <algorithm>
+#include <type_traits>
+
+/*
+ * Compact copy of the landed blocks of a game board.
+ * Every row is packed into a single integer (bit j corresponds to column j), so copying a board state
+ * is cheap. Colours are not stored, only occupancy. Board states are intended for searching placements,
+ * where many hypothetical boards have to be created and thrown away.
+ * The coordinates are used like matrix indices, i.e. row 0 is the uppermost row.
+ * All operations are constexpr and can be used in constant expressions.
+ */
+template<SizeType height, SizeType width>
+class BoardState
+{
+    static_assert(0 < width && width <= 32, "ERROR: Board states support game board widths from 1 to 32.");
+
+public:
+    using RowType = std::conditional_t<(width <= 16), uint16_t, uint32_t>; ///< Packed occupancy of a row.
+
+    static constexpr RowType FULL_ROW = static_cast<RowType>((uint64_t{1} << width) - 1); ///< Occupancy of a full row.
+
+    /*
+     * Constructor. Creates an empty board state.
+     */
+    constexpr BoardState() = default;
+
+    /*
+     * Default destructor.
+     */
+    ~BoardState() = default;
+
+    /*
+     * Returns whether the cell with coordinates (i,j) is occupied.
+     * i and j must be such that 0 <= i < height
+     *                           0 <= j < width
+     */
+    constexpr bool is_occupied(const SizeType i, const SizeType j) const;
+
+    /*
+     * Marks the cell with coordinates (i,j) as occupied or free.
+     * i and j must be such that 0 <= i < height
+     *                           0 <= j < width
+     */
+    constexpr void set_occupied(const SizeType i, const SizeType j, const bool occupied = true);
+
+    /*
+     * Returns the packed occupancy of row i.
+     */
+    constexpr RowType get_row(const SizeType i) const;
+
+    /*
+     * Replaces the packed occupancy of row i. Bits of columns outside the board must not be set.
+     */
+    constexpr void set_row(const SizeType i, const RowType row);
+
+    /*
+     * Returns the height of column j, i.e. the number of rows from the uppermost occupied cell
+     * of the column down to the floor. An empty column has height 0.
+     */
+    constexpr SizeType get_column_height(const SizeType j) const;
+
+    /*
+     * Determines whether a piece with upper left corner (row, column) lies inside the board and does not
+     * overlap any occupied cell.
+     *
+     * @param[in] piece packed occupancy of the rotated shape, a built-in one or one of a PieceSet
+     * @param[in] row row coordinate of the upper left corner
+     * @param[in] column column coordinate of the upper left corner
+     * @return true if the piece fits
+     */
+    template<SizeType extent>
+    constexpr bool fits(const BasicPieceMask<extent> &piece, const SizeType row, const SizeType column) const;
+
+    /*
+     * Returns the row in which a piece comes to rest when dropped straight down from (row, column).
+     * The piece must fit at (row, column) and have contiguous columns, see has_contiguous_columns().
+     *
+     * @param[in] piece packed occupancy of the rotated shape
+     * @param[in] row row coordinate of the upper left corner before dropping
+     * @param[in] column column coordinate of the upper left corner
+     * @return row coordinate of the upper left corner after dropping
+     */
+    template<SizeType extent>
+    constexpr SizeType get_drop_row(const BasicPieceMask<extent> &piece, const SizeType row, const SizeType column) const;
+
+    /*
+     * Adds the cells of a piece to the board and clears all full rows.
+     * The piece must fit at (row, column).
+     *
+     * @param[in] piece packed occupancy of the rotated shape
+     * @param[in] row row coordinate of the upper left corner
+     * @param[in] column column coordinate of the upper left corner
+     * @return number of cleared rows
+     */
+    template<SizeType extent>
+    constexpr uint8_t place(const BasicPieceMask<extent> &piece, const SizeType row, const SizeType column);
+
+    /*
+     * Comparison operators. Two board states are equal if they have the same occupancy.
+     */
+    constexpr bool operator==(const BoardState &other) const;
+    constexpr bool operator!=(const BoardState &other) const;
+
+private:
+    std::array<RowType, height> _rows{ 0 }; ///< packed occupancy of each row
+};
+
+#include "board_state.hpp"
+#endif /* BOARD_STATE_H_ */
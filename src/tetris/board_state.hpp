@@ -0,0 +1,129 @@
+// public:
+
+template<SizeType height, SizeType width>
+constexpr bool BoardState<height, width>::is_occupied(const SizeType i, const SizeType j) const
+{
+    return (_rows[i] >> j) & 1u;
+}
+
+template<SizeType height, SizeType width>
+constexpr void BoardState<height, width>::set_occupied(const SizeType i, const SizeType j, const bool occupied)
+{
+    const RowType bit = static_cast<RowType>(RowType{1} << j);
+    _rows[i] = occupied ? (_rows[i] | bit) : (_rows[i] & ~bit);
+    return;
+}
+
+template<SizeType height, SizeType width>
+constexpr typename BoardState<height, width>::RowType BoardState<height, width>::get_row(const SizeType i) const
+{
+    return _rows[i];
+}
+
+template<SizeType height, SizeType width>
+constexpr void BoardState<height, width>::set_row(const SizeType i, const RowType row)
+{
+    _rows[i] = row;
+    return;
+}
+
+template<SizeType height, SizeType width>
+constexpr SizeType BoardState<height, width>::get_column_height(const SizeType j) const
+{
+    for (SizeType i = 0; i < height; ++i)
+    {
+        if (is_occupied(i, j))
+        {
+            return height - i;
+        }
+    }
+    return 0;
+}
+
+template<SizeType height, SizeType width>
+template<SizeType extent>
+constexpr bool BoardState<height, width>::fits(const BasicPieceMask<extent> &piece, const SizeType row, const SizeType column) const
+{
+    if (row < 0 || column < 0 || row + piece.height > height || column + piece.width > width)
+    {
+        return false;
+    }
+
+    for (SizeType i = 0; i < piece.height; ++i)
+    {
+        if (_rows[row + i] & (static_cast<RowType>(piece.rows[i]) << column))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+template<SizeType height, SizeType width>
+template<SizeType extent>
+constexpr SizeType BoardState<height, width>::get_drop_row(const BasicPieceMask<extent> &piece, const SizeType row, const SizeType column) const
+{
+    // the piece stops as soon as the cell below the lowest cell of one of its columns is occupied
+    SizeType dropDistance = height;
+    for (SizeType j = 0; j < piece.width; ++j)
+    {
+        const SizeType lowestRow = row + piece.bottom[j];
+        SizeType i = lowestRow + 1;
+        while (i < height && !is_occupied(i, column + j))
+        {
+            ++i;
+        }
+        dropDistance = std::min<SizeType>(dropDistance, i - lowestRow - 1);
+    }
+    return row + dropDistance;
+}
+
+template<SizeType height, SizeType width>
+template<SizeType extent>
+constexpr uint8_t BoardState<height, width>::place(const BasicPieceMask<extent> &piece, const SizeType row, const SizeType column)
+{
+    for (SizeType i = 0; i < piece.height; ++i)
+    {
+        _rows[row + i] |= static_cast<RowType>(piece.rows[i]) << column;
+    }
+
+    // only the rows covered by the piece can have become full. Compact the board from the bottom up,
+    // skipping full rows, and fill the uppermost rows with empty ones
+    uint8_t clearedRows = 0;
+    for (SizeType i = row + piece.height - 1; i >= 0; --i)
+    {
+        if (_rows[i] == FULL_ROW)
+        {
+            ++clearedRows;
+        }
+        else if (clearedRows > 0)
+        {
+            _rows[i + clearedRows] = _rows[i];
+        }
+    }
+    for (SizeType i = 0; i < clearedRows; ++i)
+    {
+        _rows[i] = 0;
+    }
+
+    return clearedRows;
+}
+
+template<SizeType height, SizeType width>
+constexpr bool BoardState<height, width>::operator==(const BoardState &other) const
+{
+    for (SizeType i = 0; i < height; ++i)
+    {
+        if (_rows[i] != other._rows[i])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+template<SizeType height, SizeType width>
+constexpr bool BoardState<height, width>::operator!=(const BoardState &other) const
+{
+    return !(*this == other);
+}
@@ -0,0 +1,60 @@
+#include "bot_protocol.h"
+
+#include <cstring>
+
+namespace
+{
+    constexpr char SHAPE_LETTERS[_SHAPE_COUNT + 1] = "OLJISTZ"; ///< letter of every shape type
+}
+
+// free functions
+
+char get_shape_letter(const ShapeType shapeType)
+{
+    return SHAPE_LETTERS[shapeType];
+}
+
+bool parse_shape_letter(const char letter, ShapeType &shapeType)
+{
+    const char * const found = std::strchr(SHAPE_LETTERS, letter);
+    if (letter == '\0' || found == nullptr)
+    {
+        return false;
+    }
+    shapeType = static_cast<ShapeType>(found - SHAPE_LETTERS);
+    return true;
+}
+
+bool parse_bot_reply(const std::string &line, BotReply &reply)
+{
+    unsigned game = 0;
+    unsigned rotation = 0;
+    int column = 0;
+    char keys[256] = {};
+    if (std::sscanf(line.c_str(), "place %u %u %d", &game, &rotation, &column) == 3)
+    {
+        if (rotation > ROT_270 || column < 0 || column > 127)
+        {
+            return false;
+        }
+        reply.kind = BotReply::REPLY_PLACE;
+        reply.rotation = static_cast<Rotation>(rotation);
+        reply.column = static_cast<SizeType>(column);
+    }
+    else if (std::sscanf(line.c_str(), "input %u %255s", &game, keys) == 2)
+    {
+        reply.kind = BotReply::REPLY_INPUT;
+        reply.keys = (std::strcmp(keys, "-") == 0) ? "" : keys;
+        if (reply.keys.find_first_not_of("lrdca") != std::string::npos)
+        {
+            return false;
+        }
+    }
+    else
+    {
+        return false;
+    }
+
+    reply.game = game;
+    return true;
+}
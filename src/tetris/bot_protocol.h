@@ -0,0 +1,108 @@
+#ifndef BOT_PROTOCOL_H_
+#define BOT_PROTOCOL_H_
+
+#include "board_state.h"
+#include "types.h"
+
+#include <string>
+
+/*
+ * Line-based protocol between the engine and external bot processes, which read from their standard input and
+ * write to their standard output. Every message is one line terminated by '\n'.
+ *
+ *   engine: "tetris <version> <height> <width>"
+ *   bot:    "ready <name>"
+ *
+ * Afterwards the engine repeatedly sends a batch of moves, one for each game the bot is playing:
+ *
+ *   engine: "batch <count>", followed by <count> lines "move <game> <current> <next> <rows>"
+ *   bot:    one reply per move, in any order
+ *
+ * <game> identifies the game within the session, <current> and <next> are the letters of the current and the
+ * next shape (O, L, J, I, S, T or Z) and <rows> is the occupancy of the landed blocks from the top row down,
+ * every row as hexadecimal bit mask in which bit j is column j, separated by '/'. A reply is either
+ *
+ *   "place <game> <rotation> <column>"  the resting position of the current shape when dropped straight down,
+ *                                       with the number of clockwise quarter turns and the leftmost column
+ *   "input <game> <keys>"               keystrokes from the spawn position, l (left), r (right), d (down),
+ *                                       c (rotate clockwise) and a (rotate counterclockwise), followed by a
+ *                                       hard drop. "-" stands for no keystrokes.
+ *
+ * Bots should write all replies of a batch at once. Before a batch, the engine may send "end <game>" for every
+ * game which is over, and "quit" when the session is over.
+ */
+constexpr uint8_t BOT_PROTOCOL_VERSION{1}; ///< Version sent in the greeting.
+
+/*
+ * Reply of a bot to a move request.
+ */
+struct BotReply
+{
+    /*
+     * Kinds of replies.
+     */
+    enum Kind : uint8_t
+    {
+        REPLY_PLACE, ///< the bot has chosen a placement
+        REPLY_INPUT ///< the bot has sent keystrokes
+    };
+
+    Kind kind{REPLY_PLACE}; ///< kind of the reply
+    uint32_t game{0}; ///< game the reply belongs to
+    Rotation rotation{ROT_0}; ///< rotation of the placement
+    SizeType column{0}; ///< column of the placement
+    std::string keys{}; ///< keystrokes, without "-"
+};
+
+/*
+ * Returns the letter of a shape type in the protocol.
+ */
+char get_shape_letter(const ShapeType shapeType);
+
+/*
+ * Converts a letter of the protocol into a shape type.
+ *
+ * @param[in] letter shape letter
+ * @param[out] shapeType the shape type
+ * @return false if the letter does not denote a shape
+ */
+bool parse_shape_letter(const char letter, ShapeType &shapeType);
+
+/*
+ * Appends a move request to a message.
+ *
+ * @param[in,out] message message to append to
+ * @param[in] game game identifier
+ * @param[in] boardState occupancy of the landed blocks
+ * @param[in] currentShape type of the currently falling shape
+ * @param[in] nextShape type of the next shape
+ */
+template<SizeType height, SizeType width>
+void append_move_request(std::string &message, const uint32_t game, const BoardState<height, width> &boardState,
+                         const ShapeType currentShape, const ShapeType nextShape);
+
+/*
+ * Parses a move request line, without the line break.
+ *
+ * @param[in] line the line
+ * @param[out] game game identifier
+ * @param[out] boardState occupancy of the landed blocks
+ * @param[out] currentShape type of the currently falling shape
+ * @param[out] nextShape type of the next shape
+ * @return false if the line is not a valid move request for a board of this size
+ */
+template<SizeType height, SizeType width>
+bool parse_move_request(const std::string &line, uint32_t &game, BoardState<height, width> &boardState,
+                        ShapeType &currentShape, ShapeType &nextShape);
+
+/*
+ * Parses a reply line, without the line break.
+ *
+ * @param[in] line the line
+ * @param[out] reply the reply
+ * @return false if the line is not a valid reply
+ */
+bool parse_bot_reply(const std::string &line, BotReply &reply);
+
+#include "bot_protocol.hpp"
+#endif /* BOT_PROTOCOL_H_ */
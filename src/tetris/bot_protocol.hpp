@@ -0,0 +1,54 @@
+#include <cstdio>
+#include <cstdlib>
+
+// free functions
+
+template<SizeType height, SizeType width>
+void append_move_request(std::string &message, const uint32_t game, const BoardState<height, width> &boardState,
+                         const ShapeType currentShape, const ShapeType nextShape)
+{
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "move %u %c %c ", static_cast<unsigned>(game),
+                  get_shape_letter(currentShape), get_shape_letter(nextShape));
+    message += buffer;
+
+    for (SizeType i = 0; i < height; ++i)
+    {
+        std::snprintf(buffer, sizeof(buffer), (i + 1 < height) ? "%x/" : "%x\n",
+                      static_cast<unsigned>(boardState.get_row(i)));
+        message += buffer;
+    }
+    return;
+}
+
+template<SizeType height, SizeType width>
+bool parse_move_request(const std::string &line, uint32_t &game, BoardState<height, width> &boardState,
+                        ShapeType &currentShape, ShapeType &nextShape)
+{
+    unsigned parsedGame = 0;
+    char current = 0;
+    char next = 0;
+    int consumed = 0;
+    if (std::sscanf(line.c_str(), "move %u %c %c %n", &parsedGame, &current, &next, &consumed) != 3 || consumed == 0
+        || !parse_shape_letter(current, currentShape) || !parse_shape_letter(next, nextShape))
+    {
+        return false;
+    }
+
+    const char *position = line.c_str() + consumed;
+    for (SizeType i = 0; i < height; ++i)
+    {
+        char *end = nullptr;
+        const unsigned long row = std::strtoul(position, &end, 16);
+        const char expected = (i + 1 < height) ? '/' : '\0';
+        if (end == position || *end != expected || row > BoardState<height, width>::FULL_ROW)
+        {
+            return false;
+        }
+        boardState.set_row(i, static_cast<typename BoardState<height, width>::RowType>(row));
+        position = end + 1;
+    }
+
+    game = parsedGame;
+    return true;
+}
@@ -0,0 +1,171 @@
+#include "dataset.h"
+
+namespace dataset_detail
+{
+    // public:
+
+    BitWriter::BitWriter(std::vector<uint8_t> &output)
+        : _output(output)
+    {}
+
+    void BitWriter::write(const uint32_t value, const uint32_t bits)
+    {
+        const uint64_t mask = (uint64_t{1} << bits) - 1;
+        _pending |= (value & mask) << _pendingBits;
+        _pendingBits += bits;
+        while (_pendingBits >= 8)
+        {
+            _output.push_back(static_cast<uint8_t>(_pending));
+            _pending >>= 8;
+            _pendingBits -= 8;
+        }
+        return;
+    }
+
+    void BitWriter::flush()
+    {
+        if (_pendingBits > 0)
+        {
+            _output.push_back(static_cast<uint8_t>(_pending));
+            _pending = 0;
+            _pendingBits = 0;
+        }
+        return;
+    }
+
+    BitReader::BitReader(const uint8_t *data, const std::size_t size)
+        : _data(data), _size(size)
+    {}
+
+    uint32_t BitReader::read(const uint32_t bits)
+    {
+        while (_pendingBits < bits)
+        {
+            if (_position == _size)
+            {
+                _valid = false;
+                return 0;
+            }
+            _pending |= uint64_t{_data[_position++]} << _pendingBits;
+            _pendingBits += 8;
+        }
+        const uint64_t mask = (uint64_t{1} << bits) - 1;
+        const uint32_t value = static_cast<uint32_t>(_pending & mask);
+        _pending >>= bits;
+        _pendingBits -= bits;
+        return value;
+    }
+
+    bool BitReader::is_valid() const
+    {
+        return _valid;
+    }
+}
+
+// public:
+
+DatasetWriter::~DatasetWriter()
+{
+    close();
+}
+
+bool DatasetWriter::open(const std::string &path, const SizeType height, const SizeType width)
+{
+    using namespace dataset_detail;
+
+    close();
+    std::FILE * const file = std::fopen(path.c_str(), "wb");
+    if (file == nullptr)
+    {
+        return false;
+    }
+    FileHeader header{};
+    std::memcpy(header.magic, DATASET_MAGIC, sizeof(DATASET_MAGIC));
+    header.version = DATASET_VERSION;
+    header.height = static_cast<uint32_t>(height);
+    header.width = static_cast<uint32_t>(width);
+    if (std::fwrite(&header, sizeof(header), 1, file) != 1)
+    {
+        std::fclose(file);
+        return false;
+    }
+
+    _file = file;
+    _writtenBytes = sizeof(header);
+    _closing = false;
+    _failed = false;
+    _thread = std::thread(&DatasetWriter::write_loop, this);
+    return true;
+}
+
+void DatasetWriter::submit(std::vector<uint8_t> &chunk)
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    _changed.wait(lock, [this]() { return _queue.size() < QUEUE_CAPACITY; });
+    _queue.push_back(std::move(chunk));
+    chunk.clear();
+    if (!_spareBuffers.empty())
+    {
+        chunk.swap(_spareBuffers.back());
+        _spareBuffers.pop_back();
+    }
+    lock.unlock();
+    _changed.notify_all();
+    return;
+}
+
+bool DatasetWriter::close()
+{
+    if (_file == nullptr)
+    {
+        return true;
+    }
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _closing = true;
+    }
+    _changed.notify_all();
+    _thread.join();
+
+    const bool closed = std::fclose(_file) == 0;
+    _file = nullptr;
+    return closed && !_failed;
+}
+
+uint64_t DatasetWriter::get_written_bytes() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _writtenBytes;
+}
+
+// private:
+
+void DatasetWriter::write_loop()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (true)
+    {
+        _changed.wait(lock, [this]() { return !_queue.empty() || _closing; });
+        if (_queue.empty())
+        {
+            break;
+        }
+        std::vector<uint8_t> chunk = std::move(_queue.front());
+        _queue.pop_front();
+
+        // the producers keep going while the chunk is written
+        lock.unlock();
+        _changed.notify_all();
+        const bool written = std::fwrite(chunk.data(), 1, chunk.size(), _file) == chunk.size();
+        lock.lock();
+
+        _failed |= !written;
+        _writtenBytes += written ? chunk.size() : 0;
+        chunk.clear();
+        if (_spareBuffers.size() < QUEUE_CAPACITY)
+        {
+            _spareBuffers.push_back(std::move(chunk));
+        }
+    }
+    return;
+}
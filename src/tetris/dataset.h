@@ -0,0 +1,330 @@
+#ifndef DATASET_H_
+#define DATASET_H_
+
+#include "gameboard.h"
+
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*
+ * Dataset of recorded decisions, e.g. for training an evaluation on self-play games.
+ *
+ * A dataset file consists of a FileHeader followed by independent chunks. Every chunk holds whole games and
+ * stores its records column by column, each column bit-packed and starting at a byte boundary:
+ * - games: seed, number of records and outcome of every game, the records follow in the order of the games
+ * - pieces: current and next shape of every record as one dictionary code out of _SHAPE_COUNT^2
+ * - placements: rotation, column and row of every chosen placement
+ * - boards: every board as difference to the previous board of its game, the first one to the empty board:
+ *   a mask of the changed rows followed by the changed rows, combined by exclusive or. A placement changes
+ *   only a few rows, so a board takes about a quarter of its packed size.
+ * All multi-bit values are stored least significant bit first.
+ */
+namespace dataset_detail
+{
+    constexpr char DATASET_MAGIC[8] = {'T', 'E', 'T', 'R', 'I', 'S', 'D', 'S'}; ///< identifies dataset files
+    constexpr uint32_t DATASET_VERSION{1}; ///< version of the file format
+    constexpr uint32_t CHUNK_MAGIC{0x4b4e4843}; ///< "CHNK", starts every chunk
+    constexpr std::size_t COLUMN_COUNT{4}; ///< games, pieces, placements and boards
+
+    /*
+     * Header of a dataset file.
+     */
+    struct FileHeader
+    {
+        char magic[8]; ///< DATASET_MAGIC
+        uint32_t version; ///< DATASET_VERSION
+        uint32_t height; ///< board height of the games
+        uint32_t width; ///< board width of the games
+        uint32_t reserved; ///< 0
+    };
+
+    /*
+     * Header of a chunk. It is followed by the columns.
+     */
+    struct ChunkHeader
+    {
+        uint32_t magic; ///< CHUNK_MAGIC
+        uint32_t gameCount; ///< number of games
+        uint32_t recordCount; ///< number of records
+        uint32_t columnSizes[COLUMN_COUNT]; ///< size of each column in bytes
+    };
+
+    /*
+     * Returns the number of bits needed to store the values 0 to count - 1.
+     */
+    constexpr uint32_t get_bit_width(const uint32_t count);
+
+    /*
+     * Appends values of any bit width to a byte buffer.
+     */
+    class BitWriter
+    {
+    public:
+        /*
+         * Constructor.
+         *
+         * @param[in,out] output buffer to append to
+         */
+        explicit BitWriter(std::vector<uint8_t> &output);
+
+        /*
+         * Appends the lowest bits of a value.
+         *
+         * @param[in] value the value
+         * @param[in] bits number of bits, at most 32
+         */
+        void write(const uint32_t value, const uint32_t bits);
+
+        /*
+         * Pads the last byte with zeros, so the next value starts at a byte boundary.
+         */
+        void flush();
+
+    private:
+        std::vector<uint8_t> &_output; ///< buffer to append to
+        uint64_t _pending{0}; ///< bits not yet appended, the oldest in the lowest bits
+        uint32_t _pendingBits{0}; ///< number of bits in _pending
+    };
+
+    /*
+     * Reads values written by a BitWriter.
+     */
+    class BitReader
+    {
+    public:
+        /*
+         * Constructor.
+         *
+         * @param[in] data the bytes to read
+         * @param[in] size number of bytes
+         */
+        BitReader(const uint8_t *data, const std::size_t size);
+
+        /*
+         * Reads a value.
+         *
+         * @param[in] bits number of bits, at most 32
+         * @return the value, or 0 if reading goes beyond the end, see is_valid()
+         */
+        uint32_t read(const uint32_t bits);
+
+        /*
+         * Returns false if reading has gone beyond the end of the data.
+         */
+        bool is_valid() const;
+
+    private:
+        const uint8_t *_data; ///< the bytes
+        std::size_t _size; ///< number of bytes
+        std::size_t _position{0}; ///< number of bytes moved into _pending
+        uint64_t _pending{0}; ///< bits not yet read, the next in the lowest bits
+        uint32_t _pendingBits{0}; ///< number of bits in _pending
+        bool _valid{true}; ///< false once reading has gone beyond the end
+    };
+}
+
+/*
+ * Seed and outcome of a recorded game.
+ */
+struct DatasetGame
+{
+    uint32_t seed{0}; ///< seed of the game
+    uint32_t recordCount{0}; ///< number of recorded decisions
+    uint32_t lineClears{0}; ///< number of cleared rows at the end
+    uint32_t lockCount{0}; ///< number of settled shapes at the end
+    bool gameOver{false}; ///< true if the game ended by topping out, false if it was stopped
+};
+
+/*
+ * Recorded decision.
+ */
+template<SizeType height, SizeType width>
+struct DatasetRecord
+{
+    BoardState<height, width> boardState{}; ///< landed blocks before the decision
+    ShapeType currentShape{SHAPE_O}; ///< type of the shape to place
+    ShapeType nextShape{SHAPE_O}; ///< type of the shape following it
+    Placement placement{}; ///< chosen placement
+    uint32_t game{0}; ///< index of the record's game in its chunk
+};
+
+/*
+ * Records of whole games, collected until they are encoded as chunk. Meant to be filled by one thread.
+ * The storage is kept by clear(), so a chunk which is reused does not allocate memory once it has reached its
+ * largest size.
+ */
+template<SizeType height, SizeType width>
+class DatasetChunk
+{
+public:
+    /*
+     * Constructor. Creates an empty chunk.
+     */
+    DatasetChunk() = default;
+
+    /*
+     * Default destructor.
+     */
+    ~DatasetChunk() = default;
+
+    /*
+     * Starts recording a game.
+     *
+     * @param[in] seed seed of the game
+     */
+    void begin_game(const uint32_t seed);
+
+    /*
+     * Records a decision of the current game.
+     */
+    void add_record(const BoardState<height, width> &boardState, const ShapeType currentShape,
+                    const ShapeType nextShape, const Placement &placement);
+
+    /*
+     * Ends the current game with its outcome.
+     *
+     * @param[in] gameBoard the game board at the end of the game
+     */
+    void end_game(const GameBoard<height, width> &gameBoard);
+
+    /*
+     * Returns the number of records.
+     */
+    std::size_t get_record_count() const;
+
+    /*
+     * Appends the chunk in the file format. All games must have ended.
+     *
+     * @param[in,out] output buffer to append to
+     */
+    void encode(std::vector<uint8_t> &output) const;
+
+    /*
+     * Removes all games and records.
+     */
+    void clear();
+
+private:
+    std::vector<DatasetGame> _games{}; ///< recorded games
+    std::vector<DatasetRecord<height, width>> _records{}; ///< records of all games, in the order of the games
+};
+
+/*
+ * Appends chunks to a dataset file on a background thread, so the threads producing them never wait for the
+ * disk unless it falls behind by more than QUEUE_CAPACITY chunks.
+ */
+class DatasetWriter
+{
+public:
+    static constexpr std::size_t QUEUE_CAPACITY{16}; ///< Maximal number of chunks waiting for the disk.
+
+    /*
+     * Constructor. Creates a closed writer.
+     */
+    DatasetWriter() = default;
+
+    /*
+     * Destructor. Closes the file, see close().
+     */
+    ~DatasetWriter();
+
+    DatasetWriter(const DatasetWriter&) = delete;
+    DatasetWriter& operator=(const DatasetWriter&) = delete;
+
+    /*
+     * Creates a dataset file and starts the background thread.
+     *
+     * @param[in] path path of the file, which is replaced if it exists
+     * @param[in] height board height of the games
+     * @param[in] width board width of the games
+     * @return false if the file cannot be created
+     */
+    bool open(const std::string &path, const SizeType height, const SizeType width);
+
+    /*
+     * Hands an encoded chunk to the background thread. Blocks while QUEUE_CAPACITY chunks are waiting.
+     * Thread-safe. The buffer is swapped with an empty one whose capacity is reused, if there is one.
+     *
+     * @param[in,out] chunk the encoded chunk, empty afterwards
+     */
+    void submit(std::vector<uint8_t> &chunk);
+
+    /*
+     * Writes all waiting chunks, joins the thread and closes the file.
+     *
+     * @return false if writing any chunk has failed
+     */
+    bool close();
+
+    /*
+     * Returns the number of bytes written so far.
+     */
+    uint64_t get_written_bytes() const;
+
+private:
+    /*
+     * Writes chunks until the writer is closed.
+     */
+    void write_loop();
+
+private:
+    std::FILE *_file{nullptr}; ///< the dataset file
+    std::thread _thread{}; ///< the writing thread
+    mutable std::mutex _mutex{}; ///< guards all members below
+    std::condition_variable _changed{}; ///< notified when a chunk is queued or written, or the writer is closed
+    std::deque<std::vector<uint8_t>> _queue{}; ///< chunks waiting for the disk
+    std::vector<std::vector<uint8_t>> _spareBuffers{}; ///< written chunks, whose capacity is handed back
+    uint64_t _writtenBytes{0}; ///< number of bytes written
+    bool _closing{false}; ///< set to make the thread exit after writing all chunks
+    bool _failed{false}; ///< true if a write has failed
+};
+
+/*
+ * Reads a dataset file chunk by chunk.
+ */
+template<SizeType height, SizeType width>
+class DatasetReader
+{
+public:
+    /*
+     * Constructor. Creates a closed reader.
+     */
+    DatasetReader() = default;
+
+    /*
+     * Destructor. Closes the file.
+     */
+    ~DatasetReader();
+
+    DatasetReader(const DatasetReader&) = delete;
+    DatasetReader& operator=(const DatasetReader&) = delete;
+
+    /*
+     * Opens a dataset file.
+     *
+     * @param[in] path path of the file
+     * @return false if the file cannot be opened or is not a dataset of boards of this size
+     */
+    bool open(const std::string &path);
+
+    /*
+     * Reads the next chunk.
+     *
+     * @param[out] games games of the chunk
+     * @param[out] records records of the chunk
+     * @return false at the end of the file or if the chunk is damaged or truncated
+     */
+    bool read_chunk(std::vector<DatasetGame> &games, std::vector<DatasetRecord<height, width>> &records);
+
+private:
+    std::FILE *_file{nullptr}; ///< the dataset file
+    std::vector<uint8_t> _buffer{}; ///< columns of the current chunk
+};
+
+#include "dataset.hpp"
+#endif /* DATASET_H_ */
@@ -0,0 +1,277 @@
+#include <cstring>
+
+namespace dataset_detail
+{
+    constexpr SizeType PLACEMENT_BIAS{4}; ///< added to the coordinates of placements, which may lie left of or above the board
+    constexpr uint32_t ROTATION_BITS{2}; ///< bits of the rotation of a placement
+
+    constexpr uint32_t get_bit_width(const uint32_t count)
+    {
+        uint32_t bits = 0;
+        while (bits < 32 && (uint64_t{1} << bits) < count)
+        {
+            ++bits;
+        }
+        return bits;
+    }
+
+    /*
+     * Returns the number of bits of the dictionary code of the current and the next shape.
+     */
+    constexpr uint32_t get_piece_bits()
+    {
+        return get_bit_width(_SHAPE_COUNT * _SHAPE_COUNT);
+    }
+}
+
+// public:
+
+template<SizeType height, SizeType width>
+void DatasetChunk<height, width>::begin_game(const uint32_t seed)
+{
+    DatasetGame game;
+    game.seed = seed;
+    _games.push_back(game);
+    return;
+}
+
+template<SizeType height, SizeType width>
+void DatasetChunk<height, width>::add_record(const BoardState<height, width> &boardState, const ShapeType currentShape,
+                                            const ShapeType nextShape, const Placement &placement)
+{
+    DatasetRecord<height, width> record;
+    record.boardState = boardState;
+    record.currentShape = currentShape;
+    record.nextShape = nextShape;
+    record.placement = placement;
+    record.game = static_cast<uint32_t>(_games.size() - 1);
+    _records.push_back(record);
+    ++_games.back().recordCount;
+    return;
+}
+
+template<SizeType height, SizeType width>
+void DatasetChunk<height, width>::end_game(const GameBoard<height, width> &gameBoard)
+{
+    DatasetGame &game = _games.back();
+    game.lineClears = gameBoard.get_line_clears();
+    game.lockCount = gameBoard.get_lock_count();
+    game.gameOver = gameBoard.is_game_over();
+    return;
+}
+
+template<SizeType height, SizeType width>
+std::size_t DatasetChunk<height, width>::get_record_count() const
+{
+    return _records.size();
+}
+
+template<SizeType height, SizeType width>
+void DatasetChunk<height, width>::encode(std::vector<uint8_t> &output) const
+{
+    using namespace dataset_detail;
+    using RowType = typename BoardState<height, width>::RowType;
+    constexpr uint32_t columnBits = get_bit_width(width + PLACEMENT_BIAS);
+    constexpr uint32_t rowBits = get_bit_width(height + PLACEMENT_BIAS);
+
+    ChunkHeader header{};
+    header.magic = CHUNK_MAGIC;
+    header.gameCount = static_cast<uint32_t>(_games.size());
+    header.recordCount = static_cast<uint32_t>(_records.size());
+    const std::size_t headerOffset = output.size();
+    output.resize(headerOffset + sizeof(header));
+
+    // every column is written behind the previous one, its size is the growth of the output
+    std::size_t columnStart = output.size();
+    const auto finishColumn = [&output, &header, &columnStart](BitWriter &writer, const std::size_t column) {
+        writer.flush();
+        header.columnSizes[column] = static_cast<uint32_t>(output.size() - columnStart);
+        columnStart = output.size();
+    };
+
+    BitWriter gameWriter(output);
+    for (const DatasetGame &game : _games)
+    {
+        gameWriter.write(game.seed, 32);
+        gameWriter.write(game.recordCount, 32);
+        gameWriter.write(game.lineClears, 32);
+        gameWriter.write(game.lockCount, 32);
+        gameWriter.write(game.gameOver, 1);
+    }
+    finishColumn(gameWriter, 0);
+
+    BitWriter pieceWriter(output);
+    for (const DatasetRecord<height, width> &record : _records)
+    {
+        pieceWriter.write(record.currentShape * _SHAPE_COUNT + record.nextShape, get_piece_bits());
+    }
+    finishColumn(pieceWriter, 1);
+
+    BitWriter placementWriter(output);
+    for (const DatasetRecord<height, width> &record : _records)
+    {
+        placementWriter.write(record.placement.rotation, ROTATION_BITS);
+        placementWriter.write(static_cast<uint32_t>(record.placement.column + PLACEMENT_BIAS), columnBits);
+        placementWriter.write(static_cast<uint32_t>(record.placement.row + PLACEMENT_BIAS), rowBits);
+    }
+    finishColumn(placementWriter, 2);
+
+    BitWriter boardWriter(output);
+    BoardState<height, width> previous;
+    uint32_t previousGame = UINT32_MAX;
+    for (const DatasetRecord<height, width> &record : _records)
+    {
+        if (record.game != previousGame)
+        {
+            previous = BoardState<height, width>();
+            previousGame = record.game;
+        }
+        uint32_t changedRows = 0;
+        for (SizeType i = 0; i < height; ++i)
+        {
+            changedRows |= static_cast<uint32_t>(record.boardState.get_row(i) != previous.get_row(i)) << i;
+        }
+        boardWriter.write(changedRows, height);
+        for (uint32_t rows = changedRows; rows != 0; rows &= rows - 1)
+        {
+            const SizeType i = static_cast<SizeType>(__builtin_ctz(rows));
+            boardWriter.write(static_cast<RowType>(record.boardState.get_row(i) ^ previous.get_row(i)), width);
+        }
+        previous = record.boardState;
+    }
+    finishColumn(boardWriter, 3);
+
+    std::memcpy(output.data() + headerOffset, &header, sizeof(header));
+    return;
+}
+
+template<SizeType height, SizeType width>
+void DatasetChunk<height, width>::clear()
+{
+    _games.clear();
+    _records.clear();
+    return;
+}
+
+template<SizeType height, SizeType width>
+DatasetReader<height, width>::~DatasetReader()
+{
+    if (_file != nullptr)
+    {
+        std::fclose(_file);
+    }
+}
+
+template<SizeType height, SizeType width>
+bool DatasetReader<height, width>::open(const std::string &path)
+{
+    using namespace dataset_detail;
+
+    std::FILE * const file = std::fopen(path.c_str(), "rb");
+    if (file == nullptr)
+    {
+        return false;
+    }
+    FileHeader header{};
+    if (std::fread(&header, sizeof(header), 1, file) != 1 || std::memcmp(header.magic, DATASET_MAGIC, sizeof(DATASET_MAGIC)) != 0
+        || header.version != DATASET_VERSION || header.height != static_cast<uint32_t>(height)
+        || header.width != static_cast<uint32_t>(width))
+    {
+        std::fclose(file);
+        return false;
+    }
+
+    if (_file != nullptr)
+    {
+        std::fclose(_file);
+    }
+    _file = file;
+    return true;
+}
+
+template<SizeType height, SizeType width>
+bool DatasetReader<height, width>::read_chunk(std::vector<DatasetGame> &games,
+                                              std::vector<DatasetRecord<height, width>> &records)
+{
+    using namespace dataset_detail;
+    using RowType = typename BoardState<height, width>::RowType;
+    constexpr uint32_t columnBits = get_bit_width(width + PLACEMENT_BIAS);
+    constexpr uint32_t rowBits = get_bit_width(height + PLACEMENT_BIAS);
+
+    games.clear();
+    records.clear();
+    ChunkHeader header{};
+    if (_file == nullptr || std::fread(&header, sizeof(header), 1, _file) != 1 || header.magic != CHUNK_MAGIC)
+    {
+        return false;
+    }
+    std::size_t size = 0;
+    for (const uint32_t columnSize : header.columnSizes)
+    {
+        size += columnSize;
+    }
+    _buffer.resize(size);
+    if (std::fread(_buffer.data(), 1, size, _file) != size)
+    {
+        return false;
+    }
+
+    const uint8_t *column = _buffer.data();
+    BitReader gameReader(column, header.columnSizes[0]);
+    column += header.columnSizes[0];
+    BitReader pieceReader(column, header.columnSizes[1]);
+    column += header.columnSizes[1];
+    BitReader placementReader(column, header.columnSizes[2]);
+    column += header.columnSizes[2];
+    BitReader boardReader(column, header.columnSizes[3]);
+
+    uint64_t recordCount = 0;
+    games.resize(header.gameCount);
+    for (DatasetGame &game : games)
+    {
+        game.seed = gameReader.read(32);
+        game.recordCount = gameReader.read(32);
+        game.lineClears = gameReader.read(32);
+        game.lockCount = gameReader.read(32);
+        game.gameOver = gameReader.read(1) != 0;
+        recordCount += game.recordCount;
+    }
+    if (!gameReader.is_valid() || recordCount != header.recordCount)
+    {
+        return false;
+    }
+
+    records.resize(header.recordCount);
+    std::size_t r = 0;
+    for (uint32_t g = 0; g < header.gameCount; ++g)
+    {
+        BoardState<height, width> previous;
+        for (uint32_t n = 0; n < games[g].recordCount; ++n, ++r)
+        {
+            DatasetRecord<height, width> &record = records[r];
+            record.game = g;
+
+            const uint32_t pieces = pieceReader.read(get_piece_bits());
+            if (pieces >= _SHAPE_COUNT * _SHAPE_COUNT)
+            {
+                return false;
+            }
+            record.currentShape = static_cast<ShapeType>(pieces / _SHAPE_COUNT);
+            record.nextShape = static_cast<ShapeType>(pieces % _SHAPE_COUNT);
+
+            record.placement.shapeType = record.currentShape;
+            record.placement.rotation = static_cast<Rotation>(placementReader.read(ROTATION_BITS));
+            record.placement.column = static_cast<SizeType>(static_cast<int>(placementReader.read(columnBits)) - PLACEMENT_BIAS);
+            record.placement.row = static_cast<SizeType>(static_cast<int>(placementReader.read(rowBits)) - PLACEMENT_BIAS);
+
+            const uint32_t changedRows = boardReader.read(height);
+            for (uint32_t rows = changedRows; rows != 0; rows &= rows - 1)
+            {
+                const SizeType i = static_cast<SizeType>(__builtin_ctz(rows));
+                previous.set_row(i, static_cast<RowType>(previous.get_row(i) ^ boardReader.read(width)));
+            }
+            record.boardState = previous;
+        }
+    }
+    return pieceReader.is_valid() && placementReader.is_valid() && boardReader.is_valid();
+}
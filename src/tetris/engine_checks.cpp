@@ -0,0 +1,610 @@
+/*
+ * Compile-time checks of the game engine.
+ * Every check is a static_assert on a constant expression, so this file does not produce any code;
+ * it fails to compile as soon as an invariant of the engine is broken.
+ */
+
+#include "board_features.h"
+#include "finesse.h"
+#include "gameboard.h"
+#include "gravity.h"
+#include "lane_engine.h"
+#include "placement.h"
+
+namespace
+{
+    /*
+     * Checks that every rotated shape consists of four cells with contiguous columns and that it fits into
+     * the maximal piece extent.
+     */
+    constexpr bool check_piece_masks()
+    {
+        for (uint8_t s = 0; s < _SHAPE_COUNT; ++s)
+        {
+            for (uint8_t r = 0; r < ROTATION_COUNT; ++r)
+            {
+                const PieceMask &piece = get_piece_mask(static_cast<ShapeType>(s), static_cast<Rotation>(r));
+                if (get_cell_count(piece) != 4 || !has_contiguous_columns(piece)
+                    || piece.height > MAX_PIECE_EXTENT || piece.width > MAX_PIECE_EXTENT)
+                {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    /*
+     * Checks that four rotations in either direction restore the original falling shape.
+     */
+    constexpr bool check_rotation_cycle()
+    {
+        for (uint8_t s = 0; s < _SHAPE_COUNT; ++s)
+        {
+            Falling falling(0, 0, static_cast<ShapeType>(s));
+            const Falling original = falling;
+            for (uint8_t r = 0; r < ROTATION_COUNT; ++r)
+            {
+                falling.rotate_clockwise();
+            }
+            if (falling.get_rotation() != original.get_rotation() || falling.get_height() != original.get_height())
+            {
+                return false;
+            }
+
+            falling.rotate_counterclockwise();
+            falling.rotate_clockwise();
+            if (falling.get_rotation() != ROT_0)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /*
+     * Returns the number of placements of a shape on an empty 24x10 board.
+     */
+    constexpr std::size_t count_empty_board_placements(const ShapeType shapeType)
+    {
+        return generate_placements(BoardState<24, 10>{}, shapeType).size();
+    }
+
+    /*
+     * Fills the lowest row of a board with horizontal I shapes and an O shape, which must clear exactly one row.
+     */
+    constexpr bool check_line_clear()
+    {
+        BoardState<24, 10> boardState{};
+        const PieceMask &horizontalI = get_piece_mask(SHAPE_I, ROT_90);
+        const PieceMask &shapeO = get_piece_mask(SHAPE_O, ROT_0);
+
+        uint8_t clearedRows = 0;
+        clearedRows += boardState.place(horizontalI, boardState.get_drop_row(horizontalI, 0, 0), 0);
+        clearedRows += boardState.place(horizontalI, boardState.get_drop_row(horizontalI, 0, 4), 4);
+        clearedRows += boardState.place(shapeO, boardState.get_drop_row(shapeO, 0, 8), 8);
+
+        // the upper half of the O shape remains
+        return clearedRows == 1 && boardState.get_column_height(8) == 1 && boardState.get_column_height(9) == 1
+               && boardState.get_column_height(0) == 0;
+    }
+
+    /*
+     * Builds a 6x4 board with a covered hole in column 0 and a well in column 3 and checks its features.
+     *
+     *     . . . .
+     *     . . . .
+     *     X . . .
+     *     X X X .
+     *     . X X .
+     *     X X X X
+     */
+    constexpr bool check_board_features()
+    {
+        BoardState<6, 4> boardState{};
+        boardState.set_occupied(2, 0);
+        for (SizeType j = 0; j < 3; ++j)
+        {
+            boardState.set_occupied(3, j);
+        }
+        boardState.set_occupied(4, 1);
+        boardState.set_occupied(4, 2);
+        for (SizeType j = 0; j < 4; ++j)
+        {
+            boardState.set_occupied(5, j);
+        }
+
+        const BoardFeatures<4> features = extract_board_features(boardState);
+        return features.columnHeights[0] == 4 && features.columnHeights[1] == 3 && features.columnHeights[2] == 3
+               && features.columnHeights[3] == 1 && features.maxHeight == 4
+               && features.aggregateHeight == 11 && features.holes == 1 && features.coveredCells == 2
+               && features.rowTransitions == 8 && features.columnTransitions == 6 && features.wellDepths == 2
+               && features.bumpiness == 3;
+    }
+
+    /*
+     * Plays a seeded game by always choosing the lowest reachable placement and compares every board with
+     * the prediction of BoardState. Returns the number of played shapes, or -1 if a prediction was wrong.
+     */
+    constexpr int simulate_game(const uint32_t seed, const int shapeCount)
+    {
+        GameBoard<24, 10> gameBoard(seed);
+        int playedShapes = 0;
+        while (playedShapes < shapeCount && !gameBoard.is_game_over())
+        {
+            BoardState<24, 10> predicted = gameBoard.get_board_state();
+            const PlacementList<10> placements = generate_placements(predicted, gameBoard.get_current_falling().get_shape_type());
+            Placement placement = placements[0];
+            for (const Placement &candidate : placements)
+            {
+                placement = (candidate.row > placement.row) ? candidate : placement;
+            }
+            predicted.place(get_piece_mask(placement.shapeType, placement.rotation), placement.row, placement.column);
+
+            apply_placement(gameBoard, placement);
+            if (gameBoard.get_board_state() != predicted)
+            {
+                return -1;
+            }
+            ++playedShapes;
+        }
+        return playedShapes;
+    }
+
+    /*
+     * Moves and drops some shapes and checks after every step that the composited frame matches the cell
+     * states, and that its version only increases when something changed.
+     */
+    constexpr bool check_frame()
+    {
+        GameBoard<24, 10> gameBoard(3);
+        for (int step = 0; step < 40; ++step)
+        {
+            const uint32_t version = gameBoard.get_frame_version();
+            switch (step % 4)
+            {
+                case 0:
+                    gameBoard.rotate_clockwise_if_valid();
+                    break;
+                case 1:
+                    for (int move = 0; move < 10; ++move)
+                    {
+                        gameBoard.move_left_if_valid();
+                    }
+                    break;
+                case 2:
+                    gameBoard.update();
+                    break;
+                default:
+                    gameBoard.hard_drop();
+                    break;
+            }
+
+            const std::array<CellState, 24 * 10> &frame = gameBoard.get_frame();
+            for (SizeType i = 0; i < 24; ++i)
+            {
+                for (SizeType j = 0; j < 10; ++j)
+                {
+                    if (frame[i * 10 + j] != gameBoard.get_cell_state(i, j))
+                    {
+                        return false;
+                    }
+                }
+            }
+
+            // the shape has been moved to the left wall, where a blocked move must not change the frame
+            if (step % 4 == 1)
+            {
+                const uint32_t changedVersion = gameBoard.get_frame_version();
+                gameBoard.move_left_if_valid();
+                if (changedVersion == version || gameBoard.get_frame_version() != changedVersion)
+                {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    /*
+     * Returns true if two game boards are in the same state.
+     */
+    constexpr bool have_same_state(const GameBoard<24, 10> &first, const GameBoard<24, 10> &second)
+    {
+        const GameBoard<24, 10>::SerializedState firstState = first.serialize();
+        const GameBoard<24, 10>::SerializedState secondState = second.serialize();
+        for (std::size_t b = 0; b < firstState.size(); ++b)
+        {
+            if (firstState[b] != secondState[b])
+            {
+                return false;
+            }
+        }
+        for (std::size_t cell = 0; cell < first.get_frame().size(); ++cell)
+        {
+            if (first.get_frame()[cell] != second.get_frame()[cell])
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /*
+     * Searches two shapes deep with make_move() and unmake_move() on a board whose lowest four rows are full
+     * except for the right column. Checks that every move has the same outcome as driving the shape with the
+     * controls, and that taking the moves back restores the board.
+     */
+    constexpr bool check_make_unmake()
+    {
+        GameBoard<24, 10> gameBoard(13);
+        GameBoard<24, 10>::SerializedState state = gameBoard.serialize();
+        for (SizeType i = 20; i < 24; ++i)
+        {
+            for (SizeType j = 0; j < 9; ++j)
+            {
+                state[3 + i * 10 + j] = 1; // landed blocks
+            }
+            state[3 + 24 * 10 + i] = 9; // cells in row
+        }
+        if (!gameBoard.deserialize(state))
+        {
+            return false;
+        }
+
+        const GameBoard<24, 10> original = gameBoard;
+        const PlacementList<10> placements = generate_placements(gameBoard.get_board_state(),
+                                                                 gameBoard.get_current_falling().get_shape_type());
+        for (const Placement &placement : placements)
+        {
+            GameBoard<24, 10> driven = gameBoard;
+            apply_placement(driven, placement);
+            const GameBoard<24, 10>::UndoRecord record = gameBoard.make_move(placement);
+            if (!have_same_state(gameBoard, driven))
+            {
+                return false;
+            }
+
+            const PlacementList<10> nextPlacements = generate_placements(gameBoard.get_board_state(),
+                                                                         gameBoard.get_current_falling().get_shape_type());
+            const GameBoard<24, 10> afterMove = gameBoard;
+            for (const Placement &nextPlacement : nextPlacements)
+            {
+                gameBoard.unmake_move(gameBoard.make_move(nextPlacement));
+            }
+            if (!have_same_state(gameBoard, afterMove))
+            {
+                return false;
+            }
+
+            gameBoard.unmake_move(record);
+            if (!have_same_state(gameBoard, original))
+            {
+                return false;
+            }
+        }
+        return original.get_line_clears() == 0;
+    }
+
+    /*
+     * Checks that a game restored from a serialized state ends up in the same state as the original game after
+     * replaying the lock events recorded since, and that invalid states and events are rejected.
+     */
+    constexpr bool check_save_and_replay()
+    {
+        GameBoard<24, 10> game(11);
+        for (int step = 0; step < 4; ++step)
+        {
+            game.rotate_clockwise_if_valid();
+            game.hard_drop();
+        }
+
+        GameBoard<24, 10> resumed(1);
+        GameBoard<24, 10>::SerializedState state = game.serialize();
+        if (!resumed.deserialize(state))
+        {
+            return false;
+        }
+        state[0] = GameBoard<24, 10>::SERIALIZATION_VERSION + 1;
+        if (GameBoard<24, 10>(1).deserialize(state))
+        {
+            return false;
+        }
+
+        // spread the shapes over the board and let some of them settle by gravity
+        std::array<LockEvent, 12> locks{};
+        for (std::size_t l = 0; l < locks.size(); ++l)
+        {
+            for (std::size_t move = 0; move < l % 5; ++move)
+            {
+                if (l % 2 == 0)
+                {
+                    game.move_left_if_valid();
+                }
+                else
+                {
+                    game.move_right_if_valid();
+                }
+            }
+            const uint32_t lockCount = game.get_lock_count();
+            while (l % 3 == 0 && game.get_lock_count() == lockCount)
+            {
+                game.update();
+            }
+            if (l % 3 != 0)
+            {
+                game.hard_drop();
+            }
+            locks[l] = game.get_last_lock();
+        }
+
+        for (const LockEvent &lock : locks)
+        {
+            if (!resumed.replay_lock(lock))
+            {
+                return false;
+            }
+        }
+        if (resumed.replay_lock(locks.back()) || game.is_game_over())
+        {
+            return false;
+        }
+
+        const GameBoard<24, 10>::SerializedState gameState = game.serialize();
+        const GameBoard<24, 10>::SerializedState resumedState = resumed.serialize();
+        for (std::size_t b = 0; b < gameState.size(); ++b)
+        {
+            if (gameState[b] != resumedState[b])
+            {
+                return false;
+            }
+        }
+        for (std::size_t cell = 0; cell < game.get_frame().size(); ++cell)
+        {
+            if (game.get_frame()[cell] != resumed.get_frame()[cell])
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /*
+     * Plays four games in a lane engine and on game boards with the same seeds and controls, and checks that
+     * both always agree. Each lane receives a different mix of controls.
+     */
+    constexpr bool check_lane_engine()
+    {
+        constexpr std::size_t laneCount = 4;
+        LaneEngine<24, 10, laneCount> laneEngine({11, 12, 13, 14});
+        std::array<GameBoard<24, 10>, laneCount> gameBoards{GameBoard<24, 10>(11), GameBoard<24, 10>(12),
+                                                            GameBoard<24, 10>(13), GameBoard<24, 10>(14)};
+        for (int step = 0; step < 24; ++step)
+        {
+            const LaneMask rotating = 0b0101u ^ static_cast<LaneMask>(step % 2);
+            const LaneMask movingLeft = 0b0011u;
+            const LaneMask movingRight = 0b1100u;
+            laneEngine.rotate_clockwise_if_valid(rotating);
+            for (int move = 0; move < step % 6; ++move)
+            {
+                laneEngine.move_left_if_valid(movingLeft);
+                laneEngine.move_right_if_valid(movingRight);
+            }
+            laneEngine.update(LaneEngine<24, 10, laneCount>::ALL_LANES);
+            laneEngine.hard_drop(0b0111u);
+
+            for (std::size_t l = 0; l < laneCount; ++l)
+            {
+                GameBoard<24, 10> &gameBoard = gameBoards[l];
+                if (gameBoard.is_game_over())
+                {
+                    continue;
+                }
+                if ((rotating >> l) & 1u)
+                {
+                    gameBoard.rotate_clockwise_if_valid();
+                }
+                for (int move = 0; move < step % 6; ++move)
+                {
+                    if ((movingLeft >> l) & 1u)
+                    {
+                        gameBoard.move_left_if_valid();
+                    }
+                    if ((movingRight >> l) & 1u)
+                    {
+                        gameBoard.move_right_if_valid();
+                    }
+                }
+                gameBoard.update();
+                if (l != 3 && !gameBoard.is_game_over()) // lanes ignore all controls once their game is over
+                {
+                    gameBoard.hard_drop();
+                }
+
+                const Placement falling = laneEngine.get_falling(l);
+                const Falling &expected = gameBoard.get_current_falling();
+                if (laneEngine.get_board_state(l) != gameBoard.get_board_state()
+                    || falling.shapeType != expected.get_shape_type() || falling.rotation != expected.get_rotation()
+                    || falling.row != expected.get_upper_left_h() || falling.column != expected.get_upper_left_w()
+                    || laneEngine.get_line_clears(l) != gameBoard.get_line_clears()
+                    || laneEngine.get_level(l) != gameBoard.get_level()
+                    || ((laneEngine.get_game_over_mask() >> l) & 1u) != gameBoard.is_game_over())
+                {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    /*
+     * Checks that the update cycle threshold starts at one update per second and never increases.
+     */
+    constexpr bool check_update_cycle_thresholds()
+    {
+        for (std::size_t level = 1; level < LEVEL_COUNT; ++level)
+        {
+            if (UPDATE_CYCLE_THRESHOLDS[level] > UPDATE_CYCLE_THRESHOLDS[level - 1])
+            {
+                return false;
+            }
+        }
+        return UPDATE_CYCLE_THRESHOLDS[0] == 60 && UPDATE_CYCLE_THRESHOLDS[LEVEL_COUNT - 1] == 1;
+    }
+
+    /*
+     * Checks that the gravity starts at one row per second, never decreases and ends at MAX_GRAVITY.
+     */
+    constexpr bool check_gravity_table()
+    {
+        for (std::size_t level = 1; level < LEVEL_COUNT; ++level)
+        {
+            if (GRAVITY_TABLE[level] < GRAVITY_TABLE[level - 1])
+            {
+                return false;
+            }
+        }
+        return 59 * GRAVITY_TABLE[0] < GRAVITY_ONE_ROW && 60 * GRAVITY_TABLE[0] >= GRAVITY_ONE_ROW
+               && GRAVITY_TABLE[LEVEL_COUNT - 1] == MAX_GRAVITY;
+    }
+
+    /*
+     * Checks that at level 0, 60 frames move the falling shape like one update, and that at maximal gravity
+     * the falling shape moves 20 rows within one frame.
+     */
+    constexpr bool check_frame_gravity()
+    {
+        GameBoard<24, 10> framed(4);
+        GameBoard<24, 10> updated(4);
+        for (int row = 0; row < 20; ++row)
+        {
+            for (int frame = 0; frame < 60; ++frame)
+            {
+                framed.advance_frame();
+            }
+            updated.update();
+            for (std::size_t cell = 0; cell < framed.get_frame().size(); ++cell)
+            {
+                if (framed.get_frame()[cell] != updated.get_frame()[cell])
+                {
+                    return false;
+                }
+            }
+        }
+
+        // 2000 line clears lead to level 200
+        GameBoard<24, 10> fast(7);
+        GameBoard<24, 10>::SerializedState state = fast.serialize();
+        constexpr std::size_t lineClearsOffset = 3 + 24 * 10 + 24 + 2 * 5 + 1 + 1;
+        state[lineClearsOffset] = 2000 % 256;
+        state[lineClearsOffset + 1] = 2000 / 256;
+        if (!fast.deserialize(state))
+        {
+            return false;
+        }
+
+        fast.advance_frame();
+        if (fast.get_gravity() != MAX_GRAVITY || fast.get_lock_count() != 0
+            || fast.get_current_falling().get_upper_left_h() != 20)
+        {
+            return false;
+        }
+        fast.advance_frame();
+        return fast.get_lock_count() == 1;
+    }
+
+    /*
+     * Checks that get_frames_until_drop() predicts the gravity steps of the first five drops exactly, i.e. that
+     * the falling shape stays in its row for one frame less and moves down with the next one.
+     */
+    constexpr bool check_frames_until_drop()
+    {
+        GameBoard<24, 10> gameBoard(4);
+        for (int drop = 0; drop < 5; ++drop)
+        {
+            const SizeType row = gameBoard.get_current_falling().get_upper_left_h();
+            for (uint32_t frame = gameBoard.get_frames_until_drop(); frame > 1; --frame)
+            {
+                gameBoard.advance_frame();
+                if (gameBoard.get_current_falling().get_upper_left_h() != row)
+                {
+                    return false;
+                }
+            }
+            gameBoard.advance_frame();
+            if (gameBoard.get_current_falling().get_upper_left_h() == row)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /*
+     * Drives the first shape of a game into every placement on the empty board with its finesse sequence.
+     * Checks that it lands like with make_move(), and that the sequence is never longer than the controls
+     * apply_placement() presses.
+     */
+    constexpr bool check_finesse_table(const ShapeType shapeType)
+    {
+        uint32_t seed = 1;
+        while (GameBoard<24, 10>(seed).get_current_falling().get_shape_type() != shapeType)
+        {
+            ++seed;
+        }
+
+        const GameBoard<24, 10> gameBoard(seed);
+        for (const Placement &placement : generate_placements(gameBoard.get_board_state(), shapeType))
+        {
+            const InputSequence<10> &sequence = get_finesse_sequence<10>(placement);
+            const uint32_t rotations = (placement.rotation == ROT_180) ? 2 : (placement.rotation != ROT_0);
+            const int shifts = placement.column - get_spawn_column<10>();
+            if (!sequence.reachable || sequence.length > rotations + (shifts < 0 ? -shifts : shifts)
+                || get_finesse_errors<10>(placement, sequence.length + 2) != 2)
+            {
+                return false;
+            }
+
+            GameBoard<24, 10> driven = gameBoard;
+            apply_input_sequence(driven, sequence);
+            GameBoard<24, 10> moved = gameBoard;
+            moved.make_move(placement);
+            if (driven.get_board_state() != moved.get_board_state() || driven.get_lock_count() != moved.get_lock_count())
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+static_assert(check_piece_masks(), "ERROR: Every rotated shape must consist of four cells with contiguous columns.");
+static_assert(check_rotation_cycle(), "ERROR: Four rotations must restore the original shape.");
+
+static_assert(count_empty_board_placements(SHAPE_O) == 9 && count_empty_board_placements(SHAPE_I) == 17
+              && count_empty_board_placements(SHAPE_S) == 17 && count_empty_board_placements(SHAPE_Z) == 17
+              && count_empty_board_placements(SHAPE_L) == 34 && count_empty_board_placements(SHAPE_J) == 34
+              && count_empty_board_placements(SHAPE_T) == 34, "ERROR: Unexpected number of placements on an empty board.");
+
+static_assert(check_line_clear(), "ERROR: Filling a row must clear it and shift the rows above down.");
+static_assert(check_board_features(), "ERROR: Board features do not match a hand-counted board.");
+static_assert(simulate_game(42, 30) == 30, "ERROR: BoardState and GameBoard disagree about the outcome of placements.");
+static_assert(check_frame(), "ERROR: The composited frame must match the cell states and only change with them.");
+static_assert(check_save_and_replay(), "ERROR: Replaying recorded locks must reproduce a serialized game.");
+static_assert(check_make_unmake(), "ERROR: Taking back moves must restore the game board.");
+static_assert(check_finesse_table(SHAPE_O) && check_finesse_table(SHAPE_I) && check_finesse_table(SHAPE_S),
+              "ERROR: Finesse sequences must be minimal and lead to their placements.");
+static_assert(check_finesse_table(SHAPE_L) && check_finesse_table(SHAPE_J),
+              "ERROR: Finesse sequences must be minimal and lead to their placements.");
+static_assert(check_finesse_table(SHAPE_T) && check_finesse_table(SHAPE_Z),
+              "ERROR: Finesse sequences must be minimal and lead to their placements.");
+static_assert(get_finesse_sequence<10>(SHAPE_S, ROT_180, get_spawn_column<10>()).length == 0
+              && !get_finesse_sequence<10>(SHAPE_O, ROT_0, 9).reachable,
+              "ERROR: Finesse sequences must treat rotations with the same cells alike and reject columns outside the board.");
+static_assert(check_lane_engine(), "ERROR: Lane engine and GameBoard disagree about the course of a game.");
+static_assert(check_update_cycle_thresholds(), "ERROR: Update cycle thresholds must start at 60 and decrease to 1.");
+static_assert(check_gravity_table(), "ERROR: Gravity must start at one row per second and increase to 20 rows per frame.");
+static_assert(check_frame_gravity(), "ERROR: Frames must move the falling shape according to the gravity of the level.");
+static_assert(check_frames_until_drop(), "ERROR: The falling shape must move down exactly after the predicted number of frames.");
+
+static_assert(GameBoard<24, 10>(7).get_update_cycle_threshold() == 60, "ERROR: A new game must start at level 0.");
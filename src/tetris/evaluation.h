@@ -0,0 +1,45 @@
+#ifndef EVALUATION_H_
+#define EVALUATION_H_
+
+#include "board_features.h"
+
+/*
+ * Weights of the linear board evaluation. The default values are well-known weights for the features
+ * aggregate height, completed lines, holes and bumpiness, tuned for the standard 20x10 game.
+ */
+struct EvaluationWeights
+{
+    float aggregateHeight{-0.510066f}; ///< Weight of the sum of all column heights.
+    float completedLines{0.760666f}; ///< Weight of the number of cleared rows.
+    float holes{-0.35663f}; ///< Weight of the number of empty cells with an occupied cell above them.
+    float bumpiness{-0.184483f}; ///< Weight of the sum of height differences of neighbouring columns.
+};
+
+constexpr float GAME_OVER_SCORE{-1.0e6f}; ///< Value of a board on which a shape cannot be placed, below every evaluation.
+
+/*
+ * Evaluates the features of a board state. The higher the score, the better the board is for the player.
+ *
+ * @param[in] features features of the board state, see extract_board_features()
+ * @param[in] completedLines number of rows cleared while reaching this board state
+ * @param[in] weights weights of the individual features
+ * @return score of the board state
+ */
+template<SizeType width>
+float evaluate_features(const BoardFeatures<width> &features, const uint16_t completedLines,
+                        const EvaluationWeights &weights = EvaluationWeights{});
+
+/*
+ * Evaluates a board state. The higher the score, the better the board is for the player.
+ *
+ * @param[in] boardState occupancy of the landed blocks
+ * @param[in] completedLines number of rows cleared while reaching this board state
+ * @param[in] weights weights of the individual features
+ * @return score of the board state
+ */
+template<SizeType height, SizeType width>
+float evaluate_board(const BoardState<height, width> &boardState, const uint16_t completedLines,
+                     const EvaluationWeights &weights = EvaluationWeights{});
+
+#include "evaluation.hpp"
+#endif /* EVALUATION_H_ */
@@ -0,0 +1,14 @@
+template<SizeType width>
+float evaluate_features(const BoardFeatures<width> &features, const uint16_t completedLines,
+                        const EvaluationWeights &weights)
+{
+    return weights.aggregateHeight * features.aggregateHeight + weights.completedLines * completedLines
+           + weights.holes * features.holes + weights.bumpiness * features.bumpiness;
+}
+
+template<SizeType height, SizeType width>
+float evaluate_board(const BoardState<height, width> &boardState, const uint16_t completedLines,
+                     const EvaluationWeights &weights)
+{
+    return evaluate_features(extract_board_features(boardState), completedLines, weights);
+}
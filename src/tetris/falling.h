@@ -2,12 +2,14 @@
 #define FALLING_H_
 
 #include "types.h"
-#include "shapes.h"
+#include "piece_mask.h"
 
 /*
  * Represents a falling object in the game board.
- * All public operations refer to properties of the accordingly rotated shape.
+ * All public operations refer to properties of the accordingly rotated shape. The cells are read from the masks of
+ * the shape's rotations, so the bounding box of a shape may be up to MAX_POLYOMINO_EXTENT x MAX_POLYOMINO_EXTENT.
  * The coordinates are used like matrix indices.
+ * All operations are constexpr and can be used in constant expressions.
  */
 class Falling
 {
@@ -20,7 +22,20 @@ public:
      * @param[in] shapeType The falling object's shape type.
      * @param[in] stateType The falling object's cell state for alive shape cells, i.e. a color representation.
      */
-    Falling(const SizeType upperLeftH, const SizeType upperLeftW, const ShapeType shapeType, const CellState stateType = 0xFF);
+    constexpr Falling(const SizeType upperLeftH, const SizeType upperLeftW, const ShapeType shapeType, const CellState stateType = 0xFF);
+
+    /*
+     * Constructor for a shape given by its masks, e.g. a piece of a PieceSet.
+     *
+     * @param[in] upperLeftH The falling object's height coordinate in the game board.
+     * @param[in] upperLeftW The falling object's width coordinate in the game board.
+     * @param[in] masks The masks of all rotations of the shape in the order ROT_0, ..., ROT_270, which must outlive
+     *                  the falling object, see PieceSet::get_piece_masks().
+     * @param[in] piece The index of the shape in its set, returned by get_shape_type().
+     * @param[in] stateType The falling object's cell state for alive shape cells, i.e. a color representation.
+     */
+    constexpr Falling(const SizeType upperLeftH, const SizeType upperLeftW, const PolyominoMask *masks,
+                      const uint8_t piece, const CellState stateType = 0xFF);
 
     /*
      * Default destructor.
@@ -32,7 +47,7 @@ public:
      * @param[in] i game board row index
      * @param[in] j game board column index
      */
-    CellState get_cell_state_on_board(const SizeType i, const SizeType j) const;
+    constexpr CellState get_cell_state_on_board(const SizeType i, const SizeType j) const;
 
     /*
      * Returns the accordingly rotated falling shape's state in absolute coordinates starting in (0/0).
@@ -42,95 +57,99 @@ public:
      * @param[in] row index
      * @param[in] j column index
      */
-    CellState get_raw_cell_state(const SizeType i, const SizeType j) const;
+    constexpr CellState get_raw_cell_state(const SizeType i, const SizeType j) const;
 
     /*
      * Return row coordinate of upper left corner.
      */
-    SizeType get_upper_left_h() const;
+    constexpr SizeType get_upper_left_h() const;
 
     /*
      * Return column coordinate of upper left corner.
      */
-    SizeType get_upper_left_w() const;
+    constexpr SizeType get_upper_left_w() const;
 
     /*
      * Return row coordinate of lower right corner.
      */
-    SizeType get_lower_right_h() const;
+    constexpr SizeType get_lower_right_h() const;
 
     /*
      * Return column coordinate of lower right corner.
      */
-    SizeType get_lower_right_w() const;
+    constexpr SizeType get_lower_right_w() const;
 
     /*
      * Return height.
      */
-    SizeType get_height() const;
+    constexpr SizeType get_height() const;
 
     /*
      * return width.
      */
-    SizeType get_width() const;
+    constexpr SizeType get_width() const;
+
+    /*
+     * Return the type of the underlying base shape, or the index of the piece if the falling object was created from
+     * masks.
+     */
+    constexpr ShapeType get_shape_type() const;
+
+    /*
+     * Return the current rotation status.
+     */
+    constexpr Rotation get_rotation() const;
+
+    /*
+     * Return the cell state of alive shape cells.
+     */
+    constexpr CellState get_state_type() const;
 
     /*
      * Moves the shape up by one unit.
      */
-    void move_up();
+    constexpr void move_up();
 
     /*
      * Moves the shape left by one unit.
      */
-    void move_left();
+    constexpr void move_left();
 
     /*
      * Moves the shape right by one unit.
      */
-    void move_right();
+    constexpr void move_right();
 
     /*
      * Moves the shape down by one unit.
      */
-    void move_down();
+    constexpr void move_down();
 
     /*
      * Rotates the shape clockwise by 90°.
      */
-    void rotate_clockwise();
+    constexpr void rotate_clockwise();
 
     /*
      * Rotates the shape counterclockwise by 90°.
      */
-    void rotate_counterclockwise();
+    constexpr void rotate_counterclockwise();
 
 private:
-
-    /*
-     * Returns the cell state of the unrotated base shape.
-     *
-     * @param[in] i row index
-     * @param[in] j column index
-     */
-    CellState get_original_shape_cell_state(const SizeType i, const SizeType j) const;
-
     /*
-     * Similar to public method get_raw_cell_state(i, j), but does not provide out-of-bounds-access.
-     * Handle with care! This function is necessary because the rotated height and width of the object do not
-     * necessarily coincide with those of the base shape.
-     *
-     * @param[in] i row index
-     * @param[in] j column index
+     * Returns the mask of the current rotation.
      */
-    CellState get_rotated_shape_data(const SizeType i, const SizeType j) const;
+    constexpr const PolyominoMask& get_mask() const;
 
 private:
     SizeType _upperLeftH{0};
     SizeType _upperLeftW{0};
-    Shape _currentShape{SHAPE_O};
+    const PolyominoMask *_masks{nullptr};
+    ShapeType _shapeType{SHAPE_O};
     CellState _stateType{0xFF};
 
     RotationType _rotationStatus{ROT_0};
 };
 
+#include "falling.hpp"
 #endif /* FALLING_H_ */
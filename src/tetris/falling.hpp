@@ -0,0 +1,118 @@
+// public
+
+constexpr Falling::Falling(const SizeType upperLeftH, const SizeType upperLeftW, const ShapeType shapeType, const CellState stateType)
+: _upperLeftH{upperLeftH},
+_upperLeftW{upperLeftW},
+_masks{get_polyomino_masks(shapeType)},
+_shapeType{shapeType},
+_stateType{stateType}
+{}
+
+constexpr Falling::Falling(const SizeType upperLeftH, const SizeType upperLeftW, const PolyominoMask *masks,
+                           const uint8_t piece, const CellState stateType)
+: _upperLeftH{upperLeftH},
+_upperLeftW{upperLeftW},
+_masks{masks},
+_shapeType{static_cast<ShapeType>(piece)},
+_stateType{stateType}
+{}
+
+constexpr CellState Falling::get_cell_state_on_board(const SizeType i, const SizeType j) const
+{
+    // shift game board coordinates to absolute shape coordinate
+    const int8_t i_shifted = i - _upperLeftH;
+    const int8_t j_shifted = j - _upperLeftW;
+    return get_raw_cell_state(i_shifted, j_shifted);
+}
+
+constexpr CellState Falling::get_raw_cell_state(const SizeType i, const SizeType j) const
+{
+    // Return cell state or 0, if coordinates are outside the shape
+    return (0 <= i && i < get_height() && 0 <= j && j < get_width()) ? _stateType * ((get_mask().rows[i] >> j) & 1u) : 0;
+}
+
+constexpr SizeType Falling::get_upper_left_h() const
+{
+    return _upperLeftH;
+}
+
+constexpr SizeType Falling::get_upper_left_w() const
+{
+    return _upperLeftW;
+}
+
+constexpr SizeType Falling::get_lower_right_h() const
+{
+    return _upperLeftH + get_height() - 1;
+}
+
+constexpr SizeType Falling::get_lower_right_w() const
+{
+    return _upperLeftW + get_width() - 1;
+}
+
+
+constexpr SizeType Falling::get_height() const
+{
+    // the masks of the rotations have the accordingly rotated height and width
+    return get_mask().height;
+}
+
+constexpr SizeType Falling::get_width() const
+{
+    return get_mask().width;
+}
+
+constexpr ShapeType Falling::get_shape_type() const
+{
+    return _shapeType;
+}
+
+constexpr Rotation Falling::get_rotation() const
+{
+    return _rotationStatus;
+}
+
+constexpr CellState Falling::get_state_type() const
+{
+    return _stateType;
+}
+
+constexpr void Falling::move_up()
+{
+    // decrement, because coordinates are used like matrix indices
+    --_upperLeftH;
+}
+
+constexpr void Falling::move_left()
+{
+    --_upperLeftW;
+}
+
+constexpr void Falling::move_right()
+{
+    ++_upperLeftW;
+}
+
+constexpr void Falling::move_down()
+{
+    // increment, because coordinates are used like matrix indices
+    ++_upperLeftH;
+}
+
+constexpr void Falling::rotate_clockwise()
+{
+    ++_rotationStatus;
+}
+
+constexpr void Falling::rotate_counterclockwise()
+{
+    --_rotationStatus;
+}
+
+// private
+
+constexpr const PolyominoMask& Falling::get_mask() const
+{
+    return _masks[static_cast<Rotation>(_rotationStatus)];
+}
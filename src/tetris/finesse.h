@@ -0,0 +1,88 @@
+#ifndef FINESSE_H_
+#define FINESSE_H_
+
+#include "placement.h"
+
+/*
+ * Controls which move or rotate the falling shape, see GameBoard::move_left_if_valid() and the like.
+ */
+enum FinesseInput : uint8_t
+{
+    FINESSE_LEFT,
+    FINESSE_RIGHT,
+    FINESSE_CLOCKWISE,
+    FINESSE_COUNTERCLOCKWISE,
+    _FINESSE_INPUT_COUNT
+};
+
+/*
+ * Sequence of controls leading a falling shape from the spawn position to a target rotation and column.
+ * At most two rotations and width - 1 shifts are ever needed.
+ */
+template<SizeType width>
+struct InputSequence
+{
+    static constexpr std::size_t capacity = width + 1; ///< Maximal length of a shortest sequence.
+
+    std::array<FinesseInput, capacity> inputs{}; ///< The controls, in the order of pressing them.
+    uint8_t length{0}; ///< Number of controls.
+    bool reachable{false}; ///< False if the target cannot be reached, e.g. because the shape sticks out of the board.
+};
+
+template<SizeType width>
+using FinesseTable = std::array<std::array<std::array<InputSequence<width>, width>, ROTATION_COUNT>, _SHAPE_COUNT>;
+
+/*
+ * Builds the table of the shortest control sequences for every shape, target rotation and target column of the
+ * upper left corner, starting from the spawn position in the uppermost row of an empty board.
+ * The sequences are found by a breadth-first search over the rotations and columns in which the shape fits into
+ * the uppermost row. A target is reached as soon as the shape covers the same cells, so e.g. ROT_180 of the
+ * S shape needs no input at all. Among several shortest sequences, one which rotates first is chosen, so the
+ * rotations happen at the spawn position like for the placements of generate_placements().
+ * The table is evaluated at compile time and available via get_finesse_sequence().
+ */
+template<SizeType width>
+constexpr FinesseTable<width> build_finesse_table();
+
+/*
+ * Returns the shortest control sequence from the spawn position to a target.
+ *
+ * @param[in] shapeType type of the shape
+ * @param[in] rotation target rotation
+ * @param[in] column target column of the upper left corner
+ * @return the sequence, not reachable if the column lies outside the board
+ */
+template<SizeType width>
+constexpr const InputSequence<width>& get_finesse_sequence(const ShapeType shapeType, const Rotation rotation,
+                                                           const SizeType column);
+
+/*
+ * Returns the shortest control sequence from the spawn position to a placement, e.g. one found by a bot.
+ */
+template<SizeType width>
+constexpr const InputSequence<width>& get_finesse_sequence(const Placement &placement);
+
+/*
+ * Presses the controls of a sequence on a game board and lets the falling shape settle with hard_drop().
+ * The falling shape must be at its spawn position and every control must succeed. This holds for all
+ * placements of generate_placements(), unless a rotation by 180° is only possible counterclockwise.
+ *
+ * @param[in] gameBoard the game board
+ * @param[in] sequence the controls
+ */
+template<SizeType height, SizeType width>
+constexpr void apply_input_sequence(GameBoard<height, width> &gameBoard, const InputSequence<width> &sequence);
+
+/*
+ * Returns the number of controls a player has pressed beyond the shortest sequence for a placement, i.e. the
+ * finesse errors of the placement.
+ *
+ * @param[in] placement the placement of the shape
+ * @param[in] inputCount number of movement and rotation controls pressed between spawn and lock
+ * @return number of superfluous controls, 0 if the placement cannot be reached from the spawn position
+ */
+template<SizeType width>
+constexpr uint32_t get_finesse_errors(const Placement &placement, const uint32_t inputCount);
+
+#include "finesse.hpp"
+#endif /* FINESSE_H_ */
@@ -0,0 +1,175 @@
+namespace finesse_detail
+{
+    template<SizeType width>
+    constexpr InputSequence<width> UNREACHABLE{}; ///< sequence of targets outside the board
+
+    /*
+     * Determines whether two rotations of a shape cover the same cells.
+     */
+    constexpr bool have_same_cells(const ShapeType shapeType, const Rotation first, const Rotation second)
+    {
+        const PieceMask &firstPiece = get_piece_mask(shapeType, first);
+        const PieceMask &secondPiece = get_piece_mask(shapeType, second);
+        bool equal = firstPiece.height == secondPiece.height && firstPiece.width == secondPiece.width;
+        for (SizeType i = 0; i < MAX_PIECE_EXTENT; ++i)
+        {
+            equal = equal && firstPiece.rows[i] == secondPiece.rows[i];
+        }
+        return equal;
+    }
+
+    /*
+     * Determines whether a rotated shape fits into the uppermost row of an empty board with its upper left
+     * corner in a column.
+     */
+    template<SizeType width>
+    constexpr bool fits_empty_row(const ShapeType shapeType, const Rotation rotation, const SizeType column)
+    {
+        return column >= 0 && column + get_piece_mask(shapeType, rotation).width <= width;
+    }
+
+    /*
+     * Finds the shortest control sequences of a shape to all rotations and columns.
+     */
+    template<SizeType width>
+    constexpr std::array<std::array<InputSequence<width>, width>, ROTATION_COUNT> search_sequences(const ShapeType shapeType)
+    {
+        constexpr std::size_t stateCount = ROTATION_COUNT * width;
+        constexpr SizeType spawnColumn = get_spawn_column<width>();
+        // rotations are tried first, so a sequence rotates before it shifts whenever that is not longer
+        constexpr std::array<FinesseInput, _FINESSE_INPUT_COUNT> order = {FINESSE_CLOCKWISE, FINESSE_COUNTERCLOCKWISE, FINESSE_LEFT, FINESSE_RIGHT};
+
+        // breadth-first search over the states rotation * width + column
+        std::array<InputSequence<width>, stateCount> sequences{};
+        std::array<std::size_t, stateCount> queue{};
+        std::size_t queueBegin = 0;
+        std::size_t queueEnd = 0;
+        if (fits_empty_row<width>(shapeType, ROT_0, spawnColumn))
+        {
+            sequences[spawnColumn].reachable = true;
+            queue[queueEnd++] = spawnColumn;
+        }
+        while (queueBegin < queueEnd)
+        {
+            const std::size_t state = queue[queueBegin++];
+            const Rotation rotation = static_cast<Rotation>(state / width);
+            const SizeType column = static_cast<SizeType>(state % width);
+            for (const FinesseInput input : order)
+            {
+                RotationType nextRotation(rotation);
+                SizeType nextColumn = column;
+                switch (input)
+                {
+                    case FINESSE_LEFT:
+                        --nextColumn;
+                        break;
+                    case FINESSE_RIGHT:
+                        ++nextColumn;
+                        break;
+                    case FINESSE_CLOCKWISE:
+                        ++nextRotation;
+                        break;
+                    default:
+                        --nextRotation;
+                        break;
+                }
+                if (!fits_empty_row<width>(shapeType, nextRotation, nextColumn))
+                {
+                    continue;
+                }
+                const std::size_t nextState = static_cast<Rotation>(nextRotation) * width + nextColumn;
+                if (!sequences[nextState].reachable)
+                {
+                    sequences[nextState] = sequences[state];
+                    sequences[nextState].inputs[sequences[nextState].length++] = input;
+                    queue[queueEnd++] = nextState;
+                }
+            }
+        }
+
+        // a target is reached by the shortest sequence to any rotation covering the same cells
+        std::array<std::array<InputSequence<width>, width>, ROTATION_COUNT> targets{};
+        for (uint8_t r = 0; r < ROTATION_COUNT; ++r)
+        {
+            for (SizeType column = 0; column < width; ++column)
+            {
+                for (uint8_t other = 0; other < ROTATION_COUNT; ++other)
+                {
+                    const InputSequence<width> &candidate = sequences[other * width + column];
+                    InputSequence<width> &target = targets[r][column];
+                    if (candidate.reachable && have_same_cells(shapeType, static_cast<Rotation>(r), static_cast<Rotation>(other))
+                        && (!target.reachable || candidate.length < target.length))
+                    {
+                        target = candidate;
+                    }
+                }
+            }
+        }
+        return targets;
+    }
+}
+
+// free functions
+
+template<SizeType width>
+constexpr FinesseTable<width> build_finesse_table()
+{
+    FinesseTable<width> table{};
+    for (uint8_t s = 0; s < _SHAPE_COUNT; ++s)
+    {
+        table[s] = finesse_detail::search_sequences<width>(static_cast<ShapeType>(s));
+    }
+    return table;
+}
+
+template<SizeType width>
+constexpr FinesseTable<width> FINESSE_TABLE = build_finesse_table<width>(); ///< Shortest control sequences of a board width.
+
+template<SizeType width>
+constexpr const InputSequence<width>& get_finesse_sequence(const ShapeType shapeType, const Rotation rotation,
+                                                           const SizeType column)
+{
+    if (column < 0 || column >= width)
+    {
+        return finesse_detail::UNREACHABLE<width>;
+    }
+    return FINESSE_TABLE<width>[shapeType][rotation][column];
+}
+
+template<SizeType width>
+constexpr const InputSequence<width>& get_finesse_sequence(const Placement &placement)
+{
+    return get_finesse_sequence<width>(placement.shapeType, placement.rotation, placement.column);
+}
+
+template<SizeType height, SizeType width>
+constexpr void apply_input_sequence(GameBoard<height, width> &gameBoard, const InputSequence<width> &sequence)
+{
+    for (uint8_t i = 0; i < sequence.length; ++i)
+    {
+        switch (sequence.inputs[i])
+        {
+            case FINESSE_LEFT:
+                gameBoard.move_left_if_valid();
+                break;
+            case FINESSE_RIGHT:
+                gameBoard.move_right_if_valid();
+                break;
+            case FINESSE_CLOCKWISE:
+                gameBoard.rotate_clockwise_if_valid();
+                break;
+            default:
+                gameBoard.rotate_counterclockwise_if_valid();
+                break;
+        }
+    }
+    gameBoard.hard_drop();
+    return;
+}
+
+template<SizeType width>
+constexpr uint32_t get_finesse_errors(const Placement &placement, const uint32_t inputCount)
+{
+    const InputSequence<width> &sequence = get_finesse_sequence<width>(placement);
+    return (sequence.reachable && inputCount > sequence.length) ? inputCount - sequence.length : 0;
+}
@@ -1,20 +1,106 @@
 #ifndef GAMEBOARD_H_
 #define GAMEBOARD_H_
 
+#include "board_state.h"
 #include "falling.h"
+#include "gravity.h"
+#include "random.h"
+#include "trace.h"
 
+#include <ctime>
 #include <iostream>
-#include <random>
 
+/*
+ * Final resting position of a falling shape.
+ * (row, column) is the upper left corner of the accordingly rotated shape, like in Falling.
+ */
+struct Placement
+{
+    ShapeType shapeType{SHAPE_O}; ///< Type of the placed shape.
+    Rotation rotation{ROT_0}; ///< Rotation of the placed shape.
+    SizeType row{0}; ///< Row coordinate of the upper left corner.
+    SizeType column{0}; ///< Column coordinate of the upper left corner.
+};
+
+/*
+ * Position in which a falling shape has settled. Apart from the controls, which only move the falling shape,
+ * every change of a game board follows deterministically from its locks, so replaying the lock events of a game
+ * reproduces it exactly, see GameBoard::replay_lock().
+ */
+struct LockEvent
+{
+    uint32_t index{0}; ///< number of locks of the game up to and including this one
+    ShapeType shapeType{SHAPE_O}; ///< type of the settled shape
+    Rotation rotation{ROT_0}; ///< rotation of the settled shape
+    SizeType row{0}; ///< row coordinate of the upper left corner
+    SizeType column{0}; ///< column coordinate of the upper left corner
+    uint8_t level{0}; ///< the player's level at the time of the lock
+};
+
+/*
+ * The tetris game board. Apart from the time-seeded default constructor, all operations are constexpr,
+ * so complete games can be simulated in constant expressions.
+ */
 template<SizeType height, SizeType width>
 class GameBoard
 {
+    static_assert((width - 1) / 2 + get_max_width(ROT_0) <= width && get_max_height(ROT_0) <= height,
+                  "ERROR: Game board is too small for new falling shapes.");
+
 public:
+    static constexpr uint8_t SERIALIZATION_VERSION{2}; ///< Version of the format written by serialize().
+
+    /*
+     * Number of bytes of a serialized game board: version and dimensions, landed blocks, cells in each row,
+     * current and next falling shape (row, column, shape type, rotation, cell state), game over flag, level,
+     * line clears, random generator state, lock count and gravity progress. Multi-byte values are stored
+     * little-endian.
+     */
+    static constexpr std::size_t SERIALIZED_SIZE{3 + height * width + height + 2 * 5 + 1 + 1 + 2 + 4 + 4 + 4};
+
+    using SerializedState = std::array<uint8_t, SERIALIZED_SIZE>; ///< Complete state of a game board.
+
     /*
-     * Constructor.
+     * Compact description of a falling shape, see Falling.
+     */
+    struct FallingRecord
+    {
+        SizeType row{0}; ///< row coordinate of the upper left corner
+        SizeType column{0}; ///< column coordinate of the upper left corner
+        ShapeType shapeType{SHAPE_O}; ///< shape type
+        Rotation rotation{ROT_0}; ///< rotation
+        CellState stateType{0}; ///< cell state of alive shape cells
+    };
+
+    /*
+     * Everything make_move() changes beyond the cells of the placed shape, so unmake_move() can restore it.
+     */
+    struct UndoRecord
+    {
+        std::array<std::array<CellState, width>, MAX_PIECE_EXTENT> clearedCells{}; ///< contents of the cleared rows
+        std::array<SizeType, MAX_PIECE_EXTENT> clearedRows{}; ///< indices of the cleared rows in ascending order
+        uint8_t clearedRowCount{0}; ///< number of cleared rows
+        FallingRecord placed{}; ///< the placed shape
+        FallingRecord currentFalling{}; ///< the falling shape before the move
+        FallingRecord nextFalling{}; ///< the next falling shape before the move
+        LockEvent lastLock{}; ///< the most recent lock before the move
+        uint32_t generatorState{0}; ///< state of the random number generator before the move
+        uint16_t lineClears{0}; ///< number of cleared rows before the move
+        bool gameOver{false}; ///< game over flag before the move
+    };
+
+    /*
+     * Constructor. The sequence of falling shapes is seeded with the current time.
      */
     GameBoard();
 
+    /*
+     * Constructor. Creates a game board whose sequence of falling shapes is determined by seed.
+     *
+     * @param[in] seed seed of the random number generator
+     */
+    constexpr explicit GameBoard(const uint32_t seed);
+
     /*
      * Destructor.
      */
@@ -24,13 +110,13 @@ public:
      * Returns the player's current level
      * @return current level
      */
-    uint8_t get_level() const;
+    constexpr uint8_t get_level() const;
 
     /*
      * Returns the player's current level
      * @return current level
      */
-    uint16_t get_line_clears() const;
+    constexpr uint16_t get_line_clears() const;
 
     /*
      * Returns the current recommended update cycle threshold.
@@ -41,7 +127,15 @@ public:
      *
      * @return update cycle threshold
      */
-    uint8_t get_update_cycle_threshold() const;
+    constexpr uint8_t get_update_cycle_threshold() const;
+
+    /*
+     * Returns the gravity of the player's current level, i.e. the distance the falling shape moves down
+     * per call of advance_frame().
+     *
+     * @return gravity in rows per frame
+     */
+    constexpr Gravity get_gravity() const;
 
     /*
      * Returns the current cell state of a certain game board cell.
@@ -49,7 +143,26 @@ public:
      *                           0 <= j < width
      * @return cell state of cell with coordinates (i,j)
      */
-    CellState get_cell_state(const SizeType i, const SizeType j) const;
+    constexpr CellState get_cell_state(const SizeType i, const SizeType j) const;
+
+    /*
+     * Returns the composited cell states of the whole game board, i.e. the landed blocks together with the
+     * currently falling shape, stored row by row. The cell state of (i,j) is at index i * width + j.
+     * The frame is kept up to date by the modifying calls, which only touch the cells of the falling shape
+     * unless the landed blocks changed, so consumers reading it every frame do not pay for any composition.
+     * The reference stays valid, but its contents change with the next modifying call.
+     *
+     * @return composited cell states
+     */
+    constexpr const std::array<CellState, height * width>& get_frame() const;
+
+    /*
+     * Returns a counter which is increased whenever the composited frame changes.
+     * Consumers can compare it to the counter of the last frame they processed to skip unchanged frames.
+     *
+     * @return frame version
+     */
+    constexpr uint32_t get_frame_version() const;
 
     /*
      * Returns the shape which is generated after the current falling shape has settled.
@@ -57,7 +170,36 @@ public:
      *
      * @return next falling shape
      */
-    Falling get_next_falling() const;
+    constexpr Falling get_next_falling() const;
+
+    /*
+     * Returns the shape which is currently falling down.
+     *
+     * @return current falling shape
+     */
+    constexpr Falling get_current_falling() const;
+
+    /*
+     * Returns a compact copy of the landed blocks' occupancy, e.g. for searching placements.
+     *
+     * @return occupancy of landed blocks
+     */
+    constexpr BoardState<height, width> get_board_state() const;
+
+    /*
+     * Returns the number of shapes which have settled since the start of the game.
+     *
+     * @return lock count
+     */
+    constexpr uint32_t get_lock_count() const;
+
+    /*
+     * Returns the most recent lock. Its index equals get_lock_count(); if no shape has settled since the
+     * construction or deserialization of the game board, only the index is meaningful.
+     *
+     * @return last lock event
+     */
+    constexpr const LockEvent& get_last_lock() const;
 
     /*
      * Check if game is already over, meaning that not enough space on the gameboard is available
@@ -66,37 +208,43 @@ public:
      *
      * @return true if game is over
      */
-    bool is_game_over() const;
+    constexpr bool is_game_over() const;
 
     /*
      * Moves the currently falling shape one unit to the left if the new position is valid.
      * Otherwise, the position stays unchanged.
      */
-    void move_left_if_valid();
+    constexpr void move_left_if_valid();
 
     /*
      * Moves the currently falling shape one unit to the right if the new position is valid.
      * Otherwise, the position stays unchanged.
      */
-    void move_right_if_valid();
+    constexpr void move_right_if_valid();
 
     /*
      * Moves the currently falling shape one unit down if the new position is valid.
      * Otherwise, the position stays unchanged.
      */
-    void move_down_if_valid();
+    constexpr void move_down_if_valid();
 
     /*
     * Rotates the currently falling shape by 90° clockwise if the new position is valid.
     * Otherwise, the position stays unchanged.
     */
-    void rotate_clockwise_if_valid();
+    constexpr void rotate_clockwise_if_valid();
 
     /*
     * Rotates the currently falling shape by 90° counterclockwise if the new position is valid.
     * Otherwise, the position stays unchanged.
     */
-    void rotate_counterclockwise_if_valid();
+    constexpr void rotate_counterclockwise_if_valid();
+
+    /*
+     * Moves the currently falling shape down as far as possible and lets it settle immediately.
+     * Afterwards, a new shape starts falling from above.
+     */
+    constexpr void hard_drop();
 
     /*
      * Updates the game board.
@@ -104,7 +252,74 @@ public:
      * 2. Moves the falling shape down by one unit if the new position is valid.
      * 3. Otherwise, the shape settles and a new shape starts falling from above.
      */
-    void update();
+    constexpr void update();
+
+    /*
+     * Advances the game board by one frame, to be called at the recommended frame rate of 60 Hz instead of
+     * update().
+     * 1. Adjusts the player's current level.
+     * 2. Adds the level's gravity to the progress of the falling shape. Each whole row of progress moves the
+     *    falling shape down by one unit, all of them at once, so a shape can fall several rows per frame.
+     * 3. If a row of progress remains after the shape has reached its resting position, the shape settles
+     *    and a new shape starts falling from above, exactly like update() would do.
+     * Nothing happens once the game is over.
+     */
+    constexpr void advance_frame();
+
+    /*
+     * Returns the number of calls of advance_frame() after which the falling shape next moves down by gravity,
+     * at least 1. The frames before only accumulate progress, so they may be performed late in one go,
+     * e.g. when a game is woken only when something visible happens.
+     */
+    constexpr uint32_t get_frames_until_drop() const;
+
+    /*
+     * Lets the falling shape settle in a placement, clears full rows and lets the next shape start falling,
+     * like driving the shape there with the controls would do. Only the cells of the placed shape and the
+     * cleared rows are touched, and the returned undo record is much smaller than a game board, so a
+     * depth-first search can play moves on a single game board and take them back with unmake_move().
+     * The placement must be valid for the falling shape, e.g. one generated by generate_placements().
+     *
+     * @param[in] placement resting position of the falling shape
+     * @return undo record for unmake_move()
+     */
+    constexpr UndoRecord make_move(const Placement &placement);
+
+    /*
+     * Takes back the most recent move which has not been taken back yet. Apart from the frame version,
+     * which keeps increasing, the game board is restored exactly.
+     *
+     * @param[in] record undo record returned by make_move()
+     */
+    constexpr void unmake_move(const UndoRecord &record);
+
+    /*
+     * Replays a lock event recorded from a game which was in the same state as this one: the current falling
+     * shape settles in the recorded position and the next shape starts falling, exactly as in the recorded game.
+     * The game board stays unchanged if the event does not apply, i.e. if its index is not the next one, its
+     * shape type is not the falling one or the shape would not rest in a valid position.
+     *
+     * @param[in] lock the recorded lock event
+     * @return true if the event has been replayed
+     */
+    constexpr bool replay_lock(const LockEvent &lock);
+
+    /*
+     * Returns the complete state of the game board as a versioned byte array, see SERIALIZED_SIZE.
+     * The composited frame is not part of the state, since it can be recomputed.
+     *
+     * @return serialized state
+     */
+    constexpr SerializedState serialize() const;
+
+    /*
+     * Restores a state written by serialize(). The state is validated first, and the game board stays unchanged
+     * if it has a different version or dimensions or is inconsistent.
+     *
+     * @param[in] state serialized state
+     * @return true if the state has been restored
+     */
+    constexpr bool deserialize(const SerializedState &state);
 
 private:
 
@@ -112,13 +327,28 @@ private:
      * Returns the current cell state of previously landed shapes.
      * @return cell state
      */
-    CellState get_landed_state(const SizeType i, const SizeType j) const;
+    constexpr CellState get_landed_state(const SizeType i, const SizeType j) const;
 
     /*
      * Returns the current cell state of the currently falling shape.
      * @return cell state
      */
-    CellState get_falling_state(const SizeType i, const SizeType j) const;
+    constexpr CellState get_falling_state(const SizeType i, const SizeType j) const;
+
+    /*
+     * Brings the composited frame up to date after the falling shape has changed and increases the frame version.
+     * If the landed blocks did not change, only the cells of the previously and the currently falling shape
+     * are rewritten.
+     *
+     * @param[in] landedChanged true if the landed blocks have changed, e.g. because a shape has settled
+     */
+    constexpr void update_frame(const bool landedChanged);
+
+    /*
+     * Returns the number of rows the falling shape can move down before it rests on landed blocks or the
+     * floor. The falling shape must be in a valid position.
+     */
+    constexpr SizeType get_drop_distance() const;
 
     /*
      * Determines whether the falling shape is in a valid position,
@@ -128,7 +358,7 @@ private:
      *
      * @return true if the position is valid
      */
-    bool falling_has_valid_position() const;
+    constexpr bool falling_has_valid_position() const;
 
     /*
      * Applies the cell state cellState to the cell with coordinates (i,j) in the array of landed cells.
@@ -137,27 +367,43 @@ private:
      * @param[in] j column index
      * @param[in] cellState cell state to apply
      */
-    void set_landed_cell_state(const SizeType i, const SizeType j, const CellState cellState);
+    constexpr void set_landed_cell_state(const SizeType i, const SizeType j, const CellState cellState);
 
     /*
      * 1. Converts the currently falling shape into a landed shape.
      * 2. Updates the number of currently active cells in row.
      * 3. Clears rows if necessary.
      */
-    void convert_falling_to_landed();
+    constexpr void convert_falling_to_landed();
 
     /*
      * Delete row.
      * @param[in] row index to delete
      */
-    void clear_row(const SizeType row);
+    constexpr void clear_row(const SizeType row);
+
+    /*
+     * Returns the compact description of a falling shape.
+     */
+    static constexpr FallingRecord record_falling(const Falling &falling);
+
+    /*
+     * Creates a falling shape from its compact description.
+     */
+    static constexpr Falling restore_falling(const FallingRecord &record);
+
+    /*
+     * Creates a falling shape in the given position and rotation.
+     */
+    static constexpr Falling make_falling(const SizeType row, const SizeType column, const ShapeType shapeType,
+                                          const Rotation rotation, const CellState stateType);
 
     /*
      * Next falling shape starts falling down.
      * A new random falling shape is generated with random cell state and is going to be the next shape
      * falling down after the currently falling shape has settled.
      */
-    void generate_new_falling();
+    constexpr void generate_new_falling();
 
 private:
     std::array<SizeType, height> _cellsInRow{ 0 }; ///< number of currently active cells in each row. Used for checking whether row is full.
@@ -167,6 +413,13 @@ private:
     bool _gameOver{ false }; ///< indicating whether game is terminated
     uint8_t _level{ 0 }; ///< player's current level
     uint16_t _lineClears{ 0 }; ///< player's current number of cleared rows
+    RandomGenerator _generator{}; ///< random number generator for new falling shapes
+    uint32_t _lockCount{ 0 }; ///< number of shapes which have settled
+    Gravity _gravityProgress{ 0 }; ///< fraction of a row the falling shape has moved down, see advance_frame()
+    LockEvent _lastLock{}; ///< the most recent lock
+    std::array<CellState, height * width> _frame{ 0 }; ///< composited cell states, see get_frame()
+    Falling _framedFalling{0, (width - 1) / 2, SHAPE_L }; ///< the falling shape as contained in _frame
+    uint32_t _frameVersion{ 0 }; ///< number of changes of the composited frame
 };
 
 #include "gameboard.hpp"
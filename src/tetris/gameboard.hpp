@@ -2,32 +2,45 @@
 
 template<SizeType height, SizeType width>
 GameBoard<height, width>::GameBoard()
+: GameBoard(static_cast<uint32_t>(time(NULL)))
+{}
+
+template<SizeType height, SizeType width>
+constexpr GameBoard<height, width>::GameBoard(const uint32_t seed)
+: _generator{seed}
 {
     // make sure that even the first shape falling down is random
     generate_new_falling();
     generate_new_falling();
+    update_frame(true);
 }
 
 template<SizeType height, SizeType width>
-uint8_t GameBoard<height, width>::get_level() const
+constexpr uint8_t GameBoard<height, width>::get_level() const
 {
     return _level;
 }
 
 template<SizeType height, SizeType width>
-uint16_t GameBoard<height, width>::get_line_clears() const
+constexpr uint16_t GameBoard<height, width>::get_line_clears() const
 {
     return _lineClears;
 }
 
 template<SizeType height, SizeType width>
-uint8_t GameBoard<height, width>::get_update_cycle_threshold() const
+constexpr uint8_t GameBoard<height, width>::get_update_cycle_threshold() const
+{
+    return UPDATE_CYCLE_THRESHOLDS[get_level()];
+}
+
+template<SizeType height, SizeType width>
+constexpr Gravity GameBoard<height, width>::get_gravity() const
 {
-    return static_cast<uint8_t>(59.0 * pow(0.8, get_level()) + 1);
+    return GRAVITY_TABLE[get_level()];
 }
 
 template<SizeType height, SizeType width>
-CellState GameBoard<height, width>::get_cell_state(const SizeType i, const SizeType j) const
+constexpr CellState GameBoard<height, width>::get_cell_state(const SizeType i, const SizeType j) const
 {
     // The current game board cell's state is dependent on whether a falling shape or a landed state is present
     CellState state = ((get_landed_state(i, j) | get_falling_state(i, j)));
@@ -35,109 +48,561 @@ CellState GameBoard<height, width>::get_cell_state(const SizeType i, const SizeT
 }
 
 template<SizeType height, SizeType width>
-Falling GameBoard<height, width>::get_next_falling() const
+constexpr const std::array<CellState, height * width>& GameBoard<height, width>::get_frame() const
+{
+    return _frame;
+}
+
+template<SizeType height, SizeType width>
+constexpr uint32_t GameBoard<height, width>::get_frame_version() const
+{
+    return _frameVersion;
+}
+
+template<SizeType height, SizeType width>
+constexpr Falling GameBoard<height, width>::get_next_falling() const
 {
     return _nextFalling;
 }
 
 template<SizeType height, SizeType width>
-bool GameBoard<height, width>::is_game_over() const
+constexpr Falling GameBoard<height, width>::get_current_falling() const
+{
+    return _currentFalling;
+}
+
+template<SizeType height, SizeType width>
+constexpr BoardState<height, width> GameBoard<height, width>::get_board_state() const
+{
+    BoardState<height, width> boardState;
+    for (SizeType i = 0; i < height; ++i)
+    {
+        for (SizeType j = 0; j < width; ++j)
+        {
+            boardState.set_occupied(i, j, get_landed_state(i, j) != 0);
+        }
+    }
+    return boardState;
+}
+
+template<SizeType height, SizeType width>
+constexpr uint32_t GameBoard<height, width>::get_lock_count() const
+{
+    return _lockCount;
+}
+
+template<SizeType height, SizeType width>
+constexpr const LockEvent& GameBoard<height, width>::get_last_lock() const
+{
+    return _lastLock;
+}
+
+template<SizeType height, SizeType width>
+constexpr bool GameBoard<height, width>::is_game_over() const
 {
     return _gameOver;
 }
 
 template<SizeType height, SizeType width>
-void GameBoard<height, width>::move_left_if_valid()
+constexpr void GameBoard<height, width>::move_left_if_valid()
 {
+    const TraceMark traceMark = trace_begin();
     // Move and check if new position is valid. Otherwise, undo move.
     _currentFalling.move_left();
     if (!falling_has_valid_position())
     {
         _currentFalling.move_right();
     }
+    else
+    {
+        update_frame(false);
+    }
+    trace_end(traceMark, "GameBoard::move_left_if_valid");
     return;
 }
 
 template<SizeType height, SizeType width>
-void GameBoard<height, width>::move_right_if_valid()
+constexpr void GameBoard<height, width>::move_right_if_valid()
 {
+    const TraceMark traceMark = trace_begin();
     // Move and check if new position is valid. Otherwise, undo move.
     _currentFalling.move_right();
     if (!falling_has_valid_position())
     {
         _currentFalling.move_left();
     }
+    else
+    {
+        update_frame(false);
+    }
+    trace_end(traceMark, "GameBoard::move_right_if_valid");
     return;
 }
 
 template<SizeType height, SizeType width>
-void GameBoard<height, width>::move_down_if_valid()
+constexpr void GameBoard<height, width>::move_down_if_valid()
 {
+    const TraceMark traceMark = trace_begin();
     // Move and check if new position is valid. Otherwise, undo move.
     _currentFalling.move_down();
     if (!falling_has_valid_position())
     {
         _currentFalling.move_up();
     }
+    else
+    {
+        update_frame(false);
+    }
+    trace_end(traceMark, "GameBoard::move_down_if_valid");
     return;
 }
 
 template<SizeType height, SizeType width>
-void GameBoard<height, width>::rotate_clockwise_if_valid()
+constexpr void GameBoard<height, width>::rotate_clockwise_if_valid()
 {
+    const TraceMark traceMark = trace_begin();
     // Rotates and check if new position is valid. Otherwise, undo rotation.
     _currentFalling.rotate_clockwise();
     if (!falling_has_valid_position())
     {
         _currentFalling.rotate_counterclockwise();
     }
+    else
+    {
+        update_frame(false);
+    }
+    trace_end(traceMark, "GameBoard::rotate_clockwise_if_valid");
     return;
 }
 
 template<SizeType height, SizeType width>
-void GameBoard<height, width>::rotate_counterclockwise_if_valid()
+constexpr void GameBoard<height, width>::rotate_counterclockwise_if_valid()
 {
+    const TraceMark traceMark = trace_begin();
     // Rotates and check if new position is valid. Otherwise, undo rotation.
     _currentFalling.rotate_counterclockwise();
     if (!falling_has_valid_position())
     {
         _currentFalling.rotate_clockwise();
     }
+    else
+    {
+        update_frame(false);
+    }
+    trace_end(traceMark, "GameBoard::rotate_counterclockwise_if_valid");
+    return;
+}
+
+template<SizeType height, SizeType width>
+constexpr void GameBoard<height, width>::hard_drop()
+{
+    const TraceMark traceMark = trace_begin();
+    // Move down until the position becomes invalid, then undo the last move and settle
+    do
+    {
+        _currentFalling.move_down();
+    } while (falling_has_valid_position());
+    _currentFalling.move_up();
+
+    convert_falling_to_landed();
+    generate_new_falling();
+    update_frame(true);
+    trace_end(traceMark, "GameBoard::hard_drop");
+    return;
 }
 
 template<SizeType height, SizeType width>
-void GameBoard<height, width>::update()
+constexpr void GameBoard<height, width>::update()
 {
+    const TraceMark traceMark = trace_begin();
     // Adjust current level. After 10 cleared rows, the level increases by 1.
     _level = get_line_clears() / 10;
 
     // Move and check if new position is valid. Otherwise, undo move, settle and generate new falling shape.
     _currentFalling.move_down();
-    if (!falling_has_valid_position())
+    const bool settled = !falling_has_valid_position();
+    if (settled)
     {
         _currentFalling.move_up();
         convert_falling_to_landed();
         generate_new_falling();
     }
+    update_frame(settled);
+    trace_end(traceMark, "GameBoard::update");
+    return;
+}
+
+template<SizeType height, SizeType width>
+constexpr void GameBoard<height, width>::advance_frame()
+{
+    if (_gameOver)
+    {
+        return;
+    }
+
+    // Adjust current level. After 10 cleared rows, the level increases by 1.
+    _level = get_line_clears() / 10;
+
+    _gravityProgress += get_gravity();
+    const Gravity rows = _gravityProgress >> GRAVITY_FRACTION_BITS;
+    _gravityProgress &= GRAVITY_ONE_ROW - 1;
+    if (rows == 0)
+    {
+        return;
+    }
+
+    // only frames which move the shape are traced, the others merely add to the progress
+    const TraceMark traceMark = trace_begin();
+
+    // every row of progress moves the shape down, the first one beyond its resting position lets it settle
+    const SizeType dropDistance = get_drop_distance();
+    const bool settled = rows > static_cast<Gravity>(dropDistance);
+    for (SizeType row = settled ? dropDistance : static_cast<SizeType>(rows); row > 0; --row)
+    {
+        _currentFalling.move_down();
+    }
+    if (settled)
+    {
+        convert_falling_to_landed();
+        generate_new_falling();
+    }
+    update_frame(settled);
+    trace_end(traceMark, "GameBoard::advance_frame");
+    return;
+}
+
+template<SizeType height, SizeType width>
+constexpr uint32_t GameBoard<height, width>::get_frames_until_drop() const
+{
+    // the level used by the next frame, which may lag behind if the last lock cleared rows
+    const Gravity gravity = GRAVITY_TABLE[static_cast<uint8_t>(get_line_clears() / 10)];
+    return (GRAVITY_ONE_ROW - _gravityProgress + gravity - 1) / gravity;
+}
+
+template<SizeType height, SizeType width>
+constexpr typename GameBoard<height, width>::UndoRecord GameBoard<height, width>::make_move(const Placement &placement)
+{
+    const TraceMark traceMark = trace_begin();
+    UndoRecord record{};
+    record.currentFalling = record_falling(_currentFalling);
+    record.nextFalling = record_falling(_nextFalling);
+    record.lastLock = _lastLock;
+    record.generatorState = _generator.get_state();
+    record.lineClears = _lineClears;
+    record.gameOver = _gameOver;
+
+    _currentFalling = make_falling(placement.row, placement.column, placement.shapeType, placement.rotation,
+                                   _currentFalling.get_state_type());
+    record.placed = record_falling(_currentFalling);
+
+    // save the rows which are going to be cleared. Rows are cleared from the top down, which does not move
+    // the rows below, so their indices stay valid
+    for (SizeType i = _currentFalling.get_upper_left_h(); i <= _currentFalling.get_lower_right_h(); ++i)
+    {
+        SizeType occupiedCells = _cellsInRow[i];
+        for (SizeType j = _currentFalling.get_upper_left_w(); j <= _currentFalling.get_lower_right_w(); ++j)
+        {
+            occupiedCells += (get_falling_state(i, j) != 0);
+        }
+        if (occupiedCells == width)
+        {
+            for (SizeType j = 0; j < width; ++j)
+            {
+                record.clearedCells[record.clearedRowCount][j] = get_cell_state(i, j);
+            }
+            record.clearedRows[record.clearedRowCount++] = i;
+        }
+    }
+
+    convert_falling_to_landed();
+    generate_new_falling();
+    update_frame(true);
+    trace_end(traceMark, "GameBoard::make_move");
+    return record;
+}
+
+template<SizeType height, SizeType width>
+constexpr void GameBoard<height, width>::unmake_move(const UndoRecord &record)
+{
+    const TraceMark traceMark = trace_begin();
+    // re-insert the cleared rows in reverse order by shifting the rows above them up again
+    for (int c = record.clearedRowCount - 1; c >= 0; --c)
+    {
+        const SizeType row = record.clearedRows[c];
+        for (int cell = 0; cell < row * width; ++cell)
+        {
+            _landedBlocks[cell] = _landedBlocks[cell + width];
+        }
+        for (SizeType i = 0; i < row; ++i)
+        {
+            _cellsInRow[i] = _cellsInRow[i + 1];
+        }
+        for (SizeType j = 0; j < width; ++j)
+        {
+            _landedBlocks[row * width + j] = record.clearedCells[c][j];
+        }
+        _cellsInRow[row] = width;
+    }
+
+    // remove the placed shape
+    const Falling placed = restore_falling(record.placed);
+    for (SizeType i = placed.get_upper_left_h(); i <= placed.get_lower_right_h(); ++i)
+    {
+        for (SizeType j = placed.get_upper_left_w(); j <= placed.get_lower_right_w(); ++j)
+        {
+            if (placed.get_cell_state_on_board(i, j) != 0)
+            {
+                set_landed_cell_state(i, j, 0);
+                --_cellsInRow[i];
+            }
+        }
+    }
+
+    _currentFalling = restore_falling(record.currentFalling);
+    _nextFalling = restore_falling(record.nextFalling);
+    _lastLock = record.lastLock;
+    _lockCount = record.lastLock.index;
+    _generator.set_state(record.generatorState);
+    _lineClears = record.lineClears;
+    _gameOver = record.gameOver;
+    update_frame(true);
+    trace_end(traceMark, "GameBoard::unmake_move");
     return;
 }
 
+template<SizeType height, SizeType width>
+constexpr bool GameBoard<height, width>::replay_lock(const LockEvent &lock)
+{
+    if (_gameOver || lock.index != _lockCount + 1 || lock.shapeType != _currentFalling.get_shape_type()
+        || lock.rotation > ROT_270)
+    {
+        return false;
+    }
+
+    // the shape must fit in the recorded position and must not be able to fall any further
+    const Falling previousFalling = _currentFalling;
+    _currentFalling = make_falling(lock.row, lock.column, lock.shapeType, lock.rotation, previousFalling.get_state_type());
+    bool resting = falling_has_valid_position();
+    if (resting)
+    {
+        _currentFalling.move_down();
+        resting = !falling_has_valid_position();
+        _currentFalling.move_up();
+    }
+    if (!resting)
+    {
+        _currentFalling = previousFalling;
+        return false;
+    }
+
+    // the level is only adjusted by update(), so the recorded game may have been lagging behind its line clears
+    _level = lock.level;
+    convert_falling_to_landed();
+    generate_new_falling();
+    update_frame(true);
+    return true;
+}
+
+template<SizeType height, SizeType width>
+constexpr typename GameBoard<height, width>::SerializedState GameBoard<height, width>::serialize() const
+{
+    SerializedState state{};
+    std::size_t offset = 0;
+
+    const auto put = [&state, &offset](const uint32_t value, const std::size_t bytes)
+    {
+        for (std::size_t b = 0; b < bytes; ++b)
+        {
+            state[offset++] = static_cast<uint8_t>(value >> (8 * b));
+        }
+    };
+    const auto putFalling = [&put](const Falling &falling)
+    {
+        put(static_cast<uint8_t>(falling.get_upper_left_h()), 1);
+        put(static_cast<uint8_t>(falling.get_upper_left_w()), 1);
+        put(falling.get_shape_type(), 1);
+        put(falling.get_rotation(), 1);
+        put(falling.get_state_type(), 1);
+    };
+
+    put(SERIALIZATION_VERSION, 1);
+    put(static_cast<uint8_t>(height), 1);
+    put(static_cast<uint8_t>(width), 1);
+    for (const CellState cellState : _landedBlocks)
+    {
+        put(cellState, 1);
+    }
+    for (const SizeType cellCount : _cellsInRow)
+    {
+        put(static_cast<uint8_t>(cellCount), 1);
+    }
+    putFalling(_currentFalling);
+    putFalling(_nextFalling);
+    put(_gameOver, 1);
+    put(_level, 1);
+    put(_lineClears, 2);
+    put(_generator.get_state(), 4);
+    put(_lockCount, 4);
+    put(_gravityProgress, 4);
+    return state;
+}
+
+template<SizeType height, SizeType width>
+constexpr bool GameBoard<height, width>::deserialize(const SerializedState &state)
+{
+    std::size_t offset = 0;
+
+    const auto get = [&state, &offset](const std::size_t bytes)
+    {
+        uint32_t value = 0;
+        for (std::size_t b = 0; b < bytes; ++b)
+        {
+            value |= uint32_t{state[offset++]} << (8 * b);
+        }
+        return value;
+    };
+    const auto getFalling = [&get](Falling &falling)
+    {
+        const SizeType row = static_cast<SizeType>(get(1));
+        const SizeType column = static_cast<SizeType>(get(1));
+        const uint32_t shapeType = get(1);
+        const uint32_t rotation = get(1);
+        const uint32_t stateType = get(1);
+        if (shapeType >= _SHAPE_COUNT || rotation > ROT_270 || stateType == 0)
+        {
+            return false;
+        }
+        falling = make_falling(row, column, static_cast<ShapeType>(shapeType), static_cast<Rotation>(rotation),
+                               static_cast<CellState>(stateType));
+        return 0 <= falling.get_upper_left_h() && 0 <= falling.get_upper_left_w()
+               && falling.get_lower_right_h() < height && falling.get_lower_right_w() < width;
+    };
+
+    if (get(1) != SERIALIZATION_VERSION || get(1) != static_cast<uint8_t>(height) || get(1) != static_cast<uint8_t>(width))
+    {
+        return false;
+    }
+
+    // decode into a copy, so this game board stays unchanged if the state turns out to be invalid
+    GameBoard restored = *this;
+    for (CellState &cellState : restored._landedBlocks)
+    {
+        cellState = static_cast<CellState>(get(1));
+    }
+    for (SizeType i = 0; i < height; ++i)
+    {
+        SizeType occupiedCells = 0;
+        for (SizeType j = 0; j < width; ++j)
+        {
+            occupiedCells += (restored.get_landed_state(i, j) != 0);
+        }
+
+        // full rows are cleared immediately, so they cannot occur in a valid state
+        restored._cellsInRow[i] = static_cast<SizeType>(get(1));
+        if (restored._cellsInRow[i] != occupiedCells || occupiedCells == width)
+        {
+            return false;
+        }
+    }
+    if (!getFalling(restored._currentFalling) || !getFalling(restored._nextFalling))
+    {
+        return false;
+    }
+
+    const uint32_t gameOver = get(1);
+    restored._gameOver = (gameOver != 0);
+    restored._level = static_cast<uint8_t>(get(1));
+    restored._lineClears = static_cast<uint16_t>(get(2));
+    const uint32_t generatorState = get(4);
+    restored._generator.set_state(generatorState);
+    restored._lockCount = get(4);
+    restored._gravityProgress = get(4);
+
+    // a falling shape may only overlap landed blocks if it has ended the game
+    if (gameOver > 1 || generatorState == 0 || generatorState >= RandomGenerator::MODULUS
+        || restored._gravityProgress >= GRAVITY_ONE_ROW
+        || (!restored._gameOver && !restored.falling_has_valid_position()))
+    {
+        return false;
+    }
+
+    restored._lastLock = LockEvent{};
+    restored._lastLock.index = restored._lockCount;
+    restored._framedFalling = restored._currentFalling;
+    restored.update_frame(true);
+    *this = restored;
+    return true;
+}
+
 // private:
 
 template<SizeType height, SizeType width>
-CellState GameBoard<height, width>::get_landed_state(const SizeType i, const SizeType j) const
+constexpr CellState GameBoard<height, width>::get_landed_state(const SizeType i, const SizeType j) const
 {
     return (_landedBlocks[i * width + j]);
 }
 
 template<SizeType height, SizeType width>
-CellState GameBoard<height, width>::get_falling_state(const SizeType i, const SizeType j) const
+constexpr CellState GameBoard<height, width>::get_falling_state(const SizeType i, const SizeType j) const
 {
     return _currentFalling.get_cell_state_on_board(i, j);
 }
 
 template<SizeType height, SizeType width>
-bool GameBoard<height, width>::falling_has_valid_position() const
+constexpr void GameBoard<height, width>::update_frame(const bool landedChanged)
+{
+    if (landedChanged)
+    {
+        _frame = _landedBlocks;
+    }
+    else // remove the previously falling shape
+    {
+        for (SizeType i = _framedFalling.get_upper_left_h(); i <= _framedFalling.get_lower_right_h(); ++i)
+        {
+            for (SizeType j = _framedFalling.get_upper_left_w(); j <= _framedFalling.get_lower_right_w(); ++j)
+            {
+                _frame[i * width + j] = get_landed_state(i, j);
+            }
+        }
+    }
+
+    for (SizeType i = _currentFalling.get_upper_left_h(); i <= _currentFalling.get_lower_right_h(); ++i)
+    {
+        for (SizeType j = _currentFalling.get_upper_left_w(); j <= _currentFalling.get_lower_right_w(); ++j)
+        {
+            _frame[i * width + j] |= get_falling_state(i, j);
+        }
+    }
+    _framedFalling = _currentFalling;
+    ++_frameVersion;
+    return;
+}
+
+template<SizeType height, SizeType width>
+constexpr SizeType GameBoard<height, width>::get_drop_distance() const
+{
+    // the columns of every shape are contiguous, so only the cells below the lowest cell of each column matter
+    SizeType distance = height;
+    for (SizeType j = _currentFalling.get_upper_left_w(); j <= _currentFalling.get_lower_right_w(); ++j)
+    {
+        SizeType lowest = _currentFalling.get_lower_right_h();
+        while (get_falling_state(lowest, j) == 0)
+        {
+            --lowest;
+        }
+
+        SizeType free = 0;
+        while (lowest + free + 1 < height && free < distance && get_landed_state(lowest + free + 1, j) == 0)
+        {
+            ++free;
+        }
+        distance = (free < distance) ? free : distance;
+    }
+    return distance;
+}
+
+template<SizeType height, SizeType width>
+constexpr bool GameBoard<height, width>::falling_has_valid_position() const
 {
     if (_currentFalling.get_upper_left_h() < 0 || _currentFalling.get_upper_left_w() < 0 // upper left corner is outside game board boundaries
         || _currentFalling.get_lower_right_h() >= height || _currentFalling.get_lower_right_w() >= width) // lower right corner is outside boundaries
@@ -162,15 +627,20 @@ bool GameBoard<height, width>::falling_has_valid_position() const
 }
 
 template<SizeType height, SizeType width>
-void GameBoard<height, width>::set_landed_cell_state(const SizeType i, const SizeType j, const CellState cellState)
+constexpr void GameBoard<height, width>::set_landed_cell_state(const SizeType i, const SizeType j, const CellState cellState)
 {
     _landedBlocks[i * width + j] = cellState;
     return;
 }
 
 template<SizeType height, SizeType width>
-void GameBoard<height, width>::convert_falling_to_landed()
+constexpr void GameBoard<height, width>::convert_falling_to_landed()
 {
+    const TraceMark traceMark = trace_begin();
+    ++_lockCount;
+    _lastLock = LockEvent{_lockCount, _currentFalling.get_shape_type(), _currentFalling.get_rotation(),
+                          _currentFalling.get_upper_left_h(), _currentFalling.get_upper_left_w(), _level};
+
     for (SizeType h = _currentFalling.get_upper_left_h(); h <= _currentFalling.get_lower_right_h(); ++h)
     {
         for (SizeType w = _currentFalling.get_upper_left_w(); w <= _currentFalling.get_lower_right_w(); ++w)
@@ -187,39 +657,75 @@ void GameBoard<height, width>::convert_falling_to_landed()
             clear_row(h);
         }
     }
+    trace_end(traceMark, "GameBoard::convert_falling_to_landed");
     return;
 }
 
 template<SizeType height, SizeType width>
-void GameBoard<height, width>::clear_row(const SizeType row)
+constexpr void GameBoard<height, width>::clear_row(const SizeType row)
 {
-    // shift all cells above the one to be deleted one down (or do nothing in case the uppermost row is full)
-    std::move(_landedBlocks.begin(), _landedBlocks.begin() + row * width,
-              _landedBlocks.begin() + width);
+    const TraceMark traceMark = trace_begin();
+    // shift all cells above the one to be deleted one down (or do nothing in case the uppermost row is full).
+    // Iterate from the bottom up, since source and destination overlap
+    for (int cell = row * width - 1; cell >= 0; --cell)
+    {
+        _landedBlocks[cell + width] = _landedBlocks[cell];
+    }
     // update number of active cells for the shifted rows
-    std::move(_cellsInRow.begin(), _cellsInRow.begin() + row,
-              _cellsInRow.begin() + 1);
+    for (SizeType i = row - 1; i >= 0; --i)
+    {
+        _cellsInRow[i + 1] = _cellsInRow[i];
+    }
 
     // the most upper row has 0 active cells now
-    std::fill(_landedBlocks.begin(), _landedBlocks.begin() + width, 0);
+    for (SizeType j = 0; j < width; ++j)
+    {
+        _landedBlocks[j] = 0;
+    }
     _cellsInRow[0] = 0;
 
     ++_lineClears; // increase number of cleared lines
+    trace_end(traceMark, "GameBoard::clear_row");
     return;
 }
 
 template<SizeType height, SizeType width>
-void GameBoard<height, width>::generate_new_falling()
+constexpr typename GameBoard<height, width>::FallingRecord GameBoard<height, width>::record_falling(const Falling &falling)
+{
+    return FallingRecord{falling.get_upper_left_h(), falling.get_upper_left_w(), falling.get_shape_type(),
+                         falling.get_rotation(), falling.get_state_type()};
+}
+
+template<SizeType height, SizeType width>
+constexpr Falling GameBoard<height, width>::restore_falling(const FallingRecord &record)
+{
+    return make_falling(record.row, record.column, record.shapeType, record.rotation, record.stateType);
+}
+
+template<SizeType height, SizeType width>
+constexpr Falling GameBoard<height, width>::make_falling(const SizeType row, const SizeType column,
+                                                         const ShapeType shapeType, const Rotation rotation,
+                                                         const CellState stateType)
 {
-    static const time_t seed = time(NULL); // generate static seed
-    static std::default_random_engine generator(seed);
-    static std::uniform_int_distribution<int> distribution(0,255); // uniform distribution for shape and cell state generation
+    // rotations keep the upper left corner in place
+    Falling falling(row, column, shapeType, stateType);
+    for (uint8_t r = ROT_0; r < rotation; ++r)
+    {
+        falling.rotate_clockwise();
+    }
+    return falling;
+}
 
-    const int randomShapeNumber = distribution(generator);
-    const int randomCellState = distribution(generator);
+template<SizeType height, SizeType width>
+constexpr void GameBoard<height, width>::generate_new_falling()
+{
+    const TraceMark traceMark = trace_begin();
+    // uniformly distributed numbers between 0 and 255 for shape and cell state generation
+    const int randomShapeNumber = _generator() % 256;
+    const int randomCellState = _generator() % 256;
 
     ShapeType shape = static_cast<ShapeType>(randomShapeNumber % _SHAPE_COUNT);
-    CellState stateType = randomCellState;
+    CellState stateType = 1 + randomCellState % 255; // a cell state of 0 would make the shape invisible and intangible
 
     // place previous _nextFalling shape on top of game board
     _currentFalling = _nextFalling;
@@ -232,5 +738,6 @@ void GameBoard<height, width>::generate_new_falling()
     {
         _gameOver = true;
     }
+    trace_end(traceMark, "GameBoard::generate_new_falling");
     return;
 }
\ No newline at end of file
@@ -0,0 +1,40 @@
+#ifndef GRAVITY_H_
+#define GRAVITY_H_
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+
+constexpr std::size_t LEVEL_COUNT{256}; ///< Number of representable levels.
+
+using Frames = std::chrono::duration<int64_t, std::ratio<1, 60>>; ///< Game cycles, of which there are 60 per second.
+
+using UpdateCycleThresholdTable = std::array<uint8_t, LEVEL_COUNT>;
+
+/*
+ * Computes the update cycle threshold of every level, i.e. the number of frames after which the falling shape
+ * moves down by one unit. The threshold is 59 * 0.8^level + 1, truncated.
+ * The table is evaluated at compile time and available as UPDATE_CYCLE_THRESHOLDS, so no floating point
+ * arithmetic is necessary while playing.
+ */
+constexpr UpdateCycleThresholdTable build_update_cycle_threshold_table();
+
+using Gravity = uint32_t; ///< Falling speed in rows per frame, as fixed-point number with GRAVITY_FRACTION_BITS fractional bits.
+
+constexpr uint8_t GRAVITY_FRACTION_BITS{16}; ///< Number of fractional bits of Gravity.
+constexpr Gravity GRAVITY_ONE_ROW{Gravity{1} << GRAVITY_FRACTION_BITS}; ///< One row per frame (1G).
+constexpr Gravity MAX_GRAVITY{20 * GRAVITY_ONE_ROW}; ///< 20 rows per frame (20G), i.e. shapes drop instantly.
+
+using GravityTable = std::array<Gravity, LEVEL_COUNT>;
+
+/*
+ * Computes the gravity of every level, i.e. the distance the falling shape moves down per frame.
+ * A shape needs 60 * 0.8^level frames per row, which agrees with the update cycle thresholds at low levels,
+ * but keeps accelerating beyond one row per frame until it is capped at MAX_GRAVITY.
+ * Values are rounded up, so a shape never falls slower than the formula demands.
+ * The table is evaluated at compile time and available as GRAVITY_TABLE.
+ */
+constexpr GravityTable build_gravity_table();
+
+#include "gravity.hpp"
+#endif /* GRAVITY_H_ */
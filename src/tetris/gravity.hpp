@@ -0,0 +1,29 @@
+constexpr UpdateCycleThresholdTable build_update_cycle_threshold_table()
+{
+    UpdateCycleThresholdTable table{};
+    double factor = 1.0; // 0.8^level
+    for (std::size_t level = 0; level < LEVEL_COUNT; ++level)
+    {
+        table[level] = static_cast<uint8_t>(59.0 * factor + 1);
+        factor *= 0.8;
+    }
+    return table;
+}
+
+constexpr UpdateCycleThresholdTable UPDATE_CYCLE_THRESHOLDS = build_update_cycle_threshold_table(); ///< Thresholds of all levels.
+
+constexpr GravityTable build_gravity_table()
+{
+    GravityTable table{};
+    double framesPerRow = 60.0; // 60 * 0.8^level
+    for (std::size_t level = 0; level < LEVEL_COUNT; ++level)
+    {
+        const double gravity = GRAVITY_ONE_ROW / framesPerRow;
+        const Gravity truncated = (gravity < MAX_GRAVITY) ? static_cast<Gravity>(gravity) : MAX_GRAVITY;
+        table[level] = (truncated < gravity && truncated < MAX_GRAVITY) ? truncated + 1 : truncated;
+        framesPerRow *= 0.8;
+    }
+    return table;
+}
+
+constexpr GravityTable GRAVITY_TABLE = build_gravity_table(); ///< Gravity of all levels.
@@ -0,0 +1,151 @@
+#ifndef LANE_ENGINE_H_
+#define LANE_ENGINE_H_
+
+#include "board_state.h"
+#include "placement.h"
+#include "random.h"
+
+using LaneMask = uint32_t; ///< Set of lanes of a LaneEngine. Bit l is set if lane l belongs to the set.
+
+/*
+ * Engine which plays many games in lockstep, one per lane.
+ * Every game follows exactly the rules of GameBoard: seeded with the same value, a lane produces the same
+ * sequence of shapes, the same landed blocks, line clears, levels and game over as a GameBoard receiving the
+ * same calls. Only occupancy is stored, cell states (i.e. colours) are not.
+ *
+ * The state is stored as a structure of arrays: row i of all boards is a contiguous array with one packed row
+ * per lane, and so are the positions, rotations and shapes of the falling shapes. Every operation takes a mask
+ * of the lanes it applies to and processes all lanes in one loop with the same steps, so the compiler can
+ * vectorise it. Lanes whose game is over ignore all operations until they are reset.
+ */
+template<SizeType height, SizeType width, std::size_t lanes>
+class LaneEngine
+{
+    static_assert(0 < lanes && lanes <= 32, "ERROR: Lane engines support 1 to 32 lanes.");
+
+public:
+    using RowType = typename BoardState<height, width>::RowType; ///< Packed occupancy of a row.
+
+    static constexpr LaneMask ALL_LANES = static_cast<LaneMask>((uint64_t{1} << lanes) - 1); ///< Mask of all lanes.
+
+    /*
+     * Constructor. Starts a new game in every lane.
+     *
+     * @param[in] seeds seed of each lane, see GameBoard(const uint32_t)
+     */
+    constexpr explicit LaneEngine(const std::array<uint32_t, lanes> &seeds);
+
+    /*
+     * Default destructor.
+     */
+    ~LaneEngine() = default;
+
+    /*
+     * Starts a new game in a lane.
+     *
+     * @param[in] lane lane index
+     * @param[in] seed seed of the new game
+     */
+    constexpr void reset_lane(const std::size_t lane, const uint32_t seed);
+
+    /*
+     * Returns the lanes whose game is over.
+     */
+    constexpr LaneMask get_game_over_mask() const;
+
+    /*
+     * Returns the occupancy of the landed blocks of a lane.
+     */
+    constexpr BoardState<height, width> get_board_state(const std::size_t lane) const;
+
+    /*
+     * Returns the type of the currently falling shape of a lane.
+     */
+    constexpr ShapeType get_shape_type(const std::size_t lane) const;
+
+    /*
+     * Returns the type of the shape falling after the current one in a lane.
+     */
+    constexpr ShapeType get_next_shape_type(const std::size_t lane) const;
+
+    /*
+     * Returns the currently falling shape of a lane as a placement, i.e. its shape type, rotation and
+     * upper left corner.
+     */
+    constexpr Placement get_falling(const std::size_t lane) const;
+
+    /*
+     * Returns the player's current level in a lane, see GameBoard::get_level().
+     */
+    constexpr uint8_t get_level(const std::size_t lane) const;
+
+    /*
+     * Returns the number of cleared rows in a lane.
+     */
+    constexpr uint16_t get_line_clears(const std::size_t lane) const;
+
+    /*
+     * Counterparts of the GameBoard controls. Each one applies to the given lanes whose game is not over.
+     *
+     * @param[in] mask lanes to apply the control to
+     */
+    constexpr void move_left_if_valid(const LaneMask mask);
+    constexpr void move_right_if_valid(const LaneMask mask);
+    constexpr void move_down_if_valid(const LaneMask mask);
+    constexpr void rotate_clockwise_if_valid(const LaneMask mask);
+    constexpr void rotate_counterclockwise_if_valid(const LaneMask mask);
+    constexpr void hard_drop(const LaneMask mask);
+    constexpr void update(const LaneMask mask);
+
+    /*
+     * Counterpart of apply_placement(). Puts the falling shapes of the given lanes directly into the rotation
+     * and column of their placements and drops them, which leads to the same result as driving them there
+     * with the controls. The placements must have been generated for the current shapes at the spawn
+     * position, see generate_placements().
+     *
+     * @param[in] placements placement of every lane, ignored for lanes outside the mask
+     * @param[in] mask lanes to apply the placements to
+     */
+    constexpr void apply_placements(const std::array<Placement, lanes> &placements, const LaneMask mask);
+
+private:
+    /*
+     * Determines whether the falling shape of a lane fits with the given rotation and upper left corner.
+     */
+    constexpr bool fits(const std::size_t lane, const Rotation rotation, const SizeType row, const SizeType column) const;
+
+    /*
+     * Moves and rotates the falling shapes of the given lanes, keeping the old position where the new one
+     * does not fit.
+     */
+    constexpr void move_if_valid(const LaneMask mask, const SizeType rowOffset, const SizeType columnOffset,
+                                 const uint8_t rotationOffset);
+
+    /*
+     * Adds the falling shape of a lane to its landed blocks, clears full rows and lets the next shape fall.
+     */
+    constexpr void settle(const std::size_t lane);
+
+    /*
+     * Lets the next shape of a lane start falling and draws a new next shape, consuming random numbers like
+     * GameBoard::generate_new_falling(). The game of the lane is over if the new falling shape does not fit.
+     */
+    constexpr void generate_new_falling(const std::size_t lane);
+
+private:
+    // the rows below the board are full and act as the floor
+    std::array<std::array<RowType, lanes>, height + MAX_PIECE_EXTENT> _rows{}; ///< packed rows of every lane
+    std::array<ShapeType, lanes> _shapeTypes{}; ///< type of the falling shape of every lane
+    std::array<ShapeType, lanes> _nextShapeTypes{}; ///< type of the next shape of every lane
+    std::array<Rotation, lanes> _rotations{}; ///< rotation of the falling shape of every lane
+    std::array<SizeType, lanes> _fallingRows{}; ///< upper row of the falling shape of every lane
+    std::array<SizeType, lanes> _fallingColumns{}; ///< left column of the falling shape of every lane
+    std::array<SizeType, lanes> _stackTops{}; ///< row of every lane above which all rows are empty
+    std::array<RandomGenerator, lanes> _generators; ///< random number generator of every lane
+    std::array<uint16_t, lanes> _lineClears{}; ///< number of cleared rows of every lane
+    std::array<uint8_t, lanes> _levels{}; ///< level of every lane
+    LaneMask _gameOver{0}; ///< lanes whose game is over
+};
+
+#include "lane_engine.hpp"
+#endif /* LANE_ENGINE_H_ */
@@ -0,0 +1,304 @@
+// public:
+
+template<SizeType height, SizeType width, std::size_t lanes>
+constexpr LaneEngine<height, width, lanes>::LaneEngine(const std::array<uint32_t, lanes> &seeds)
+{
+    for (std::size_t l = 0; l < lanes; ++l)
+    {
+        reset_lane(l, seeds[l]);
+    }
+}
+
+template<SizeType height, SizeType width, std::size_t lanes>
+constexpr void LaneEngine<height, width, lanes>::reset_lane(const std::size_t lane, const uint32_t seed)
+{
+    for (SizeType i = 0; i < height; ++i)
+    {
+        _rows[i][lane] = 0;
+    }
+    for (SizeType i = height; i < height + MAX_PIECE_EXTENT; ++i)
+    {
+        _rows[i][lane] = BoardState<height, width>::FULL_ROW;
+    }
+    _generators[lane] = RandomGenerator(seed);
+    _nextShapeTypes[lane] = SHAPE_L;
+    _lineClears[lane] = 0;
+    _levels[lane] = 0;
+    _stackTops[lane] = height;
+    _gameOver &= ~(LaneMask{1} << lane);
+
+    // like the GameBoard constructor, make sure that even the first shape falling down is random
+    generate_new_falling(lane);
+    generate_new_falling(lane);
+    return;
+}
+
+template<SizeType height, SizeType width, std::size_t lanes>
+constexpr LaneMask LaneEngine<height, width, lanes>::get_game_over_mask() const
+{
+    return _gameOver;
+}
+
+template<SizeType height, SizeType width, std::size_t lanes>
+constexpr BoardState<height, width> LaneEngine<height, width, lanes>::get_board_state(const std::size_t lane) const
+{
+    BoardState<height, width> boardState;
+    for (SizeType i = 0; i < height; ++i)
+    {
+        boardState.set_row(i, _rows[i][lane]);
+    }
+    return boardState;
+}
+
+template<SizeType height, SizeType width, std::size_t lanes>
+constexpr ShapeType LaneEngine<height, width, lanes>::get_shape_type(const std::size_t lane) const
+{
+    return _shapeTypes[lane];
+}
+
+template<SizeType height, SizeType width, std::size_t lanes>
+constexpr ShapeType LaneEngine<height, width, lanes>::get_next_shape_type(const std::size_t lane) const
+{
+    return _nextShapeTypes[lane];
+}
+
+template<SizeType height, SizeType width, std::size_t lanes>
+constexpr Placement LaneEngine<height, width, lanes>::get_falling(const std::size_t lane) const
+{
+    return Placement{_shapeTypes[lane], _rotations[lane], _fallingRows[lane], _fallingColumns[lane]};
+}
+
+template<SizeType height, SizeType width, std::size_t lanes>
+constexpr uint8_t LaneEngine<height, width, lanes>::get_level(const std::size_t lane) const
+{
+    return _levels[lane];
+}
+
+template<SizeType height, SizeType width, std::size_t lanes>
+constexpr uint16_t LaneEngine<height, width, lanes>::get_line_clears(const std::size_t lane) const
+{
+    return _lineClears[lane];
+}
+
+template<SizeType height, SizeType width, std::size_t lanes>
+constexpr void LaneEngine<height, width, lanes>::move_left_if_valid(const LaneMask mask)
+{
+    move_if_valid(mask, 0, -1, 0);
+    return;
+}
+
+template<SizeType height, SizeType width, std::size_t lanes>
+constexpr void LaneEngine<height, width, lanes>::move_right_if_valid(const LaneMask mask)
+{
+    move_if_valid(mask, 0, 1, 0);
+    return;
+}
+
+template<SizeType height, SizeType width, std::size_t lanes>
+constexpr void LaneEngine<height, width, lanes>::move_down_if_valid(const LaneMask mask)
+{
+    move_if_valid(mask, 1, 0, 0);
+    return;
+}
+
+template<SizeType height, SizeType width, std::size_t lanes>
+constexpr void LaneEngine<height, width, lanes>::rotate_clockwise_if_valid(const LaneMask mask)
+{
+    move_if_valid(mask, 0, 0, 1);
+    return;
+}
+
+template<SizeType height, SizeType width, std::size_t lanes>
+constexpr void LaneEngine<height, width, lanes>::rotate_counterclockwise_if_valid(const LaneMask mask)
+{
+    move_if_valid(mask, 0, 0, ROTATION_COUNT - 1);
+    return;
+}
+
+template<SizeType height, SizeType width, std::size_t lanes>
+constexpr void LaneEngine<height, width, lanes>::hard_drop(const LaneMask mask)
+{
+    const LaneMask active = mask & ~_gameOver;
+
+    // every shape which is still above the stack can skip the empty rows at once
+    std::array<std::array<RowType, lanes>, MAX_PIECE_EXTENT> pieceRows{};
+    for (std::size_t l = 0; l < lanes; ++l)
+    {
+        const PieceMask &piece = get_piece_mask(_shapeTypes[l], _rotations[l]);
+        for (SizeType k = 0; k < MAX_PIECE_EXTENT; ++k)
+        {
+            pieceRows[k][l] = static_cast<RowType>(static_cast<RowType>(piece.rows[k]) << _fallingColumns[l]);
+        }
+        const SizeType aboveStack = _stackTops[l] - piece.height;
+        _fallingRows[l] = ((active >> l) & 1u) ? std::max(_fallingRows[l], aboveStack) : _fallingRows[l];
+    }
+
+    // all lanes move down one row per iteration until the last one has come to rest. The full rows below
+    // the board stop every shape at the floor, so no bounds need to be tested
+    LaneMask falling = active;
+    while (falling != 0)
+    {
+        for (std::size_t l = 0; l < lanes; ++l)
+        {
+            RowType overlap = 0;
+            for (SizeType k = 0; k < MAX_PIECE_EXTENT; ++k)
+            {
+                overlap |= _rows[_fallingRows[l] + 1 + k][l] & pieceRows[k][l];
+            }
+            const bool moving = ((falling >> l) & 1u) && overlap == 0;
+            _fallingRows[l] += moving;
+            falling &= ~(static_cast<LaneMask>(!moving) << l);
+        }
+    }
+
+    for (std::size_t l = 0; l < lanes; ++l)
+    {
+        if ((active >> l) & 1u)
+        {
+            settle(l);
+        }
+    }
+    return;
+}
+
+template<SizeType height, SizeType width, std::size_t lanes>
+constexpr void LaneEngine<height, width, lanes>::update(const LaneMask mask)
+{
+    const LaneMask active = mask & ~_gameOver;
+    LaneMask settling = 0;
+    for (std::size_t l = 0; l < lanes; ++l)
+    {
+        const bool isActive = (active >> l) & 1u;
+        const bool moving = isActive & fits(l, _rotations[l], _fallingRows[l] + 1, _fallingColumns[l]);
+        _levels[l] = isActive ? static_cast<uint8_t>(_lineClears[l] / 10) : _levels[l];
+        _fallingRows[l] += moving;
+        settling |= static_cast<LaneMask>(isActive && !moving) << l;
+    }
+
+    for (std::size_t l = 0; l < lanes; ++l)
+    {
+        if ((settling >> l) & 1u)
+        {
+            settle(l);
+        }
+    }
+    return;
+}
+
+template<SizeType height, SizeType width, std::size_t lanes>
+constexpr void LaneEngine<height, width, lanes>::apply_placements(const std::array<Placement, lanes> &placements,
+                                                                  const LaneMask mask)
+{
+    const LaneMask active = mask & ~_gameOver;
+    for (std::size_t l = 0; l < lanes; ++l)
+    {
+        const bool isActive = (active >> l) & 1u;
+        _rotations[l] = isActive ? placements[l].rotation : _rotations[l];
+        _fallingColumns[l] = isActive ? placements[l].column : _fallingColumns[l];
+    }
+    hard_drop(active);
+    return;
+}
+
+// private:
+
+template<SizeType height, SizeType width, std::size_t lanes>
+constexpr bool LaneEngine<height, width, lanes>::fits(const std::size_t lane, const Rotation rotation,
+                                                      const SizeType row, const SizeType column) const
+{
+    const PieceMask &piece = get_piece_mask(_shapeTypes[lane], rotation);
+    const bool inside = (row >= 0) & (column >= 0) & (column + piece.width <= width);
+
+    // the test is free of branches, positions outside the board are replaced by a valid one and rejected
+    // afterwards. Unused rows of the mask are empty and the full rows below the board act as the floor,
+    // so the whole extent can be tested without looking at the height of the shape
+    const SizeType safeRow = inside ? row : 0;
+    const SizeType safeColumn = inside ? column : 0;
+    RowType overlap = 0;
+    for (SizeType k = 0; k < MAX_PIECE_EXTENT; ++k)
+    {
+        overlap |= _rows[safeRow + k][lane] & static_cast<RowType>(static_cast<RowType>(piece.rows[k]) << safeColumn);
+    }
+    return inside & (overlap == 0);
+}
+
+template<SizeType height, SizeType width, std::size_t lanes>
+constexpr void LaneEngine<height, width, lanes>::move_if_valid(const LaneMask mask, const SizeType rowOffset,
+                                                               const SizeType columnOffset, const uint8_t rotationOffset)
+{
+    const LaneMask active = mask & ~_gameOver;
+    for (std::size_t l = 0; l < lanes; ++l)
+    {
+        const Rotation rotation = static_cast<Rotation>((_rotations[l] + rotationOffset) % ROTATION_COUNT);
+        const SizeType row = _fallingRows[l] + rowOffset;
+        const SizeType column = _fallingColumns[l] + columnOffset;
+        const bool valid = ((active >> l) & 1u) & fits(l, rotation, row, column);
+
+        _rotations[l] = valid ? rotation : _rotations[l];
+        _fallingRows[l] = valid ? row : _fallingRows[l];
+        _fallingColumns[l] = valid ? column : _fallingColumns[l];
+    }
+    return;
+}
+
+template<SizeType height, SizeType width, std::size_t lanes>
+constexpr void LaneEngine<height, width, lanes>::settle(const std::size_t lane)
+{
+    const PieceMask &piece = get_piece_mask(_shapeTypes[lane], _rotations[lane]);
+    const SizeType row = _fallingRows[lane];
+    for (SizeType k = 0; k < piece.height; ++k)
+    {
+        _rows[row + k][lane] |= static_cast<RowType>(static_cast<RowType>(piece.rows[k]) << _fallingColumns[lane]);
+    }
+
+    // only the rows covered by the shape can have become full, see BoardState::place()
+    bool full = false;
+    for (SizeType k = 0; k < piece.height; ++k)
+    {
+        full = full || _rows[row + k][lane] == BoardState<height, width>::FULL_ROW;
+    }
+
+    uint8_t clearedRows = 0;
+    for (SizeType i = row + piece.height - 1; full && i >= 0; --i)
+    {
+        if (_rows[i][lane] == BoardState<height, width>::FULL_ROW)
+        {
+            ++clearedRows;
+        }
+        else if (clearedRows > 0)
+        {
+            _rows[i + clearedRows][lane] = _rows[i][lane];
+        }
+    }
+    for (SizeType i = 0; i < clearedRows; ++i)
+    {
+        _rows[i][lane] = 0;
+    }
+    _lineClears[lane] += clearedRows;
+
+    // all rows above the stack stay empty, and clearing rows moves them down
+    _stackTops[lane] = std::min<SizeType>(std::min(_stackTops[lane], row) + clearedRows, height);
+
+    generate_new_falling(lane);
+    return;
+}
+
+template<SizeType height, SizeType width, std::size_t lanes>
+constexpr void LaneEngine<height, width, lanes>::generate_new_falling(const std::size_t lane)
+{
+    // the second number determines the cell state in GameBoard. It is not used, but it must be drawn
+    const int randomShapeNumber = _generators[lane]() % 256;
+    _generators[lane]();
+
+    _shapeTypes[lane] = _nextShapeTypes[lane];
+    _rotations[lane] = ROT_0;
+    _fallingRows[lane] = 0;
+    _fallingColumns[lane] = get_spawn_column<width>();
+    _nextShapeTypes[lane] = static_cast<ShapeType>(randomShapeNumber % _SHAPE_COUNT);
+
+    if (!fits(lane, ROT_0, 0, _fallingColumns[lane]))
+    {
+        _gameOver |= LaneMask{1} << lane;
+    }
+    return;
+}
@@ -0,0 +1,191 @@
+#include "net_transport.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace
+{
+    /*
+     * Fills the address of a Unix socket.
+     *
+     * @return false if the path is too long
+     */
+    bool make_unix_address(const std::string &path, sockaddr_un &address)
+    {
+        address = sockaddr_un{};
+        address.sun_family = AF_UNIX;
+        if (path.size() >= sizeof(address.sun_path))
+        {
+            return false;
+        }
+        std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+        return true;
+    }
+
+    /*
+     * Returns the address of a port on the loopback interface.
+     */
+    sockaddr_in make_loopback_address(const uint16_t port)
+    {
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(port);
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        return address;
+    }
+}
+
+// DatagramSocket public:
+
+DatagramSocket::~DatagramSocket()
+{
+    close();
+}
+
+bool DatagramSocket::open_unix(const std::string &localPath)
+{
+    close();
+
+    sockaddr_un address{};
+    if (!make_unix_address(localPath, address))
+    {
+        return false;
+    }
+    _fileDescriptor = socket(AF_UNIX, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (_fileDescriptor < 0 || bind(_fileDescriptor, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0)
+    {
+        close();
+        return false;
+    }
+    _boundPath = localPath;
+    return true;
+}
+
+bool DatagramSocket::open_udp(const uint16_t localPort)
+{
+    close();
+
+    const sockaddr_in address = make_loopback_address(localPort);
+    _fileDescriptor = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (_fileDescriptor < 0 || bind(_fileDescriptor, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0)
+    {
+        close();
+        return false;
+    }
+    return true;
+}
+
+bool DatagramSocket::connect_unix(const std::string &remotePath)
+{
+    sockaddr_un address{};
+    return _fileDescriptor >= 0 && make_unix_address(remotePath, address)
+           && connect(_fileDescriptor, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == 0;
+}
+
+bool DatagramSocket::connect_udp(const uint16_t remotePort)
+{
+    const sockaddr_in address = make_loopback_address(remotePort);
+    return _fileDescriptor >= 0
+           && connect(_fileDescriptor, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == 0;
+}
+
+uint16_t DatagramSocket::get_port() const
+{
+    sockaddr_in address{};
+    socklen_t length = sizeof(address);
+    if (_fileDescriptor < 0 || getsockname(_fileDescriptor, reinterpret_cast<sockaddr*>(&address), &length) != 0
+        || address.sin_family != AF_INET)
+    {
+        return 0;
+    }
+    return ntohs(address.sin_port);
+}
+
+bool DatagramSocket::send(const uint8_t *data, const std::size_t size)
+{
+    return _fileDescriptor >= 0 && ::send(_fileDescriptor, data, size, MSG_NOSIGNAL) == static_cast<ssize_t>(size);
+}
+
+std::size_t DatagramSocket::receive(uint8_t *data)
+{
+    if (_fileDescriptor < 0)
+    {
+        return 0;
+    }
+    // errors like a refused datagram of a peer which has not been bound yet are treated like no datagram
+    const ssize_t received = recv(_fileDescriptor, data, MAX_DATAGRAM_SIZE, 0);
+    return received > 0 ? static_cast<std::size_t>(received) : 0;
+}
+
+int DatagramSocket::get_file_descriptor() const
+{
+    return _fileDescriptor;
+}
+
+void DatagramSocket::close()
+{
+    if (_fileDescriptor >= 0)
+    {
+        ::close(_fileDescriptor);
+        _fileDescriptor = -1;
+    }
+    if (!_boundPath.empty())
+    {
+        unlink(_boundPath.c_str());
+        _boundPath.clear();
+    }
+    return;
+}
+
+// LatencyInjector public:
+
+LatencyInjector::LatencyInjector(DatagramSocket &socket, const LatencySettings &settings, const uint32_t seed)
+    : _socket(socket), _settings(settings), _generator(seed)
+{}
+
+bool LatencyInjector::send(const uint8_t *data, const std::size_t size)
+{
+    flush();
+    if (_generator() % 100 < _settings.lossPercent)
+    {
+        return true;
+    }
+
+    // uniformly distributed in [latency - jitter, latency + jitter], but not negative
+    const double deviation = 2.0 * _generator() / RandomGenerator::MODULUS - 1.0;
+    const std::chrono::microseconds delay = std::max(std::chrono::microseconds(0), _settings.latency
+        + std::chrono::duration_cast<std::chrono::microseconds>(_settings.jitter * deviation));
+    _delayed.push_back({NetClock::now() + delay, std::vector<uint8_t>(data, data + size)});
+    return true;
+}
+
+std::size_t LatencyInjector::receive(uint8_t *data)
+{
+    flush();
+    return _socket.receive(data);
+}
+
+void LatencyInjector::flush()
+{
+    // the packets are not ordered by their due times, so all of them are examined
+    const NetClock::time_point now = NetClock::now();
+    for (auto packet = _delayed.begin(); packet != _delayed.end();)
+    {
+        if (packet->due <= now)
+        {
+            _socket.send(packet->data.data(), packet->data.size());
+            packet = _delayed.erase(packet);
+        }
+        else
+        {
+            ++packet;
+        }
+    }
+    return;
+}
@@ -0,0 +1,190 @@
+#ifndef NET_TRANSPORT_H_
+#define NET_TRANSPORT_H_
+
+#include "random.h"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+
+/*
+ * Local transports for the packets of two-player play, see rollback.h.
+ *
+ * Both transports deliver datagrams, which may be lost, duplicated or reordered, so the packets of a
+ * RollbackSession are self-contained. DatagramSocket sends over a Unix datagram socket or over UDP on the
+ * loopback interface. LatencyInjector wraps a DatagramSocket and delays, jitters and drops the sent packets,
+ * to test the rollback under bad network conditions on a single machine. Both provide send() and receive(),
+ * so code driving a session can be written against either of them.
+ */
+
+using NetClock = std::chrono::steady_clock; ///< Clock of the latency injection.
+
+/*
+ * Non-blocking datagram socket connected to a single peer.
+ */
+class DatagramSocket
+{
+public:
+    static constexpr std::size_t MAX_DATAGRAM_SIZE{1024}; ///< Maximal size of a sent or received datagram.
+
+    /*
+     * Constructor. Creates a closed socket.
+     */
+    DatagramSocket() = default;
+
+    /*
+     * Destructor. Closes the socket.
+     */
+    ~DatagramSocket();
+
+    DatagramSocket(const DatagramSocket&) = delete;
+    DatagramSocket& operator=(const DatagramSocket&) = delete;
+
+    /*
+     * Opens a Unix datagram socket bound to a path, which must not exist yet. A previous socket is closed.
+     *
+     * @param[in] localPath path of the socket, removed again on close()
+     * @return false if the socket cannot be created or bound
+     */
+    bool open_unix(const std::string &localPath);
+
+    /*
+     * Opens a UDP socket bound to a port of the loopback interface. A previous socket is closed.
+     *
+     * @param[in] localPort port, 0 for any free port, see get_port()
+     * @return false if the socket cannot be created or bound
+     */
+    bool open_udp(const uint16_t localPort);
+
+    /*
+     * Directs the datagrams of a Unix socket to a peer and only accepts the peer's datagrams.
+     *
+     * @param[in] remotePath path of the peer's socket, which must be bound already
+     * @return false if the peer does not exist
+     */
+    bool connect_unix(const std::string &remotePath);
+
+    /*
+     * Directs the datagrams of a UDP socket to a peer on the loopback interface and only accepts the peer's
+     * datagrams.
+     *
+     * @param[in] remotePort port of the peer
+     * @return false if the socket cannot be connected
+     */
+    bool connect_udp(const uint16_t remotePort);
+
+    /*
+     * Returns the bound port of a UDP socket, 0 for a Unix socket.
+     */
+    uint16_t get_port() const;
+
+    /*
+     * Sends a datagram to the peer without blocking.
+     *
+     * @param[in] data the datagram
+     * @param[in] size its size, at most MAX_DATAGRAM_SIZE
+     * @return false if it could not be sent, e.g. because the peer has gone or its buffer is full
+     */
+    bool send(const uint8_t *data, const std::size_t size);
+
+    /*
+     * Receives a pending datagram without blocking.
+     *
+     * @param[out] data buffer of MAX_DATAGRAM_SIZE bytes
+     * @return size of the datagram, 0 if none is pending
+     */
+    std::size_t receive(uint8_t *data);
+
+    /*
+     * Returns the descriptor of the socket, e.g. for poll(), -1 if it is closed.
+     */
+    int get_file_descriptor() const;
+
+    /*
+     * Closes the socket and removes the path of a Unix socket.
+     */
+    void close();
+
+private:
+    int _fileDescriptor{-1}; ///< descriptor of the socket
+    std::string _boundPath{}; ///< path of a bound Unix socket
+};
+
+/*
+ * Settings of the injected network conditions.
+ */
+struct LatencySettings
+{
+    std::chrono::microseconds latency{0}; ///< Mean delay of a packet.
+    std::chrono::microseconds jitter{0}; ///< Maximal deviation of a packet's delay from the mean, uniformly distributed.
+    uint32_t lossPercent{0}; ///< Probability of dropping a packet, in percent.
+};
+
+/*
+ * Delays, jitters and drops the packets sent over a DatagramSocket. Since every packet is delayed on its own,
+ * jitter beyond the interval between packets reorders them. Delayed packets are only sent during the calls of
+ * send(), receive() and flush(), so one of them has to be called regularly, e.g. once per frame.
+ */
+class LatencyInjector
+{
+public:
+    /*
+     * Constructor.
+     *
+     * @param[in] socket the socket, which must outlive the injector
+     * @param[in] settings the network conditions
+     * @param[in] seed seed of the random delays and losses
+     */
+    LatencyInjector(DatagramSocket &socket, const LatencySettings &settings, const uint32_t seed);
+
+    /*
+     * Default destructor. Packets which are still delayed are dropped.
+     */
+    ~LatencyInjector() = default;
+
+    LatencyInjector(const LatencyInjector&) = delete;
+    LatencyInjector& operator=(const LatencyInjector&) = delete;
+
+    /*
+     * Queues a datagram, which is sent after its random delay unless it is dropped.
+     *
+     * @param[in] data the datagram
+     * @param[in] size its size, at most DatagramSocket::MAX_DATAGRAM_SIZE
+     * @return true, since the outcome of sending is only known later
+     */
+    bool send(const uint8_t *data, const std::size_t size);
+
+    /*
+     * Sends the due packets and receives a pending datagram without blocking.
+     *
+     * @param[out] data buffer of DatagramSocket::MAX_DATAGRAM_SIZE bytes
+     * @return size of the datagram, 0 if none is pending
+     */
+    std::size_t receive(uint8_t *data);
+
+    /*
+     * Sends the packets whose delay has passed.
+     */
+    void flush();
+
+private:
+    /*
+     * Packet waiting for its delay to pass.
+     */
+    struct DelayedPacket
+    {
+        NetClock::time_point due{}; ///< time at which the packet is sent
+        std::vector<uint8_t> data{}; ///< the packet
+    };
+
+private:
+    DatagramSocket &_socket; ///< the wrapped socket
+    LatencySettings _settings; ///< the network conditions
+    RandomGenerator _generator; ///< source of the delays and losses
+    std::deque<DelayedPacket> _delayed{}; ///< packets waiting for their delay, in the order of sending
+};
+
+#endif /* NET_TRANSPORT_H_ */
@@ -0,0 +1,167 @@
+#include "perfect_clear.h"
+
+#include <cstring>
+#include <fstream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+    constexpr char MAGIC[8] = {'T', 'E', 'T', 'R', 'I', 'S', 'P', 'C'}; ///< identifies database files
+    constexpr uint32_t VERSION = 1; ///< version of the file format
+
+    /*
+     * Header of a database file. It is followed by the keys (uint64_t each) and the piece counts (uint8_t each).
+     * The header size is a multiple of 8, so the keys are aligned inside the mapping.
+     */
+    struct FileHeader
+    {
+        char magic[8];
+        uint32_t version;
+        uint8_t width;
+        uint8_t rows;
+        uint8_t maxPieceCount;
+        uint8_t reserved;
+        uint64_t size;
+    };
+
+    static_assert(sizeof(FileHeader) % alignof(PerfectClearKey) == 0, "ERROR: Keys must be aligned in the file.");
+}
+
+// free functions
+
+bool write_perfect_clear_database(const std::string &path, const uint8_t width, const uint8_t rows,
+                                  const uint8_t maxPieceCount, const std::vector<PerfectClearEntry> &entries)
+{
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file)
+    {
+        return false;
+    }
+
+    FileHeader header{};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.width = width;
+    header.rows = rows;
+    header.maxPieceCount = maxPieceCount;
+    header.size = entries.size();
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    for (const PerfectClearEntry &entry : entries)
+    {
+        file.write(reinterpret_cast<const char*>(&entry.key), sizeof(entry.key));
+    }
+    for (const PerfectClearEntry &entry : entries)
+    {
+        file.write(reinterpret_cast<const char*>(&entry.pieceCount), sizeof(entry.pieceCount));
+    }
+    return static_cast<bool>(file);
+}
+
+// PerfectClearDatabase public
+
+PerfectClearDatabase::~PerfectClearDatabase()
+{
+    close();
+}
+
+bool PerfectClearDatabase::open(const std::string &path)
+{
+    close();
+
+    const int fileDescriptor = ::open(path.c_str(), O_RDONLY);
+    if (fileDescriptor < 0)
+    {
+        return false;
+    }
+
+    struct stat fileStatus{};
+    void *mapping = MAP_FAILED;
+    if (fstat(fileDescriptor, &fileStatus) == 0 && static_cast<std::size_t>(fileStatus.st_size) >= sizeof(FileHeader))
+    {
+        mapping = mmap(nullptr, fileStatus.st_size, PROT_READ, MAP_SHARED, fileDescriptor, 0);
+    }
+    ::close(fileDescriptor); // the mapping stays valid after closing the file
+    if (mapping == MAP_FAILED)
+    {
+        return false;
+    }
+
+    _mapping = mapping;
+    _mappingSize = fileStatus.st_size;
+
+    // validate the header and the file size without reading the entries
+    const FileHeader &header = *static_cast<const FileHeader*>(_mapping);
+    const bool valid = std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) == 0 && header.version == VERSION
+                       && header.rows <= MAX_PERFECT_CLEAR_ROWS
+                       && _mappingSize == sizeof(FileHeader) + header.size * (sizeof(PerfectClearKey) + sizeof(uint8_t));
+    if (!valid)
+    {
+        close();
+        return false;
+    }
+
+    _size = header.size;
+    _width = header.width;
+    _rows = header.rows;
+    _maxPieceCount = header.maxPieceCount;
+    _keys = reinterpret_cast<const PerfectClearKey*>(static_cast<const char*>(_mapping) + sizeof(FileHeader));
+    _pieceCounts = reinterpret_cast<const uint8_t*>(_keys + _size);
+
+    // queries jump around the keys
+    madvise(_mapping, _mappingSize, MADV_RANDOM);
+    return true;
+}
+
+void PerfectClearDatabase::close()
+{
+    if (_mapping)
+    {
+        munmap(_mapping, _mappingSize);
+    }
+    _mapping = nullptr;
+    _mappingSize = 0;
+    _keys = nullptr;
+    _pieceCounts = nullptr;
+    _size = 0;
+    _width = 0;
+    _rows = 0;
+    _maxPieceCount = 0;
+    return;
+}
+
+bool PerfectClearDatabase::is_open() const
+{
+    return _mapping != nullptr;
+}
+
+uint8_t PerfectClearDatabase::get_width() const
+{
+    return _width;
+}
+
+uint8_t PerfectClearDatabase::get_rows() const
+{
+    return _rows;
+}
+
+uint8_t PerfectClearDatabase::get_max_piece_count() const
+{
+    return _maxPieceCount;
+}
+
+uint64_t PerfectClearDatabase::get_size() const
+{
+    return _size;
+}
+
+int PerfectClearDatabase::find_piece_count(const PerfectClearKey key) const
+{
+    const PerfectClearKey * const end = _keys + _size;
+    const PerfectClearKey * const found = std::lower_bound(_keys, end, key);
+    return (found != end && *found == key) ? _pieceCounts[found - _keys] : -1;
+}
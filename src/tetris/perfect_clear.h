@@ -0,0 +1,157 @@
+#ifndef PERFECT_CLEAR_H_
+#define PERFECT_CLEAR_H_
+
+#include "board_state.h"
+#include "thread_pool.h"
+
+#include <string>
+#include <vector>
+
+constexpr uint8_t MAX_PERFECT_CLEAR_ROWS{4}; ///< Maximal number of rows of the perfect clear region.
+
+using PerfectClearKey = uint64_t; ///< Packed occupancy of the lowest rows of a board, see get_perfect_clear_key().
+
+/*
+ * Board which can be cleared completely, together with the minimal number of shapes necessary for it.
+ */
+struct PerfectClearEntry
+{
+    PerfectClearKey key; ///< packed occupancy of the region
+    uint8_t pieceCount; ///< minimal number of shapes necessary to clear the region
+};
+
+/*
+ * Packs the lowest rows of a board state into a key. Row height - rows + i occupies the bits starting at
+ * (rows - 1 - i) * width, so keys of boards which only differ in higher rows are far apart.
+ *
+ * @param[in] boardState occupancy of the landed blocks
+ * @param[in] rows number of rows of the region, at most MAX_PERFECT_CLEAR_ROWS
+ * @return packed occupancy of the region
+ */
+template<SizeType height, SizeType width>
+constexpr PerfectClearKey get_perfect_clear_key(const BoardState<height, width> &boardState, const uint8_t rows);
+
+/*
+ * Enumerates all boards of the given width whose occupied cells lie in the lowest rows rows and which can be
+ * cleared completely with at most maxPieceCount shapes, without any shape sticking out of the region.
+ * Each shape must be placed like generate_placements() does, i.e. dropped straight down from above.
+ *
+ * The enumeration is a breadth-first search backwards from the empty board: a predecessor of a board is
+ * obtained by re-inserting cleared rows and removing a resting shape. Layer k contains the boards needing
+ * exactly k shapes. Predecessors of each layer are generated in parallel on the thread pool.
+ *
+ * @param[in] rows number of rows of the region, at most MAX_PERFECT_CLEAR_ROWS
+ * @param[in] maxPieceCount maximal number of shapes
+ * @param[in] threadPool thread pool for generating predecessors
+ * @return entries sorted by key
+ */
+template<SizeType width>
+std::vector<PerfectClearEntry> generate_perfect_clears(const uint8_t rows, const uint8_t maxPieceCount,
+                                                       ThreadPool &threadPool);
+
+/*
+ * Writes entries sorted by key to a perfect clear database file.
+ *
+ * @param[in] path file path
+ * @param[in] width board width
+ * @param[in] rows number of rows of the region
+ * @param[in] maxPieceCount maximal number of shapes used for generating the entries
+ * @param[in] entries entries sorted by key
+ * @return true if the file has been written successfully
+ */
+bool write_perfect_clear_database(const std::string &path, const uint8_t width, const uint8_t rows,
+                                  const uint8_t maxPieceCount, const std::vector<PerfectClearEntry> &entries);
+
+/*
+ * Read-only view of a perfect clear database file.
+ *
+ * The file consists of a fixed header, the sorted keys and the piece counts in the same order. It is mapped
+ * into memory and queried by binary search directly in the mapping, so opening takes constant time
+ * regardless of the size of the database, and pages are only loaded when queries touch them.
+ */
+class PerfectClearDatabase
+{
+public:
+    /*
+     * Constructor. Creates a closed database.
+     */
+    PerfectClearDatabase() = default;
+
+    /*
+     * Destructor. Unmaps the file.
+     */
+    ~PerfectClearDatabase();
+
+    PerfectClearDatabase(const PerfectClearDatabase&) = delete;
+    PerfectClearDatabase& operator=(const PerfectClearDatabase&) = delete;
+
+    /*
+     * Maps a database file into memory. A previously opened file is closed.
+     *
+     * @param[in] path file path
+     * @return true if the file exists and has a valid header
+     */
+    bool open(const std::string &path);
+
+    /*
+     * Unmaps the file.
+     */
+    void close();
+
+    /*
+     * Returns true if a database file is mapped.
+     */
+    bool is_open() const;
+
+    /*
+     * Returns the board width of the database.
+     */
+    uint8_t get_width() const;
+
+    /*
+     * Returns the number of rows of the region.
+     */
+    uint8_t get_rows() const;
+
+    /*
+     * Returns the maximal number of shapes used for generating the database.
+     */
+    uint8_t get_max_piece_count() const;
+
+    /*
+     * Returns the number of stored boards.
+     */
+    uint64_t get_size() const;
+
+    /*
+     * Looks up a key in O(log n).
+     *
+     * @param[in] key packed occupancy of the region
+     * @return minimal number of shapes necessary to clear the region, or -1 if the region cannot be cleared
+     *         with at most get_max_piece_count() shapes
+     */
+    int find_piece_count(const PerfectClearKey key) const;
+
+    /*
+     * Looks up a board state. Boards with occupied cells above the region, or of a different width than
+     * the database, cannot be found.
+     *
+     * @param[in] boardState occupancy of the landed blocks
+     * @return minimal number of shapes necessary to clear the board, or -1
+     */
+    template<SizeType height, SizeType width>
+    int find_piece_count(const BoardState<height, width> &boardState) const;
+
+private:
+    void *_mapping{nullptr}; ///< start of the mapped file
+    std::size_t _mappingSize{0}; ///< size of the mapped file in bytes
+    const PerfectClearKey *_keys{nullptr}; ///< sorted keys inside the mapping
+    const uint8_t *_pieceCounts{nullptr}; ///< piece counts inside the mapping
+    uint64_t _size{0}; ///< number of entries
+    uint8_t _width{0}; ///< board width
+    uint8_t _rows{0}; ///< number of rows of the region
+    uint8_t _maxPieceCount{0}; ///< maximal number of shapes used for generating the database
+};
+
+#include "perfect_clear.hpp"
+#endif /* PERFECT_CLEAR_H_ */
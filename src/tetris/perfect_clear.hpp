@@ -0,0 +1,201 @@
+#include <algorithm>
+#include <iterator>
+
+namespace perfect_clear_detail
+{
+    /*
+     * Returns row i (0 is the uppermost row) of a region with the given number of rows.
+     */
+    template<SizeType width>
+    constexpr uint32_t get_row(const PerfectClearKey key, const uint8_t rows, const uint8_t i)
+    {
+        return static_cast<uint32_t>(key >> ((rows - 1 - i) * width)) & ((1u << width) - 1);
+    }
+
+    /*
+     * Appends all boards from which the board key can be reached by placing a single shape.
+     */
+    template<SizeType width>
+    void append_predecessors(const PerfectClearKey key, const uint8_t rows, std::vector<PerfectClearKey> &predecessors)
+    {
+        constexpr uint32_t fullRow = (1u << width) - 1;
+
+        std::array<uint32_t, MAX_PERFECT_CLEAR_ROWS> current{};
+        for (uint8_t i = 0; i < rows; ++i)
+        {
+            current[i] = get_row<width>(key, rows, i);
+        }
+
+        // clearing k rows leaves the uppermost k rows of the region empty. Re-insert k full rows in any
+        // combination of positions, then remove a shape which covers every re-inserted row
+        for (uint8_t clearedRows = 0; clearedRows <= rows && (clearedRows == 0 || current[clearedRows - 1] == 0); ++clearedRows)
+        {
+            for (uint32_t fullRows = 0; fullRows < (1u << rows); ++fullRows)
+            {
+                if (__builtin_popcount(fullRows) != clearedRows)
+                {
+                    continue;
+                }
+
+                std::array<uint32_t, MAX_PERFECT_CLEAR_ROWS> filled{};
+                for (uint8_t i = 0, kept = clearedRows; i < rows; ++i)
+                {
+                    filled[i] = ((fullRows >> i) & 1u) ? fullRow : current[kept++];
+                }
+
+                for (uint8_t s = 0; s < _SHAPE_COUNT; ++s)
+                {
+                    for (uint8_t r = 0; r < ROTATION_COUNT; ++r)
+                    {
+                        const ShapeType shapeType = static_cast<ShapeType>(s);
+                        const Rotation rotation = static_cast<Rotation>(r);
+                        if (!is_distinct_rotation(shapeType, rotation))
+                        {
+                            continue;
+                        }
+
+                        const PieceMask &piece = get_piece_mask(shapeType, rotation);
+                        for (SizeType row = 0; row + piece.height <= rows; ++row)
+                        {
+                            for (SizeType column = 0; column + piece.width <= width; ++column)
+                            {
+                                // the shape must lie inside the filled cells and cover every re-inserted row
+                                std::array<uint32_t, MAX_PERFECT_CLEAR_ROWS> previous = filled;
+                                bool valid = true;
+                                for (SizeType i = 0; i < piece.height && valid; ++i)
+                                {
+                                    const uint32_t pieceRow = static_cast<uint32_t>(piece.rows[i]) << column;
+                                    valid = (previous[row + i] & pieceRow) == pieceRow;
+                                    previous[row + i] &= ~pieceRow;
+                                }
+                                for (uint8_t i = 0; i < rows && valid; ++i)
+                                {
+                                    valid = previous[i] != fullRow;
+                                }
+
+                                // the shape must rest on the floor or on a cell, and it must be reachable
+                                // from above, i.e. no cell above the shape is occupied
+                                bool resting = false;
+                                for (SizeType j = 0; j < piece.width && valid; ++j)
+                                {
+                                    const SizeType lowestRow = row + piece.bottom[j];
+                                    resting = resting || lowestRow + 1 == rows || ((previous[lowestRow + 1] >> (column + j)) & 1u);
+
+                                    SizeType uppermostRow = row;
+                                    while (!((piece.rows[uppermostRow - row] >> j) & 1u))
+                                    {
+                                        ++uppermostRow;
+                                    }
+                                    for (SizeType i = 0; i < uppermostRow && valid; ++i)
+                                    {
+                                        valid = !((previous[i] >> (column + j)) & 1u);
+                                    }
+                                }
+
+                                if (valid && resting)
+                                {
+                                    PerfectClearKey predecessor = 0;
+                                    for (uint8_t i = 0; i < rows; ++i)
+                                    {
+                                        predecessor = (predecessor << width) | previous[i];
+                                    }
+                                    predecessors.push_back(predecessor);
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        }
+        return;
+    }
+}
+
+template<SizeType height, SizeType width>
+constexpr PerfectClearKey get_perfect_clear_key(const BoardState<height, width> &boardState, const uint8_t rows)
+{
+    PerfectClearKey key = 0;
+    for (SizeType i = height - rows; i < height; ++i)
+    {
+        key = (key << width) | boardState.get_row(i);
+    }
+    return key;
+}
+
+template<SizeType width>
+std::vector<PerfectClearEntry> generate_perfect_clears(const uint8_t rows, const uint8_t maxPieceCount,
+                                                       ThreadPool &threadPool)
+{
+    static_assert(width * MAX_PERFECT_CLEAR_ROWS <= 64, "ERROR: Perfect clear keys support widths up to 16.");
+
+    // layers[k] holds the boards which need exactly k shapes, visited holds all layers sorted
+    std::vector<std::vector<PerfectClearKey>> layers{{0}};
+    std::vector<PerfectClearKey> visited{0};
+
+    const std::size_t chunkCount = 8 * threadPool.get_thread_count();
+    std::vector<std::vector<PerfectClearKey>> chunks(chunkCount);
+    for (uint8_t pieceCount = 1; pieceCount <= maxPieceCount && !layers.back().empty(); ++pieceCount)
+    {
+        const std::vector<PerfectClearKey> &frontier = layers.back();
+        threadPool.parallel_for(chunkCount, [&frontier, &chunks, chunkCount, rows](const std::size_t chunk) {
+            std::vector<PerfectClearKey> &predecessors = chunks[chunk];
+            predecessors.clear();
+            for (std::size_t k = chunk * frontier.size() / chunkCount; k < (chunk + 1) * frontier.size() / chunkCount; ++k)
+            {
+                perfect_clear_detail::append_predecessors<width>(frontier[k], rows, predecessors);
+            }
+            std::sort(predecessors.begin(), predecessors.end());
+            predecessors.erase(std::unique(predecessors.begin(), predecessors.end()), predecessors.end());
+        });
+
+        std::vector<PerfectClearKey> candidates;
+        for (std::vector<PerfectClearKey> &predecessors : chunks)
+        {
+            candidates.insert(candidates.end(), predecessors.begin(), predecessors.end());
+            std::vector<PerfectClearKey>().swap(predecessors);
+        }
+        std::sort(candidates.begin(), candidates.end());
+        candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+        // only boards which have not been reached with fewer shapes form the next layer
+        std::vector<PerfectClearKey> layer;
+        std::set_difference(candidates.begin(), candidates.end(), visited.begin(), visited.end(), std::back_inserter(layer));
+        std::vector<PerfectClearKey> merged;
+        merged.reserve(visited.size() + layer.size());
+        std::merge(visited.begin(), visited.end(), layer.begin(), layer.end(), std::back_inserter(merged));
+        visited.swap(merged);
+        layers.push_back(std::move(layer));
+    }
+
+    std::vector<PerfectClearEntry> entries;
+    entries.reserve(visited.size());
+    for (std::size_t pieceCount = 0; pieceCount < layers.size(); ++pieceCount)
+    {
+        for (const PerfectClearKey key : layers[pieceCount])
+        {
+            entries.push_back({key, static_cast<uint8_t>(pieceCount)});
+        }
+    }
+    std::sort(entries.begin(), entries.end(), [](const PerfectClearEntry &lhs, const PerfectClearEntry &rhs) {
+        return lhs.key < rhs.key;
+    });
+    return entries;
+}
+
+template<SizeType height, SizeType width>
+int PerfectClearDatabase::find_piece_count(const BoardState<height, width> &boardState) const
+{
+    if (!is_open() || width != _width || height < _rows)
+    {
+        return -1;
+    }
+
+    for (SizeType i = 0; i < height - _rows; ++i)
+    {
+        if (boardState.get_row(i) != 0)
+        {
+            return -1;
+        }
+    }
+    return find_piece_count(get_perfect_clear_key(boardState, _rows));
+}
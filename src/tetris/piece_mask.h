@@ -0,0 +1,123 @@
+#ifndef PIECE_MASK_H_
+#define PIECE_MASK_H_
+
+#include "shapes.h"
+
+#include <algorithm>
+
+using RowMask = uint8_t; ///< Occupancy of a single row of a shape. Bit j is set if column j is occupied.
+
+constexpr SizeType MAX_PIECE_EXTENT{4}; ///< Maximal height or width of any rotated built-in shape.
+constexpr SizeType MAX_POLYOMINO_EXTENT{8 * sizeof(RowMask)}; ///< Maximal height or width of any rotated shape of a PieceSet.
+constexpr uint8_t ROTATION_COUNT{4}; ///< Number of distinct rotation states.
+
+/*
+ * Packed occupancy of a rotated shape whose bounding box is at most extent x extent.
+ * Row i of the rotated shape occupies exactly the columns whose bits are set in rows[i].
+ */
+template<SizeType extent>
+struct BasicPieceMask
+{
+    SizeType height; ///< Height of the rotated shape.
+    SizeType width; ///< Width of the rotated shape.
+    std::array<RowMask, extent> rows; ///< Occupancy of each row, unused rows are 0.
+    std::array<SizeType, extent> bottom; ///< Lowest occupied row of each column, unused columns are -1.
+};
+
+using PieceMask = BasicPieceMask<MAX_PIECE_EXTENT>; ///< Mask of a built-in shape, used by the searches.
+using PolyominoMask = BasicPieceMask<MAX_POLYOMINO_EXTENT>; ///< Mask of any shape, used by Falling and PieceSet.
+
+using PieceMaskTable = std::array<std::array<PieceMask, ROTATION_COUNT>, _SHAPE_COUNT>;
+using PolyominoMaskTable = std::array<std::array<PolyominoMask, ROTATION_COUNT>, _SHAPE_COUNT>;
+
+/*
+ * Creates the mask of a shape from its cells.
+ *
+ * @param[in] height height of the shape, at most extent
+ * @param[in] width width of the shape, at most extent
+ * @param[in] isOccupied callable with signature bool(SizeType i, SizeType j), true if cell (i,j) is occupied
+ * @return the mask
+ */
+template<SizeType extent, typename Cells>
+constexpr BasicPieceMask<extent> make_piece_mask(const SizeType height, const SizeType width, const Cells &isOccupied);
+
+/*
+ * Returns the mask of a shape rotated by 90° clockwise. Rotating a matrix clockwise corresponds to transposing it
+ * and taking the columns in reverse order, which is also how Falling rotates.
+ */
+template<SizeType extent>
+constexpr BasicPieceMask<extent> rotate_piece_mask(const BasicPieceMask<extent> &mask);
+
+/*
+ * Builds the masks of all built-in shapes and rotations from the memory representations of the shapes, see Shape.
+ * The table is evaluated at compile time and available as POLYOMINO_MASKS. Falling draws its cells from it, so the
+ * masks always agree with the cells drawn on the game board.
+ */
+constexpr PolyominoMaskTable build_polyomino_mask_table();
+
+/*
+ * Narrows the masks of POLYOMINO_MASKS to MAX_PIECE_EXTENT. The table is evaluated at compile time and available
+ * as PIECE_MASKS.
+ */
+constexpr PieceMaskTable build_piece_mask_table();
+
+/*
+ * Returns the packed occupancy of a shape in a certain rotation.
+ *
+ * @param[in] shapeType shape type
+ * @param[in] rotation rotation of the shape
+ * @return packed occupancy
+ */
+constexpr const PieceMask& get_piece_mask(const ShapeType shapeType, const Rotation rotation);
+
+/*
+ * Returns true if two masks have the same size and cover the same cells.
+ */
+template<SizeType extent>
+constexpr bool are_same_masks(const BasicPieceMask<extent> &first, const BasicPieceMask<extent> &second);
+
+/*
+ * Determines whether a rotation is the first one (in the order ROT_0, ..., ROT_270) leading to its mask.
+ * For example, ROT_180 of the S shape covers the same cells as ROT_0, so it is not distinct.
+ * Enumerating only distinct rotations avoids examining identical placements twice.
+ *
+ * @param[in] shapeType shape type
+ * @param[in] rotation rotation of the shape
+ * @return true if no smaller rotation leads to the same mask
+ */
+constexpr bool is_distinct_rotation(const ShapeType shapeType, const Rotation rotation);
+
+/*
+ * Returns the masks of all rotations of a built-in shape, in the order ROT_0, ..., ROT_270.
+ */
+constexpr const PolyominoMask* get_polyomino_masks(const ShapeType shapeType);
+
+/*
+ * Returns the number of occupied cells of a mask.
+ */
+template<SizeType extent>
+constexpr uint8_t get_cell_count(const BasicPieceMask<extent> &piece);
+
+/*
+ * Determines whether the occupied cells of every column of a mask are contiguous. Dropping such a piece only
+ * depends on the cell below the lowest occupied cell of each column, see BoardState::get_drop_row().
+ */
+template<SizeType extent>
+constexpr bool has_contiguous_columns(const BasicPieceMask<extent> &piece);
+
+/*
+ * Returns the maximal height of all built-in shapes in a certain rotation.
+ */
+constexpr SizeType get_max_height(const Rotation rotation);
+
+/*
+ * Returns the maximal width of all built-in shapes in a certain rotation.
+ */
+constexpr SizeType get_max_width(const Rotation rotation);
+
+#include "piece_mask.hpp"
+
+static_assert(is_distinct_rotation(SHAPE_T, ROT_180) && !is_distinct_rotation(SHAPE_S, ROT_180)
+              && !is_distinct_rotation(SHAPE_O, ROT_90), "ERROR: Unexpected rotational symmetries of the shapes.");
+
+#endif /* PIECE_MASK_H_ */
@@ -0,0 +1,160 @@
+template<SizeType extent, typename Cells>
+constexpr BasicPieceMask<extent> make_piece_mask(const SizeType height, const SizeType width, const Cells &isOccupied)
+{
+    BasicPieceMask<extent> mask{height, width, {}, {}};
+    for (SizeType j = 0; j < extent; ++j)
+    {
+        mask.rows[j] = 0;
+        mask.bottom[j] = -1;
+    }
+
+    // bounded by extent as well, so the writes provably stay within the mask
+    for (SizeType i = 0; i < height && i < extent; ++i)
+    {
+        for (SizeType j = 0; j < width && j < extent; ++j)
+        {
+            if (isOccupied(i, j))
+            {
+                mask.rows[i] |= static_cast<RowMask>(1u << j);
+                mask.bottom[j] = i;
+            }
+        }
+    }
+    return mask;
+}
+
+template<SizeType extent>
+constexpr BasicPieceMask<extent> rotate_piece_mask(const BasicPieceMask<extent> &mask)
+{
+    return make_piece_mask<extent>(mask.width, mask.height, [&mask](const SizeType i, const SizeType j) {
+        return ((mask.rows[mask.height - 1 - j] >> i) & 1u) != 0;
+    });
+}
+
+constexpr PolyominoMaskTable build_polyomino_mask_table()
+{
+    PolyominoMaskTable table{};
+    for (uint8_t s = 0; s < _SHAPE_COUNT; ++s)
+    {
+        const Shape shape(static_cast<ShapeType>(s));
+        table[s][ROT_0] = make_piece_mask<MAX_POLYOMINO_EXTENT>(shape.get_height(), shape.get_width(),
+                                                                [&shape](const SizeType i, const SizeType j) {
+            return shape(i, j) != 0;
+        });
+        for (uint8_t r = 1; r < ROTATION_COUNT; ++r)
+        {
+            table[s][r] = rotate_piece_mask(table[s][r - 1]);
+        }
+    }
+    return table;
+}
+
+constexpr PolyominoMaskTable POLYOMINO_MASKS = build_polyomino_mask_table(); ///< Masks of all built-in shapes and rotations for Falling.
+
+constexpr PieceMaskTable build_piece_mask_table()
+{
+    PieceMaskTable table{};
+    for (uint8_t s = 0; s < _SHAPE_COUNT; ++s)
+    {
+        for (uint8_t r = 0; r < ROTATION_COUNT; ++r)
+        {
+            const PolyominoMask &mask = POLYOMINO_MASKS[s][r];
+            table[s][r] = make_piece_mask<MAX_PIECE_EXTENT>(mask.height, mask.width, [&mask](const SizeType i, const SizeType j) {
+                return ((mask.rows[i] >> j) & 1u) != 0;
+            });
+        }
+    }
+    return table;
+}
+
+constexpr PieceMaskTable PIECE_MASKS = build_piece_mask_table(); ///< Masks of all shapes and rotations.
+
+constexpr const PieceMask& get_piece_mask(const ShapeType shapeType, const Rotation rotation)
+{
+    return PIECE_MASKS[shapeType][rotation];
+}
+
+template<SizeType extent>
+constexpr bool are_same_masks(const BasicPieceMask<extent> &first, const BasicPieceMask<extent> &second)
+{
+    bool equal = (first.height == second.height && first.width == second.width);
+    for (SizeType i = 0; i < extent; ++i)
+    {
+        equal = equal && (first.rows[i] == second.rows[i]);
+    }
+    return equal;
+}
+
+constexpr bool is_distinct_rotation(const ShapeType shapeType, const Rotation rotation)
+{
+    const PieceMask &mask = get_piece_mask(shapeType, rotation);
+    for (uint8_t r = 0; r < rotation; ++r)
+    {
+        if (are_same_masks(get_piece_mask(shapeType, static_cast<Rotation>(r)), mask))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+constexpr const PolyominoMask* get_polyomino_masks(const ShapeType shapeType)
+{
+    return POLYOMINO_MASKS[shapeType].data();
+}
+
+template<SizeType extent>
+constexpr uint8_t get_cell_count(const BasicPieceMask<extent> &piece)
+{
+    uint8_t cellCount = 0;
+    for (SizeType i = 0; i < extent; ++i)
+    {
+        for (RowMask row = piece.rows[i]; row != 0; row &= row - 1)
+        {
+            ++cellCount;
+        }
+    }
+    return cellCount;
+}
+
+template<SizeType extent>
+constexpr bool has_contiguous_columns(const BasicPieceMask<extent> &piece)
+{
+    for (SizeType j = 0; j < piece.width; ++j)
+    {
+        // every column must be occupied from its uppermost occupied cell down to its lowest one
+        bool started = false;
+        bool ended = false;
+        for (SizeType i = 0; i < piece.height; ++i)
+        {
+            const bool occupied = (piece.rows[i] >> j) & 1u;
+            if (occupied && ended)
+            {
+                return false;
+            }
+            ended = ended || (started && !occupied);
+            started = started || occupied;
+        }
+    }
+    return true;
+}
+
+constexpr SizeType get_max_height(const Rotation rotation)
+{
+    SizeType maxHeight = 0;
+    for (uint8_t s = 0; s < _SHAPE_COUNT; ++s)
+    {
+        maxHeight = std::max(maxHeight, get_piece_mask(static_cast<ShapeType>(s), rotation).height);
+    }
+    return maxHeight;
+}
+
+constexpr SizeType get_max_width(const Rotation rotation)
+{
+    SizeType maxWidth = 0;
+    for (uint8_t s = 0; s < _SHAPE_COUNT; ++s)
+    {
+        maxWidth = std::max(maxWidth, get_piece_mask(static_cast<ShapeType>(s), rotation).width);
+    }
+    return maxWidth;
+}
@@ -0,0 +1,279 @@
+#include "piece_set.h"
+
+#include <fstream>
+
+namespace
+{
+    /*
+     * Determines whether the occupied cells of a mask are connected by shared edges.
+     */
+    bool is_connected(const PolyominoMask &mask)
+    {
+        // grow the region of the first occupied cell until it stops changing
+        std::array<RowMask, MAX_POLYOMINO_EXTENT> region{};
+        for (SizeType i = 0; i < mask.height; ++i)
+        {
+            if (mask.rows[i] != 0)
+            {
+                region[i] = static_cast<RowMask>(mask.rows[i] & -mask.rows[i]);
+                break;
+            }
+        }
+
+        bool grown = true;
+        while (grown)
+        {
+            grown = false;
+            for (SizeType i = 0; i < mask.height; ++i)
+            {
+                RowMask neighbours = static_cast<RowMask>(region[i] | (region[i] << 1) | (region[i] >> 1));
+                neighbours |= (i > 0) ? region[i - 1] : 0;
+                neighbours |= (i + 1 < mask.height) ? region[i + 1] : 0;
+                const RowMask next = static_cast<RowMask>(neighbours & mask.rows[i]);
+                grown = grown || next != region[i];
+                region[i] = next;
+            }
+        }
+
+        for (SizeType i = 0; i < mask.height; ++i)
+        {
+            if (region[i] != mask.rows[i])
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /*
+     * Creates the mask of the cells of a piece given as rows of '#' and '.', without the empty rows and columns
+     * around it.
+     *
+     * @param[in] rows the rows
+     * @param[out] mask the mask
+     * @param[out] error reason if the piece is invalid
+     * @return false if the piece is empty, too large or not connected
+     */
+    bool parse_piece(const std::vector<std::string> &rows, PolyominoMask &mask, std::string &error)
+    {
+        // bounding box of the occupied cells
+        std::size_t top = rows.size();
+        std::size_t bottom = 0;
+        std::size_t left = std::string::npos;
+        std::size_t right = 0;
+        for (std::size_t i = 0; i < rows.size(); ++i)
+        {
+            const std::size_t first = rows[i].find('#');
+            if (first != std::string::npos)
+            {
+                top = std::min(top, i);
+                bottom = i;
+                left = std::min(left, first);
+                right = std::max(right, rows[i].rfind('#'));
+            }
+        }
+
+        if (top == rows.size())
+        {
+            error = "has no cells";
+            return false;
+        }
+        if (bottom - top >= static_cast<std::size_t>(MAX_POLYOMINO_EXTENT)
+            || right - left >= static_cast<std::size_t>(MAX_POLYOMINO_EXTENT))
+        {
+            error = "is larger than " + std::to_string(MAX_POLYOMINO_EXTENT) + "x" + std::to_string(MAX_POLYOMINO_EXTENT);
+            return false;
+        }
+
+        mask = make_piece_mask<MAX_POLYOMINO_EXTENT>(static_cast<SizeType>(bottom - top + 1), static_cast<SizeType>(right - left + 1),
+                                                     [&rows, top, left](const SizeType i, const SizeType j) {
+            const std::string &row = rows[top + i];
+            return left + j < row.size() && row[left + j] == '#';
+        });
+        if (!is_connected(mask))
+        {
+            error = "is not connected";
+            return false;
+        }
+        return true;
+    }
+}
+
+// PieceSet public:
+
+void PieceSet::load_builtin_shapes()
+{
+    clear();
+    for (uint8_t s = 0; s < _SHAPE_COUNT; ++s)
+    {
+        static constexpr const char *NAMES[_SHAPE_COUNT] = {"O", "L", "J", "I", "S", "T", "Z"};
+        add_piece(NAMES[s], get_polyomino_masks(static_cast<ShapeType>(s))[ROT_0]);
+    }
+    return;
+}
+
+bool PieceSet::load(const std::string &path)
+{
+    std::ifstream file(path);
+    if (!file)
+    {
+        clear();
+        _error = "cannot open " + path;
+        return false;
+    }
+    return read(file);
+}
+
+bool PieceSet::read(std::istream &input)
+{
+    clear();
+
+    std::string name;
+    std::vector<std::string> rows;
+    bool started = false;
+    std::size_t pieceLine = 0;
+    std::size_t lineNumber = 0;
+    const auto finishPiece = [this, &name, &rows, &pieceLine]() {
+        PolyominoMask mask{};
+        std::string error;
+        if (!parse_piece(rows, mask, error))
+        {
+            _error = "line " + std::to_string(pieceLine) + ": piece " + name + " " + error;
+            return false;
+        }
+        add_piece(name, mask);
+        return true;
+    };
+
+    std::string line;
+    bool valid = true;
+    while (valid && std::getline(input, line))
+    {
+        ++lineNumber;
+        line.erase(line.find_last_not_of(" \t\r") + 1);
+        if (line.empty() || line.compare(0, 2, "//") == 0)
+        {
+            continue;
+        }
+
+        if (line.compare(0, 6, "piece ") == 0)
+        {
+            valid = !started || finishPiece();
+            if (valid && _pieces.size() == MAX_PIECE_SET_SIZE)
+            {
+                _error = "line " + std::to_string(lineNumber) + ": more than " + std::to_string(MAX_PIECE_SET_SIZE) + " pieces";
+                valid = false;
+            }
+            name = line.substr(line.find_first_not_of(' ', 6));
+            rows.clear();
+            started = true;
+            pieceLine = lineNumber;
+        }
+        else if (!started || line.find_first_not_of("#.") != std::string::npos)
+        {
+            _error = "line " + std::to_string(lineNumber) + ": expected \"piece <name>\" or a row of '#' and '.'";
+            valid = false;
+        }
+        else
+        {
+            rows.push_back(line);
+        }
+    }
+
+    if (valid && !started)
+    {
+        _error = "no pieces";
+        valid = false;
+    }
+    valid = valid && finishPiece();
+    if (!valid)
+    {
+        const std::string error = _error;
+        clear();
+        _error = error;
+    }
+    return valid;
+}
+
+const std::string& PieceSet::get_error() const
+{
+    return _error;
+}
+
+std::size_t PieceSet::get_piece_count() const
+{
+    return _pieces.size();
+}
+
+const std::string& PieceSet::get_name(const uint8_t piece) const
+{
+    return _pieces[piece].name;
+}
+
+uint8_t PieceSet::get_cell_count(const uint8_t piece) const
+{
+    return _pieces[piece].cellCount;
+}
+
+SizeType PieceSet::get_max_height() const
+{
+    return _maxHeight;
+}
+
+SizeType PieceSet::get_max_width() const
+{
+    return _maxWidth;
+}
+
+bool PieceSet::fits_board(const SizeType height, const SizeType width) const
+{
+    for (uint8_t p = 0; p < _pieces.size(); ++p)
+    {
+        const PolyominoMask &mask = get_piece_mask(p, ROT_0);
+        const SizeType spawnColumn = get_spawn_column(p, width);
+        if (mask.height > height || spawnColumn < 0 || spawnColumn + mask.width > width)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// PieceSet private:
+
+void PieceSet::add_piece(const std::string &name, const PolyominoMask &mask)
+{
+    PieceInfo info;
+    info.name = name;
+    info.cellCount = ::get_cell_count(mask);
+    info.spawnOffset = static_cast<SizeType>(std::min(0, 1 - (mask.width - 1) / 2));
+
+    const std::size_t first = _masks.size();
+    for (uint8_t r = 0; r < ROTATION_COUNT; ++r)
+    {
+        _masks.push_back((r == 0) ? mask : rotate_piece_mask(_masks.back()));
+        const PolyominoMask &rotated = _masks.back();
+
+        bool distinct = true;
+        for (uint8_t other = 0; other < r; ++other)
+        {
+            distinct = distinct && !are_same_masks(_masks[first + other], rotated);
+        }
+        info.distinctRotations |= static_cast<uint8_t>(distinct << r);
+        info.contiguousRotations |= static_cast<uint8_t>(has_contiguous_columns(rotated) << r);
+        _maxHeight = std::max(_maxHeight, rotated.height);
+        _maxWidth = std::max(_maxWidth, rotated.width);
+    }
+    _pieces.push_back(info);
+    return;
+}
+
+void PieceSet::clear()
+{
+    _masks.clear();
+    _pieces.clear();
+    _maxHeight = 0;
+    _maxWidth = 0;
+    _error.clear();
+    return;
+}
@@ -0,0 +1,183 @@
+#ifndef PIECE_SET_H_
+#define PIECE_SET_H_
+
+#include "placement.h"
+
+#include <istream>
+#include <string>
+#include <vector>
+
+constexpr std::size_t MAX_PIECE_SET_SIZE{64}; ///< Maximal number of pieces of a PieceSet.
+
+/*
+ * Set of arbitrary polyominoes with bounding boxes of up to MAX_POLYOMINO_EXTENT x MAX_POLYOMINO_EXTENT, e.g.
+ * pentominoes, loaded at startup instead of the built-in shapes.
+ *
+ * A piece set file lists the pieces one after another. A piece starts with a line "piece <name>", followed by its
+ * rows in the rotation ROT_0, where '#' is an occupied and '.' a free cell. Empty lines and lines starting with
+ * "//" are ignored. For example:
+ *
+ *     // the T tetromino
+ *     piece T
+ *     .#.
+ *     ###
+ *
+ * Empty rows and columns around a piece are removed, and its cells must be connected. When a piece is added, the
+ * masks of all its rotations, which rotations are distinct and which have contiguous columns and its spawn
+ * position are computed once. The masks of all pieces are stored in one flat array, the four rotations of a piece
+ * next to each other, so Falling, BoardState and generate_placements() use them exactly like the masks of the
+ * built-in shapes.
+ */
+class PieceSet
+{
+public:
+    /*
+     * Constructor. Creates an empty set.
+     */
+    PieceSet() = default;
+
+    /*
+     * Default destructor.
+     */
+    ~PieceSet() = default;
+
+    /*
+     * Replaces the pieces by the built-in shapes in the order of ShapeType, so piece s is the shape of type s.
+     */
+    void load_builtin_shapes();
+
+    /*
+     * Replaces the pieces by the ones of a piece set file. The set is left empty if the file is invalid.
+     *
+     * @param[in] path path of the file
+     * @return false if the file cannot be read or is invalid, see get_error()
+     */
+    bool load(const std::string &path);
+
+    /*
+     * Replaces the pieces by the ones read from a stream in the format of a piece set file.
+     * The set is left empty if the input is invalid.
+     *
+     * @param[in,out] input the stream
+     * @return false if the input is invalid, see get_error()
+     */
+    bool read(std::istream &input);
+
+    /*
+     * Returns a description of the reason why the last call of load() or read() failed.
+     */
+    const std::string& get_error() const;
+
+    /*
+     * Returns the number of pieces.
+     */
+    std::size_t get_piece_count() const;
+
+    /*
+     * Returns the name of a piece.
+     */
+    const std::string& get_name(const uint8_t piece) const;
+
+    /*
+     * Returns the number of cells of a piece.
+     */
+    uint8_t get_cell_count(const uint8_t piece) const;
+
+    /*
+     * Returns the packed occupancy of a piece in a certain rotation.
+     * Only access for piece < get_piece_count().
+     */
+    const PolyominoMask& get_piece_mask(const uint8_t piece, const Rotation rotation) const;
+
+    /*
+     * Returns the masks of all rotations of a piece in the order ROT_0, ..., ROT_270, e.g. to create a Falling.
+     * They stay valid until the pieces are replaced.
+     */
+    const PolyominoMask* get_piece_masks(const uint8_t piece) const;
+
+    /*
+     * Returns a bit mask with bit r set if rotation r of a piece is the first one leading to its mask,
+     * see is_distinct_rotation().
+     */
+    uint8_t get_distinct_rotations(const uint8_t piece) const;
+
+    /*
+     * Returns a bit mask with bit r set if rotation r of a piece has contiguous columns, see has_contiguous_columns().
+     */
+    uint8_t get_contiguous_rotations(const uint8_t piece) const;
+
+    /*
+     * Returns the column in which a piece appears on a game board of the given width. Pieces up to three columns
+     * wide appear in the same column as the built-in shapes, see get_spawn_column(), wider ones are shifted to
+     * the left so that they stay centred.
+     *
+     * @param[in] piece the piece
+     * @param[in] width width of the game board
+     * @return column of the upper left corner of the piece in rotation ROT_0
+     */
+    SizeType get_spawn_column(const uint8_t piece, const SizeType width) const;
+
+    /*
+     * Returns the maximal height of all pieces in all rotations.
+     */
+    SizeType get_max_height() const;
+
+    /*
+     * Returns the maximal width of all pieces in all rotations.
+     */
+    SizeType get_max_width() const;
+
+    /*
+     * Returns false if a piece does not fit at its spawn position on an empty game board of the given size.
+     */
+    bool fits_board(const SizeType height, const SizeType width) const;
+
+private:
+    /*
+     * Properties of a piece apart from its masks.
+     */
+    struct PieceInfo
+    {
+        std::string name{}; ///< name of the piece
+        uint8_t cellCount{0}; ///< number of occupied cells
+        uint8_t distinctRotations{0}; ///< bit r is set if rotation r is distinct
+        uint8_t contiguousRotations{0}; ///< bit r is set if rotation r has contiguous columns
+        SizeType spawnOffset{0}; ///< column of the piece at the spawn position relative to the built-in shapes
+    };
+
+    /*
+     * Appends a piece and computes all its rotations.
+     *
+     * @param[in] name name of the piece
+     * @param[in] mask mask of the piece in rotation ROT_0, without empty rows or columns around it
+     */
+    void add_piece(const std::string &name, const PolyominoMask &mask);
+
+    /*
+     * Removes all pieces.
+     */
+    void clear();
+
+private:
+    std::vector<PolyominoMask> _masks{}; ///< masks of all pieces, the rotations of piece p at ROTATION_COUNT * p
+    std::vector<PieceInfo> _pieces{}; ///< properties of all pieces
+    SizeType _maxHeight{0}; ///< maximal height of all pieces in all rotations
+    SizeType _maxWidth{0}; ///< maximal width of all pieces in all rotations
+    std::string _error{}; ///< reason of the last failed load() or read()
+};
+
+/*
+ * Enumerates all placements of a piece of a set which are reachable from its spawn position, exactly like
+ * generate_placements() does for a built-in shape. The placements store the index of the piece as shape type.
+ *
+ * @param[in] boardState occupancy of the landed blocks
+ * @param[in] pieceSet the piece set
+ * @param[in] piece index of the piece to place
+ * @return list of reachable placements
+ */
+template<SizeType height, SizeType width>
+PlacementList<width> generate_placements(const BoardState<height, width> &boardState, const PieceSet &pieceSet,
+                                         const uint8_t piece);
+
+#include "piece_set.hpp"
+#endif /* PIECE_SET_H_ */
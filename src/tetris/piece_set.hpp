@@ -0,0 +1,38 @@
+// PieceSet public:
+
+inline const PolyominoMask& PieceSet::get_piece_mask(const uint8_t piece, const Rotation rotation) const
+{
+    return _masks[ROTATION_COUNT * piece + rotation];
+}
+
+inline const PolyominoMask* PieceSet::get_piece_masks(const uint8_t piece) const
+{
+    return _masks.data() + ROTATION_COUNT * piece;
+}
+
+inline uint8_t PieceSet::get_distinct_rotations(const uint8_t piece) const
+{
+    return _pieces[piece].distinctRotations;
+}
+
+inline uint8_t PieceSet::get_contiguous_rotations(const uint8_t piece) const
+{
+    return _pieces[piece].contiguousRotations;
+}
+
+inline SizeType PieceSet::get_spawn_column(const uint8_t piece, const SizeType width) const
+{
+    return (width - 1) / 2 + _pieces[piece].spawnOffset;
+}
+
+// free functions
+
+template<SizeType height, SizeType width>
+PlacementList<width> generate_placements(const BoardState<height, width> &boardState, const PieceSet &pieceSet,
+                                         const uint8_t piece)
+{
+    return placement_detail::generate_placements(boardState, pieceSet.get_piece_masks(piece), static_cast<ShapeType>(piece),
+                                                 pieceSet.get_spawn_column(piece, width),
+                                                 pieceSet.get_distinct_rotations(piece),
+                                                 pieceSet.get_contiguous_rotations(piece));
+}
@@ -0,0 +1,97 @@
+#ifndef PLACEMENT_H_
+#define PLACEMENT_H_
+
+#include "board_state.h"
+#include "gameboard.h"
+
+/*
+ * Fixed-capacity list of placements. A shape has at most one placement per distinct rotation and column,
+ * so no dynamic memory is needed.
+ */
+template<SizeType width>
+class PlacementList
+{
+public:
+    static constexpr std::size_t capacity = ROTATION_COUNT * width; ///< Maximal number of placements.
+
+    constexpr PlacementList() = default;
+
+    /*
+     * Appends a placement. The list must not be full.
+     */
+    constexpr void push_back(const Placement &placement);
+
+    /*
+     * Returns the number of stored placements.
+     */
+    constexpr std::size_t size() const;
+
+    /*
+     * Returns true if no placements are stored.
+     */
+    constexpr bool empty() const;
+
+    /*
+     * Access operator. Only access for 0 <= index < size().
+     */
+    constexpr const Placement& operator[](const std::size_t index) const;
+
+    /*
+     * Iterators.
+     */
+    constexpr const Placement* begin() const;
+    constexpr const Placement* end() const;
+
+private:
+    std::array<Placement, capacity> _placements{}; ///< storage for placements
+    std::size_t _size{0}; ///< number of stored placements
+};
+
+/*
+ * Returns the column in which new falling shapes appear on a game board of the given width.
+ */
+template<SizeType width>
+constexpr SizeType get_spawn_column();
+
+/*
+ * Enumerates all placements of a shape which are reachable from the spawn position.
+ * A placement is reachable if the shape can be rotated at the spawn position, then shifted horizontally in the
+ * uppermost row and then dropped straight down, exactly like a player would do with the controls.
+ * Only distinct rotations are considered, see is_distinct_rotation().
+ * If the shape does not fit at the spawn position (i.e. the game is over), the list is empty.
+ *
+ * @param[in] boardState occupancy of the landed blocks
+ * @param[in] shapeType type of the shape to place
+ * @return list of reachable placements
+ */
+template<SizeType height, SizeType width>
+constexpr PlacementList<width> generate_placements(const BoardState<height, width> &boardState, const ShapeType shapeType);
+
+/*
+ * Looks up the reachable placement of a shape with a given rotation and column, e.g. one chosen by an external
+ * player. Rotations which cover the same cells as a distinct rotation are accepted as that rotation.
+ *
+ * @param[in] boardState occupancy of the landed blocks
+ * @param[in] shapeType type of the shape to place
+ * @param[in] rotation desired rotation
+ * @param[in] column desired column of the upper left corner
+ * @param[out] placement the reachable placement, unchanged if there is none
+ * @return false if the placement is not reachable
+ */
+template<SizeType height, SizeType width>
+constexpr bool find_placement(const BoardState<height, width> &boardState, const ShapeType shapeType,
+                              const Rotation rotation, const SizeType column, Placement &placement);
+
+/*
+ * Drives the currently falling shape of a game board into a placement using the regular controls
+ * and lets it settle with hard_drop().
+ * The placement must have been generated for the game board's current falling shape.
+ *
+ * @param[in] gameBoard the game board
+ * @param[in] placement the desired placement
+ */
+template<SizeType height, SizeType width>
+constexpr void apply_placement(GameBoard<height, width> &gameBoard, const Placement &placement);
+
+#include "placement.hpp"
+#endif /* PLACEMENT_H_ */
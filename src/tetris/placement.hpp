@@ -0,0 +1,219 @@
+namespace placement_detail
+{
+    /*
+     * Returns, for every built-in shape, a bit mask with bit r set if rotation r is distinct, see is_distinct_rotation().
+     */
+    constexpr std::array<uint8_t, _SHAPE_COUNT> get_distinct_rotations()
+    {
+        std::array<uint8_t, _SHAPE_COUNT> distinctRotations{};
+        for (uint8_t s = 0; s < _SHAPE_COUNT; ++s)
+        {
+            for (uint8_t r = 0; r < ROTATION_COUNT; ++r)
+            {
+                if (is_distinct_rotation(static_cast<ShapeType>(s), static_cast<Rotation>(r)))
+                {
+                    distinctRotations[s] |= static_cast<uint8_t>(1u << r);
+                }
+            }
+        }
+        return distinctRotations;
+    }
+
+    constexpr std::array<uint8_t, _SHAPE_COUNT> DISTINCT_ROTATIONS = get_distinct_rotations(); ///< distinct rotations of the built-in shapes
+
+    /*
+     * Enumerates all placements of a shape given by the masks of its rotations, see generate_placements().
+     *
+     * @param[in] boardState occupancy of the landed blocks
+     * @param[in] masks masks of the rotations ROT_0, ..., ROT_270
+     * @param[in] shapeType type of the shape stored in the placements
+     * @param[in] spawnColumn column of the upper left corner at the spawn position
+     * @param[in] distinctRotations bit r is set if rotation r is distinct
+     * @param[in] contiguousRotations bit r is set if rotation r has contiguous columns, see has_contiguous_columns()
+     * @return list of reachable placements
+     */
+    template<SizeType height, SizeType width, SizeType extent>
+    constexpr PlacementList<width> generate_placements(const BoardState<height, width> &boardState,
+                                                       const BasicPieceMask<extent> *masks, const ShapeType shapeType,
+                                                       const SizeType spawnColumn, const uint8_t distinctRotations,
+                                                       const uint8_t contiguousRotations)
+    {
+        PlacementList<width> placements;
+        if (!boardState.fits(masks[ROT_0], 0, spawnColumn))
+        {
+            return placements;
+        }
+
+        // rotations are only possible if every intermediate rotation fits at the spawn position
+        const auto fitsAtSpawn = [&boardState, masks, spawnColumn](const Rotation rotation) {
+            return boardState.fits(masks[rotation], 0, spawnColumn);
+        };
+        std::array<bool, ROTATION_COUNT> reachable{};
+        reachable[ROT_0] = true;
+        reachable[ROT_90] = fitsAtSpawn(ROT_90);
+        reachable[ROT_270] = fitsAtSpawn(ROT_270);
+        reachable[ROT_180] = (reachable[ROT_90] || reachable[ROT_270]) && fitsAtSpawn(ROT_180);
+
+        for (uint8_t r = 0; r < ROTATION_COUNT; ++r)
+        {
+            const Rotation rotation = static_cast<Rotation>(r);
+            if (!reachable[rotation] || !((distinctRotations >> r) & 1u))
+            {
+                continue;
+            }
+
+            // shift the rotated shape in the uppermost row as far as possible in both directions and drop it
+            const BasicPieceMask<extent> &piece = masks[rotation];
+            SizeType leftmost = spawnColumn;
+            while (boardState.fits(piece, 0, leftmost - 1))
+            {
+                --leftmost;
+            }
+            for (SizeType column = leftmost; boardState.fits(piece, 0, column); ++column)
+            {
+                // get_drop_row() only looks below the lowest cell of each column, so shapes with gaps drop row by row
+                SizeType row = 0;
+                if ((contiguousRotations >> r) & 1u)
+                {
+                    row = boardState.get_drop_row(piece, 0, column);
+                }
+                else
+                {
+                    while (boardState.fits(piece, row + 1, column))
+                    {
+                        ++row;
+                    }
+                }
+                placements.push_back({shapeType, rotation, row, column});
+            }
+        }
+
+        return placements;
+    }
+}
+
+// PlacementList public:
+
+template<SizeType width>
+constexpr void PlacementList<width>::push_back(const Placement &placement)
+{
+    _placements[_size] = placement;
+    ++_size;
+    return;
+}
+
+template<SizeType width>
+constexpr std::size_t PlacementList<width>::size() const
+{
+    return _size;
+}
+
+template<SizeType width>
+constexpr bool PlacementList<width>::empty() const
+{
+    return _size == 0;
+}
+
+template<SizeType width>
+constexpr const Placement& PlacementList<width>::operator[](const std::size_t index) const
+{
+    return _placements[index];
+}
+
+template<SizeType width>
+constexpr const Placement* PlacementList<width>::begin() const
+{
+    return _placements.data();
+}
+
+template<SizeType width>
+constexpr const Placement* PlacementList<width>::end() const
+{
+    return _placements.data() + _size;
+}
+
+// free functions:
+
+template<SizeType width>
+constexpr SizeType get_spawn_column()
+{
+    // must coincide with the position used by GameBoard for new falling shapes
+    return (width - 1) / 2;
+}
+
+template<SizeType height, SizeType width>
+constexpr PlacementList<width> generate_placements(const BoardState<height, width> &boardState, const ShapeType shapeType)
+{
+    // all built-in shapes have contiguous columns
+    return placement_detail::generate_placements(boardState, PIECE_MASKS[shapeType].data(), shapeType,
+                                                 get_spawn_column<width>(), placement_detail::DISTINCT_ROTATIONS[shapeType],
+                                                 0xF);
+}
+
+template<SizeType height, SizeType width>
+constexpr bool find_placement(const BoardState<height, width> &boardState, const ShapeType shapeType,
+                              const Rotation rotation, const SizeType column, Placement &placement)
+{
+    if (rotation >= ROTATION_COUNT)
+    {
+        return false;
+    }
+
+    const PieceMask &piece = get_piece_mask(shapeType, rotation);
+    for (const Placement &candidate : generate_placements(boardState, shapeType))
+    {
+        const PieceMask &candidatePiece = get_piece_mask(shapeType, candidate.rotation);
+        bool sameCells = candidate.column == column && candidatePiece.height == piece.height;
+        for (SizeType r = 0; r < piece.height && sameCells; ++r)
+        {
+            sameCells = candidatePiece.rows[r] == piece.rows[r];
+        }
+        if (sameCells)
+        {
+            placement = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+template<SizeType height, SizeType width>
+constexpr void apply_placement(GameBoard<height, width> &gameBoard, const Placement &placement)
+{
+    // rotate in the shortest direction. A rotation by 180° goes counterclockwise if ROT_90 is blocked
+    switch (placement.rotation)
+    {
+        case ROT_0:
+            break;
+        case ROT_90:
+            gameBoard.rotate_clockwise_if_valid();
+            break;
+        case ROT_180:
+            gameBoard.rotate_clockwise_if_valid();
+            if (gameBoard.get_current_falling().get_rotation() == ROT_90)
+            {
+                gameBoard.rotate_clockwise_if_valid();
+            }
+            else
+            {
+                gameBoard.rotate_counterclockwise_if_valid();
+                gameBoard.rotate_counterclockwise_if_valid();
+            }
+            break;
+        case ROT_270:
+            gameBoard.rotate_counterclockwise_if_valid();
+            break;
+    }
+
+    // shift horizontally, then let the shape settle
+    for (SizeType column = gameBoard.get_current_falling().get_upper_left_w(); column > placement.column; --column)
+    {
+        gameBoard.move_left_if_valid();
+    }
+    for (SizeType column = gameBoard.get_current_falling().get_upper_left_w(); column < placement.column; ++column)
+    {
+        gameBoard.move_right_if_valid();
+    }
+    gameBoard.hard_drop();
+    return;
+}
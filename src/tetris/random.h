@@ -0,0 +1,43 @@
+#ifndef RANDOM_H_
+#define RANDOM_H_
+
+#include <cstdint>
+
+/*
+ * Minimal standard linear congruential random number generator. It produces the same sequence as
+ * std::minstd_rand, but it is usable in constant expressions and its state can be read and restored.
+ */
+class RandomGenerator
+{
+public:
+    static constexpr uint32_t MULTIPLIER{48271}; ///< Multiplier of the generator.
+    static constexpr uint32_t MODULUS{2147483647}; ///< Modulus of the generator, 2^31 - 1.
+
+    /*
+     * Constructor. A seed which is a multiple of the modulus is replaced by 1.
+     *
+     * @param[in] seed initial state
+     */
+    constexpr explicit RandomGenerator(const uint32_t seed = 1);
+
+    /*
+     * Advances the state and returns it. The result lies in [1, MODULUS - 1].
+     */
+    constexpr uint32_t operator()();
+
+    /*
+     * Returns the current state.
+     */
+    constexpr uint32_t get_state() const;
+
+    /*
+     * Restores a state previously returned by get_state().
+     */
+    constexpr void set_state(const uint32_t state);
+
+private:
+    uint32_t _state; ///< current state
+};
+
+#include "random.hpp"
+#endif /* RANDOM_H_ */
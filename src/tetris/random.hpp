@@ -0,0 +1,22 @@
+// public
+
+constexpr RandomGenerator::RandomGenerator(const uint32_t seed)
+: _state{(seed % MODULUS == 0) ? 1 : seed % MODULUS}
+{}
+
+constexpr uint32_t RandomGenerator::operator()()
+{
+    _state = static_cast<uint32_t>((uint64_t{_state} * MULTIPLIER) % MODULUS);
+    return _state;
+}
+
+constexpr uint32_t RandomGenerator::get_state() const
+{
+    return _state;
+}
+
+constexpr void RandomGenerator::set_state(const uint32_t state)
+{
+    _state = state;
+    return;
+}
@@ -0,0 +1,219 @@
+#ifndef ROLLBACK_H_
+#define ROLLBACK_H_
+
+#include "gameboard.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/*
+ * Rollback netcode for two players, each simulating both game boards locally and sending only its inputs.
+ *
+ * Time is divided into frames of 1/60 s. In every frame, both game boards first apply their player's inputs of
+ * the frame and then advance_frame(). The game boards start from the same seed and all operations of a game board
+ * are deterministic, so both sides compute exactly the same games as long as they apply the same inputs.
+ *
+ * A side does not wait for the inputs of its peer: frames whose remote inputs are still missing are simulated
+ * with the prediction that the peer presses nothing. The game boards are saved at the start of every frame in a
+ * ring buffer. When remote inputs arrive which differ from the prediction, the game boards are restored from the
+ * frame of the first difference and the frames since are simulated again with the actual inputs. The prediction
+ * may run at most ROLLBACK_WINDOW frames ahead of the peer's inputs, which bounds the work of a rollback, and a
+ * side stalls when it would go beyond.
+ *
+ * Packets are self-contained, see write_packet(): each one repeats all inputs the peer has not acknowledged yet,
+ * so lost and reordered packets are repaired by the following ones. Each packet also carries a checksum of the
+ * sender's game boards at its last frame with known inputs of both players, which lets the receiver detect any
+ * divergence of the simulations.
+ */
+
+constexpr uint32_t ROLLBACK_WINDOW{8}; ///< Maximal number of frames simulated ahead of the peer's inputs.
+constexpr uint32_t ROLLBACK_HISTORY{32}; ///< Number of frames whose game boards and inputs are kept.
+constexpr std::size_t ROLLBACK_PACKET_CAPACITY{28 + ROLLBACK_HISTORY}; ///< Maximal size of a packet in bytes.
+
+static_assert(2 * ROLLBACK_WINDOW < ROLLBACK_HISTORY, "ERROR: The history must cover the inputs the peer may lack.");
+
+/*
+ * Controls pressed by a player during a frame, combined as bit mask. They are applied in the order of their bits.
+ */
+enum FrameInput : uint8_t
+{
+    FRAME_INPUT_CLOCKWISE = 1 << 0,
+    FRAME_INPUT_COUNTERCLOCKWISE = 1 << 1,
+    FRAME_INPUT_LEFT = 1 << 2,
+    FRAME_INPUT_RIGHT = 1 << 3,
+    FRAME_INPUT_DOWN = 1 << 4,
+    FRAME_INPUT_HARD_DROP = 1 << 5
+};
+
+/*
+ * Counters of the rollbacks of a session.
+ */
+struct RollbackStatistics
+{
+    uint64_t rollbacks{0}; ///< number of restored game boards
+    uint64_t resimulatedFrames{0}; ///< number of frames simulated again
+    uint32_t maximalRollback{0}; ///< largest number of frames simulated again at once
+    uint64_t stalls{0}; ///< number of calls of advance() which had to wait for the peer
+    uint64_t rejectedPackets{0}; ///< number of packets which were malformed or belonged to another game
+};
+
+/*
+ * Applies the inputs of a frame to a game board and advances it by the frame.
+ *
+ * @param[in,out] gameBoard the game board
+ * @param[in] inputs bit mask of FrameInput
+ */
+template<SizeType height, SizeType width>
+constexpr void simulate_frame(GameBoard<height, width> &gameBoard, const uint8_t inputs);
+
+/*
+ * Returns the FNV-1a hash of the serialized state of a game board, see GameBoard::serialize().
+ *
+ * @param[in] gameBoard the game board
+ * @param[in] hash hash to continue, e.g. the one of another game board
+ * @return the hash
+ */
+template<SizeType height, SizeType width>
+constexpr uint32_t get_checksum(const GameBoard<height, width> &gameBoard, const uint32_t hash = 2166136261u);
+
+/*
+ * One side of a two-player game with rollback. Sending and receiving the packets is left to the caller,
+ * e.g. over a DatagramSocket, so the session itself does not block and does not allocate memory.
+ */
+template<SizeType height, SizeType width>
+class RollbackSession
+{
+public:
+    static constexpr uint32_t PACKET_MAGIC{0x4b424c52}; ///< "RLBK", starts every packet.
+
+    /*
+     * Constructor.
+     *
+     * @param[in] seed seed of both game boards, which must be the same on both sides
+     * @param[in] localPlayer index of the local player, 0 or 1, the peer has the other one
+     */
+    constexpr RollbackSession(const uint32_t seed, const uint8_t localPlayer);
+
+    /*
+     * Default destructor.
+     */
+    ~RollbackSession() = default;
+
+    /*
+     * Returns false while the next frame would be more than ROLLBACK_WINDOW frames ahead of the peer's inputs.
+     */
+    constexpr bool can_advance() const;
+
+    /*
+     * Simulates the next frame with the local player's inputs, after a pending rollback. If the session is too far
+     * ahead of the peer, see can_advance(), only the rollback is performed and the frame is not simulated.
+     *
+     * @param[in] localInputs bit mask of FrameInput pressed by the local player during the frame
+     * @return false if the frame had to be skipped
+     */
+    constexpr bool advance(const uint8_t localInputs);
+
+    /*
+     * Performs a pending rollback, so the game boards reflect all received inputs.
+     */
+    constexpr void synchronise();
+
+    /*
+     * Writes the packet for the peer: the local inputs it has not acknowledged, the acknowledgement of its
+     * inputs and the checksum of the last frame whose inputs are known on both sides.
+     *
+     * Layout, little-endian: magic, seed, number of the first contained frame, number of received remote frames,
+     * number of the checksummed frame and checksum as 32-bit values, the number of contained frames as 16-bit
+     * value, the local player as 8-bit value, one reserved byte and the inputs of the contained frames.
+     *
+     * @param[out] packet buffer of ROLLBACK_PACKET_CAPACITY bytes
+     * @return size of the packet
+     */
+    constexpr std::size_t write_packet(uint8_t *packet) const;
+
+    /*
+     * Takes the inputs and the acknowledgement from a packet of the peer. A rollback is scheduled if inputs of
+     * already simulated frames differ from their prediction.
+     *
+     * @param[in] packet the packet
+     * @param[in] size its size
+     * @return false if the packet is malformed or belongs to another game, it is ignored then
+     */
+    constexpr bool read_packet(const uint8_t *packet, const std::size_t size);
+
+    /*
+     * Returns the game board of a player.
+     *
+     * @param[in] player 0 or 1
+     */
+    constexpr const GameBoard<height, width>& get_game_board(const uint8_t player) const;
+
+    /*
+     * Returns the number of simulated frames.
+     */
+    constexpr uint32_t get_frame() const;
+
+    /*
+     * Returns the number of frames whose inputs of both players are known, which cannot be rolled back anymore.
+     */
+    constexpr uint32_t get_confirmed_frame() const;
+
+    /*
+     * Returns true if the peer's checksum of a confirmed frame differed from the local one.
+     */
+    constexpr bool is_desynchronised() const;
+
+    /*
+     * Returns the counters of the rollbacks.
+     */
+    constexpr const RollbackStatistics& get_statistics() const;
+
+private:
+    /*
+     * Game boards of both players at the start of a frame.
+     */
+    struct FrameState
+    {
+        std::array<GameBoard<height, width>, 2> gameBoards{GameBoard<height, width>(1), GameBoard<height, width>(1)}; ///< the game boards, indexed by player
+    };
+
+    /*
+     * Returns the ring buffer slot of a frame.
+     */
+    static constexpr std::size_t get_slot(const uint32_t frame);
+
+    /*
+     * Returns the checksum of the game boards of both players.
+     */
+    static constexpr uint32_t get_checksum(const FrameState &state);
+
+    /*
+     * Simulates a frame with the stored inputs and saves the game boards at the start of the following frame.
+     */
+    constexpr void simulate_stored_frame(const uint32_t frame);
+
+    /*
+     * Computes the checksums of the frames which have become confirmed and compares the peer's checksum.
+     */
+    constexpr void update_checksums();
+
+private:
+    uint32_t _seed; ///< seed of both game boards
+    uint8_t _localPlayer; ///< index of the local player
+    std::array<FrameState, ROLLBACK_HISTORY> _states{}; ///< game boards at the start of the recent frames, the latest one of frame _frame
+    std::array<std::array<uint8_t, ROLLBACK_HISTORY>, 2> _inputs{}; ///< inputs of the recent frames by player, remote ones predicted until received
+    std::array<uint32_t, ROLLBACK_HISTORY> _checksums{}; ///< checksums of the game boards at the start of the recent confirmed frames
+    uint32_t _frame{0}; ///< number of simulated frames
+    uint32_t _remoteFrame{0}; ///< number of frames whose remote inputs have been received
+    uint32_t _acknowledgedFrame{0}; ///< number of frames whose local inputs the peer has received
+    uint32_t _rollbackFrame{UINT32_MAX}; ///< first frame to simulate again, UINT32_MAX if none
+    uint32_t _checksummedFrame{0}; ///< last frame whose checksum has been computed
+    uint32_t _peerChecksumFrame{0}; ///< frame of the latest checksum of the peer
+    uint32_t _peerChecksum{0}; ///< latest checksum of the peer
+    bool _desynchronised{false}; ///< true if a checksum of the peer differed
+    RollbackStatistics _statistics{}; ///< counters of the rollbacks
+};
+
+#include "rollback.hpp"
+#endif /* ROLLBACK_H_ */
@@ -0,0 +1,283 @@
+#include <algorithm>
+
+namespace rollback_detail
+{
+    constexpr std::size_t PACKET_HEADER_SIZE{28}; ///< size of a packet without its inputs
+
+    static_assert(ROLLBACK_PACKET_CAPACITY == PACKET_HEADER_SIZE + ROLLBACK_HISTORY, "ERROR: Wrong packet capacity.");
+
+    /*
+     * Stores a 32-bit value little-endian.
+     */
+    constexpr void store_value(uint8_t *data, const uint32_t value)
+    {
+        for (std::size_t b = 0; b < 4; ++b)
+        {
+            data[b] = static_cast<uint8_t>(value >> (8 * b));
+        }
+        return;
+    }
+
+    /*
+     * Loads a 32-bit value stored little-endian.
+     */
+    constexpr uint32_t load_value(const uint8_t *data)
+    {
+        uint32_t value = 0;
+        for (std::size_t b = 0; b < 4; ++b)
+        {
+            value |= static_cast<uint32_t>(data[b]) << (8 * b);
+        }
+        return value;
+    }
+}
+
+// free functions
+
+template<SizeType height, SizeType width>
+constexpr void simulate_frame(GameBoard<height, width> &gameBoard, const uint8_t inputs)
+{
+    if (inputs != 0 && !gameBoard.is_game_over())
+    {
+        if (inputs & FRAME_INPUT_CLOCKWISE)
+        {
+            gameBoard.rotate_clockwise_if_valid();
+        }
+        if (inputs & FRAME_INPUT_COUNTERCLOCKWISE)
+        {
+            gameBoard.rotate_counterclockwise_if_valid();
+        }
+        if (inputs & FRAME_INPUT_LEFT)
+        {
+            gameBoard.move_left_if_valid();
+        }
+        if (inputs & FRAME_INPUT_RIGHT)
+        {
+            gameBoard.move_right_if_valid();
+        }
+        if (inputs & FRAME_INPUT_DOWN)
+        {
+            gameBoard.move_down_if_valid();
+        }
+        if (inputs & FRAME_INPUT_HARD_DROP)
+        {
+            gameBoard.hard_drop();
+        }
+    }
+    gameBoard.advance_frame();
+    return;
+}
+
+template<SizeType height, SizeType width>
+constexpr uint32_t get_checksum(const GameBoard<height, width> &gameBoard, const uint32_t hash)
+{
+    uint32_t result = hash;
+    for (const uint8_t byte : gameBoard.serialize())
+    {
+        result = (result ^ byte) * 16777619u;
+    }
+    return result;
+}
+
+// public:
+
+template<SizeType height, SizeType width>
+constexpr RollbackSession<height, width>::RollbackSession(const uint32_t seed, const uint8_t localPlayer)
+    : _seed(seed), _localPlayer(localPlayer & 1)
+{
+    _states[get_slot(0)].gameBoards = {GameBoard<height, width>(seed), GameBoard<height, width>(seed)};
+    _checksums[get_slot(0)] = get_checksum(_states[get_slot(0)]);
+    _peerChecksum = _checksums[get_slot(0)]; // the peer starts from the same seed, which every packet confirms
+}
+
+template<SizeType height, SizeType width>
+constexpr bool RollbackSession<height, width>::can_advance() const
+{
+    return _frame < _remoteFrame + ROLLBACK_WINDOW && _frame < _acknowledgedFrame + ROLLBACK_HISTORY;
+}
+
+template<SizeType height, SizeType width>
+constexpr bool RollbackSession<height, width>::advance(const uint8_t localInputs)
+{
+    synchronise();
+    if (!can_advance())
+    {
+        ++_statistics.stalls;
+        return false;
+    }
+
+    // a frame without received remote inputs is predicted to have none
+    const std::size_t slot = get_slot(_frame);
+    _inputs[_localPlayer][slot] = localInputs;
+    if (_frame >= _remoteFrame)
+    {
+        _inputs[1 - _localPlayer][slot] = 0;
+    }
+    simulate_stored_frame(_frame);
+    ++_frame;
+    update_checksums();
+    return true;
+}
+
+template<SizeType height, SizeType width>
+constexpr void RollbackSession<height, width>::synchronise()
+{
+    if (_rollbackFrame < _frame)
+    {
+        // the saved game boards of the first mispredicted frame are still valid, all later ones are simulated again
+        const uint32_t frameCount = _frame - _rollbackFrame;
+        for (uint32_t frame = _rollbackFrame; frame < _frame; ++frame)
+        {
+            simulate_stored_frame(frame);
+        }
+        ++_statistics.rollbacks;
+        _statistics.resimulatedFrames += frameCount;
+        _statistics.maximalRollback = std::max(_statistics.maximalRollback, frameCount);
+    }
+    _rollbackFrame = UINT32_MAX;
+    update_checksums();
+    return;
+}
+
+template<SizeType height, SizeType width>
+constexpr std::size_t RollbackSession<height, width>::write_packet(uint8_t *packet) const
+{
+    using namespace rollback_detail;
+
+    const uint32_t frameCount = _frame - _acknowledgedFrame;
+    store_value(packet, PACKET_MAGIC);
+    store_value(packet + 4, _seed);
+    store_value(packet + 8, _acknowledgedFrame);
+    store_value(packet + 12, _remoteFrame);
+    store_value(packet + 16, _checksummedFrame);
+    store_value(packet + 20, _checksums[get_slot(_checksummedFrame)]);
+    packet[24] = static_cast<uint8_t>(frameCount);
+    packet[25] = static_cast<uint8_t>(frameCount >> 8);
+    packet[26] = _localPlayer;
+    packet[27] = 0;
+    for (uint32_t f = 0; f < frameCount; ++f)
+    {
+        packet[PACKET_HEADER_SIZE + f] = _inputs[_localPlayer][get_slot(_acknowledgedFrame + f)];
+    }
+    return PACKET_HEADER_SIZE + frameCount;
+}
+
+template<SizeType height, SizeType width>
+constexpr bool RollbackSession<height, width>::read_packet(const uint8_t *packet, const std::size_t size)
+{
+    using namespace rollback_detail;
+
+    const uint32_t frameCount = (size >= PACKET_HEADER_SIZE) ? (packet[24] | (packet[25] << 8)) : 0;
+    if (size < PACKET_HEADER_SIZE || load_value(packet) != PACKET_MAGIC || load_value(packet + 4) != _seed
+        || packet[26] != 1 - _localPlayer || frameCount > ROLLBACK_HISTORY || size != PACKET_HEADER_SIZE + frameCount)
+    {
+        ++_statistics.rejectedPackets;
+        return false;
+    }
+
+    // the peer cannot have received inputs which have not been sent yet
+    _acknowledgedFrame = std::max(_acknowledgedFrame, std::min(load_value(packet + 12), _frame));
+
+    // only the next missing frames are taken, as far as their slots are not needed for a rollback anymore
+    const uint8_t remotePlayer = 1 - _localPlayer;
+    const uint32_t firstFrame = load_value(packet + 8);
+    for (uint32_t frame = std::max(firstFrame, _remoteFrame); frame < firstFrame + frameCount; ++frame)
+    {
+        if (frame != _remoteFrame || frame >= _frame + ROLLBACK_HISTORY - ROLLBACK_WINDOW)
+        {
+            break;
+        }
+        const uint8_t inputs = packet[PACKET_HEADER_SIZE + frame - firstFrame];
+        uint8_t &stored = _inputs[remotePlayer][get_slot(frame)];
+        if (frame < _frame && stored != inputs)
+        {
+            _rollbackFrame = std::min(_rollbackFrame, frame);
+        }
+        stored = inputs;
+        ++_remoteFrame;
+    }
+
+    const uint32_t checksumFrame = load_value(packet + 16);
+    if (checksumFrame >= _peerChecksumFrame)
+    {
+        _peerChecksumFrame = checksumFrame;
+        _peerChecksum = load_value(packet + 20);
+    }
+    update_checksums();
+    return true;
+}
+
+template<SizeType height, SizeType width>
+constexpr const GameBoard<height, width>& RollbackSession<height, width>::get_game_board(const uint8_t player) const
+{
+    return _states[get_slot(_frame)].gameBoards[player & 1];
+}
+
+template<SizeType height, SizeType width>
+constexpr uint32_t RollbackSession<height, width>::get_frame() const
+{
+    return _frame;
+}
+
+template<SizeType height, SizeType width>
+constexpr uint32_t RollbackSession<height, width>::get_confirmed_frame() const
+{
+    return std::min(_frame, _remoteFrame);
+}
+
+template<SizeType height, SizeType width>
+constexpr bool RollbackSession<height, width>::is_desynchronised() const
+{
+    return _desynchronised;
+}
+
+template<SizeType height, SizeType width>
+constexpr const RollbackStatistics& RollbackSession<height, width>::get_statistics() const
+{
+    return _statistics;
+}
+
+// private:
+
+template<SizeType height, SizeType width>
+constexpr std::size_t RollbackSession<height, width>::get_slot(const uint32_t frame)
+{
+    return frame % ROLLBACK_HISTORY;
+}
+
+template<SizeType height, SizeType width>
+constexpr uint32_t RollbackSession<height, width>::get_checksum(const FrameState &state)
+{
+    return ::get_checksum(state.gameBoards[1], ::get_checksum(state.gameBoards[0]));
+}
+
+template<SizeType height, SizeType width>
+constexpr void RollbackSession<height, width>::simulate_stored_frame(const uint32_t frame)
+{
+    FrameState &next = _states[get_slot(frame + 1)];
+    next = _states[get_slot(frame)];
+    for (uint8_t player = 0; player < 2; ++player)
+    {
+        simulate_frame(next.gameBoards[player], _inputs[player][get_slot(frame)]);
+    }
+    return;
+}
+
+template<SizeType height, SizeType width>
+constexpr void RollbackSession<height, width>::update_checksums()
+{
+    // the game boards of frames after a pending rollback are not final yet
+    const uint32_t confirmedFrame = std::min(get_confirmed_frame(), _rollbackFrame);
+    for (uint32_t frame = _checksummedFrame + 1; frame <= confirmedFrame; ++frame)
+    {
+        _checksums[get_slot(frame)] = get_checksum(_states[get_slot(frame)]);
+        _checksummedFrame = frame;
+    }
+
+    if (_peerChecksumFrame <= _checksummedFrame && _checksummedFrame - _peerChecksumFrame < ROLLBACK_HISTORY - ROLLBACK_WINDOW
+        && _checksums[get_slot(_peerChecksumFrame)] != _peerChecksum)
+    {
+        _desynchronised = true;
+    }
+    return;
+}
@@ -0,0 +1,228 @@
+#include "save_journal.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+    constexpr char MAGIC[8] = {'T', 'E', 'T', 'R', 'I', 'S', 'S', 'V'}; ///< identifies checkpoint files
+    constexpr uint32_t VERSION = 1; ///< version of the file format
+    constexpr char CHECKPOINT_NAME[] = "checkpoint"; ///< name of the checkpoint file in the save directory
+    constexpr char TEMPORARY_CHECKPOINT_NAME[] = "checkpoint.tmp"; ///< name of a checkpoint being written
+
+    /*
+     * Header of a checkpoint file. It is followed by the serialized game board.
+     */
+    struct CheckpointHeader
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t size;
+        uint32_t checksum;
+        uint32_t reserved;
+    };
+
+    /*
+     * Stores a value little-endian.
+     */
+    void put_bytes(uint8_t *destination, const uint32_t value, const std::size_t bytes)
+    {
+        for (std::size_t b = 0; b < bytes; ++b)
+        {
+            destination[b] = static_cast<uint8_t>(value >> (8 * b));
+        }
+        return;
+    }
+
+    /*
+     * Loads a little-endian value.
+     */
+    uint32_t get_bytes(const uint8_t *source, const std::size_t bytes)
+    {
+        uint32_t value = 0;
+        for (std::size_t b = 0; b < bytes; ++b)
+        {
+            value |= uint32_t{source[b]} << (8 * b);
+        }
+        return value;
+    }
+
+    /*
+     * Writes a whole buffer, retrying after interruptions and short writes.
+     */
+    bool write_fully(const int fileDescriptor, const void *data, const std::size_t size)
+    {
+        const char *bytes = static_cast<const char*>(data);
+        std::size_t written = 0;
+        while (written < size)
+        {
+            const ssize_t result = write(fileDescriptor, bytes + written, size - written);
+            if (result < 0 && errno != EINTR)
+            {
+                return false;
+            }
+            written += (result > 0) ? static_cast<std::size_t>(result) : 0;
+        }
+        return true;
+    }
+}
+
+// free functions
+
+std::string save_journal_detail::get_checkpoint_path(const std::string &directory)
+{
+    return directory + "/" + CHECKPOINT_NAME;
+}
+
+std::string save_journal_detail::get_journal_path(const std::string &directory)
+{
+    return directory + "/journal";
+}
+
+uint32_t save_journal_detail::compute_checksum(const uint8_t *data, const std::size_t size)
+{
+    uint32_t hash = 2166136261u;
+    for (std::size_t b = 0; b < size; ++b)
+    {
+        hash = (hash ^ data[b]) * 16777619u;
+    }
+    return hash;
+}
+
+save_journal_detail::LockRecord save_journal_detail::encode_lock(const LockEvent &lock, const uint32_t checkpointChecksum)
+{
+    // index (4), checkpoint checksum (4), shape type, rotation, row, column, level, 3 reserved bytes, checksum (4)
+    LockRecord record{};
+    put_bytes(&record[0], lock.index, 4);
+    put_bytes(&record[4], checkpointChecksum, 4);
+    record[8] = lock.shapeType;
+    record[9] = lock.rotation;
+    record[10] = static_cast<uint8_t>(lock.row);
+    record[11] = static_cast<uint8_t>(lock.column);
+    record[12] = lock.level;
+    put_bytes(&record[16], compute_checksum(record.data(), 16), 4);
+    return record;
+}
+
+bool save_journal_detail::decode_lock(const uint8_t *record, LockEvent &lock, uint32_t &checkpointChecksum)
+{
+    if (get_bytes(&record[16], 4) != compute_checksum(record, 16) || record[8] >= _SHAPE_COUNT || record[9] > ROT_270)
+    {
+        return false;
+    }
+
+    lock.index = get_bytes(&record[0], 4);
+    checkpointChecksum = get_bytes(&record[4], 4);
+    lock.shapeType = static_cast<ShapeType>(record[8]);
+    lock.rotation = static_cast<Rotation>(record[9]);
+    lock.row = static_cast<SizeType>(record[10]);
+    lock.column = static_cast<SizeType>(record[11]);
+    lock.level = record[12];
+    return true;
+}
+
+bool save_journal_detail::write_checkpoint(const int directoryDescriptor, const uint8_t *state, const std::size_t size)
+{
+    CheckpointHeader header{};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.size = static_cast<uint32_t>(size);
+    header.checksum = compute_checksum(state, size);
+
+    const int fileDescriptor = openat(directoryDescriptor, TEMPORARY_CHECKPOINT_NAME,
+                                      O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fileDescriptor < 0)
+    {
+        return false;
+    }
+    const bool written = write_fully(fileDescriptor, &header, sizeof(header)) && write_fully(fileDescriptor, state, size)
+                         && fsync(fileDescriptor) == 0;
+    close(fileDescriptor);
+
+    // the rename replaces the previous checkpoint atomically, so a crash leaves either the old or the new one
+    if (!written || renameat(directoryDescriptor, TEMPORARY_CHECKPOINT_NAME, directoryDescriptor, CHECKPOINT_NAME) != 0)
+    {
+        unlinkat(directoryDescriptor, TEMPORARY_CHECKPOINT_NAME, 0);
+        return false;
+    }
+    fsync(directoryDescriptor);
+    return true;
+}
+
+bool save_journal_detail::read_checkpoint(const std::string &directory, uint8_t *state, const std::size_t size,
+                                          uint32_t &checksum)
+{
+    MappedFile file;
+    if (!file.open(get_checkpoint_path(directory)) || file.get_size() != sizeof(CheckpointHeader) + size)
+    {
+        return false;
+    }
+
+    CheckpointHeader header{};
+    std::memcpy(&header, file.get_data(), sizeof(header));
+    const uint8_t *payload = file.get_data() + sizeof(header);
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION || header.size != size
+        || header.checksum != compute_checksum(payload, size))
+    {
+        return false;
+    }
+
+    std::memcpy(state, payload, size);
+    checksum = header.checksum;
+    return true;
+}
+
+// MappedFile, public:
+
+save_journal_detail::MappedFile::~MappedFile()
+{
+    if (_mapping != nullptr)
+    {
+        munmap(_mapping, _size);
+    }
+}
+
+bool save_journal_detail::MappedFile::open(const std::string &path)
+{
+    const int fileDescriptor = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fileDescriptor < 0)
+    {
+        return false;
+    }
+
+    struct stat fileStatus{};
+    void *mapping = MAP_FAILED;
+    if (fstat(fileDescriptor, &fileStatus) == 0 && fileStatus.st_size > 0)
+    {
+        mapping = mmap(nullptr, fileStatus.st_size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+    }
+    ::close(fileDescriptor); // the mapping stays valid
+
+    if (mapping == MAP_FAILED)
+    {
+        return false;
+    }
+    if (_mapping != nullptr)
+    {
+        munmap(_mapping, _size);
+    }
+    _mapping = mapping;
+    _size = static_cast<std::size_t>(fileStatus.st_size);
+    return true;
+}
+
+const uint8_t* save_journal_detail::MappedFile::get_data() const
+{
+    return static_cast<const uint8_t*>(_mapping);
+}
+
+std::size_t save_journal_detail::MappedFile::get_size() const
+{
+    return _size;
+}
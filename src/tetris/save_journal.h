@@ -0,0 +1,240 @@
+#ifndef SAVE_JOURNAL_H_
+#define SAVE_JOURNAL_H_
+
+#include "gameboard.h"
+#include "spsc_queue.h"
+
+#include <atomic>
+#include <string>
+#include <thread>
+
+/*
+ * A saved game consists of two files in a save directory:
+ * - the checkpoint, a serialized game board (see GameBoard::serialize()) behind a header with a checksum. It is
+ *   replaced atomically by writing a temporary file and renaming it.
+ * - the journal, an append-only sequence of fixed-size lock records written since the checkpoint. Every record
+ *   carries the checksum of the checkpoint it continues and its own checksum, so records of an older checkpoint
+ *   and a torn record at the end of the file are recognised after a crash.
+ */
+namespace save_journal_detail
+{
+    constexpr std::size_t LOCK_RECORD_SIZE{20}; ///< Size of a lock record in the journal.
+
+    using LockRecord = std::array<uint8_t, LOCK_RECORD_SIZE>; ///< Encoded lock event.
+
+    /*
+     * Returns the path of the checkpoint file in a save directory.
+     */
+    std::string get_checkpoint_path(const std::string &directory);
+
+    /*
+     * Returns the path of the journal file in a save directory.
+     */
+    std::string get_journal_path(const std::string &directory);
+
+    /*
+     * Computes the 32-bit FNV-1a hash of a byte sequence.
+     */
+    uint32_t compute_checksum(const uint8_t *data, const std::size_t size);
+
+    /*
+     * Encodes a lock event.
+     *
+     * @param[in] lock the lock event
+     * @param[in] checkpointChecksum checksum of the checkpoint the event follows
+     * @return encoded record
+     */
+    LockRecord encode_lock(const LockEvent &lock, const uint32_t checkpointChecksum);
+
+    /*
+     * Decodes a lock record.
+     *
+     * @param[in] record LOCK_RECORD_SIZE bytes of the journal
+     * @param[out] lock the lock event
+     * @param[out] checkpointChecksum checksum of the checkpoint the event follows
+     * @return false if the record is damaged
+     */
+    bool decode_lock(const uint8_t *record, LockEvent &lock, uint32_t &checkpointChecksum);
+
+    /*
+     * Replaces the checkpoint of a save directory. Returns only after the file has reached the disk.
+     * The files are opened relative to the directory's descriptor, so no paths have to be built.
+     *
+     * @param[in] directoryDescriptor descriptor of the save directory
+     * @param[in] state serialized game board
+     * @param[in] size size of the serialized game board
+     * @return true if the checkpoint has been written
+     */
+    bool write_checkpoint(const int directoryDescriptor, const uint8_t *state, const std::size_t size);
+
+    /*
+     * Maps the checkpoint of a save directory into memory and copies its serialized game board.
+     *
+     * @param[in] directory save directory
+     * @param[out] state serialized game board
+     * @param[in] size expected size of the serialized game board
+     * @param[out] checksum checksum of the serialized game board
+     * @return false if there is no checkpoint of the expected size or it is damaged
+     */
+    bool read_checkpoint(const std::string &directory, uint8_t *state, const std::size_t size, uint32_t &checksum);
+
+    /*
+     * Read-only memory mapping of a whole file.
+     */
+    class MappedFile
+    {
+    public:
+        MappedFile() = default;
+
+        /*
+         * Destructor. Unmaps the file.
+         */
+        ~MappedFile();
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        /*
+         * Maps a file into memory.
+         *
+         * @param[in] path file path
+         * @return false if the file does not exist, is empty or cannot be mapped
+         */
+        bool open(const std::string &path);
+
+        /*
+         * Returns the mapped bytes.
+         */
+        const uint8_t* get_data() const;
+
+        /*
+         * Returns the number of mapped bytes.
+         */
+        std::size_t get_size() const;
+
+    private:
+        void *_mapping{nullptr}; ///< start of the mapping, nullptr if no file is mapped
+        std::size_t _size{0}; ///< size of the mapping
+    };
+}
+
+/*
+ * Restores the game saved in a save directory: the checkpoint is mapped and deserialized, and the lock events
+ * journaled after it are replayed. Replaying stops at the first damaged record.
+ * A finished game is not restored.
+ *
+ * @param[in] directory save directory
+ * @param[out] gameBoard the restored game board, unchanged if false is returned
+ * @return true if a game has been restored
+ */
+template<SizeType height, SizeType width>
+bool load_saved_game(const std::string &directory, GameBoard<height, width> &gameBoard);
+
+/*
+ * Write-behind journal of a running game. The game thread records every lock after it happened, which only
+ * pushes the lock event into a lock-free queue; a background thread appends it to the journal file.
+ * Every CHECKPOINT_INTERVAL locks, the game thread enqueues a serialized game board instead, which the
+ * background thread writes as new checkpoint before it empties the journal.
+ *
+ * The game thread never waits for the disk: if the queue is full, the lock is dropped and a checkpoint is
+ * enqueued with the next lock instead, which covers all locks missing from the journal.
+ */
+template<SizeType height, SizeType width>
+class SaveJournal
+{
+public:
+    static constexpr std::size_t QUEUE_CAPACITY{64}; ///< Maximal number of entries waiting for the disk.
+    static constexpr uint32_t CHECKPOINT_INTERVAL{100}; ///< Maximal number of locks journaled after a checkpoint.
+
+    /*
+     * Constructor. Starts the background thread and checkpoints the current state of the game, which
+     * supersedes any game saved in the directory before.
+     *
+     * @param[in] directory save directory, which must exist
+     * @param[in] gameBoard the game to be journaled
+     */
+    SaveJournal(const std::string &directory, const GameBoard<height, width> &gameBoard);
+
+    /*
+     * Destructor. Writes all pending entries and joins the thread, see stop().
+     */
+    ~SaveJournal();
+
+    SaveJournal(const SaveJournal&) = delete;
+    SaveJournal& operator=(const SaveJournal&) = delete;
+
+    /*
+     * Returns true if the journal file could be opened and the thread has been started.
+     */
+    bool is_running() const;
+
+    /*
+     * Records the lock of the game board, if a shape has settled since the last call. Only to be called by a
+     * single game thread, after every operation which can settle a shape. Never blocks.
+     *
+     * @param[in] gameBoard the journaled game board
+     */
+    void record(const GameBoard<height, width> &gameBoard);
+
+    /*
+     * Writes all pending entries and joins the thread. If locks of the game board are missing from the journal,
+     * e.g. because the queue was full when they were recorded, a final checkpoint is written by the calling
+     * thread, which blocks until it has reached the disk. Only to be called by the game thread.
+     *
+     * @param[in] gameBoard the journaled game board
+     */
+    void stop(const GameBoard<height, width> &gameBoard);
+
+private:
+    /*
+     * Lock event or checkpoint waiting to be written.
+     */
+    struct Entry
+    {
+        bool checkpoint{false}; ///< true if state is to be written as checkpoint, otherwise lock is journaled
+        LockEvent lock{}; ///< lock to journal
+        typename GameBoard<height, width>::SerializedState state{}; ///< game board to checkpoint
+    };
+
+    /*
+     * Writes all pending entries and joins the thread.
+     */
+    void join();
+
+    /*
+     * Writes entries each time the thread is woken up, until it is stopped.
+     */
+    void write_loop();
+
+    /*
+     * Writes one entry to disk.
+     */
+    void write_entry(const Entry &entry);
+
+    /*
+     * Enqueues a checkpoint of the game board.
+     *
+     * @return false if the queue is full
+     */
+    bool enqueue_checkpoint(const GameBoard<height, width> &gameBoard);
+
+    /*
+     * Wakes the background thread up. Never blocks.
+     */
+    void wake();
+
+private:
+    int _directoryDescriptor{-1}; ///< save directory
+    int _journalDescriptor{-1}; ///< journal file, opened for appending
+    int _wakePipe[2]{-1, -1}; ///< written after enqueueing or stopping, waited for by the background thread
+    std::atomic<bool> _stopping{false}; ///< set to make the thread exit after writing all entries
+    uint32_t _recordedLockCount{0}; ///< lock count of the game board at the last call of record()
+    uint32_t _checkpointLockCount{0}; ///< lock count of the game board at the last enqueued checkpoint
+    bool _checkpointPending{false}; ///< true if locks have been dropped since the last enqueued checkpoint
+    uint32_t _checkpointChecksum{0}; ///< checksum of the last written checkpoint
+    SpscQueue<Entry, QUEUE_CAPACITY> _entries{}; ///< entries waiting for the disk
+    std::thread _thread{}; ///< the writing thread
+};
+
+#include "save_journal.hpp"
+#endif /* SAVE_JOURNAL_H_ */
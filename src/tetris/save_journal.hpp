@@ -0,0 +1,225 @@
+#include <cerrno>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+
+// free functions
+
+template<SizeType height, SizeType width>
+bool load_saved_game(const std::string &directory, GameBoard<height, width> &gameBoard)
+{
+    typename GameBoard<height, width>::SerializedState state{};
+    uint32_t checkpointChecksum = 0;
+    GameBoard<height, width> restored(1);
+    if (!save_journal_detail::read_checkpoint(directory, state.data(), state.size(), checkpointChecksum)
+        || !restored.deserialize(state))
+    {
+        return false;
+    }
+
+    save_journal_detail::MappedFile journal;
+    if (journal.open(save_journal_detail::get_journal_path(directory)))
+    {
+        const std::size_t recordCount = journal.get_size() / save_journal_detail::LOCK_RECORD_SIZE;
+        for (std::size_t r = 0; r < recordCount; ++r)
+        {
+            LockEvent lock;
+            uint32_t recordChecksum = 0;
+            if (!save_journal_detail::decode_lock(journal.get_data() + r * save_journal_detail::LOCK_RECORD_SIZE,
+                                                  lock, recordChecksum))
+            {
+                break; // torn by a crash while appending
+            }
+
+            // records from before the checkpoint survive if a crash interrupted emptying the journal
+            if (recordChecksum != checkpointChecksum || lock.index <= restored.get_lock_count())
+            {
+                continue;
+            }
+            if (!restored.replay_lock(lock))
+            {
+                break;
+            }
+        }
+    }
+
+    if (restored.is_game_over())
+    {
+        return false;
+    }
+    gameBoard = restored;
+    return true;
+}
+
+// public:
+
+template<SizeType height, SizeType width>
+SaveJournal<height, width>::SaveJournal(const std::string &directory, const GameBoard<height, width> &gameBoard)
+: _recordedLockCount{gameBoard.get_lock_count()}
+{
+    _directoryDescriptor = open(directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    _journalDescriptor = open(save_journal_detail::get_journal_path(directory).c_str(),
+                              O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (_directoryDescriptor >= 0 && _journalDescriptor >= 0 && pipe2(_wakePipe, O_NONBLOCK | O_CLOEXEC) == 0)
+    {
+        enqueue_checkpoint(gameBoard);
+        _thread = std::thread(&SaveJournal::write_loop, this);
+    }
+}
+
+template<SizeType height, SizeType width>
+SaveJournal<height, width>::~SaveJournal()
+{
+    join();
+
+    for (const int descriptor : {_directoryDescriptor, _journalDescriptor, _wakePipe[0], _wakePipe[1]})
+    {
+        if (descriptor >= 0)
+        {
+            close(descriptor);
+        }
+    }
+}
+
+template<SizeType height, SizeType width>
+bool SaveJournal<height, width>::is_running() const
+{
+    return _thread.joinable();
+}
+
+template<SizeType height, SizeType width>
+void SaveJournal<height, width>::record(const GameBoard<height, width> &gameBoard)
+{
+    const uint32_t lockCount = gameBoard.get_lock_count();
+    if (!is_running() || lockCount == _recordedLockCount)
+    {
+        return;
+    }
+
+    // a checkpoint is also necessary if locks have been missed, since the journal must not have gaps
+    const bool checkpointDue = _checkpointPending || lockCount != _recordedLockCount + 1
+                               || lockCount - _checkpointLockCount >= CHECKPOINT_INTERVAL || gameBoard.is_game_over();
+    _recordedLockCount = lockCount;
+    if (checkpointDue)
+    {
+        _checkpointPending = !enqueue_checkpoint(gameBoard);
+    }
+    else
+    {
+        Entry entry;
+        entry.lock = gameBoard.get_last_lock();
+        _checkpointPending = !_entries.push(entry);
+    }
+    wake();
+    return;
+}
+
+template<SizeType height, SizeType width>
+void SaveJournal<height, width>::stop(const GameBoard<height, width> &gameBoard)
+{
+    if (!is_running())
+    {
+        return;
+    }
+    join();
+
+    if (_checkpointPending || gameBoard.get_lock_count() != _recordedLockCount)
+    {
+        Entry entry;
+        entry.checkpoint = true;
+        entry.state = gameBoard.serialize();
+        write_entry(entry);
+    }
+    return;
+}
+
+// private:
+
+template<SizeType height, SizeType width>
+void SaveJournal<height, width>::join()
+{
+    if (_thread.joinable())
+    {
+        _stopping.store(true, std::memory_order_release);
+        wake();
+        _thread.join();
+    }
+    return;
+}
+
+template<SizeType height, SizeType width>
+void SaveJournal<height, width>::write_loop()
+{
+    pollfd wakeUp{_wakePipe[0], POLLIN, 0};
+    while (true)
+    {
+        if (poll(&wakeUp, 1, -1) < 0 && errno != EINTR)
+        {
+            return;
+        }
+
+        char buffer[64];
+        while (read(_wakePipe[0], buffer, sizeof(buffer)) > 0)
+        {
+        }
+        const bool stopping = _stopping.load(std::memory_order_acquire);
+
+        Entry entry;
+        bool journaled = false;
+        while (_entries.pop(entry))
+        {
+            write_entry(entry);
+            journaled = journaled || !entry.checkpoint;
+        }
+        if (journaled)
+        {
+            fdatasync(_journalDescriptor);
+        }
+        if (stopping)
+        {
+            return;
+        }
+    }
+}
+
+template<SizeType height, SizeType width>
+void SaveJournal<height, width>::write_entry(const Entry &entry)
+{
+    if (entry.checkpoint)
+    {
+        // the journal is only emptied once the checkpoint covering it is safe
+        if (save_journal_detail::write_checkpoint(_directoryDescriptor, entry.state.data(), entry.state.size()))
+        {
+            _checkpointChecksum = save_journal_detail::compute_checksum(entry.state.data(), entry.state.size());
+            (void) ftruncate(_journalDescriptor, 0);
+        }
+        return;
+    }
+
+    const save_journal_detail::LockRecord record = save_journal_detail::encode_lock(entry.lock, _checkpointChecksum);
+    (void) write(_journalDescriptor, record.data(), record.size()); // a short write is detected when loading
+    return;
+}
+
+template<SizeType height, SizeType width>
+bool SaveJournal<height, width>::enqueue_checkpoint(const GameBoard<height, width> &gameBoard)
+{
+    Entry entry;
+    entry.checkpoint = true;
+    entry.state = gameBoard.serialize();
+    if (!_entries.push(entry))
+    {
+        return false;
+    }
+    _checkpointLockCount = gameBoard.get_lock_count();
+    return true;
+}
+
+template<SizeType height, SizeType width>
+void SaveJournal<height, width>::wake()
+{
+    const char wakeUp = 0;
+    (void) write(_wakePipe[1], &wakeUp, 1); // a full pipe already wakes the thread
+    return;
+}
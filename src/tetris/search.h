@@ -0,0 +1,161 @@
+#ifndef SEARCH_H_
+#define SEARCH_H_
+
+#include "evaluation.h"
+#include "placement.h"
+#include "thread_pool.h"
+
+#include <chrono>
+#include <memory>
+
+/*
+ * Settings of the placement search.
+ */
+struct SearchSettings
+{
+    std::chrono::microseconds timeBudget{std::chrono::milliseconds(50)}; ///< Time available for each move, including returning.
+    uint8_t maxDepth{3}; ///< Maximal number of placed shapes per line, including the current and the next shape.
+    EvaluationWeights weights{}; ///< Weights of the board evaluation in the leaves.
+};
+
+/*
+ * Expectimax search over placements of the current shape.
+ *
+ * The current and the next shape are known, all following shapes are unknown. The search builds a tree in
+ * which the player maximises over placements and unknown shapes are averaged over (chance nodes). Chance nodes
+ * are resolved by Monte Carlo sampling: with increasing time, more shape types are sampled per chance node
+ * until all shape types are covered and the average becomes exact. Search depth and number of samples are
+ * increased iteratively until the time budget is exhausted; the result of the last complete iteration is used.
+ *
+ * The subtrees below the placements of the current shape are searched in parallel on a thread pool.
+ * After a move, the subtree of the chosen placement is kept and reused for the next move as soon as the
+ * following shape is revealed. Every inner node checks the time budget. The other subtrees are only freed by
+ * free_discarded(), which callers run between moves, outside of their time budget.
+ *
+ * The tree stores BoardState objects, not full GameBoards.
+ */
+template<SizeType height, SizeType width>
+class ExpectimaxSearch
+{
+public:
+    /*
+     * Constructor.
+     *
+     * @param[in] threadPool thread pool used for searching, must outlive the search
+     * @param[in] settings search settings
+     */
+    explicit ExpectimaxSearch(ThreadPool &threadPool, const SearchSettings &settings = SearchSettings{});
+
+    /*
+     * Default destructor.
+     */
+    ~ExpectimaxSearch() = default;
+
+    /*
+     * Returns the search settings.
+     */
+    const SearchSettings& get_settings() const;
+
+    /*
+     * Searches the best placement of the current shape within the time budget.
+     * If the board state results from the placement returned by the previous call, the previous tree is reused.
+     * If the current shape cannot be placed at all (i.e. the game is over), a placement at the spawn position
+     * is returned.
+     *
+     * @param[in] boardState occupancy of the landed blocks
+     * @param[in] currentShape type of the currently falling shape
+     * @param[in] nextShape type of the shape falling after the current one
+     * @return best placement of the current shape
+     */
+    Placement find_best_placement(const BoardState<height, width> &boardState, const ShapeType currentShape,
+                                  const ShapeType nextShape);
+
+    /*
+     * Returns the search depth of the last complete iteration of the previous call to find_best_placement().
+     */
+    uint8_t get_completed_depth() const;
+
+    /*
+     * Frees the subtrees discarded by the previous call to find_best_placement(). Freeing a large tree takes
+     * milliseconds, so this is meant to run between moves. Subtrees which are still discarded are freed by the next
+     * call to find_best_placement(), within its time budget.
+     */
+    void free_discarded();
+
+    /*
+     * Discards the search tree.
+     */
+    void reset();
+
+private:
+    /*
+     * Node of the search tree. The node represents the board state after a placement. If shapeType is a valid
+     * shape, the node is a decision node whose children are the placements of this shape. Otherwise, the shape
+     * is unknown and the node is a chance node with one child per sampled shape type.
+     */
+    struct Node
+    {
+        BoardState<height, width> boardState{}; ///< occupancy after placement
+        Placement placement{}; ///< placement leading to this node
+        ShapeType shapeType{_SHAPE_COUNT}; ///< shape to place next, _SHAPE_COUNT if unknown
+        uint16_t completedLines{0}; ///< number of rows cleared on the way from the root
+        float score{0}; ///< static evaluation of the board state
+        bool expanded{false}; ///< indicating whether the children have been created
+        std::vector<std::unique_ptr<Node>> children{}; ///< placements or sampled shape types
+    };
+
+    /*
+     * Creates the children of a decision node, one for each reachable placement.
+     *
+     * @param[in] node decision node
+     * @param[in] childShapeType shape to be placed in the children, _SHAPE_COUNT if unknown
+     */
+    void expand_decision(Node &node, const ShapeType childShapeType) const;
+
+    /*
+     * Returns the decision node below a chance node corresponding to a certain shape type. Creates it if necessary.
+     */
+    Node& get_chance_child(Node &node, const ShapeType shapeType) const;
+
+    /*
+     * Computes the expectimax value of a node.
+     *
+     * @param[in] node node to evaluate
+     * @param[in] depth remaining number of placements
+     * @param[in] samples number of sampled shape types per chance node
+     * @return value of the node, meaningless if the time budget has been exceeded
+     */
+    float evaluate(Node &node, const uint8_t depth, const uint8_t samples);
+
+    /*
+     * Returns the order in which shape types are sampled in a chance node. The order is pseudo-random,
+     * but deterministic for a given board state, so that increasing the sample count extends the previous sample.
+     */
+    std::array<ShapeType, _SHAPE_COUNT> get_sampling_order(const BoardState<height, width> &boardState) const;
+
+    /*
+     * Checks whether the time budget has been exceeded.
+     */
+    bool is_timed_out();
+
+    /*
+     * Replaces a chance node by the decision node of the now revealed shape type. The subtrees of the other shape
+     * types are kept for free_discarded().
+     */
+    void reveal_shape(std::unique_ptr<Node> &node, const ShapeType shapeType);
+
+private:
+    ThreadPool &_threadPool; ///< thread pool for searching the root's children in parallel
+    SearchSettings _settings; ///< search settings
+
+    std::unique_ptr<Node> _root{}; ///< root of the search tree, kept between moves
+    std::vector<std::unique_ptr<Node>> _discarded{}; ///< subtrees discarded by the previous move, not freed yet
+    std::vector<float> _rootValues{}; ///< values of the root's children in the current iteration
+    uint8_t _completedDepth{0}; ///< depth of the last complete iteration
+
+    std::chrono::steady_clock::time_point _deadline{}; ///< end of the time budget of the current move
+    std::atomic<bool> _timedOut{false}; ///< indicating whether the time budget has been exceeded
+};
+
+#include "search.hpp"
+#endif /* SEARCH_H_ */
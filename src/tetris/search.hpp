@@ -0,0 +1,249 @@
+#include <iterator>
+#include <random>
+
+// public:
+
+template<SizeType height, SizeType width>
+ExpectimaxSearch<height, width>::ExpectimaxSearch(ThreadPool &threadPool, const SearchSettings &settings)
+: _threadPool{threadPool},
+_settings{settings}
+{}
+
+template<SizeType height, SizeType width>
+const SearchSettings& ExpectimaxSearch<height, width>::get_settings() const
+{
+    return _settings;
+}
+
+template<SizeType height, SizeType width>
+Placement ExpectimaxSearch<height, width>::find_best_placement(const BoardState<height, width> &boardState,
+                                                               const ShapeType currentShape, const ShapeType nextShape)
+{
+    // the search stops a sixteenth early, so unwinding it and returning still fit into the budget
+    _deadline = std::chrono::steady_clock::now() + _settings.timeBudget - _settings.timeBudget / 16;
+    _timedOut = false;
+    free_discarded();
+
+    // reuse the subtree of the previously chosen placement, now that the next shape is revealed
+    if (_root && _root->boardState == boardState && _root->shapeType == currentShape)
+    {
+        for (std::unique_ptr<Node> &child : _root->children)
+        {
+            reveal_shape(child, nextShape);
+        }
+    }
+    else
+    {
+        _root = std::make_unique<Node>();
+        _root->boardState = boardState;
+        _root->shapeType = currentShape;
+    }
+
+    if (!_root->expanded)
+    {
+        expand_decision(*_root, nextShape);
+    }
+    if (_root->children.empty())
+    {
+        const Placement spawnPlacement{currentShape, ROT_0, 0, get_spawn_column<width>()};
+        _root.reset();
+        return spawnPlacement;
+    }
+
+    // iterative deepening. Depth 1 only uses static scores and hence always completes
+    std::size_t bestChild = 0;
+    _completedDepth = 0;
+    _rootValues.resize(_root->children.size());
+    for (uint8_t depth = 1; depth <= _settings.maxDepth && !_timedOut; ++depth)
+    {
+        // chance nodes are only reached from depth 3 on
+        const uint8_t maxSamples = (depth >= 3) ? _SHAPE_COUNT : 1;
+        for (uint8_t samples = 1; samples <= maxSamples && !_timedOut; ++samples)
+        {
+            _threadPool.parallel_for(_root->children.size(), [this, depth, samples](const std::size_t index) {
+                _rootValues[index] = evaluate(*_root->children[index], depth - 1, samples);
+            });
+            if (_timedOut)
+            {
+                break;
+            }
+
+            bestChild = std::max_element(_rootValues.begin(), _rootValues.end()) - _rootValues.begin();
+            _completedDepth = depth;
+        }
+    }
+
+    // keep the subtree of the chosen placement for the next move, the rest is left to free_discarded()
+    std::unique_ptr<Node> chosen = std::move(_root->children[bestChild]);
+    _discarded.push_back(std::move(_root));
+    _root = std::move(chosen);
+    return _root->placement;
+}
+
+template<SizeType height, SizeType width>
+uint8_t ExpectimaxSearch<height, width>::get_completed_depth() const
+{
+    return _completedDepth;
+}
+
+template<SizeType height, SizeType width>
+void ExpectimaxSearch<height, width>::free_discarded()
+{
+    _discarded.clear();
+    return;
+}
+
+template<SizeType height, SizeType width>
+void ExpectimaxSearch<height, width>::reset()
+{
+    _root.reset();
+    _discarded.clear();
+    return;
+}
+
+// private:
+
+template<SizeType height, SizeType width>
+void ExpectimaxSearch<height, width>::expand_decision(Node &node, const ShapeType childShapeType) const
+{
+    constexpr std::size_t childCapacity = PlacementList<width>::capacity;
+
+    const PlacementList<width> placements = generate_placements(node.boardState, node.shapeType);
+    std::array<BoardState<height, width>, childCapacity> boardStates;
+    node.children.reserve(placements.size());
+    for (const Placement &placement : placements)
+    {
+        std::unique_ptr<Node> child = std::make_unique<Node>();
+        child->boardState = node.boardState;
+        const uint8_t clearedRows = child->boardState.place(get_piece_mask(placement.shapeType, placement.rotation),
+                                                            placement.row, placement.column);
+        child->placement = placement;
+        child->shapeType = childShapeType;
+        child->completedLines = node.completedLines + clearedRows;
+        boardStates[node.children.size()] = child->boardState;
+        node.children.push_back(std::move(child));
+    }
+
+    // all children are rated in one batch
+    std::array<BoardFeatures<width>, childCapacity> features;
+    extract_board_features(boardStates.data(), placements.size(), features.data());
+    for (std::size_t c = 0; c < placements.size(); ++c)
+    {
+        node.children[c]->score = evaluate_features(features[c], node.children[c]->completedLines, _settings.weights);
+    }
+    node.expanded = true;
+    return;
+}
+
+template<SizeType height, SizeType width>
+typename ExpectimaxSearch<height, width>::Node& ExpectimaxSearch<height, width>::get_chance_child(Node &node, const ShapeType shapeType) const
+{
+    if (!node.expanded)
+    {
+        node.children.resize(_SHAPE_COUNT);
+        node.expanded = true;
+    }
+
+    std::unique_ptr<Node> &child = node.children[shapeType];
+    if (!child)
+    {
+        child = std::make_unique<Node>();
+        child->boardState = node.boardState;
+        child->placement = node.placement;
+        child->shapeType = shapeType;
+        child->completedLines = node.completedLines;
+        child->score = node.score;
+    }
+    return *child;
+}
+
+template<SizeType height, SizeType width>
+float ExpectimaxSearch<height, width>::evaluate(Node &node, const uint8_t depth, const uint8_t samples)
+{
+    if (depth == 0)
+    {
+        return node.score;
+    }
+    if (is_timed_out())
+    {
+        return GAME_OVER_SCORE;
+    }
+
+    if (node.shapeType == _SHAPE_COUNT) // chance node: average over sampled shape types
+    {
+        const std::array<ShapeType, _SHAPE_COUNT> order = get_sampling_order(node.boardState);
+        float sum = 0;
+        for (uint8_t s = 0; s < samples; ++s)
+        {
+            sum += evaluate(get_chance_child(node, order[s]), depth, samples);
+        }
+        return sum / samples;
+    }
+
+    // decision node: maximise over placements
+    if (!node.expanded)
+    {
+        expand_decision(node, _SHAPE_COUNT);
+    }
+
+    float best = GAME_OVER_SCORE;
+    for (std::unique_ptr<Node> &child : node.children)
+    {
+        best = std::max(best, evaluate(*child, depth - 1, samples));
+    }
+    return best;
+}
+
+template<SizeType height, SizeType width>
+std::array<ShapeType, _SHAPE_COUNT> ExpectimaxSearch<height, width>::get_sampling_order(const BoardState<height, width> &boardState) const
+{
+    // FNV-1a hash of the occupancy seeds the shuffle
+    uint32_t seed = 2166136261u;
+    for (SizeType i = 0; i < height; ++i)
+    {
+        seed = (seed ^ boardState.get_row(i)) * 16777619u;
+    }
+    std::minstd_rand generator(seed);
+
+    std::array<ShapeType, _SHAPE_COUNT> order;
+    for (uint8_t s = 0; s < _SHAPE_COUNT; ++s)
+    {
+        order[s] = static_cast<ShapeType>(s);
+    }
+    std::shuffle(order.begin(), order.end(), generator);
+    return order;
+}
+
+template<SizeType height, SizeType width>
+bool ExpectimaxSearch<height, width>::is_timed_out()
+{
+    if (!_timedOut && std::chrono::steady_clock::now() >= _deadline)
+    {
+        _timedOut = true;
+    }
+    return _timedOut;
+}
+
+template<SizeType height, SizeType width>
+void ExpectimaxSearch<height, width>::reveal_shape(std::unique_ptr<Node> &node, const ShapeType shapeType)
+{
+    if (node->shapeType != _SHAPE_COUNT)
+    {
+        return;
+    }
+
+    if (node->expanded && node->children[shapeType])
+    {
+        std::unique_ptr<Node> revealed = std::move(node->children[shapeType]);
+        _discarded.push_back(std::move(node));
+        node = std::move(revealed);
+    }
+    else
+    {
+        node->shapeType = shapeType;
+        node->expanded = false;
+        std::move(node->children.begin(), node->children.end(), std::back_inserter(_discarded));
+        node->children.clear();
+    }
+    return;
+}
@@ -33,7 +33,7 @@ public:
     /*
      * Returns a pointer to the shape's memory representation.
      */
-    SizeType const * data() const;
+    constexpr static SizeType const * data();
 
     constexpr static SizeType height{2};
     constexpr static SizeType width{2};
@@ -53,7 +53,7 @@ public:
     /*
      * Returns a pointer to the shape's memory representation.
      */
-    SizeType const * data() const;
+    constexpr static SizeType const * data();
 
     constexpr static SizeType height{3};
     constexpr static SizeType width{2};
@@ -74,7 +74,7 @@ public:
     /*
      * Returns a pointer to the shape's memory representation.
      */
-    SizeType const * data() const;
+    constexpr static SizeType const * data();
 
     constexpr static SizeType height{3};
     constexpr static SizeType width{2};
@@ -95,12 +95,10 @@ public:
     /*
      * Returns a pointer to the shape's memory representation.
      */
-    SizeType const * data() const;
+    constexpr static SizeType const * data();
 
     constexpr static SizeType height{4};
     constexpr static SizeType width{1};
-private:
-    ShapeO _shapeO{};
 };
 
 /*
@@ -114,7 +112,7 @@ public:
     /*
      * Returns a pointer to the shape's memory representation.
      */
-    SizeType const * data() const;
+    constexpr static SizeType const * data();
 
     constexpr static SizeType height{2};
     constexpr static SizeType width{3};
@@ -134,7 +132,7 @@ public:
     /*
      * Returns a pointer to the shape's memory representation.
      */
-    SizeType const * data() const;
+    constexpr static SizeType const * data();
 
     constexpr static SizeType height{2};
     constexpr static SizeType width{3};
@@ -154,7 +152,7 @@ public:
     /*
      * Returns a pointer to the shape's memory representation.
      */
-    SizeType const * data() const;
+    constexpr static SizeType const * data();
 
     constexpr static SizeType height{2};
     constexpr static SizeType width{3};
@@ -166,7 +164,8 @@ private:
 /*
  * General shape class.
  * When constructed with a ShapeType, the class takes on the corresponding base shape's properties.
- * All base shapes are contained via composition.
+ * The base shapes' memory representations are static, so the class only stores a pointer to one of them.
+ * All operations are constexpr and can be used in constant expressions.
  */
 class Shape
 {
@@ -175,7 +174,7 @@ public:
      * Constructor. Takes a ShapeType as input and copies its properties into the class.
      * @param[in] shapeType Type of the desired shape.
      */
-    Shape (const ShapeType shapeType);
+    constexpr Shape (const ShapeType shapeType);
 
     /*
      * Access operator. Accesses the memory representation in the form of a _height*_width-matrix.
@@ -185,17 +184,30 @@ public:
      * @param[in] i row index
      * @param[in] j column index
      */
-    CellState operator()(const SizeType i, const SizeType j) const;
+    constexpr CellState operator()(const SizeType i, const SizeType j) const;
 
     /*
      * Returns the shape's height.
      */
-    SizeType get_height() const;
+    constexpr SizeType get_height() const;
 
     /*
      * Returns the shape's width.
      */
-    SizeType get_width() const;
+    constexpr SizeType get_width() const;
+
+    /*
+     * Returns the shape's type.
+     */
+    constexpr ShapeType get_shape_type() const;
+
+private:
+    /*
+     * Returns the properties of the base shape corresponding to shapeType.
+     */
+    constexpr static ShapePointer get_base_data(const ShapeType shapeType);
+    constexpr static SizeType get_base_height(const ShapeType shapeType);
+    constexpr static SizeType get_base_width(const ShapeType shapeType);
 
 private:
     ShapeType _shapeType; ///< Shape type.
@@ -203,14 +215,7 @@ private:
     SizeType _height; ///< Height of underlying base shape.
     SizeType _width; ///< Width of underlying base shape.
     ShapePointer _shapePointer; ///< Pointer to memory representation of underlying base shape.
-
-    ShapeO shapeO{};
-    ShapeL shapeL{};
-    ShapeJ shapeJ{};
-    ShapeI shapeI{};
-    ShapeS shapeS{};
-    ShapeT shapeT{};
-    ShapeZ shapeZ{};
 };
 
+#include "shapes.hpp"
 #endif
@@ -0,0 +1,130 @@
+constexpr SizeType const * ShapeO::data()
+{
+    return _representation.data();
+}
+
+constexpr SizeType const * ShapeL::data()
+{
+    return _representation.data();
+}
+
+constexpr SizeType const * ShapeJ::data()
+{
+    return _representation.data();
+}
+
+constexpr SizeType const * ShapeI::data()
+{
+    // the I shape shares its memory representation with the O shape
+    return ShapeO::data();
+}
+
+constexpr SizeType const * ShapeS::data()
+{
+    return _representation.data();
+}
+
+constexpr SizeType const * ShapeT::data()
+{
+    return _representation.data();
+}
+
+constexpr SizeType const * ShapeZ::data()
+{
+    return _representation.data();
+}
+
+constexpr Shape::Shape (const ShapeType shapeType)
+: _shapeType{shapeType},
+_height{get_base_height(shapeType)},
+_width{get_base_width(shapeType)},
+_shapePointer{get_base_data(shapeType)}
+{}
+
+constexpr CellState Shape::operator()(const SizeType i, const SizeType j) const
+{
+    return _shapePointer[i*_width + j];
+}
+
+constexpr SizeType Shape::get_height() const
+{
+    return _height;
+}
+
+constexpr SizeType Shape::get_width() const
+{
+    return _width;
+}
+
+constexpr ShapeType Shape::get_shape_type() const
+{
+    return _shapeType;
+}
+
+// private
+
+constexpr ShapePointer Shape::get_base_data(const ShapeType shapeType)
+{
+    switch (shapeType)
+    {
+        case SHAPE_O:
+            return ShapeO::data();
+        case SHAPE_L:
+            return ShapeL::data();
+        case SHAPE_J:
+            return ShapeJ::data();
+        case SHAPE_I:
+            return ShapeI::data();
+        case SHAPE_S:
+            return ShapeS::data();
+        case SHAPE_T:
+            return ShapeT::data();
+        case SHAPE_Z:
+        default:
+            return ShapeZ::data();
+    }
+}
+
+constexpr SizeType Shape::get_base_height(const ShapeType shapeType)
+{
+    switch (shapeType)
+    {
+        case SHAPE_O:
+            return ShapeO::height;
+        case SHAPE_L:
+            return ShapeL::height;
+        case SHAPE_J:
+            return ShapeJ::height;
+        case SHAPE_I:
+            return ShapeI::height;
+        case SHAPE_S:
+            return ShapeS::height;
+        case SHAPE_T:
+            return ShapeT::height;
+        case SHAPE_Z:
+        default:
+            return ShapeZ::height;
+    }
+}
+
+constexpr SizeType Shape::get_base_width(const ShapeType shapeType)
+{
+    switch (shapeType)
+    {
+        case SHAPE_O:
+            return ShapeO::width;
+        case SHAPE_L:
+            return ShapeL::width;
+        case SHAPE_J:
+            return ShapeJ::width;
+        case SHAPE_I:
+            return ShapeI::width;
+        case SHAPE_S:
+            return ShapeS::width;
+        case SHAPE_T:
+            return ShapeT::width;
+        case SHAPE_Z:
+        default:
+            return ShapeZ::width;
+    }
+}
@@ -0,0 +1,124 @@
+#include "shared_game.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace shared_game_detail
+{
+    // public:
+
+    SharedSegment::~SharedSegment()
+    {
+        close();
+    }
+
+    bool SharedSegment::create(const std::string &name, const std::size_t size)
+    {
+        close();
+
+        _fileDescriptor = name.empty() ? memfd_create("tetris_games", MFD_CLOEXEC)
+                                       : shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0600);
+        if (_fileDescriptor < 0)
+        {
+            return false;
+        }
+        if (!name.empty())
+        {
+            _ownedName = name;
+        }
+
+        // a new segment is filled with zeros
+        if (ftruncate(_fileDescriptor, static_cast<off_t>(size)) != 0 || !map(size))
+        {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    bool SharedSegment::attach(const std::string &name)
+    {
+        close();
+
+        _fileDescriptor = shm_open(name.c_str(), O_RDWR | O_CLOEXEC, 0);
+        struct stat fileStatus{};
+        if (_fileDescriptor < 0 || fstat(_fileDescriptor, &fileStatus) != 0 || !map(fileStatus.st_size))
+        {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    bool SharedSegment::attach(const int fileDescriptor)
+    {
+        close();
+
+        _fileDescriptor = fcntl(fileDescriptor, F_DUPFD_CLOEXEC, 0);
+        struct stat fileStatus{};
+        if (_fileDescriptor < 0 || fstat(_fileDescriptor, &fileStatus) != 0 || !map(fileStatus.st_size))
+        {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    void SharedSegment::close()
+    {
+        if (_mapping)
+        {
+            munmap(_mapping, _size);
+            _mapping = nullptr;
+            _size = 0;
+        }
+        if (_fileDescriptor >= 0)
+        {
+            ::close(_fileDescriptor);
+            _fileDescriptor = -1;
+        }
+        if (!_ownedName.empty())
+        {
+            shm_unlink(_ownedName.c_str());
+            _ownedName.clear();
+        }
+        return;
+    }
+
+    void* SharedSegment::get_data() const
+    {
+        return _mapping;
+    }
+
+    std::size_t SharedSegment::get_size() const
+    {
+        return _size;
+    }
+
+    int SharedSegment::get_file_descriptor() const
+    {
+        return _fileDescriptor;
+    }
+
+    // private:
+
+    bool SharedSegment::map(const std::size_t size)
+    {
+        if (size == 0)
+        {
+            return false;
+        }
+
+        void * const mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, _fileDescriptor, 0);
+        if (mapping == MAP_FAILED)
+        {
+            return false;
+        }
+
+        _mapping = mapping;
+        _size = size;
+        return true;
+    }
+}
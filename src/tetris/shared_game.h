@@ -0,0 +1,330 @@
+#ifndef SHARED_GAME_H_
+#define SHARED_GAME_H_
+
+#include "gameboard.h"
+
+#include <array>
+#include <atomic>
+#include <string>
+#include <vector>
+
+/*
+ * Shared-memory interface between the engine and bots running on the same machine.
+ *
+ * The engine publishes the games in a shared memory segment, created with shm_open() if it has a name or with
+ * memfd_create() otherwise, whose descriptor can then be inherited by a bot process. The segment consists of a
+ * header followed by one slot per game. Each slot holds
+ *   - the game state: packed occupancy, current and next shape, line clears, game over flag and the number
+ *     of the requested move, guarded by a sequence lock, and
+ *   - a move word, into which the bot posts its placement together with the number of the answered move.
+ *
+ * Neither side makes a system call or serialises the board per move: the engine overwrites the state in place
+ * and the bot copies it out of the slot, so a decision costs a copy of a few cache lines. The sequence lock
+ * never blocks the engine; a bot which reads while the engine writes simply retries. Both sides have to be
+ * built with the same board size, which is checked when attaching. When the engine is done, it sets the closed
+ * flag after the header, upon which bots are expected to exit.
+ */
+
+constexpr uint32_t SHARED_GAME_VERSION{2}; ///< Version of the segment layout.
+
+/*
+ * Game state of a slot as seen by a bot.
+ */
+template<SizeType height, SizeType width>
+struct SharedGameView
+{
+    BoardState<height, width> boardState{}; ///< occupancy of the landed blocks
+    uint32_t moveNumber{0}; ///< number of the requested move, starting at 1, 0 if the slot is unused
+    uint32_t lineClears{0}; ///< number of rows cleared so far
+    ShapeType currentShape{SHAPE_O}; ///< type of the shape to place
+    ShapeType nextShape{SHAPE_O}; ///< type of the shape falling after the current one
+    bool gameOver{false}; ///< true if the game has ended, then no move is requested
+};
+
+namespace shared_game_detail
+{
+    constexpr char SEGMENT_MAGIC[8] = {'T', 'E', 'T', 'R', 'I', 'S', 'G', 'M'}; ///< identifies a segment
+
+    /*
+     * Header at the start of a segment.
+     */
+    struct SegmentHeader
+    {
+        char magic[8]; ///< SEGMENT_MAGIC
+        uint32_t version; ///< SHARED_GAME_VERSION
+        uint32_t gameCount; ///< number of game slots
+        uint32_t slotSize; ///< size of a game slot in bytes
+        uint8_t height; ///< board height
+        uint8_t width; ///< board width
+    };
+
+    constexpr std::size_t CACHE_LINE_SIZE{64}; ///< assumed size of a cache line
+    constexpr std::size_t CLOSED_FLAG_OFFSET{32}; ///< offset of the closed flag, a std::atomic<uint32_t>, in the segment
+
+    /*
+     * Slot of a game. The state is stored as atomic words, which are copied in and out of a SharedGameView,
+     * so that reading it concurrently with the engine writing it is well-defined.
+     */
+    template<SizeType height, SizeType width>
+    struct alignas(CACHE_LINE_SIZE) GameSlot
+    {
+        static constexpr std::size_t WORD_COUNT = (sizeof(SharedGameView<height, width>) + 7) / 8; ///< size of the state in words
+
+        std::atomic<uint32_t> sequence; ///< sequence lock, odd while the engine writes the state
+        std::array<std::atomic<uint64_t>, WORD_COUNT> state; ///< copy of a SharedGameView
+        alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> move; ///< move posted by the bot, see encode_move()
+    };
+
+    /*
+     * Packs a placement and the number of the move it answers into a move word. A word of 0 denotes no move.
+     */
+    constexpr uint64_t encode_move(const uint32_t moveNumber, const Rotation rotation, const SizeType column);
+
+    /*
+     * Returns the number of the move a move word answers.
+     */
+    constexpr uint32_t get_move_number(const uint64_t move);
+
+    /*
+     * Returns the rotation of a move word.
+     */
+    constexpr Rotation get_move_rotation(const uint64_t move);
+
+    /*
+     * Returns the column of a move word.
+     */
+    constexpr SizeType get_move_column(const uint64_t move);
+
+    /*
+     * Mapping of a shared memory segment.
+     */
+    class SharedSegment
+    {
+    public:
+        SharedSegment() = default;
+
+        /*
+         * Destructor. Unmaps the segment and closes its descriptor.
+         */
+        ~SharedSegment();
+
+        SharedSegment(const SharedSegment&) = delete;
+        SharedSegment& operator=(const SharedSegment&) = delete;
+
+        /*
+         * Creates and maps a zero-filled segment. A previously mapped segment is unmapped.
+         *
+         * @param[in] name POSIX shared memory name like "/tetris", or empty for an anonymous memfd
+         * @param[in] size size in bytes
+         * @return false if the segment cannot be created, e.g. because the name is already in use
+         */
+        bool create(const std::string &name, const std::size_t size);
+
+        /*
+         * Maps an existing segment by name. A previously mapped segment is unmapped.
+         *
+         * @param[in] name POSIX shared memory name
+         * @return false if the segment does not exist or cannot be mapped
+         */
+        bool attach(const std::string &name);
+
+        /*
+         * Maps an existing segment by descriptor, e.g. an inherited memfd. The descriptor is duplicated.
+         *
+         * @param[in] fileDescriptor descriptor of the segment
+         * @return false if the segment cannot be mapped
+         */
+        bool attach(const int fileDescriptor);
+
+        /*
+         * Unmaps the segment. A named segment created by this object is removed; processes which have mapped
+         * it keep their mappings.
+         */
+        void close();
+
+        /*
+         * Returns the start of the mapping, nullptr if no segment is mapped.
+         */
+        void* get_data() const;
+
+        /*
+         * Returns the size of the mapping.
+         */
+        std::size_t get_size() const;
+
+        /*
+         * Returns the descriptor of the segment, -1 if no segment is mapped.
+         */
+        int get_file_descriptor() const;
+
+    private:
+        /*
+         * Maps the segment behind _fileDescriptor.
+         */
+        bool map(const std::size_t size);
+
+    private:
+        int _fileDescriptor{-1}; ///< descriptor of the segment
+        void *_mapping{nullptr}; ///< start of the mapping
+        std::size_t _size{0}; ///< size of the mapping
+        std::string _ownedName{}; ///< name of a segment created by this object, removed on close()
+    };
+}
+
+/*
+ * Engine side of the shared-memory interface. Publishes games and collects the bots' moves.
+ * All methods must be called by the same thread.
+ */
+template<SizeType height, SizeType width>
+class SharedGameHost
+{
+public:
+    /*
+     * Constructor. Creates a host without a segment.
+     */
+    SharedGameHost() = default;
+
+    /*
+     * Default destructor. Removes the segment.
+     */
+    ~SharedGameHost() = default;
+
+    SharedGameHost(const SharedGameHost&) = delete;
+    SharedGameHost& operator=(const SharedGameHost&) = delete;
+
+    /*
+     * Creates the segment with the given number of unused game slots.
+     *
+     * @param[in] name POSIX shared memory name like "/tetris", or empty for an anonymous memfd
+     * @param[in] gameCount number of game slots
+     * @return false if the segment cannot be created
+     */
+    bool create(const std::string &name, const uint32_t gameCount);
+
+    /*
+     * Returns the descriptor of the segment, -1 if it has not been created.
+     * An anonymous segment is handed to a bot by letting it inherit this descriptor.
+     */
+    int get_file_descriptor() const;
+
+    /*
+     * Returns the number of game slots.
+     */
+    uint32_t get_game_count() const;
+
+    /*
+     * Publishes the state of a game and requests the next move, unless the game is over.
+     *
+     * @param[in] game index of the slot
+     * @param[in] gameBoard the game
+     */
+    void publish(const uint32_t game, const GameBoard<height, width> &gameBoard);
+
+    /*
+     * Takes the move posted for the last published state of a game.
+     *
+     * @param[in] game index of the slot
+     * @param[out] rotation rotation chosen by the bot
+     * @param[out] column column chosen by the bot
+     * @return false if the bot has not answered the requested move yet
+     */
+    bool take_move(const uint32_t game, Rotation &rotation, SizeType &column);
+
+    /*
+     * Tells the bots that no more moves will be requested, so they can exit.
+     */
+    void close_games();
+
+private:
+    using GameSlot = shared_game_detail::GameSlot<height, width>;
+
+    shared_game_detail::SharedSegment _segment{}; ///< the shared memory
+    std::atomic<uint32_t> *_closed{nullptr}; ///< closed flag in the segment
+    GameSlot *_slots{nullptr}; ///< game slots in the segment
+    uint32_t _gameCount{0}; ///< number of game slots
+    std::vector<uint32_t> _moveNumbers{}; ///< number of the last published state of each game, never reused in a slot
+    std::vector<bool> _awaitingMove{}; ///< true for each game whose last published state requests a move
+};
+
+/*
+ * Bot side of the shared-memory interface, the reference client. Reads games and posts moves.
+ * Different games may be handled by different threads, but each game only by one thread at a time.
+ */
+template<SizeType height, SizeType width>
+class SharedGameClient
+{
+public:
+    /*
+     * Constructor. Creates a detached client.
+     */
+    SharedGameClient() = default;
+
+    /*
+     * Default destructor. Unmaps the segment.
+     */
+    ~SharedGameClient() = default;
+
+    SharedGameClient(const SharedGameClient&) = delete;
+    SharedGameClient& operator=(const SharedGameClient&) = delete;
+
+    /*
+     * Maps the segment of a host by name.
+     *
+     * @param[in] name POSIX shared memory name
+     * @return false if the segment does not exist or was created for another version or board size
+     */
+    bool attach(const std::string &name);
+
+    /*
+     * Maps the segment of a host by an inherited descriptor.
+     *
+     * @param[in] fileDescriptor descriptor of the segment
+     * @return false if the segment cannot be mapped or was created for another version or board size
+     */
+    bool attach(const int fileDescriptor);
+
+    /*
+     * Returns the number of game slots.
+     */
+    uint32_t get_game_count() const;
+
+    /*
+     * Copies the consistent state of a game out of its slot. Spins while the engine writes the slot.
+     *
+     * @param[in] game index of the slot
+     * @param[out] view the game state
+     */
+    void read_game(const uint32_t game, SharedGameView<height, width> &view) const;
+
+    /*
+     * Answers a move request of a game. Answers to outdated requests are ignored by the host.
+     *
+     * @param[in] game index of the slot
+     * @param[in] moveNumber number of the answered move, see SharedGameView::moveNumber
+     * @param[in] rotation rotation of the placement
+     * @param[in] column column of the placement
+     */
+    void post_move(const uint32_t game, const uint32_t moveNumber, const Rotation rotation, const SizeType column);
+
+    /*
+     * Returns true once the host has closed the games, see SharedGameHost::close_games(). The bot should exit then.
+     */
+    bool is_closed() const;
+
+private:
+    /*
+     * Validates the header of the mapped segment.
+     */
+    bool validate();
+
+private:
+    using GameSlot = shared_game_detail::GameSlot<height, width>;
+
+    shared_game_detail::SharedSegment _segment{}; ///< the shared memory
+    const std::atomic<uint32_t> *_closed{nullptr}; ///< closed flag in the segment
+    GameSlot *_slots{nullptr}; ///< game slots in the segment
+    uint32_t _gameCount{0}; ///< number of game slots
+};
+
+#include "shared_game.hpp"
+#endif /* SHARED_GAME_H_ */
@@ -0,0 +1,233 @@
+#include <cstring>
+#include <new>
+#include <type_traits>
+
+// free functions
+
+namespace shared_game_detail
+{
+    constexpr uint64_t encode_move(const uint32_t moveNumber, const Rotation rotation, const SizeType column)
+    {
+        return (uint64_t{moveNumber} << 32) | (uint64_t{rotation} << 8) | uint64_t{static_cast<uint8_t>(column)};
+    }
+
+    constexpr uint32_t get_move_number(const uint64_t move)
+    {
+        return static_cast<uint32_t>(move >> 32);
+    }
+
+    constexpr Rotation get_move_rotation(const uint64_t move)
+    {
+        return static_cast<Rotation>((move >> 8) & 0xFF);
+    }
+
+    constexpr SizeType get_move_column(const uint64_t move)
+    {
+        return static_cast<SizeType>(static_cast<uint8_t>(move & 0xFF));
+    }
+
+    static_assert(sizeof(SegmentHeader) <= CLOSED_FLAG_OFFSET
+                  && CLOSED_FLAG_OFFSET + sizeof(std::atomic<uint32_t>) <= CACHE_LINE_SIZE,
+                  "ERROR: The segment header and the closed flag must fit into a cache line.");
+    static_assert(std::atomic<uint64_t>::is_always_lock_free && std::atomic<uint32_t>::is_always_lock_free,
+                  "ERROR: Atomics in shared memory must be lock-free.");
+    static_assert(get_move_column(encode_move(7, ROT_270, -2)) == -2 && get_move_rotation(encode_move(7, ROT_270, -2)) == ROT_270
+                  && get_move_number(encode_move(7, ROT_270, -2)) == 7, "ERROR: Move words must round-trip.");
+}
+
+// public:
+
+template<SizeType height, SizeType width>
+bool SharedGameHost<height, width>::create(const std::string &name, const uint32_t gameCount)
+{
+    static_assert(std::is_trivially_copyable<SharedGameView<height, width>>::value,
+                  "ERROR: Game states are copied bytewise into shared memory.");
+
+    _closed = nullptr;
+    _slots = nullptr;
+    _gameCount = 0;
+    if (!_segment.create(name, shared_game_detail::CACHE_LINE_SIZE + gameCount * sizeof(GameSlot)))
+    {
+        return false;
+    }
+
+    char * const data = static_cast<char*>(_segment.get_data());
+    _closed = new (data + shared_game_detail::CLOSED_FLAG_OFFSET) std::atomic<uint32_t>{0};
+    _slots = reinterpret_cast<GameSlot*>(data + shared_game_detail::CACHE_LINE_SIZE);
+    for (uint32_t g = 0; g < gameCount; ++g)
+    {
+        new (&_slots[g]) GameSlot{};
+    }
+    _gameCount = gameCount;
+    _moveNumbers.assign(gameCount, 0);
+    _awaitingMove.assign(gameCount, false);
+
+    // the header is written last, clients attaching early reject the segment
+    shared_game_detail::SegmentHeader header{};
+    std::memcpy(header.magic, shared_game_detail::SEGMENT_MAGIC, sizeof(header.magic));
+    header.version = SHARED_GAME_VERSION;
+    header.gameCount = gameCount;
+    header.slotSize = sizeof(GameSlot);
+    header.height = height;
+    header.width = width;
+    std::memcpy(data, &header, sizeof(header));
+    return true;
+}
+
+template<SizeType height, SizeType width>
+int SharedGameHost<height, width>::get_file_descriptor() const
+{
+    return _segment.get_file_descriptor();
+}
+
+template<SizeType height, SizeType width>
+uint32_t SharedGameHost<height, width>::get_game_count() const
+{
+    return _gameCount;
+}
+
+template<SizeType height, SizeType width>
+void SharedGameHost<height, width>::publish(const uint32_t game, const GameBoard<height, width> &gameBoard)
+{
+    SharedGameView<height, width> view;
+    view.boardState = gameBoard.get_board_state();
+    view.moveNumber = ++_moveNumbers[game];
+    view.lineClears = gameBoard.get_line_clears();
+    view.currentShape = gameBoard.get_current_falling().get_shape_type();
+    view.nextShape = gameBoard.get_next_falling().get_shape_type();
+    view.gameOver = gameBoard.is_game_over();
+    _awaitingMove[game] = !view.gameOver;
+
+    std::array<uint64_t, GameSlot::WORD_COUNT> words{};
+    std::memcpy(words.data(), &view, sizeof(view));
+
+    // odd sequence numbers make readers retry until the state is complete again
+    GameSlot &slot = _slots[game];
+    const uint32_t sequence = slot.sequence.load(std::memory_order_relaxed);
+    slot.sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (std::size_t w = 0; w < words.size(); ++w)
+    {
+        slot.state[w].store(words[w], std::memory_order_relaxed);
+    }
+    slot.sequence.store(sequence + 2, std::memory_order_release);
+    return;
+}
+
+template<SizeType height, SizeType width>
+bool SharedGameHost<height, width>::take_move(const uint32_t game, Rotation &rotation, SizeType &column)
+{
+    if (!_awaitingMove[game])
+    {
+        return false;
+    }
+
+    const uint64_t move = _slots[game].move.load(std::memory_order_acquire);
+    if (shared_game_detail::get_move_number(move) != _moveNumbers[game])
+    {
+        return false; // not answered yet, or an answer to an earlier state
+    }
+
+    rotation = shared_game_detail::get_move_rotation(move);
+    column = shared_game_detail::get_move_column(move);
+    _awaitingMove[game] = false;
+    return true;
+}
+
+template<SizeType height, SizeType width>
+void SharedGameHost<height, width>::close_games()
+{
+    if (_closed != nullptr)
+    {
+        _closed->store(1, std::memory_order_release);
+    }
+    return;
+}
+
+template<SizeType height, SizeType width>
+bool SharedGameClient<height, width>::attach(const std::string &name)
+{
+    return _segment.attach(name) && validate();
+}
+
+template<SizeType height, SizeType width>
+bool SharedGameClient<height, width>::attach(const int fileDescriptor)
+{
+    return _segment.attach(fileDescriptor) && validate();
+}
+
+template<SizeType height, SizeType width>
+uint32_t SharedGameClient<height, width>::get_game_count() const
+{
+    return _gameCount;
+}
+
+template<SizeType height, SizeType width>
+void SharedGameClient<height, width>::read_game(const uint32_t game, SharedGameView<height, width> &view) const
+{
+    const GameSlot &slot = _slots[game];
+    std::array<uint64_t, GameSlot::WORD_COUNT> words;
+    uint32_t before = 0;
+    uint32_t after = 0;
+    do
+    {
+        before = slot.sequence.load(std::memory_order_acquire);
+        for (std::size_t w = 0; w < words.size(); ++w)
+        {
+            words[w] = slot.state[w].load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        after = slot.sequence.load(std::memory_order_relaxed);
+    }
+    while ((before & 1) != 0 || before != after);
+
+    std::memcpy(static_cast<void*>(&view), words.data(), sizeof(view));
+    return;
+}
+
+template<SizeType height, SizeType width>
+void SharedGameClient<height, width>::post_move(const uint32_t game, const uint32_t moveNumber,
+                                                const Rotation rotation, const SizeType column)
+{
+    _slots[game].move.store(shared_game_detail::encode_move(moveNumber, rotation, column), std::memory_order_release);
+    return;
+}
+
+template<SizeType height, SizeType width>
+bool SharedGameClient<height, width>::is_closed() const
+{
+    return _closed == nullptr || _closed->load(std::memory_order_acquire) != 0;
+}
+
+// private:
+
+template<SizeType height, SizeType width>
+bool SharedGameClient<height, width>::validate()
+{
+    _closed = nullptr;
+    _slots = nullptr;
+    _gameCount = 0;
+    if (_segment.get_size() < shared_game_detail::CACHE_LINE_SIZE)
+    {
+        _segment.close();
+        return false;
+    }
+
+    shared_game_detail::SegmentHeader header;
+    char * const data = static_cast<char*>(_segment.get_data());
+    std::memcpy(&header, data, sizeof(header));
+    const bool valid = std::memcmp(header.magic, shared_game_detail::SEGMENT_MAGIC, sizeof(header.magic)) == 0
+                       && header.version == SHARED_GAME_VERSION && header.height == height && header.width == width
+                       && header.slotSize == sizeof(GameSlot)
+                       && _segment.get_size() >= shared_game_detail::CACHE_LINE_SIZE + header.gameCount * sizeof(GameSlot);
+    if (!valid)
+    {
+        _segment.close();
+        return false;
+    }
+
+    _closed = reinterpret_cast<const std::atomic<uint32_t>*>(data + shared_game_detail::CLOSED_FLAG_OFFSET);
+    _slots = reinterpret_cast<GameSlot*>(data + shared_game_detail::CACHE_LINE_SIZE);
+    _gameCount = header.gameCount;
+    return true;
+}
@@ -0,0 +1,58 @@
+#ifndef SPSC_QUEUE_H_
+#define SPSC_QUEUE_H_
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+/*
+ * Bounded lock-free queue for exactly one producer thread and one consumer thread.
+ * push() must only be called by the producer and pop() only by the consumer. Neither call blocks or allocates;
+ * the producer and the consumer only synchronise through the two indices, which live on separate cache lines.
+ * T must be default constructible and copy assignable.
+ */
+template<typename T, std::size_t capacity>
+class SpscQueue
+{
+    static_assert(capacity > 0 && (capacity & (capacity - 1)) == 0, "ERROR: Queue capacity must be a power of two.");
+
+public:
+    /*
+     * Constructor. Creates an empty queue.
+     */
+    SpscQueue() = default;
+
+    /*
+     * Default destructor.
+     */
+    ~SpscQueue() = default;
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    /*
+     * Appends an element. Only to be called by the producer.
+     *
+     * @param[in] element element to append
+     * @return false if the queue is full, in which case the element is dropped
+     */
+    bool push(const T &element);
+
+    /*
+     * Removes the oldest element. Only to be called by the consumer.
+     *
+     * @param[out] element the removed element, unchanged if the queue is empty
+     * @return false if the queue is empty
+     */
+    bool pop(T &element);
+
+private:
+    static constexpr std::size_t CACHE_LINE_SIZE{64}; ///< assumed size of a cache line
+
+    alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> _head{0}; ///< number of popped elements, written by the consumer
+    alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> _tail{0}; ///< number of pushed elements, written by the producer
+    alignas(CACHE_LINE_SIZE) std::array<T, capacity> _elements{}; ///< ring buffer of elements
+};
+
+#include "spsc_queue.hpp"
+#endif /* SPSC_QUEUE_H_ */
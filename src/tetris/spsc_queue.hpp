@@ -0,0 +1,29 @@
+// public:
+
+template<typename T, std::size_t capacity>
+bool SpscQueue<T, capacity>::push(const T &element)
+{
+    const std::size_t tail = _tail.load(std::memory_order_relaxed);
+    if (tail - _head.load(std::memory_order_acquire) == capacity)
+    {
+        return false;
+    }
+
+    _elements[tail & (capacity - 1)] = element;
+    _tail.store(tail + 1, std::memory_order_release); // publishes the element to the consumer
+    return true;
+}
+
+template<typename T, std::size_t capacity>
+bool SpscQueue<T, capacity>::pop(T &element)
+{
+    const std::size_t head = _head.load(std::memory_order_relaxed);
+    if (head == _tail.load(std::memory_order_acquire))
+    {
+        return false;
+    }
+
+    element = _elements[head & (capacity - 1)];
+    _head.store(head + 1, std::memory_order_release); // hands the slot back to the producer
+    return true;
+}
@@ -0,0 +1,334 @@
+#include "state_explorer.h"
+
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <utility>
+
+namespace
+{
+    constexpr std::size_t FILE_BUFFER_SIZE{1 << 16}; ///< number of keys read or written at once
+    constexpr unsigned SHARD_BITS{6}; ///< number of bits of the hash selecting the shard
+
+    static_assert(StateSet::SHARD_COUNT == std::size_t{1} << SHARD_BITS, "ERROR: The shards must be selected by whole bits.");
+}
+
+// StateFileWriter public:
+
+StateFileWriter::~StateFileWriter()
+{
+    close();
+}
+
+bool StateFileWriter::open(const std::string &path)
+{
+    close();
+    _file = std::fopen(path.c_str(), "wb");
+    _buffer.reserve(FILE_BUFFER_SIZE);
+    _count = 0;
+    _failed = false;
+    return _file != nullptr;
+}
+
+void StateFileWriter::write(const StateKey key)
+{
+    _buffer.push_back(key);
+    ++_count;
+    if (_buffer.size() == FILE_BUFFER_SIZE)
+    {
+        flush();
+    }
+    return;
+}
+
+uint64_t StateFileWriter::get_count() const
+{
+    return _count;
+}
+
+bool StateFileWriter::close()
+{
+    if (_file == nullptr)
+    {
+        return !_failed;
+    }
+    flush();
+    _failed = (std::fclose(_file) != 0) || _failed;
+    _file = nullptr;
+    return !_failed;
+}
+
+// StateFileWriter private:
+
+void StateFileWriter::flush()
+{
+    if (_file == nullptr || std::fwrite(_buffer.data(), sizeof(StateKey), _buffer.size(), _file) != _buffer.size())
+    {
+        _failed = true;
+    }
+    _buffer.clear();
+    return;
+}
+
+// StateFileReader public:
+
+StateFileReader::~StateFileReader()
+{
+    close();
+}
+
+bool StateFileReader::open(const std::string &path)
+{
+    close();
+    _file = std::fopen(path.c_str(), "rb");
+    _buffer.reserve(FILE_BUFFER_SIZE);
+    return _file != nullptr;
+}
+
+bool StateFileReader::read(StateKey &key)
+{
+    if (_position == _buffer.size())
+    {
+        if (!read(_buffer, FILE_BUFFER_SIZE))
+        {
+            return false;
+        }
+        _position = 0;
+    }
+    key = _buffer[_position++];
+    return true;
+}
+
+bool StateFileReader::read(std::vector<StateKey> &keys, const std::size_t maxCount)
+{
+    // keys still buffered by read(key) come first
+    const std::size_t buffered = std::min(maxCount, _buffer.size() - _position);
+    if (&keys != &_buffer)
+    {
+        keys.assign(_buffer.begin() + _position, _buffer.begin() + _position + buffered);
+        _position += buffered;
+    }
+    else
+    {
+        keys.clear();
+        _position = 0;
+    }
+
+    if (_file != nullptr && keys.size() < maxCount)
+    {
+        const std::size_t offset = keys.size();
+        keys.resize(maxCount);
+        keys.resize(offset + std::fread(keys.data() + offset, sizeof(StateKey), maxCount - offset, _file));
+    }
+    return !keys.empty();
+}
+
+void StateFileReader::close()
+{
+    if (_file != nullptr)
+    {
+        std::fclose(_file);
+        _file = nullptr;
+    }
+    _buffer.clear();
+    _position = 0;
+    return;
+}
+
+// StateSet public:
+
+StateSet::StateSet()
+{
+    for (Shard &shard : _shards)
+    {
+        shard.entries.assign(INITIAL_CAPACITY, EMPTY_KEY);
+    }
+}
+
+bool StateSet::insert(const StateKey key)
+{
+    const uint64_t hash = get_hash(key);
+    Shard &shard = _shards[hash >> (64 - SHARD_BITS)];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    if (4 * (shard.size + 1) > 3 * shard.entries.size())
+    {
+        std::vector<StateKey> entries(2 * shard.entries.size(), EMPTY_KEY);
+        for (const StateKey entry : shard.entries)
+        {
+            if (entry != EMPTY_KEY)
+            {
+                insert_entry(entries, entry, get_hash(entry));
+            }
+        }
+        shard.entries.swap(entries);
+    }
+
+    const bool inserted = insert_entry(shard.entries, key, hash);
+    shard.size += inserted;
+    return inserted;
+}
+
+uint64_t StateSet::get_size() const
+{
+    uint64_t size = 0;
+    for (const Shard &shard : _shards)
+    {
+        size += shard.size;
+    }
+    return size;
+}
+
+std::size_t StateSet::get_memory_usage() const
+{
+    std::size_t memory = 0;
+    for (const Shard &shard : _shards)
+    {
+        memory += shard.entries.capacity() * sizeof(StateKey);
+    }
+    return memory;
+}
+
+void StateSet::write_sorted(StateFileWriter &writer)
+{
+    // move the keys of every shard to the front of its table and sort them there
+    for (Shard &shard : _shards)
+    {
+        const auto end = std::remove(shard.entries.begin(), shard.entries.end(), EMPTY_KEY);
+        std::sort(shard.entries.begin(), end);
+    }
+
+    // the shards are disjoint, so merging them gives every key once
+    using Head = std::pair<StateKey, std::size_t>;
+    std::priority_queue<Head, std::vector<Head>, std::greater<Head>> heads;
+    std::array<std::size_t, SHARD_COUNT> positions{};
+    for (std::size_t s = 0; s < SHARD_COUNT; ++s)
+    {
+        if (_shards[s].size > 0)
+        {
+            heads.push({_shards[s].entries[0], s});
+        }
+    }
+    while (!heads.empty())
+    {
+        const std::size_t s = heads.top().second;
+        writer.write(heads.top().first);
+        heads.pop();
+        if (++positions[s] < _shards[s].size)
+        {
+            heads.push({_shards[s].entries[positions[s]], s});
+        }
+    }
+
+    for (Shard &shard : _shards)
+    {
+        std::vector<StateKey>(INITIAL_CAPACITY, EMPTY_KEY).swap(shard.entries);
+        shard.size = 0;
+    }
+    return;
+}
+
+// StateSet private:
+
+uint64_t StateSet::get_hash(const StateKey key)
+{
+    // finaliser of SplitMix64
+    uint64_t hash = key;
+    hash = (hash ^ (hash >> 30)) * 0xbf58476d1ce4e5b9u;
+    hash = (hash ^ (hash >> 27)) * 0x94d049bb133111ebu;
+    return hash ^ (hash >> 31);
+}
+
+bool StateSet::insert_entry(std::vector<StateKey> &entries, const StateKey key, const uint64_t hash)
+{
+    const std::size_t mask = entries.size() - 1;
+    for (std::size_t index = hash & mask; ; index = (index + 1) & mask)
+    {
+        if (entries[index] == key)
+        {
+            return false;
+        }
+        if (entries[index] == EMPTY_KEY)
+        {
+            entries[index] = key;
+            return true;
+        }
+    }
+}
+
+// free functions
+
+bool merge_state_runs(const std::vector<std::string> &runPaths, const std::string &visitedPath,
+                      const std::string &mergedPath, const std::string &layerPath, uint64_t &layerSize)
+{
+    layerSize = 0;
+
+    std::vector<StateFileReader> runs(runPaths.size());
+    using Head = std::pair<StateKey, std::size_t>;
+    std::priority_queue<Head, std::vector<Head>, std::greater<Head>> heads;
+    for (std::size_t r = 0; r < runs.size(); ++r)
+    {
+        StateKey key = 0;
+        if (!runs[r].open(runPaths[r]))
+        {
+            return false;
+        }
+        if (runs[r].read(key))
+        {
+            heads.push({key, r});
+        }
+    }
+
+    StateFileReader visited;
+    StateFileWriter merged;
+    StateFileWriter layer;
+    if (!visited.open(visitedPath) || !merged.open(mergedPath) || !layer.open(layerPath))
+    {
+        return false;
+    }
+
+    StateKey visitedKey = 0;
+    bool hasVisitedKey = visited.read(visitedKey);
+    StateKey previousKey = 0;
+    bool hasPreviousKey = false;
+    while (!heads.empty())
+    {
+        const StateKey key = heads.top().first;
+        const std::size_t r = heads.top().second;
+        heads.pop();
+        StateKey nextKey = 0;
+        if (runs[r].read(nextKey))
+        {
+            heads.push({nextKey, r});
+        }
+
+        // several runs may contain the same key
+        if (hasPreviousKey && key == previousKey)
+        {
+            continue;
+        }
+        previousKey = key;
+        hasPreviousKey = true;
+
+        // copy all visited keys up to the key, which belongs to the layer if it is not among them
+        while (hasVisitedKey && visitedKey < key)
+        {
+            merged.write(visitedKey);
+            hasVisitedKey = visited.read(visitedKey);
+        }
+        if (!hasVisitedKey || visitedKey != key)
+        {
+            merged.write(key);
+            layer.write(key);
+        }
+    }
+    while (hasVisitedKey)
+    {
+        merged.write(visitedKey);
+        hasVisitedKey = visited.read(visitedKey);
+    }
+
+    layerSize = layer.get_count();
+    const bool mergedWritten = merged.close();
+    return layer.close() && mergedWritten;
+}
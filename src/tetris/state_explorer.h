@@ -0,0 +1,289 @@
+#ifndef STATE_EXPLORER_H_
+#define STATE_EXPLORER_H_
+
+#include "placement.h"
+#include "thread_pool.h"
+
+#include <array>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/*
+ * Breadth-first exploration of all boards which can be reached from the empty board by placing shapes, for any
+ * sequence of shapes. Meant for analysing the state spaces of small game boards, e.g. narrow or short ones.
+ *
+ * A board is identified by its packed occupancy, see get_state_key(). Layer k holds the boards which are reached
+ * with k shapes but not with fewer. The successors of a layer are collected in a StateSet in memory. Whenever the
+ * set exceeds the memory limit, it is written to a sorted run file and emptied, so a layer may be larger than
+ * the memory. After the layer, merge_state_runs() merges the runs and removes the boards of all previous layers,
+ * which are kept in a sorted file as well. All files are read and written sequentially.
+ */
+
+using StateKey = uint64_t; ///< Packed occupancy of all rows of a board, see get_state_key().
+
+/*
+ * Packs the occupancy of a board into a key. Row i occupies the bits starting at (height - 1 - i) * width.
+ *
+ * @param[in] boardState occupancy of the landed blocks
+ * @return the key
+ */
+template<SizeType height, SizeType width>
+constexpr StateKey get_state_key(const BoardState<height, width> &boardState);
+
+/*
+ * Unpacks a key created by get_state_key().
+ *
+ * @param[in] key the key
+ * @return occupancy of the landed blocks
+ */
+template<SizeType height, SizeType width>
+constexpr BoardState<height, width> get_state_from_key(const StateKey key);
+
+/*
+ * Writes keys to a file sequentially, buffered.
+ */
+class StateFileWriter
+{
+public:
+    /*
+     * Constructor. Creates a closed writer.
+     */
+    StateFileWriter() = default;
+
+    /*
+     * Destructor. Closes the file.
+     */
+    ~StateFileWriter();
+
+    StateFileWriter(const StateFileWriter&) = delete;
+    StateFileWriter& operator=(const StateFileWriter&) = delete;
+
+    /*
+     * Creates a file. A previously opened file is closed.
+     *
+     * @param[in] path path of the file, which is replaced if it exists
+     * @return false if the file cannot be created
+     */
+    bool open(const std::string &path);
+
+    /*
+     * Appends a key.
+     */
+    void write(const StateKey key);
+
+    /*
+     * Returns the number of keys written since open().
+     */
+    uint64_t get_count() const;
+
+    /*
+     * Writes the buffered keys and closes the file.
+     *
+     * @return false if any write has failed
+     */
+    bool close();
+
+private:
+    /*
+     * Writes the buffered keys.
+     */
+    void flush();
+
+private:
+    std::FILE *_file{nullptr}; ///< the file
+    std::vector<StateKey> _buffer{}; ///< keys not written yet
+    uint64_t _count{0}; ///< number of written keys
+    bool _failed{false}; ///< true if a write has failed
+};
+
+/*
+ * Reads keys written by a StateFileWriter sequentially, buffered.
+ */
+class StateFileReader
+{
+public:
+    /*
+     * Constructor. Creates a closed reader.
+     */
+    StateFileReader() = default;
+
+    /*
+     * Destructor. Closes the file.
+     */
+    ~StateFileReader();
+
+    StateFileReader(const StateFileReader&) = delete;
+    StateFileReader& operator=(const StateFileReader&) = delete;
+
+    /*
+     * Opens a file. A previously opened file is closed.
+     *
+     * @param[in] path path of the file
+     * @return false if the file cannot be opened
+     */
+    bool open(const std::string &path);
+
+    /*
+     * Reads the next key.
+     *
+     * @param[out] key the key
+     * @return false at the end of the file
+     */
+    bool read(StateKey &key);
+
+    /*
+     * Reads up to maxCount keys.
+     *
+     * @param[out] keys the keys, replacing the previous content
+     * @param[in] maxCount maximal number of keys
+     * @return false if no key was left
+     */
+    bool read(std::vector<StateKey> &keys, const std::size_t maxCount);
+
+    /*
+     * Closes the file.
+     */
+    void close();
+
+private:
+    std::FILE *_file{nullptr}; ///< the file
+    std::vector<StateKey> _buffer{}; ///< keys read from the file
+    std::size_t _position{0}; ///< index of the next key in _buffer
+};
+
+/*
+ * Concurrent hash set of keys, split into shards with a lock each, so threads inserting different keys rarely
+ * wait for each other. Every shard is an open-addressing table with linear probing which doubles when it is three
+ * quarters full.
+ */
+class StateSet
+{
+public:
+    static constexpr std::size_t SHARD_COUNT{64}; ///< Number of independently locked shards.
+
+    /*
+     * Constructor. Creates an empty set.
+     */
+    StateSet();
+
+    /*
+     * Default destructor.
+     */
+    ~StateSet() = default;
+
+    StateSet(const StateSet&) = delete;
+    StateSet& operator=(const StateSet&) = delete;
+
+    /*
+     * Inserts a key. Thread-safe.
+     *
+     * @param[in] key the key, any value except EMPTY_KEY
+     * @return true if the key was not contained yet
+     */
+    bool insert(const StateKey key);
+
+    /*
+     * Returns the number of contained keys. Not thread-safe.
+     */
+    uint64_t get_size() const;
+
+    /*
+     * Returns the memory taken by the tables in bytes. Not thread-safe.
+     */
+    std::size_t get_memory_usage() const;
+
+    /*
+     * Writes all keys in ascending order and empties the set, giving its memory back. Not thread-safe.
+     * The shards are sorted in place, so no memory is needed apart from the tables.
+     *
+     * @param[in,out] writer the opened file to write to
+     */
+    void write_sorted(StateFileWriter &writer);
+
+private:
+    static constexpr StateKey EMPTY_KEY{~StateKey{0}}; ///< marks free entries, not a valid board since full rows are cleared
+    static constexpr std::size_t INITIAL_CAPACITY{1024}; ///< number of entries of an empty shard
+
+    /*
+     * Part of the set with its own lock.
+     */
+    struct Shard
+    {
+        std::mutex mutex{}; ///< guards the members below
+        std::vector<StateKey> entries{}; ///< the table, its size is a power of two
+        std::size_t size{0}; ///< number of contained keys
+    };
+
+    /*
+     * Mixes the bits of a key, so both the shard and the table index can be taken from it.
+     */
+    static uint64_t get_hash(const StateKey key);
+
+    /*
+     * Inserts a key into a table which has a free entry for it.
+     *
+     * @return true if the key was not contained yet
+     */
+    static bool insert_entry(std::vector<StateKey> &entries, const StateKey key, const uint64_t hash);
+
+private:
+    std::array<Shard, SHARD_COUNT> _shards{}; ///< the shards, selected by the highest bits of the hash
+};
+
+/*
+ * Merges sorted run files into the next layer of an exploration, see the top of this file.
+ * Every key contained in any run but not in the visited file forms the next layer, written in ascending order.
+ * The visited file is extended by the next layer.
+ *
+ * @param[in] runPaths paths of the runs, each sorted without duplicates
+ * @param[in] visitedPath path of the sorted keys of all previous layers
+ * @param[in] mergedPath path of the file for the sorted keys of all previous layers and the next layer
+ * @param[in] layerPath path of the file for the sorted keys of the next layer
+ * @param[out] layerSize number of keys of the next layer
+ * @return false if reading or writing has failed
+ */
+bool merge_state_runs(const std::vector<std::string> &runPaths, const std::string &visitedPath,
+                      const std::string &mergedPath, const std::string &layerPath, uint64_t &layerSize);
+
+/*
+ * Settings of an exploration.
+ */
+struct ExplorationSettings
+{
+    std::string directory{"."}; ///< existing directory for the files, which are removed at the end
+    std::size_t memoryLimit{std::size_t{1} << 30}; ///< approximate size of the StateSet in bytes before it is written to a run
+    uint32_t maxDepth{UINT32_MAX}; ///< last layer to explore
+};
+
+/*
+ * Counts of a layer of an exploration.
+ */
+struct DepthStatistics
+{
+    uint32_t depth{0}; ///< number of placed shapes
+    uint64_t states{0}; ///< number of boards first reached with depth shapes
+    uint64_t visitedStates{0}; ///< number of boards reached with at most depth shapes
+    uint64_t transitions{0}; ///< number of placements of any shape on the boards of the layer
+    uint64_t clearedRows{0}; ///< number of rows cleared by these placements
+    std::array<uint64_t, _SHAPE_COUNT + 1> placeableShapes{}; ///< number of boards of the layer by the number of shapes which can still be placed
+    uint32_t runs{0}; ///< number of run files written for the successors of the layer
+};
+
+/*
+ * Explores the boards which can be reached from the empty board, see the top of this file.
+ * A board survives a shape if generate_placements() finds at least one placement, otherwise that shape ends the
+ * game. Boards which survive every shape are expanded like all others, boards which survive no shape have no
+ * successors.
+ *
+ * @param[in] settings the settings
+ * @param[in] threadPool thread pool for expanding the layers
+ * @param[in] report callable with signature void(const DepthStatistics&), called after each layer
+ * @return false if a file could not be read or written
+ */
+template<SizeType height, SizeType width, typename Report>
+bool explore_states(const ExplorationSettings &settings, ThreadPool &threadPool, const Report &report);
+
+#include "state_explorer.hpp"
+#endif /* STATE_EXPLORER_H_ */
@@ -0,0 +1,167 @@
+#include <string>
+
+namespace state_explorer_detail
+{
+    constexpr std::size_t BATCH_SIZE{4096}; ///< number of boards of a layer expanded between two checks of the memory limit
+
+    /*
+     * Places every shape on a board in every reachable way, counts the placements and inserts the resulting
+     * boards.
+     *
+     * @param[in] key the board
+     * @param[in,out] successors set for the resulting boards, nullptr to only count
+     * @param[in,out] statistics counts to add to
+     */
+    template<SizeType height, SizeType width>
+    void expand_state(const StateKey key, StateSet *successors, DepthStatistics &statistics)
+    {
+        const BoardState<height, width> boardState = get_state_from_key<height, width>(key);
+        uint8_t placeableShapes = 0;
+        for (uint8_t s = 0; s < _SHAPE_COUNT; ++s)
+        {
+            const ShapeType shapeType = static_cast<ShapeType>(s);
+            const PlacementList<width> placements = generate_placements(boardState, shapeType);
+            placeableShapes += !placements.empty();
+            statistics.transitions += placements.size();
+            for (const Placement &placement : placements)
+            {
+                BoardState<height, width> successor = boardState;
+                statistics.clearedRows += successor.place(get_piece_mask(shapeType, placement.rotation),
+                                                          placement.row, placement.column);
+                if (successors != nullptr)
+                {
+                    successors->insert(get_state_key(successor));
+                }
+            }
+        }
+        ++statistics.placeableShapes[placeableShapes];
+        return;
+    }
+}
+
+// free functions
+
+template<SizeType height, SizeType width>
+constexpr StateKey get_state_key(const BoardState<height, width> &boardState)
+{
+    static_assert(height * width <= 64, "ERROR: State keys support boards of at most 64 cells.");
+
+    StateKey key = 0;
+    for (SizeType i = 0; i < height; ++i)
+    {
+        key = (key << width) | boardState.get_row(i);
+    }
+    return key;
+}
+
+template<SizeType height, SizeType width>
+constexpr BoardState<height, width> get_state_from_key(const StateKey key)
+{
+    static_assert(height * width <= 64, "ERROR: State keys support boards of at most 64 cells.");
+    using RowType = typename BoardState<height, width>::RowType;
+
+    BoardState<height, width> boardState;
+    for (SizeType i = 0; i < height; ++i)
+    {
+        boardState.set_row(i, static_cast<RowType>((key >> ((height - 1 - i) * width)) & BoardState<height, width>::FULL_ROW));
+    }
+    return boardState;
+}
+
+template<SizeType height, SizeType width, typename Report>
+bool explore_states(const ExplorationSettings &settings, ThreadPool &threadPool, const Report &report)
+{
+    using namespace state_explorer_detail;
+
+    const std::string visitedPath = settings.directory + "/visited.states";
+    const std::string mergedPath = settings.directory + "/merged.states";
+    const std::string layerPath = settings.directory + "/layer.states";
+    const std::string nextLayerPath = settings.directory + "/next_layer.states";
+
+    // layer 0 consists of the empty board
+    bool success = true;
+    for (const std::string &path : {visitedPath, layerPath})
+    {
+        StateFileWriter writer;
+        success = success && writer.open(path);
+        writer.write(get_state_key(BoardState<height, width>()));
+        success = writer.close() && success;
+    }
+
+    StateSet successors;
+    std::vector<StateKey> batch;
+    const std::size_t chunkCount = 8 * threadPool.get_thread_count();
+    std::vector<DepthStatistics> chunkStatistics(chunkCount);
+    uint64_t layerSize = 1;
+    uint64_t visitedCount = 1;
+    for (uint32_t depth = 0; success && layerSize > 0; ++depth)
+    {
+        const bool expand = depth < settings.maxDepth;
+        std::vector<std::string> runPaths;
+        const auto writeRun = [&settings, &successors, &runPaths]() {
+            runPaths.push_back(settings.directory + "/run" + std::to_string(runPaths.size()) + ".states");
+            StateFileWriter run;
+            const bool opened = run.open(runPaths.back());
+            successors.write_sorted(run);
+            return run.close() && opened;
+        };
+
+        StateFileReader layer;
+        success = layer.open(layerPath);
+        while (success && layer.read(batch, BATCH_SIZE))
+        {
+            StateSet * const target = expand ? &successors : nullptr;
+            threadPool.parallel_for(chunkCount, [&batch, &chunkStatistics, chunkCount, target](const std::size_t chunk) {
+                for (std::size_t k = chunk * batch.size() / chunkCount; k < (chunk + 1) * batch.size() / chunkCount; ++k)
+                {
+                    expand_state<height, width>(batch[k], target, chunkStatistics[chunk]);
+                }
+            });
+            if (successors.get_memory_usage() > settings.memoryLimit)
+            {
+                success = writeRun();
+            }
+        }
+        layer.close();
+
+        DepthStatistics statistics;
+        statistics.depth = depth;
+        statistics.states = layerSize;
+        statistics.visitedStates = visitedCount;
+        for (DepthStatistics &counts : chunkStatistics)
+        {
+            statistics.transitions += counts.transitions;
+            statistics.clearedRows += counts.clearedRows;
+            for (std::size_t k = 0; k < counts.placeableShapes.size(); ++k)
+            {
+                statistics.placeableShapes[k] += counts.placeableShapes[k];
+            }
+            counts = DepthStatistics();
+        }
+
+        // the boards of the next layer are all successors which have not been visited before
+        layerSize = 0;
+        if (success && expand)
+        {
+            success = writeRun() && merge_state_runs(runPaths, visitedPath, mergedPath, nextLayerPath, layerSize)
+                      && std::rename(mergedPath.c_str(), visitedPath.c_str()) == 0
+                      && std::rename(nextLayerPath.c_str(), layerPath.c_str()) == 0;
+            visitedCount += layerSize;
+        }
+        for (const std::string &path : runPaths)
+        {
+            std::remove(path.c_str());
+        }
+        statistics.runs = static_cast<uint32_t>(runPaths.size());
+        if (success)
+        {
+            report(statistics);
+        }
+    }
+
+    for (const std::string &path : {visitedPath, mergedPath, layerPath, nextLayerPath})
+    {
+        std::remove(path.c_str());
+    }
+    return success;
+}
@@ -0,0 +1,90 @@
+#include "thread_pool.h"
+
+#include <algorithm>
+
+// public
+
+ThreadPool::ThreadPool(const std::size_t threadCount)
+{
+    const std::size_t totalThreads = threadCount ? threadCount : std::max(1u, std::thread::hardware_concurrency());
+    for (std::size_t t = 1; t < totalThreads; ++t)
+    {
+        _workers.emplace_back(&ThreadPool::worker_loop, this);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _terminate = true;
+    }
+    _loopStarted.notify_all();
+
+    for (std::thread &worker : _workers)
+    {
+        worker.join();
+    }
+}
+
+std::size_t ThreadPool::get_thread_count() const
+{
+    return _workers.size() + 1;
+}
+
+// private
+
+void ThreadPool::run(const std::size_t count, const Invoker invoker, const void *function)
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _invoker = invoker;
+        _function = function;
+        _count = count;
+        _nextIndex = 0;
+        _busyWorkers = _workers.size();
+        ++_generation;
+    }
+    _loopStarted.notify_all();
+
+    process_indices();
+
+    // the loop body must stay alive until every worker has stopped using it
+    std::unique_lock<std::mutex> lock(_mutex);
+    _loopFinished.wait(lock, [this] { return _busyWorkers == 0; });
+    return;
+}
+
+void ThreadPool::process_indices()
+{
+    for (std::size_t index = _nextIndex++; index < _count; index = _nextIndex++)
+    {
+        _invoker(_function, index);
+    }
+    return;
+}
+
+void ThreadPool::worker_loop()
+{
+    uint64_t seenGeneration = 0;
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _loopStarted.wait(lock, [this, seenGeneration] { return _terminate || _generation != seenGeneration; });
+            if (_terminate)
+            {
+                return;
+            }
+            seenGeneration = _generation;
+        }
+
+        process_indices();
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            --_busyWorkers;
+        }
+        _loopFinished.notify_one();
+    }
+}
@@ -0,0 +1,86 @@
+#ifndef THREAD_POOL_H_
+#define THREAD_POOL_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*
+ * Fixed-size pool of worker threads for data-parallel loops.
+ * The workers are created once and sleep while no loop is running, so running a loop neither creates
+ * threads nor allocates memory. Only one loop runs at a time; the calling thread takes part in it.
+ */
+class ThreadPool
+{
+public:
+    /*
+     * Constructor.
+     *
+     * @param[in] threadCount total number of threads taking part in a loop, including the calling thread.
+     *                        0 means one thread per hardware thread.
+     */
+    explicit ThreadPool(const std::size_t threadCount = 0);
+
+    /*
+     * Destructor. Waits for all workers to terminate.
+     */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /*
+     * Returns the total number of threads taking part in a loop, including the calling thread.
+     */
+    std::size_t get_thread_count() const;
+
+    /*
+     * Calls function(index) for every 0 <= index < count, distributed over all threads of the pool.
+     * Returns as soon as all calls have finished. Calls for different indices may run concurrently,
+     * so function must be safe to call from several threads.
+     *
+     * @param[in] count number of indices
+     * @param[in] function callable with signature void(std::size_t)
+     */
+    template<typename Function>
+    void parallel_for(const std::size_t count, const Function &function);
+
+private:
+    using Invoker = void (*)(const void *function, const std::size_t index); ///< type-erased call of the loop body
+
+    /*
+     * Publishes a loop to the workers, takes part in it and waits until it has finished.
+     */
+    void run(const std::size_t count, const Invoker invoker, const void *function);
+
+    /*
+     * Takes indices of the current loop and calls the loop body until no indices are left.
+     */
+    void process_indices();
+
+    /*
+     * Main function of each worker thread.
+     */
+    void worker_loop();
+
+private:
+    std::vector<std::thread> _workers; ///< worker threads, the calling thread is not contained
+    std::mutex _mutex; ///< protects the loop description and the counters below
+    std::condition_variable _loopStarted; ///< notifies workers about a new loop or termination
+    std::condition_variable _loopFinished; ///< notifies the calling thread that all workers are done
+
+    Invoker _invoker{nullptr}; ///< loop body of the current loop
+    const void *_function{nullptr}; ///< callable of the current loop
+    std::size_t _count{0}; ///< number of indices of the current loop
+    std::atomic<std::size_t> _nextIndex{0}; ///< next index to process in the current loop
+    std::size_t _busyWorkers{0}; ///< number of workers still working on the current loop
+    uint64_t _generation{0}; ///< incremented for each loop, so workers can detect new loops
+    bool _terminate{false}; ///< indicating whether the workers should terminate
+};
+
+#include "thread_pool.hpp"
+#endif /* THREAD_POOL_H_ */
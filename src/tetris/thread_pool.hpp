@@ -0,0 +1,9 @@
+template<typename Function>
+void ThreadPool::parallel_for(const std::size_t count, const Function &function)
+{
+    const Invoker invoker = [](const void *f, const std::size_t index) {
+        (*static_cast<const Function*>(f))(index);
+    };
+    run(count, invoker, &function);
+    return;
+}
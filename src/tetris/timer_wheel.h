@@ -0,0 +1,79 @@
+#ifndef TIMER_WHEEL_H_
+#define TIMER_WHEEL_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/*
+ * Hashed timer wheel for many timers with deadlines in discrete ticks, e.g. frames.
+ * Each timer is stored in the slot of its deadline modulo the number of slots, so scheduling takes constant time
+ * and advancing by one tick only visits the timers of one slot, regardless of the number of timers. Timers more
+ * than one revolution ahead stay in their slot until their deadline is reached.
+ * Timers cannot be cancelled; owners which reschedule are expected to ignore stale expirations, e.g. by
+ * comparing the expired deadline with the current one. The slots keep their capacity, so a wheel with a steady
+ * number of timers does not allocate memory.
+ * T must be copyable.
+ */
+template<typename T, std::size_t slotCount>
+class TimerWheel
+{
+    static_assert(slotCount > 0 && (slotCount & (slotCount - 1)) == 0, "ERROR: Slot count must be a power of two.");
+
+public:
+    /*
+     * Constructor. Creates an empty wheel at tick 0.
+     */
+    TimerWheel() = default;
+
+    /*
+     * Default destructor.
+     */
+    ~TimerWheel() = default;
+
+    /*
+     * Schedules a timer. A deadline which has already passed expires with the next advance().
+     *
+     * @param[in] tick deadline of the timer
+     * @param[in] payload value passed to the callback of advance() on expiry
+     */
+    void schedule(const uint64_t tick, const T &payload);
+
+    /*
+     * Advances the wheel to a tick and expires all timers whose deadline has been reached.
+     * The callback may schedule further timers.
+     *
+     * @param[in] tick the new current tick, not less than the current one
+     * @param[in] expire callable taking the payload of each expired timer
+     */
+    template<typename Callback>
+    void advance(const uint64_t tick, Callback &&expire);
+
+    /*
+     * Returns the current tick.
+     */
+    uint64_t get_current_tick() const;
+
+    /*
+     * Returns the number of scheduled timers.
+     */
+    std::size_t size() const;
+
+private:
+    /*
+     * Scheduled timer.
+     */
+    struct Timer
+    {
+        uint64_t tick; ///< deadline
+        T payload; ///< value passed on expiry
+    };
+
+    std::array<std::vector<Timer>, slotCount> _slots{}; ///< timers by deadline modulo slotCount
+    uint64_t _currentTick{0}; ///< tick up to which all timers have expired
+    std::size_t _size{0}; ///< number of scheduled timers
+};
+
+#include "timer_wheel.hpp"
+#endif /* TIMER_WHEEL_H_ */
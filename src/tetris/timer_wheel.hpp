@@ -0,0 +1,60 @@
+// public:
+
+template<typename T, std::size_t slotCount>
+void TimerWheel<T, slotCount>::schedule(const uint64_t tick, const T &payload)
+{
+    const uint64_t deadline = (tick > _currentTick) ? tick : _currentTick + 1;
+    _slots[deadline & (slotCount - 1)].push_back({deadline, payload});
+    ++_size;
+    return;
+}
+
+template<typename T, std::size_t slotCount>
+template<typename Callback>
+void TimerWheel<T, slotCount>::advance(const uint64_t tick, Callback &&expire)
+{
+    // after a long pause, every slot is visited once instead of once per tick
+    const bool fullRevolution = tick - _currentTick > slotCount;
+    const uint64_t firstTick = fullRevolution ? tick - slotCount + 1 : _currentTick + 1;
+    if (fullRevolution)
+    {
+        _currentTick = tick; // timers scheduled by the callback are due after the tick
+    }
+
+    for (uint64_t slotTick = firstTick; slotTick <= tick; ++slotTick)
+    {
+        if (!fullRevolution)
+        {
+            _currentTick = slotTick;
+        }
+
+        std::vector<Timer> &slot = _slots[slotTick & (slotCount - 1)];
+        std::size_t t = 0;
+        while (t < slot.size())
+        {
+            if (slot[t].tick > _currentTick)
+            {
+                ++t; // due in a later revolution
+                continue;
+            }
+            const T payload = slot[t].payload;
+            slot[t] = slot.back();
+            slot.pop_back();
+            --_size;
+            expire(payload);
+        }
+    }
+    return;
+}
+
+template<typename T, std::size_t slotCount>
+uint64_t TimerWheel<T, slotCount>::get_current_tick() const
+{
+    return _currentTick;
+}
+
+template<typename T, std::size_t slotCount>
+std::size_t TimerWheel<T, slotCount>::size() const
+{
+    return _size;
+}
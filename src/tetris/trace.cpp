@@ -0,0 +1,155 @@
+#include "trace.h"
+
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <unistd.h>
+
+namespace
+{
+    /*
+     * Recorded span.
+     */
+    struct Span
+    {
+        const char *name; ///< name of the span
+        uint64_t start; ///< start time in nanoseconds
+        uint64_t end; ///< end time in nanoseconds
+    };
+
+    /*
+     * Ring buffer of the spans of one thread.
+     */
+    struct ThreadBuffer
+    {
+        std::array<Span, trace_detail::BUFFER_CAPACITY> spans{}; ///< spans by their number modulo the capacity
+        std::atomic<uint64_t> count{0}; ///< number of spans recorded so far
+        std::atomic<const char*> name{nullptr}; ///< name of the thread, nullptr if unnamed
+        uint32_t threadId{0}; ///< identifier of the thread in the trace
+    };
+
+    std::mutex registryMutex; ///< guards buffers
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers; ///< buffers of all threads which have recorded spans
+
+    thread_local ThreadBuffer *threadBuffer{nullptr}; ///< buffer of the calling thread
+
+    /*
+     * Returns the buffer of the calling thread, registering it on first use.
+     * Buffers are kept when their thread ends, so its spans remain in the trace.
+     */
+    ThreadBuffer& get_thread_buffer()
+    {
+        if (!threadBuffer)
+        {
+            std::unique_ptr<ThreadBuffer> buffer = std::make_unique<ThreadBuffer>();
+            std::lock_guard<std::mutex> lock(registryMutex);
+            buffer->threadId = static_cast<uint32_t>(buffers.size() + 1);
+            threadBuffer = buffer.get();
+            buffers.push_back(std::move(buffer));
+        }
+        return *threadBuffer;
+    }
+}
+
+namespace trace_detail
+{
+    std::atomic<bool> enabled{false};
+
+    uint64_t get_timestamp()
+    {
+        static const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+        const std::chrono::nanoseconds elapsed = std::chrono::steady_clock::now() - epoch;
+        return static_cast<uint64_t>(elapsed.count()) + 1;
+    }
+
+    void record(const char *name, const uint64_t start, const uint64_t end)
+    {
+        ThreadBuffer &buffer = get_thread_buffer();
+        const uint64_t count = buffer.count.load(std::memory_order_relaxed);
+        buffer.spans[count & (BUFFER_CAPACITY - 1)] = Span{name, start, end};
+        buffer.count.store(count + 1, std::memory_order_release);
+        return;
+    }
+}
+
+// public:
+
+TraceScope::TraceScope(const char *name)
+: _name{name},
+  _mark{trace_begin()}
+{
+}
+
+TraceScope::~TraceScope()
+{
+    trace_end(_mark, _name);
+}
+
+// free functions
+
+void set_tracing_enabled(const bool enabled)
+{
+    if (enabled)
+    {
+        trace_detail::get_timestamp(); // starts the clock
+    }
+    trace_detail::enabled.store(enabled, std::memory_order_relaxed);
+    return;
+}
+
+bool is_tracing_enabled()
+{
+    return trace_detail::enabled.load(std::memory_order_relaxed);
+}
+
+void set_trace_thread_name(const char *name)
+{
+    get_thread_buffer().name.store(name, std::memory_order_relaxed);
+    return;
+}
+
+bool write_trace(const std::string &path)
+{
+    FILE * const file = std::fopen(path.c_str(), "w");
+    if (!file)
+    {
+        return false;
+    }
+
+    const int processId = static_cast<int>(getpid());
+    std::fprintf(file, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+    bool first = true;
+    const auto separate = [file, &first]() {
+        std::fputs(first ? "" : ",\n", file);
+        first = false;
+    };
+
+    std::lock_guard<std::mutex> lock(registryMutex);
+    for (const std::unique_ptr<ThreadBuffer> &buffer : buffers)
+    {
+        const char * const name = buffer->name.load(std::memory_order_relaxed);
+        if (name)
+        {
+            separate();
+            std::fprintf(file, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%u,\"args\":{\"name\":\"%s\"}}",
+                         processId, buffer->threadId, name);
+        }
+
+        // only the last BUFFER_CAPACITY spans are still in the ring buffer
+        const uint64_t count = buffer->count.load(std::memory_order_acquire);
+        const uint64_t oldest = count > trace_detail::BUFFER_CAPACITY ? count - trace_detail::BUFFER_CAPACITY : 0;
+        for (uint64_t s = oldest; s < count; ++s)
+        {
+            const Span &span = buffer->spans[s & (trace_detail::BUFFER_CAPACITY - 1)];
+            separate();
+            std::fprintf(file, "{\"name\":\"%s\",\"ph\":\"X\",\"pid\":%d,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                         span.name, processId, buffer->threadId, span.start / 1000.0, (span.end - span.start) / 1000.0);
+        }
+    }
+    std::fprintf(file, "\n]}\n");
+    return std::fclose(file) == 0;
+}
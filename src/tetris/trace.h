@@ -0,0 +1,115 @@
+#ifndef TRACE_H_
+#define TRACE_H_
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+/*
+ * Timeline tracing of scoped spans, written as Chrome trace-event JSON for chrome://tracing or Perfetto.
+ *
+ * Every thread records its spans into its own fixed-size ring buffer, which is allocated and registered when the
+ * thread records its first span. Afterwards, recording a span takes two clock readings and one store into the
+ * buffer, without allocating memory or taking a lock, so tracing can stay enabled in production. The oldest
+ * spans are overwritten once a buffer is full. While tracing is disabled, a span costs one relaxed load.
+ *
+ * Spans in constexpr code, e.g. the GameBoard methods, are taken with trace_begin() and trace_end(), which do
+ * nothing during constant evaluation. Other code uses TraceScope. Span names must be string literals or
+ * otherwise outlive the trace, since only their pointers are recorded.
+ */
+namespace trace_detail
+{
+    constexpr std::size_t BUFFER_CAPACITY{1 << 15}; ///< number of spans kept per thread, a power of two
+
+    extern std::atomic<bool> enabled; ///< true while spans are recorded
+
+    /*
+     * Returns the current time in nanoseconds since the first call, at least 1.
+     */
+    uint64_t get_timestamp();
+
+    /*
+     * Records a span of the calling thread.
+     *
+     * @param[in] name name of the span
+     * @param[in] start start time as returned by get_timestamp()
+     * @param[in] end end time as returned by get_timestamp()
+     */
+    void record(const char *name, const uint64_t start, const uint64_t end);
+}
+
+/*
+ * Start of a span taken by trace_begin().
+ */
+struct TraceMark
+{
+    uint64_t start{0}; ///< start time, 0 if the span is not recorded
+};
+
+/*
+ * Records spans in the enclosing scope, from construction to destruction.
+ */
+class TraceScope
+{
+public:
+    /*
+     * Constructor. Starts the span.
+     *
+     * @param[in] name name of the span
+     */
+    explicit TraceScope(const char *name);
+
+    /*
+     * Destructor. Ends and records the span.
+     */
+    ~TraceScope();
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    const char *_name; ///< name of the span
+    TraceMark _mark; ///< start of the span
+};
+
+/*
+ * Enables or disables the recording of spans. Spans already recorded are kept.
+ */
+void set_tracing_enabled(const bool enabled);
+
+/*
+ * Returns true if spans are recorded.
+ */
+bool is_tracing_enabled();
+
+/*
+ * Names the calling thread in the trace. The name must outlive the trace.
+ */
+void set_trace_thread_name(const char *name);
+
+/*
+ * Starts a span. Does nothing during constant evaluation or while tracing is disabled.
+ *
+ * @return start of the span, to be passed to trace_end()
+ */
+constexpr TraceMark trace_begin();
+
+/*
+ * Ends and records a span started by trace_begin().
+ *
+ * @param[in] mark start of the span
+ * @param[in] name name of the span
+ */
+constexpr void trace_end(const TraceMark &mark, const char *name);
+
+/*
+ * Writes the spans of all threads as Chrome trace-event JSON. Spans recorded by threads which are running at
+ * the same time may be incomplete, so threads of interest should be stopped or idle.
+ *
+ * @param[in] path path of the written file
+ * @return false if the file could not be written
+ */
+bool write_trace(const std::string &path);
+
+#include "trace.hpp"
+#endif /* TRACE_H_ */
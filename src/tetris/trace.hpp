@@ -0,0 +1,20 @@
+// free functions
+
+constexpr TraceMark trace_begin()
+{
+    if (__builtin_is_constant_evaluated() || !trace_detail::enabled.load(std::memory_order_relaxed))
+    {
+        return TraceMark{};
+    }
+    return TraceMark{trace_detail::get_timestamp()};
+}
+
+constexpr void trace_end(const TraceMark &mark, const char *name)
+{
+    // a span which has started while tracing was enabled is recorded even if it has been disabled since
+    if (mark.start != 0)
+    {
+        trace_detail::record(name, mark.start, trace_detail::get_timestamp());
+    }
+    return;
+}
@@ -0,0 +1,69 @@
+#ifndef TRIPLE_BUFFER_H_
+#define TRIPLE_BUFFER_H_
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+/*
+ * Lock-free triple buffer handing values from exactly one writer thread to exactly one reader thread.
+ * The writer fills the back slot and publishes it, the reader fetches the most recently published slot to the
+ * front. Neither side ever waits for the other: the writer can publish at any rate and the reader skips all values
+ * which have been superseded before it fetched them. The third slot is exchanged between both through an atomic
+ * index, together with a flag telling whether it holds a value the reader has not seen yet.
+ * T must be default constructible.
+ */
+template<typename T>
+class TripleBuffer
+{
+public:
+    /*
+     * Constructor. Creates a buffer of three default constructed values, none of them published.
+     */
+    TripleBuffer() = default;
+
+    /*
+     * Default destructor.
+     */
+    ~TripleBuffer() = default;
+
+    TripleBuffer(const TripleBuffer&) = delete;
+    TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+    /*
+     * Returns the slot which the writer may fill. Only to be called by the writer.
+     * The slot contains an older value, which has to be overwritten completely.
+     */
+    T& get_back();
+
+    /*
+     * Publishes the back slot to the reader and provides a new back slot. Only to be called by the writer.
+     */
+    void publish();
+
+    /*
+     * Makes the most recently published value the front slot, if it has not been fetched yet.
+     * Only to be called by the reader.
+     *
+     * @return true if a new value has been fetched
+     */
+    bool fetch();
+
+    /*
+     * Returns the most recently fetched value. Only to be called by the reader.
+     */
+    const T& get_front() const;
+
+private:
+    static constexpr uint8_t INDEX_MASK{3}; ///< bits of the exchanged slot index
+    static constexpr uint8_t FRESH_BIT{4}; ///< set if the exchanged slot has been published but not fetched
+    static constexpr std::size_t CACHE_LINE_SIZE{64}; ///< assumed size of a cache line
+
+    std::array<T, 3> _slots{}; ///< the three values
+    alignas(CACHE_LINE_SIZE) std::atomic<uint8_t> _middle{1}; ///< index of the exchanged slot and its fresh bit
+    alignas(CACHE_LINE_SIZE) uint8_t _back{0}; ///< index of the writer's slot
+    alignas(CACHE_LINE_SIZE) uint8_t _front{2}; ///< index of the reader's slot
+};
+
+#include "triple_buffer.hpp"
+#endif /* TRIPLE_BUFFER_H_ */
@@ -0,0 +1,34 @@
+// public:
+
+template<typename T>
+T& TripleBuffer<T>::get_back()
+{
+    return _slots[_back];
+}
+
+template<typename T>
+void TripleBuffer<T>::publish()
+{
+    // releases the written slot to the reader and acquires the slot the reader has handed back
+    _back = _middle.exchange(_back | FRESH_BIT, std::memory_order_acq_rel) & INDEX_MASK;
+    return;
+}
+
+template<typename T>
+bool TripleBuffer<T>::fetch()
+{
+    if ((_middle.load(std::memory_order_relaxed) & FRESH_BIT) == 0)
+    {
+        return false;
+    }
+
+    // only the writer can change the middle slot in between, and it keeps the fresh bit set
+    _front = _middle.exchange(_front, std::memory_order_acq_rel) & INDEX_MASK;
+    return true;
+}
+
+template<typename T>
+const T& TripleBuffer<T>::get_front() const
+{
+    return _slots[_front];
+}
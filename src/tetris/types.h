@@ -28,29 +28,30 @@ public:
      * Constructor.
      * Initializes the RotationType object with a given rotation.
      */
-    RotationType(const Rotation rotation);
+    constexpr RotationType(const Rotation rotation);
 
     ~RotationType() = default;
 
     /*
      * Implicit conversion operator to type Rotation.
      */
-    operator Rotation() const;
+    constexpr operator Rotation() const;
 
     /*
      * Increment operator.
      * Corresponds to rotating the current RotationType object 90° clockwise.
      */
-    RotationType& operator++();
+    constexpr RotationType& operator++();
 
    /*
     * Decrement operator.
     * Corresponds to rotating the current RotationType object 90° counterclockwise.
     */
-    RotationType& operator--();
+    constexpr RotationType& operator--();
 
 private:
     Rotation _rotation; ///< The current rotation status.
 };
 
+#include "types.hpp"
 #endif /* TYPES_H_ */
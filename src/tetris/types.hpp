@@ -1,25 +1,23 @@
-#include "types.h"
-
 // public
 
-RotationType::RotationType(const Rotation rotation)
+constexpr RotationType::RotationType(const Rotation rotation)
         : _rotation(rotation)
 {}
 
-RotationType::operator Rotation() const {
+constexpr RotationType::operator Rotation() const
+{
     return _rotation;
 }
 
-RotationType& RotationType::operator++()
+constexpr RotationType& RotationType::operator++()
 {
     _rotation = static_cast<Rotation>((_rotation + 1) % 4);
     return (*this);
 }
 
-RotationType& RotationType::operator--()
+constexpr RotationType& RotationType::operator--()
 {
     // get positive module
     _rotation = static_cast<Rotation>((4 + (_rotation - 1) % 4) % 4);
     return (*this);
 }
-
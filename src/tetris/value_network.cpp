@@ -0,0 +1,96 @@
+#include "value_network.h"
+
+#include <cerrno>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace value_network_detail
+{
+    // public:
+
+    NetworkFile::~NetworkFile()
+    {
+        close();
+    }
+
+    bool NetworkFile::open(const std::string &path, const std::size_t height, const std::size_t width)
+    {
+        const int fileDescriptor = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fileDescriptor < 0)
+        {
+            return false;
+        }
+
+        const NetworkLayout layout = get_network_layout(height * width + 2 * _SHAPE_COUNT);
+        struct stat fileStatus{};
+        void *mapping = MAP_FAILED;
+        if (fstat(fileDescriptor, &fileStatus) == 0 && static_cast<std::size_t>(fileStatus.st_size) == layout.size)
+        {
+            mapping = mmap(nullptr, layout.size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+        }
+        ::close(fileDescriptor); // the mapping stays valid
+
+        if (mapping == MAP_FAILED)
+        {
+            return false;
+        }
+        NetworkHeader header{};
+        std::memcpy(&header, mapping, sizeof(header));
+        if (std::memcmp(header.magic, NETWORK_MAGIC, sizeof(NETWORK_MAGIC)) != 0 || header.version != NETWORK_VERSION
+            || header.height != height || header.width != width || header.firstHiddenCount != FIRST_HIDDEN_COUNT
+            || header.secondHiddenCount != SECOND_HIDDEN_COUNT)
+        {
+            munmap(mapping, layout.size);
+            return false;
+        }
+
+        close();
+        _mapping = mapping;
+        _size = layout.size;
+        return true;
+    }
+
+    const uint8_t* NetworkFile::get_data() const
+    {
+        return static_cast<const uint8_t*>(_mapping);
+    }
+
+    // private:
+
+    void NetworkFile::close()
+    {
+        if (_mapping != nullptr)
+        {
+            munmap(_mapping, _size);
+            _mapping = nullptr;
+            _size = 0;
+        }
+        return;
+    }
+
+    // free functions
+
+    bool write_file(const std::string &path, const std::vector<uint8_t> &content)
+    {
+        const int fileDescriptor = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fileDescriptor < 0)
+        {
+            return false;
+        }
+
+        std::size_t written = 0;
+        while (written < content.size())
+        {
+            const ssize_t result = write(fileDescriptor, content.data() + written, content.size() - written);
+            if (result < 0 && errno != EINTR)
+            {
+                break;
+            }
+            written += (result > 0) ? static_cast<std::size_t>(result) : 0;
+        }
+        return ::close(fileDescriptor) == 0 && written == content.size();
+    }
+}
@@ -0,0 +1,244 @@
+#ifndef VALUE_NETWORK_H_
+#define VALUE_NETWORK_H_
+
+#include "board_features.h"
+#include "board_state.h"
+#include "shapes.h"
+
+#include <array>
+#include <string>
+#include <vector>
+
+/*
+ * Quantised value network: a multilayer perceptron which scores a board from its packed occupancy and the types
+ * of the current and the next shape.
+ *
+ * The inputs are binary, one per cell and one per shape type for each of the two shapes, so the first layer
+ * only adds up the int16 weight rows of the occupied cells and of the two shapes. Its weights are quantised
+ * small enough for these sums to fit into int16. The second layer and the output use int8 weights on int8
+ * activations, which are clipped to [0, ACTIVATION_ONE], and int32 sums.
+ * All arithmetic is integer, so the batch kernel and the scalar reference give identical scores.
+ *
+ * The network is stored in a file which is mapped into memory, see write_value_network() for the format.
+ */
+namespace value_network_detail
+{
+    constexpr char NETWORK_MAGIC[8] = {'T', 'E', 'T', 'R', 'I', 'S', 'N', 'N'}; ///< identifies network files
+    constexpr uint32_t NETWORK_VERSION{2}; ///< version of the file format
+    constexpr std::size_t FIRST_HIDDEN_COUNT{64}; ///< number of neurons of the first hidden layer
+    constexpr std::size_t SECOND_HIDDEN_COUNT{32}; ///< number of neurons of the second hidden layer
+    constexpr std::size_t SECTION_ALIGNMENT{64}; ///< alignment of the weight arrays in the file
+    constexpr int32_t ACTIVATION_ONE{127}; ///< quantised activation and first layer weight of 1.0
+    constexpr int WEIGHT_SHIFT{6}; ///< int8 weights are quantised in steps of 2^-WEIGHT_SHIFT
+
+    /*
+     * Header of a network file.
+     */
+    struct NetworkHeader
+    {
+        char magic[8]; ///< NETWORK_MAGIC
+        uint32_t version; ///< NETWORK_VERSION
+        uint32_t height; ///< board height the network is made for
+        uint32_t width; ///< board width the network is made for
+        uint32_t firstHiddenCount; ///< FIRST_HIDDEN_COUNT
+        uint32_t secondHiddenCount; ///< SECOND_HIDDEN_COUNT
+        uint32_t reserved; ///< 0
+    };
+
+    /*
+     * Offsets of the weight arrays in a network file, in bytes.
+     */
+    struct NetworkLayout
+    {
+        std::size_t inputWeights; ///< int16 [inputs][FIRST_HIDDEN_COUNT]
+        std::size_t inputBiases; ///< int16 [FIRST_HIDDEN_COUNT]
+        std::size_t hiddenWeights; ///< int8 [SECOND_HIDDEN_COUNT][FIRST_HIDDEN_COUNT]
+        std::size_t hiddenBiases; ///< int32 [SECOND_HIDDEN_COUNT]
+        std::size_t outputWeights; ///< int8 [SECOND_HIDDEN_COUNT]
+        std::size_t outputBias; ///< int32
+        std::size_t size; ///< size of the file
+    };
+
+    /*
+     * Returns the layout of a network file for a number of inputs.
+     */
+    constexpr NetworkLayout get_network_layout(const std::size_t inputCount);
+
+    /*
+     * Read-only memory mapping of a network file.
+     */
+    class NetworkFile
+    {
+    public:
+        NetworkFile() = default;
+
+        /*
+         * Destructor. Unmaps the file.
+         */
+        ~NetworkFile();
+
+        NetworkFile(const NetworkFile&) = delete;
+        NetworkFile& operator=(const NetworkFile&) = delete;
+
+        /*
+         * Maps a network file into memory and checks its header and size.
+         *
+         * @param[in] path file path
+         * @param[in] height expected board height
+         * @param[in] width expected board width
+         * @return false if the file cannot be mapped or is not a network for boards of this size
+         */
+        bool open(const std::string &path, const std::size_t height, const std::size_t width);
+
+        /*
+         * Returns the mapped bytes, nullptr if no file is mapped.
+         */
+        const uint8_t* get_data() const;
+
+    private:
+        /*
+         * Unmaps the file, if one is mapped.
+         */
+        void close();
+
+    private:
+        void *_mapping{nullptr}; ///< start of the mapping, nullptr if no file is mapped
+        std::size_t _size{0}; ///< size of the mapping
+    };
+
+    /*
+     * Writes a file completely.
+     *
+     * @return false if the file could not be written
+     */
+    bool write_file(const std::string &path, const std::vector<uint8_t> &content);
+}
+
+/*
+ * Unquantised weights of a value network, e.g. as exported by training.
+ * The weights of the first layer are stored input by input, those of the second layer neuron by neuron.
+ */
+template<SizeType height, SizeType width>
+struct ValueNetworkParameters
+{
+    static constexpr std::size_t INPUT_COUNT{height * width + 2 * _SHAPE_COUNT}; ///< Cells, current and next shape.
+
+    std::vector<float> inputWeights = std::vector<float>(INPUT_COUNT * value_network_detail::FIRST_HIDDEN_COUNT); ///< Weights of the first layer.
+    std::vector<float> inputBiases = std::vector<float>(value_network_detail::FIRST_HIDDEN_COUNT); ///< Biases of the first layer.
+    std::vector<float> hiddenWeights = std::vector<float>(value_network_detail::SECOND_HIDDEN_COUNT * value_network_detail::FIRST_HIDDEN_COUNT); ///< Weights of the second layer.
+    std::vector<float> hiddenBiases = std::vector<float>(value_network_detail::SECOND_HIDDEN_COUNT); ///< Biases of the second layer.
+    std::vector<float> outputWeights = std::vector<float>(value_network_detail::SECOND_HIDDEN_COUNT); ///< Weights of the output.
+    float outputBias{0}; ///< Bias of the output.
+};
+
+/*
+ * Value network loaded from a file, see the description of value_network_detail.
+ */
+template<SizeType height, SizeType width>
+class ValueNetwork
+{
+public:
+    static constexpr std::size_t INPUT_COUNT{ValueNetworkParameters<height, width>::INPUT_COUNT}; ///< Number of inputs.
+
+    /*
+     * Constructor. Creates a network without weights, which has to be loaded before evaluating.
+     */
+    ValueNetwork() = default;
+
+    /*
+     * Default destructor. Unmaps the weights.
+     */
+    ~ValueNetwork() = default;
+
+    ValueNetwork(const ValueNetwork&) = delete;
+    ValueNetwork& operator=(const ValueNetwork&) = delete;
+
+    /*
+     * Maps the weights of a network file into memory.
+     *
+     * @param[in] path path of the file
+     * @return false if the file is not a network for boards of this size, the previous weights are kept then
+     */
+    bool load(const std::string &path);
+
+    /*
+     * Returns true if weights have been loaded.
+     */
+    bool is_loaded() const;
+
+    /*
+     * Scores a batch of boards with the same current and next shape, e.g. the candidate placements of a shape.
+     * The first layer's sums of a board are updated from those of the previous board if fewer cells differ than
+     * are occupied, so similar boards, like the placements of one shape, should follow each other. The later
+     * layers are plain loops over int16 vectors, which the compiler turns into SIMD instructions where the target
+     * supports them.
+     *
+     * @param[in] boardStates array of count board states
+     * @param[in] count number of board states
+     * @param[in] currentShape type of the current shape
+     * @param[in] nextShape type of the next shape
+     * @param[out] scores array of count scores, the higher the better for the player
+     */
+    void evaluate(const BoardState<height, width> *boardStates, const std::size_t count, const ShapeType currentShape,
+                  const ShapeType nextShape, float *scores) const;
+
+    /*
+     * Scores a board.
+     *
+     * @param[in] boardState the board
+     * @param[in] currentShape type of the current shape
+     * @param[in] nextShape type of the next shape
+     * @return score, the higher the better for the player
+     */
+    float evaluate(const BoardState<height, width> &boardState, const ShapeType currentShape,
+                   const ShapeType nextShape) const;
+
+    /*
+     * Scores a board cell by cell and neuron by neuron. Slow, for verifying the batch kernel.
+     */
+    float evaluate_reference(const BoardState<height, width> &boardState, const ShapeType currentShape,
+                             const ShapeType nextShape) const;
+
+private:
+    /*
+     * Computes the first layer's sums of a board, from scratch or by updating those of the previous board.
+     *
+     * @param[in] boardState the board
+     * @param[in] previousState previous board of the batch, nullptr if there is none
+     * @param[in] currentShape type of the current shape
+     * @param[in] nextShape type of the next shape
+     * @param[in,out] sums sums of the previous board, replaced by those of the board
+     */
+    void accumulate_inputs(const BoardState<height, width> &boardState, const BoardState<height, width> *previousState,
+                           const ShapeType currentShape, const ShapeType nextShape,
+                           std::array<int16_t, value_network_detail::FIRST_HIDDEN_COUNT> &sums) const;
+
+private:
+    value_network_detail::NetworkFile _file{}; ///< mapped network file
+    const int16_t *_inputWeights{nullptr}; ///< weights of the first layer in the file
+    const int16_t *_inputBiases{nullptr}; ///< biases of the first layer in the file
+    std::array<int16_t, value_network_detail::SECOND_HIDDEN_COUNT * value_network_detail::FIRST_HIDDEN_COUNT> _hiddenWeights{}; ///< weights of the second layer, widened
+    const int32_t *_hiddenBiases{nullptr}; ///< biases of the second layer in the file
+    std::array<int16_t, value_network_detail::SECOND_HIDDEN_COUNT> _outputWeights{}; ///< weights of the output, widened
+    int32_t _outputBias{0}; ///< bias of the output
+};
+
+/*
+ * Quantises the parameters of a network and writes them as network file.
+ *
+ * The file starts with a NetworkHeader, followed by the arrays of NetworkLayout, each aligned to
+ * SECTION_ALIGNMENT bytes, in the byte order of the machine. The first layer's weights and biases are
+ * multiplied by ACTIVATION_ONE, rounded and clamped to INT16_MAX / (height * width + 3), so the bias plus every
+ * cell and both shapes still fit into int16. The int8 weights are rounded to multiples of 2^-WEIGHT_SHIFT, and
+ * the biases of the later layers are scaled like the sums they are added to.
+ * Weights outside the quantised range are clamped.
+ *
+ * @param[in] path path of the file
+ * @param[in] parameters the network
+ * @return false if the file could not be written
+ */
+template<SizeType height, SizeType width>
+bool write_value_network(const std::string &path, const ValueNetworkParameters<height, width> &parameters);
+
+#include "value_network.hpp"
+#endif /* VALUE_NETWORK_H_ */
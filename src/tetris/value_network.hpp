@@ -0,0 +1,296 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace value_network_detail
+{
+    constexpr std::size_t align_section(const std::size_t offset)
+    {
+        return (offset + SECTION_ALIGNMENT - 1) / SECTION_ALIGNMENT * SECTION_ALIGNMENT;
+    }
+
+    constexpr NetworkLayout get_network_layout(const std::size_t inputCount)
+    {
+        NetworkLayout layout{};
+        layout.inputWeights = align_section(sizeof(NetworkHeader));
+        layout.inputBiases = align_section(layout.inputWeights + inputCount * FIRST_HIDDEN_COUNT * sizeof(int16_t));
+        layout.hiddenWeights = align_section(layout.inputBiases + FIRST_HIDDEN_COUNT * sizeof(int16_t));
+        layout.hiddenBiases = align_section(layout.hiddenWeights + SECOND_HIDDEN_COUNT * FIRST_HIDDEN_COUNT);
+        layout.outputWeights = align_section(layout.hiddenBiases + SECOND_HIDDEN_COUNT * sizeof(int32_t));
+        layout.outputBias = align_section(layout.outputWeights + SECOND_HIDDEN_COUNT);
+        layout.size = layout.outputBias + sizeof(int32_t);
+        return layout;
+    }
+
+    /*
+     * Clips the sum of a neuron to the range of the activations.
+     */
+    constexpr int32_t clip_activation(const int32_t sum)
+    {
+        return std::min(std::max(sum, int32_t{0}), ACTIVATION_ONE);
+    }
+
+    /*
+     * Converts the sum of the output to a score.
+     */
+    constexpr float get_score(const int32_t sum)
+    {
+        return static_cast<float>(sum) / static_cast<float>(ACTIVATION_ONE << WEIGHT_SHIFT);
+    }
+
+    /*
+     * Rounds a scaled value to the nearest integer and clamps it to [-limit, limit].
+     */
+    inline int32_t quantise(const float value, const float scale, const int32_t limit)
+    {
+        const float rounded = std::round(value * scale);
+        return static_cast<int32_t>(std::min(std::max(rounded, static_cast<float>(-limit)), static_cast<float>(limit)));
+    }
+}
+
+// public:
+
+template<SizeType height, SizeType width>
+bool ValueNetwork<height, width>::load(const std::string &path)
+{
+    using namespace value_network_detail;
+
+    if (!_file.open(path, height, width))
+    {
+        return false;
+    }
+
+    // the sections are aligned within the page-aligned mapping
+    constexpr NetworkLayout layout = get_network_layout(INPUT_COUNT);
+    const uint8_t * const data = _file.get_data();
+    _inputWeights = reinterpret_cast<const int16_t*>(data + layout.inputWeights);
+    _inputBiases = reinterpret_cast<const int16_t*>(data + layout.inputBiases);
+    _hiddenBiases = reinterpret_cast<const int32_t*>(data + layout.hiddenBiases);
+
+    // the int8 weights are widened once, so the kernel multiplies int16 vectors only
+    const int8_t * const hiddenWeights = reinterpret_cast<const int8_t*>(data + layout.hiddenWeights);
+    const int8_t * const outputWeights = reinterpret_cast<const int8_t*>(data + layout.outputWeights);
+    std::copy(hiddenWeights, hiddenWeights + _hiddenWeights.size(), _hiddenWeights.begin());
+    std::copy(outputWeights, outputWeights + _outputWeights.size(), _outputWeights.begin());
+    std::memcpy(&_outputBias, data + layout.outputBias, sizeof(_outputBias));
+    return true;
+}
+
+template<SizeType height, SizeType width>
+bool ValueNetwork<height, width>::is_loaded() const
+{
+    return _file.get_data() != nullptr;
+}
+
+template<SizeType height, SizeType width>
+void ValueNetwork<height, width>::evaluate(const BoardState<height, width> *boardStates, const std::size_t count,
+                                          const ShapeType currentShape, const ShapeType nextShape,
+                                          float *scores) const
+{
+    using namespace value_network_detail;
+
+    std::array<int16_t, FIRST_HIDDEN_COUNT> firstSums{};
+    for (std::size_t b = 0; b < count; ++b)
+    {
+        // first layer, updating the sums of the previous board
+        accumulate_inputs(boardStates[b], (b > 0) ? &boardStates[b - 1] : nullptr, currentShape, nextShape, firstSums);
+        std::array<int16_t, FIRST_HIDDEN_COUNT> firstActivations;
+        for (std::size_t k = 0; k < FIRST_HIDDEN_COUNT; ++k)
+        {
+            firstActivations[k] = static_cast<int16_t>(clip_activation(firstSums[k]));
+        }
+
+        // second layer and output as dot products of int16 vectors with int32 sums, for which the compiler uses
+        // multiply-add instructions where the target has them
+        std::array<int16_t, SECOND_HIDDEN_COUNT> secondActivations;
+        for (std::size_t j = 0; j < SECOND_HIDDEN_COUNT; ++j)
+        {
+            const int16_t * const weights = _hiddenWeights.data() + j * FIRST_HIDDEN_COUNT;
+            int32_t sum = _hiddenBiases[j];
+            for (std::size_t k = 0; k < FIRST_HIDDEN_COUNT; ++k)
+            {
+                sum += firstActivations[k] * weights[k];
+            }
+            secondActivations[j] = static_cast<int16_t>(clip_activation(sum >> WEIGHT_SHIFT));
+        }
+
+        int32_t output = _outputBias;
+        for (std::size_t j = 0; j < SECOND_HIDDEN_COUNT; ++j)
+        {
+            output += secondActivations[j] * _outputWeights[j];
+        }
+        scores[b] = get_score(output);
+    }
+    return;
+}
+
+template<SizeType height, SizeType width>
+float ValueNetwork<height, width>::evaluate(const BoardState<height, width> &boardState, const ShapeType currentShape,
+                                           const ShapeType nextShape) const
+{
+    float score = 0;
+    evaluate(&boardState, 1, currentShape, nextShape, &score);
+    return score;
+}
+
+template<SizeType height, SizeType width>
+float ValueNetwork<height, width>::evaluate_reference(const BoardState<height, width> &boardState,
+                                                     const ShapeType currentShape, const ShapeType nextShape) const
+{
+    using namespace value_network_detail;
+
+    std::array<bool, INPUT_COUNT> inputs{};
+    for (SizeType i = 0; i < height; ++i)
+    {
+        for (SizeType j = 0; j < width; ++j)
+        {
+            inputs[i * width + j] = boardState.is_occupied(i, j);
+        }
+    }
+    inputs[height * width + currentShape] = true;
+    inputs[height * width + _SHAPE_COUNT + nextShape] = true;
+
+    std::array<int32_t, FIRST_HIDDEN_COUNT> firstActivations{};
+    for (std::size_t k = 0; k < FIRST_HIDDEN_COUNT; ++k)
+    {
+        int32_t sum = _inputBiases[k];
+        for (std::size_t i = 0; i < INPUT_COUNT; ++i)
+        {
+            sum += inputs[i] ? _inputWeights[i * FIRST_HIDDEN_COUNT + k] : 0;
+        }
+        firstActivations[k] = clip_activation(sum);
+    }
+
+    std::array<int32_t, SECOND_HIDDEN_COUNT> secondActivations{};
+    for (std::size_t j = 0; j < SECOND_HIDDEN_COUNT; ++j)
+    {
+        int32_t sum = _hiddenBiases[j];
+        for (std::size_t k = 0; k < FIRST_HIDDEN_COUNT; ++k)
+        {
+            sum += firstActivations[k] * _hiddenWeights[j * FIRST_HIDDEN_COUNT + k];
+        }
+        secondActivations[j] = clip_activation(sum >> WEIGHT_SHIFT);
+    }
+
+    int32_t output = _outputBias;
+    for (std::size_t j = 0; j < SECOND_HIDDEN_COUNT; ++j)
+    {
+        output += secondActivations[j] * _outputWeights[j];
+    }
+    return get_score(output);
+}
+
+// private:
+
+template<SizeType height, SizeType width>
+void ValueNetwork<height, width>::accumulate_inputs(const BoardState<height, width> &boardState,
+                                                    const BoardState<height, width> *previousState,
+                                                    const ShapeType currentShape, const ShapeType nextShape,
+                                                    std::array<int16_t, value_network_detail::FIRST_HIDDEN_COUNT> &sums) const
+{
+    using namespace value_network_detail;
+
+    // the sums may wrap around in between, only the final ones are bounded by the quantisation
+    const auto addInput = [this, &sums](const std::size_t input) {
+        const int16_t * const weights = _inputWeights + input * FIRST_HIDDEN_COUNT;
+        for (std::size_t k = 0; k < FIRST_HIDDEN_COUNT; ++k)
+        {
+            sums[k] = static_cast<int16_t>(static_cast<uint16_t>(sums[k]) + static_cast<uint16_t>(weights[k]));
+        }
+    };
+    const auto subtractInput = [this, &sums](const std::size_t input) {
+        const int16_t * const weights = _inputWeights + input * FIRST_HIDDEN_COUNT;
+        for (std::size_t k = 0; k < FIRST_HIDDEN_COUNT; ++k)
+        {
+            sums[k] = static_cast<int16_t>(static_cast<uint16_t>(sums[k]) - static_cast<uint16_t>(weights[k]));
+        }
+    };
+
+    // the placements of a shape differ in a few cells, so updating is cheaper than starting over
+    using RowType = typename BoardState<height, width>::RowType;
+    uint32_t changedCells = 0;
+    uint32_t occupiedCells = 0;
+    for (SizeType i = 0; previousState != nullptr && i < height; ++i)
+    {
+        changedCells += board_features_detail::count_bits(static_cast<RowType>(boardState.get_row(i) ^ previousState->get_row(i)));
+        occupiedCells += board_features_detail::count_bits(boardState.get_row(i));
+    }
+    if (previousState != nullptr && changedCells < occupiedCells)
+    {
+        for (SizeType i = 0; i < height; ++i)
+        {
+            const uint32_t row = boardState.get_row(i);
+            const uint32_t previousRow = previousState->get_row(i);
+            for (uint32_t added = row & ~previousRow; added != 0; added &= added - 1)
+            {
+                addInput(i * width + __builtin_ctz(added));
+            }
+            for (uint32_t removed = previousRow & ~row; removed != 0; removed &= removed - 1)
+            {
+                subtractInput(i * width + __builtin_ctz(removed));
+            }
+        }
+        return;
+    }
+
+    std::copy(_inputBiases, _inputBiases + FIRST_HIDDEN_COUNT, sums.begin());
+    for (SizeType i = 0; i < height; ++i)
+    {
+        // visit the occupied cells of the row only, bit j is column j
+        for (uint32_t row = boardState.get_row(i); row != 0; row &= row - 1)
+        {
+            addInput(i * width + __builtin_ctz(row));
+        }
+    }
+    addInput(height * width + currentShape);
+    addInput(height * width + _SHAPE_COUNT + nextShape);
+    return;
+}
+
+// free functions
+
+template<SizeType height, SizeType width>
+bool write_value_network(const std::string &path, const ValueNetworkParameters<height, width> &parameters)
+{
+    using namespace value_network_detail;
+
+    constexpr std::size_t inputCount = ValueNetworkParameters<height, width>::INPUT_COUNT;
+    constexpr NetworkLayout layout = get_network_layout(inputCount);
+    constexpr float weightScale = 1 << WEIGHT_SHIFT;
+    constexpr float sumScale = static_cast<float>(ACTIVATION_ONE << WEIGHT_SHIFT);
+    constexpr int32_t inputLimit = INT16_MAX / static_cast<int32_t>(height * width + 3); // bias, cells and two shapes
+    std::vector<uint8_t> content(layout.size, 0);
+
+    const auto store = [&content](const std::size_t offset, const auto value) {
+        std::memcpy(content.data() + offset, &value, sizeof(value));
+    };
+
+    NetworkHeader header{};
+    std::memcpy(header.magic, NETWORK_MAGIC, sizeof(NETWORK_MAGIC));
+    header.version = NETWORK_VERSION;
+    header.height = height;
+    header.width = width;
+    header.firstHiddenCount = FIRST_HIDDEN_COUNT;
+    header.secondHiddenCount = SECOND_HIDDEN_COUNT;
+    store(0, header);
+
+    for (std::size_t w = 0; w < inputCount * FIRST_HIDDEN_COUNT; ++w)
+    {
+        store(layout.inputWeights + w * sizeof(int16_t), static_cast<int16_t>(quantise(parameters.inputWeights[w], ACTIVATION_ONE, inputLimit)));
+    }
+    for (std::size_t k = 0; k < FIRST_HIDDEN_COUNT; ++k)
+    {
+        store(layout.inputBiases + k * sizeof(int16_t), static_cast<int16_t>(quantise(parameters.inputBiases[k], ACTIVATION_ONE, inputLimit)));
+    }
+    for (std::size_t w = 0; w < SECOND_HIDDEN_COUNT * FIRST_HIDDEN_COUNT; ++w)
+    {
+        store(layout.hiddenWeights + w, static_cast<int8_t>(quantise(parameters.hiddenWeights[w], weightScale, INT8_MAX)));
+    }
+    for (std::size_t j = 0; j < SECOND_HIDDEN_COUNT; ++j)
+    {
+        store(layout.hiddenBiases + j * sizeof(int32_t), quantise(parameters.hiddenBiases[j], sumScale, INT32_MAX / 2));
+        store(layout.outputWeights + j, static_cast<int8_t>(quantise(parameters.outputWeights[j], weightScale, INT8_MAX)));
+    }
+    store(layout.outputBias, quantise(parameters.outputBias, sumScale, INT32_MAX / 2));
+    return write_file(path, content);
+}
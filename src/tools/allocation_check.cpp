@@ -0,0 +1,327 @@
+/*
+ * Checks that the frame path of the game allocates no heap memory once it is running.
+ *
+ * Usage: tetris_allocation_check [-f frames] [-s seed]
+ *
+ * Only built with the CMake option TETRIS_ALLOCATION_CHECK. The global operator new is replaced by one which
+ * counts its calls. A scripted game then runs through the path of main.cpp: its keystrokes are written into a
+ * pipe read by an InputThread, the events are applied together with the frames due, the locks are journaled
+ * into a temporary save directory and snapshots are rendered by a RenderThread into an ncurses screen whose
+ * output goes to /dev/null. Alongside, a TerminalSession of the server plays the same keystrokes through a
+ * socket pair. Tracing is enabled, so recording spans is covered, too.
+ * Keystrokes alone rarely lock a shape, so every PLACEMENT_INTERVAL frames the falling shape is also dropped
+ * into a placement, mostly the best one by evaluate_board() and every eighth time a random one. Thereby lines
+ * are cleared, games end and new games are started while allocations are counted.
+ *
+ * After a warm-up, in which buffers reach their final sizes, every allocation by any thread is counted. The
+ * check fails with EXIT_FAILURE if there is one. Allocations by C code, e.g. ncurses, use malloc() and are
+ * not seen.
+ */
+
+#include "main_auxiliary.h"
+#include "render_thread.h"
+#include "terminal_session.h"
+#include "tetris/evaluation.h"
+#include "tetris/placement.h"
+#include "tetris/save_journal.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <new>
+
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace
+{
+    constexpr SizeType HEIGHT = 24; ///< board height of the game
+    constexpr SizeType WIDTH = 10; ///< board width of the game
+    constexpr uint32_t WARM_UP_FRAMES = 600; ///< frames before allocations are counted
+    constexpr uint32_t KEY_INTERVAL = 4; ///< frames between two scripted keystrokes
+    constexpr uint32_t PLACEMENT_INTERVAL = 12; ///< frames between two scripted placements
+    constexpr std::chrono::microseconds FRAME_PAUSE{200}; ///< time given to the other threads every frame
+
+    /// keystrokes of the script, as sent by a terminal: left, right, down and both rotations
+    constexpr const char *KEYS[] = {"\x1b[D", "\x1b[C", "\x1b[B", "r", "u"};
+
+    std::atomic<bool> counting{false}; ///< true while allocations are counted
+    std::atomic<uint64_t> allocationCount{0}; ///< number of counted allocations
+
+    /*
+     * Counts an allocation if counting is enabled.
+     */
+    void count_allocation()
+    {
+        if (counting.load(std::memory_order_relaxed))
+        {
+            allocationCount.fetch_add(1, std::memory_order_relaxed);
+        }
+        return;
+    }
+
+    /*
+     * Drops the falling shape into the best placement by evaluate_board(), or into a random one.
+     */
+    void drop_shape(GameBoard<HEIGHT, WIDTH> &gameBoard, RandomGenerator &generator)
+    {
+        const BoardState<HEIGHT, WIDTH> boardState = gameBoard.get_board_state();
+        const ShapeType shapeType = gameBoard.get_current_falling().get_shape_type();
+        const PlacementList<WIDTH> placements = generate_placements(boardState, shapeType);
+        if (placements.size() == 0)
+        {
+            return;
+        }
+
+        std::size_t chosen = generator() % placements.size();
+        if (generator() % 8 != 0)
+        {
+            float bestScore = -std::numeric_limits<float>::infinity();
+            for (std::size_t p = 0; p < placements.size(); ++p)
+            {
+                BoardState<HEIGHT, WIDTH> successor = boardState;
+                const uint16_t clearedRows = successor.place(get_piece_mask(shapeType, placements[p].rotation),
+                                                             placements[p].row, placements[p].column);
+                const float score = evaluate_board(successor, clearedRows);
+                if (score > bestScore)
+                {
+                    bestScore = score;
+                    chosen = p;
+                }
+            }
+        }
+        apply_placement(gameBoard, placements[chosen]);
+        return;
+    }
+
+    /*
+     * Sends bytes to a non-blocking socket or pipe, dropping them if it is full.
+     */
+    void send_key(const int fileDescriptor, const char *key)
+    {
+        (void) write(fileDescriptor, key, std::strlen(key));
+        return;
+    }
+
+    /*
+     * Reads and discards everything available on a non-blocking socket.
+     */
+    void drain(const int fileDescriptor)
+    {
+        char buffer[4096];
+        while (read(fileDescriptor, buffer, sizeof(buffer)) > 0)
+        {
+        }
+        return;
+    }
+}
+
+// the library's array, nothrow and sized variants forward to these
+void* operator new(const std::size_t size)
+{
+    count_allocation();
+    void * const memory = std::malloc(size ? size : 1);
+    if (!memory)
+    {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+void* operator new(const std::size_t size, const std::align_val_t alignment)
+{
+    count_allocation();
+    const std::size_t bytes = static_cast<std::size_t>(alignment);
+    void * const memory = std::aligned_alloc(bytes, (size + bytes - 1) / bytes * bytes);
+    if (!memory)
+    {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+// every delete is replaced as well, so none of the library's can free memory it did not allocate
+void operator delete(void *memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void *memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void *memory, std::align_val_t) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void *memory, std::size_t, std::align_val_t) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void *memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void *memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void *memory, std::align_val_t) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void *memory, std::size_t, std::align_val_t) noexcept
+{
+    std::free(memory);
+}
+
+int main(int argc, char *argv[])
+{
+    uint32_t frameCount = 5000;
+    uint32_t seed = 1;
+    bool invalidOption = false;
+    int option = 0;
+    while (!invalidOption && (option = getopt(argc, argv, "f:s:")) != -1)
+    {
+        switch (option)
+        {
+            case 'f':
+                frameCount = static_cast<uint32_t>(std::max(1, std::atoi(optarg)));
+                break;
+            case 's':
+                seed = static_cast<uint32_t>(std::strtoul(optarg, nullptr, 10));
+                break;
+            default:
+                invalidOption = true;
+                break;
+        }
+    }
+    if (invalidOption || optind != argc)
+    {
+        std::cerr << "Usage: " << argv[0] << " [-f frames = 5000] [-s seed = 1]" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // ncurses renders into /dev/null, with the capabilities of an xterm if no terminal is set
+    FILE * const screenOutput = std::fopen("/dev/null", "w");
+    FILE * const screenInput = std::fopen("/dev/null", "r");
+    SCREEN * const screen = (screenOutput && screenInput)
+                            ? newterm(std::getenv("TERM") ? nullptr : "xterm", screenOutput, screenInput) : nullptr;
+    char saveDirectory[] = "/tmp/tetris_allocation_check.XXXXXX";
+    int inputPipe[2] = {-1, -1};
+    int sessionSockets[2] = {-1, -1};
+    if (!screen || !mkdtemp(saveDirectory) || pipe2(inputPipe, O_NONBLOCK | O_CLOEXEC) != 0
+        || socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0, sessionSockets) != 0)
+    {
+        std::cerr << "Could not set up the game." << std::endl;
+        return EXIT_FAILURE;
+    }
+    start_color();
+    initialize_colors();
+    set_tracing_enabled(true);
+    set_trace_thread_name("main");
+
+    uint64_t allocations = 0;
+    {
+        GameBoard<HEIGHT, WIDTH> gameBoard(seed);
+        SaveJournal<HEIGHT, WIDTH> journal(saveDirectory, gameBoard);
+        InputThread input(inputPipe[0]);
+        RenderThread<HEIGHT, WIDTH> renderer;
+        TerminalSession<HEIGHT, WIDTH> session(sessionSockets[0], seed, 0);
+        if (!journal.is_running() || !input.is_running() || !renderer.is_running())
+        {
+            std::cerr << "Could not start the threads." << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        // the game runs on a virtual clock, so the frames do not depend on the speed of the machine
+        const InputClock::time_point start = InputClock::now();
+        const auto getFrameTime = [start](const uint32_t frame) {
+            return start + std::chrono::duration_cast<InputClock::duration>(Frames(frame));
+        };
+        InputClock::time_point nextFrame = getFrameTime(1);
+        uint32_t publishedFrameVersion = gameBoard.get_frame_version();
+        uint32_t games = 1;
+        uint32_t lineClears = 0;
+        const auto recordLock = [&journal, &gameBoard]() { journal.record(gameBoard); };
+        RandomGenerator keyGenerator(seed);
+        renderer.publish(gameBoard);
+
+        for (uint32_t frame = 1; frame <= WARM_UP_FRAMES + frameCount; ++frame)
+        {
+            counting.store(frame > WARM_UP_FRAMES, std::memory_order_relaxed);
+
+            if (frame % KEY_INTERVAL == 0)
+            {
+                const char * const key = KEYS[keyGenerator() % (sizeof(KEYS) / sizeof(KEYS[0]))];
+                send_key(inputPipe[1], key);
+                send_key(sessionSockets[1], key);
+            }
+            if (frame % PLACEMENT_INTERVAL == 0 && !gameBoard.is_game_over())
+            {
+                drop_shape(gameBoard, keyGenerator);
+                recordLock();
+            }
+            input.wait_for_event(InputClock::now() + FRAME_PAUSE);
+
+            InputEvent event;
+            while (input.pop_event(event))
+            {
+                apply_input(gameBoard, event.action);
+                recordLock();
+            }
+            advance_gravity(gameBoard, nextFrame, getFrameTime(frame), recordLock);
+            if (gameBoard.is_game_over())
+            {
+                lineClears += gameBoard.get_line_clears();
+                gameBoard = GameBoard<HEIGHT, WIDTH>(seed + games++);
+                recordLock();
+            }
+            if (gameBoard.get_frame_version() != publishedFrameVersion)
+            {
+                publishedFrameVersion = gameBoard.get_frame_version();
+                renderer.publish(gameBoard);
+            }
+
+            session.receive(frame);
+            session.advance(frame);
+            session.transmit();
+            drain(sessionSockets[1]);
+        }
+
+        counting.store(false, std::memory_order_relaxed);
+        allocations = allocationCount.load(std::memory_order_relaxed);
+        std::printf("frames %u after %u warm-up frames, %u games, %u line clears, %u locks in the last one\n",
+                    frameCount, WARM_UP_FRAMES, games, lineClears + gameBoard.get_line_clears(),
+                    gameBoard.get_lock_count());
+
+        renderer.stop();
+        journal.stop(gameBoard);
+    }
+
+    unlink(save_journal_detail::get_checkpoint_path(saveDirectory).c_str());
+    unlink(save_journal_detail::get_journal_path(saveDirectory).c_str());
+    rmdir(saveDirectory);
+    endwin();
+    delscreen(screen);
+    std::fclose(screenOutput);
+    std::fclose(screenInput);
+    for (const int fileDescriptor : {inputPipe[0], inputPipe[1], sessionSockets[1]})
+    {
+        close(fileDescriptor);
+    }
+
+    std::printf("heap allocations on the frame path: %llu\n", static_cast<unsigned long long>(allocations));
+    return allocations == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,284 @@
+/*
+ * Reference bot for tetris_arena, playing with one of the engine's searches.
+ *
+ * Usage: tetris_arena_bot [-a beam|expectimax|greedy] [-w beam width] [-d depth] [-t move budget in ms]
+ *                         [-c games] [-n maximal shapes per game]
+ *
+ * Speaks the protocol of bot_protocol.h on its standard input and output. The replies to a batch are
+ * collected and written at once, so a batch costs a single write regardless of the number of games.
+ * The beam search (default) uses the beam width and the depth, the expectimax search of search.h the depth as
+ * its maximal depth and the move budget, and the greedy search chooses the placement with the best
+ * evaluate_board() score after placing the current shape alone.
+ *
+ * With -c, no protocol is spoken. Instead, the chosen search and the greedy search play the same seeded games
+ * locally, game i with seed i + 1, and their line clears and move times are reported. The check fails with
+ * EXIT_FAILURE if the chosen search clears fewer lines than the greedy one or any of its moves takes longer
+ * than the move budget. It also fails if every game of the greedy search reaches the maximal number of shapes,
+ * since line clears then only grow with the shapes and do not tell the searches apart.
+ */
+
+#include "tetris/beam_search.h"
+#include "tetris/bot_protocol.h"
+#include "tetris/search.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <string>
+
+#include <unistd.h>
+
+namespace
+{
+    constexpr SizeType HEIGHT = 24; ///< board height of the games
+    constexpr SizeType WIDTH = 10; ///< board width of the games
+
+    using PlacementFinder = std::function<Placement(const BoardState<HEIGHT, WIDTH>&, ShapeType, ShapeType)>;
+    using MoveFinisher = std::function<void()>;
+
+    /*
+     * Results of games played locally by one search.
+     */
+    struct LocalResults
+    {
+        uint64_t lineClears{0}; ///< line clears of all games
+        uint64_t shapes{0}; ///< placed shapes of all games
+        uint32_t cappedGames{0}; ///< games which reached the maximal number of shapes
+        double moveSeconds{0.0}; ///< time spent searching placements
+        double maxMoveSeconds{0.0}; ///< longest time spent searching a placement
+    };
+
+    /*
+     * Chooses the placement of the current shape with the best evaluate_board() score, or the spawn position if
+     * there is none.
+     */
+    Placement find_greedy_placement(const BoardState<HEIGHT, WIDTH> &boardState, const ShapeType shapeType)
+    {
+        Placement bestPlacement{shapeType, ROT_0, 0, get_spawn_column<WIDTH>()};
+        float bestScore = -std::numeric_limits<float>::infinity();
+        for (const Placement &placement : generate_placements(boardState, shapeType))
+        {
+            BoardState<HEIGHT, WIDTH> successor = boardState;
+            const uint16_t clearedRows = successor.place(get_piece_mask(shapeType, placement.rotation),
+                                                         placement.row, placement.column);
+            const float score = evaluate_board(successor, clearedRows);
+            if (score > bestScore)
+            {
+                bestScore = score;
+                bestPlacement = placement;
+            }
+        }
+        return bestPlacement;
+    }
+
+    /*
+     * Plays seeded games with a search until they are over or have placed the maximal number of shapes.
+     * finishMove runs after each move, outside of the measured move time.
+     */
+    LocalResults play_games(const uint32_t gameCount, const uint32_t maxShapes, const PlacementFinder &findPlacement,
+                            const MoveFinisher &finishMove)
+    {
+        LocalResults results;
+        for (uint32_t g = 0; g < gameCount; ++g)
+        {
+            GameBoard<HEIGHT, WIDTH> gameBoard(g + 1);
+            uint32_t s = 0;
+            for (; s < maxShapes && !gameBoard.is_game_over(); ++s)
+            {
+                const BoardState<HEIGHT, WIDTH> boardState = gameBoard.get_board_state();
+                const ShapeType currentShape = gameBoard.get_current_falling().get_shape_type();
+                if (generate_placements(boardState, currentShape).size() == 0)
+                {
+                    break;
+                }
+
+                const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+                const Placement placement = findPlacement(boardState, currentShape,
+                                                          gameBoard.get_next_falling().get_shape_type());
+                const std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
+                results.moveSeconds += duration.count();
+                results.maxMoveSeconds = std::max(results.maxMoveSeconds, duration.count());
+                ++results.shapes;
+                gameBoard.make_move(placement);
+                finishMove();
+            }
+            results.cappedGames += (s == maxShapes) ? 1 : 0;
+            results.lineClears += gameBoard.get_line_clears();
+        }
+        return results;
+    }
+
+    /*
+     * Prints the results of a search played locally.
+     */
+    void print_results(const std::string &name, const LocalResults &results, const uint32_t gameCount)
+    {
+        std::printf("%s: shapes %llu, line clears %llu (%.1f per game), %u of %u games reached the shape limit,"
+                    " move time mean %.3f ms, max %.3f ms\n", name.c_str(),
+                    static_cast<unsigned long long>(results.shapes), static_cast<unsigned long long>(results.lineClears),
+                    static_cast<double>(results.lineClears) / gameCount, results.cappedGames, gameCount,
+                    1000.0 * results.moveSeconds / std::max<uint64_t>(1, results.shapes),
+                    1000.0 * results.maxMoveSeconds);
+        return;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    std::string searcher = "beam";
+    BeamSettings beamSettings;
+    SearchSettings searchSettings;
+    std::chrono::milliseconds moveBudget{50};
+    uint32_t compareGames = 0;
+    uint32_t maxShapes = 5000;
+    bool invalidOption = false;
+    int option = 0;
+    while (!invalidOption && (option = getopt(argc, argv, "a:w:d:t:c:n:")) != -1)
+    {
+        switch (option)
+        {
+            case 'a':
+                searcher = optarg;
+                break;
+            case 'w':
+                beamSettings.beamWidth = static_cast<std::size_t>(std::max(1, std::atoi(optarg)));
+                break;
+            case 'd':
+                beamSettings.depth = static_cast<uint8_t>(std::clamp(std::atoi(optarg), 1, int{MAX_BEAM_DEPTH}));
+                searchSettings.maxDepth = static_cast<uint8_t>(std::clamp(std::atoi(optarg), 1, 255));
+                break;
+            case 't':
+                moveBudget = std::chrono::milliseconds(std::max(1, std::atoi(optarg)));
+                break;
+            case 'c':
+                compareGames = static_cast<uint32_t>(std::max(1, std::atoi(optarg)));
+                break;
+            case 'n':
+                maxShapes = static_cast<uint32_t>(std::max(1, std::atoi(optarg)));
+                break;
+            default:
+                invalidOption = true;
+                break;
+        }
+    }
+    if (invalidOption || optind != argc
+        || (searcher != "beam" && searcher != "expectimax" && searcher != "greedy"))
+    {
+        std::cerr << "Usage: " << argv[0] << " [-a beam|expectimax|greedy = beam] [-w beam width = 16] [-d depth]"
+                  << " [-t move budget in ms = 50] [-c games] [-n maximal shapes per game = 5000]" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    searchSettings.timeBudget = moveBudget;
+    ThreadPool threadPool;
+    std::unique_ptr<BeamSearch<HEIGHT, WIDTH>> beamSearch;
+    std::unique_ptr<ExpectimaxSearch<HEIGHT, WIDTH>> expectimaxSearch;
+    const PlacementFinder findGreedyPlacement = [](const BoardState<HEIGHT, WIDTH> &boardState,
+                                                   const ShapeType currentShape, const ShapeType) {
+        return find_greedy_placement(boardState, currentShape);
+    };
+    const MoveFinisher finishNothing = [] {};
+    PlacementFinder findPlacement;
+    MoveFinisher finishMove = finishNothing;
+    std::string name;
+    if (searcher == "beam")
+    {
+        beamSearch = std::make_unique<BeamSearch<HEIGHT, WIDTH>>(threadPool, beamSettings);
+        findPlacement = [&beamSearch](const BoardState<HEIGHT, WIDTH> &boardState, const ShapeType currentShape,
+                                      const ShapeType nextShape) {
+            return beamSearch->find_best_placement(boardState, currentShape, nextShape);
+        };
+        name = "beam-" + std::to_string(beamSettings.beamWidth) + "-" + std::to_string(beamSettings.depth);
+    }
+    else if (searcher == "expectimax")
+    {
+        expectimaxSearch = std::make_unique<ExpectimaxSearch<HEIGHT, WIDTH>>(threadPool, searchSettings);
+        findPlacement = [&expectimaxSearch](const BoardState<HEIGHT, WIDTH> &boardState, const ShapeType currentShape,
+                                            const ShapeType nextShape) {
+            return expectimaxSearch->find_best_placement(boardState, currentShape, nextShape);
+        };
+        // the discarded subtrees are freed between moves, so the frees do not count against the move budget
+        finishMove = [&expectimaxSearch] { expectimaxSearch->free_discarded(); };
+        name = "expectimax-" + std::to_string(moveBudget.count()) + "ms-" + std::to_string(searchSettings.maxDepth);
+    }
+    else
+    {
+        findPlacement = findGreedyPlacement;
+        name = "greedy";
+    }
+
+    if (compareGames > 0)
+    {
+        const LocalResults results = play_games(compareGames, maxShapes, findPlacement, finishMove);
+        const LocalResults greedyResults = play_games(compareGames, maxShapes, findGreedyPlacement, finishNothing);
+        print_results(name, results, compareGames);
+        print_results("greedy", greedyResults, compareGames);
+
+        const std::chrono::duration<double> budget = moveBudget;
+        const bool conclusive = greedyResults.cappedGames < compareGames;
+        const bool stronger = results.lineClears >= greedyResults.lineClears;
+        const bool withinBudget = results.maxMoveSeconds <= budget.count();
+        std::printf("%s: %s greedy one-ply search%s, %s the move budget of %.0f ms\n", name.c_str(),
+                    stronger ? "at least as good as" : "worse than",
+                    conclusive ? "" : " (inconclusive, every greedy game reached the shape limit)",
+                    withinBudget ? "every move within" : "moves beyond", 1000.0 * budget.count());
+        return (conclusive && stronger && withinBudget) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    std::ios::sync_with_stdio(false);
+    std::string line;
+    if (!std::getline(std::cin, line))
+    {
+        return EXIT_FAILURE;
+    }
+    int version = 0;
+    int boardHeight = 0;
+    int boardWidth = 0;
+    if (std::sscanf(line.c_str(), "tetris %d %d %d", &version, &boardHeight, &boardWidth) != 3
+        || version != BOT_PROTOCOL_VERSION || boardHeight != HEIGHT || boardWidth != WIDTH)
+    {
+        return EXIT_FAILURE;
+    }
+    std::cout << "ready " << name << std::endl;
+
+    std::string replies;
+    while (std::getline(std::cin, line))
+    {
+        if (line == "quit")
+        {
+            break;
+        }
+
+        unsigned long moveCount = 0;
+        if (std::sscanf(line.c_str(), "batch %lu", &moveCount) != 1)
+        {
+            continue; // "end" needs no bookkeeping, the bot keeps no state per game
+        }
+
+        replies.clear();
+        for (unsigned long m = 0; m < moveCount && std::getline(std::cin, line); ++m)
+        {
+            uint32_t game = 0;
+            BoardState<HEIGHT, WIDTH> boardState;
+            ShapeType currentShape = SHAPE_O;
+            ShapeType nextShape = SHAPE_O;
+            if (!parse_move_request(line, game, boardState, currentShape, nextShape))
+            {
+                continue;
+            }
+
+            const Placement placement = findPlacement(boardState, currentShape, nextShape);
+            char reply[48];
+            std::snprintf(reply, sizeof(reply), "place %u %d %d\n", game, placement.rotation, placement.column);
+            replies += reply;
+            finishMove();
+        }
+        std::cout << replies << std::flush;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,599 @@
+/*
+ * Headless arena in which external bots play tetris on the engine.
+ *
+ * Usage: tetris_arena [-g games] [-p parallel games] [-t move budget in ms] [-n maximal shapes per game]
+ *                     [-s seed] <bot command>...
+ *
+ * Every bot command is run by /bin/sh in its own process, which is spoken to over its standard input and output
+ * with the protocol of bot_protocol.h. Each bot plays the same seeded games, so their results are comparable.
+ * Several games are multiplexed per process: the moves of all running games of a bot are sent as one batch and
+ * the replies are read back in bulk, which amortises the system calls over the games. All bots play
+ * concurrently.
+ *
+ * A batch has to be answered within the move budget times the number of its moves. Games without a reply in
+ * time, with an invalid reply or of a bot which terminated are forfeited. At the end, the results, throughput
+ * and reply latencies of every bot are reported.
+ */
+
+#include "tetris/bot_protocol.h"
+#include "tetris/placement.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace
+{
+    constexpr SizeType HEIGHT = 24; ///< board height of the arena games
+    constexpr SizeType WIDTH = 10; ///< board width of the arena games
+    constexpr std::chrono::seconds GREETING_BUDGET{5}; ///< time a bot has for answering the greeting
+    constexpr std::chrono::seconds QUIT_BUDGET{5}; ///< time a bot has for reading the final lines
+
+    using ArenaClock = std::chrono::steady_clock;
+
+    /*
+     * Settings given on the command line.
+     */
+    struct ArenaSettings
+    {
+        uint32_t games{16}; ///< number of games every bot plays
+        uint32_t parallelGames{8}; ///< maximal number of games multiplexed per bot process
+        std::chrono::milliseconds moveBudget{100}; ///< time per move
+        uint32_t maxShapes{1000}; ///< number of shapes after which a game ends
+        uint32_t seed{1}; ///< seed of the first game, the following games use the following seeds
+    };
+
+    /*
+     * Running game of a bot.
+     */
+    struct ArenaGame
+    {
+        uint32_t id{0}; ///< identifier in the protocol, also determines the seed
+        GameBoard<HEIGHT, WIDTH> gameBoard{1}; ///< the game
+        uint32_t shapes{0}; ///< number of placed shapes
+        bool awaitingReply{false}; ///< true while the current batch contains the game's move
+        bool over{false}; ///< true if the game has ended
+    };
+
+    /*
+     * Results and measurements of a bot.
+     */
+    struct BotStatistics
+    {
+        uint32_t finishedGames{0}; ///< number of ended games
+        uint64_t moves{0}; ///< number of answered moves
+        uint64_t lineClears{0}; ///< number of cleared rows in all games
+        uint32_t timeouts{0}; ///< number of moves which were not answered in time
+        uint32_t invalidReplies{0}; ///< number of replies which could not be applied
+        uint32_t crashedGames{0}; ///< number of games lost because the bot terminated
+        std::vector<double> latencies{}; ///< time from sending a batch until each reply, in milliseconds
+        std::chrono::duration<double> busyTime{0}; ///< total time between sending batches and their completion
+    };
+
+    /*
+     * States of the conversation with a bot.
+     */
+    enum BotState : uint8_t
+    {
+        BOT_GREETING, ///< the greeting has been sent, waiting for "ready"
+        BOT_IDLE, ///< the next batch can be sent
+        BOT_WAITING, ///< waiting for the replies of a batch
+        BOT_DONE ///< all games have ended or the bot has terminated
+    };
+
+    /*
+     * External bot process and the games it plays.
+     */
+    struct BotProcess
+    {
+        std::string command{}; ///< shell command starting the bot
+        std::string name{}; ///< name sent by the bot
+        pid_t pid{-1}; ///< process identifier
+        int input{-1}; ///< pipe to the bot's standard input, non-blocking
+        int output{-1}; ///< pipe from the bot's standard output, non-blocking
+        BotState state{BOT_GREETING}; ///< state of the conversation
+        std::string outgoing{}; ///< data not yet written to the bot
+        std::string incoming{}; ///< data read from the bot which does not form a complete line yet
+        std::vector<ArenaGame> games{}; ///< running games
+        std::vector<uint32_t> endedGames{}; ///< games to be announced as ended before the next batch
+        uint32_t startedGames{0}; ///< number of started games
+        ArenaClock::time_point batchStart{}; ///< time at which the current batch was sent
+        ArenaClock::time_point deadline{}; ///< time by which the greeting or the current batch must be answered, or
+                                           ///< the final lines must be read
+        std::size_t pendingReplies{0}; ///< number of replies of the current batch still missing
+        BotStatistics statistics{}; ///< results and measurements
+    };
+
+    /*
+     * Starts a bot process with pipes connected to its standard input and output.
+     *
+     * @param[in,out] bot the bot, whose command is used and whose process fields are set
+     * @return false if the process could not be started
+     */
+    bool start_bot(BotProcess &bot)
+    {
+        int toBot[2];
+        int fromBot[2];
+        if (pipe2(toBot, O_CLOEXEC) != 0)
+        {
+            return false;
+        }
+        if (pipe2(fromBot, O_CLOEXEC) != 0)
+        {
+            close(toBot[0]);
+            close(toBot[1]);
+            return false;
+        }
+
+        bot.pid = fork();
+        if (bot.pid == 0)
+        {
+            dup2(toBot[0], STDIN_FILENO);
+            dup2(fromBot[1], STDOUT_FILENO);
+            execl("/bin/sh", "sh", "-c", bot.command.c_str(), static_cast<char*>(nullptr));
+            _exit(127);
+        }
+
+        close(toBot[0]);
+        close(fromBot[1]);
+        bot.input = toBot[1];
+        bot.output = fromBot[0];
+        fcntl(bot.input, F_SETFL, fcntl(bot.input, F_GETFL) | O_NONBLOCK);
+        fcntl(bot.output, F_SETFL, fcntl(bot.output, F_GETFL) | O_NONBLOCK);
+        if (bot.pid < 0)
+        {
+            return false;
+        }
+
+        char greeting[64];
+        std::snprintf(greeting, sizeof(greeting), "tetris %d %d %d\n", BOT_PROTOCOL_VERSION, HEIGHT, WIDTH);
+        bot.outgoing = greeting;
+        bot.deadline = ArenaClock::now() + GREETING_BUDGET;
+        return true;
+    }
+
+    /*
+     * Ends a game and schedules its announcement.
+     */
+    void end_game(BotProcess &bot, ArenaGame &game)
+    {
+        game.over = true;
+        game.awaitingReply = false;
+        bot.endedGames.push_back(game.id);
+        ++bot.statistics.finishedGames;
+        bot.statistics.lineClears += game.gameBoard.get_line_clears();
+        return;
+    }
+
+    /*
+     * Stops talking to a bot. All of its running games are forfeited.
+     */
+    void finish_bot(BotProcess &bot)
+    {
+        for (ArenaGame &game : bot.games)
+        {
+            if (!game.over)
+            {
+                ++bot.statistics.crashedGames;
+                end_game(bot, game);
+            }
+        }
+        if (bot.input >= 0)
+        {
+            close(bot.input);
+            bot.input = -1;
+        }
+        if (bot.output >= 0)
+        {
+            close(bot.output);
+            bot.output = -1;
+        }
+        bot.state = BOT_DONE;
+        return;
+    }
+
+    /*
+     * Starts new games if possible and sends the moves of all running games as one batch.
+     * If no game is left, the session is closed.
+     */
+    void send_batch(BotProcess &bot, const ArenaSettings &settings)
+    {
+        bot.games.erase(std::remove_if(bot.games.begin(), bot.games.end(),
+                                       [](const ArenaGame &game) { return game.over; }), bot.games.end());
+        while (bot.games.size() < settings.parallelGames && bot.startedGames < settings.games)
+        {
+            ArenaGame game;
+            game.id = bot.startedGames++;
+            game.gameBoard = GameBoard<HEIGHT, WIDTH>(settings.seed + game.id);
+            bot.games.push_back(game);
+        }
+
+        for (const uint32_t id : bot.endedGames)
+        {
+            bot.outgoing += "end " + std::to_string(id) + "\n";
+        }
+        bot.endedGames.clear();
+
+        if (bot.games.empty())
+        {
+            bot.outgoing += "quit\n";
+            bot.state = BOT_DONE; // the remaining data is still written, then the pipe is closed
+            bot.deadline = ArenaClock::now() + QUIT_BUDGET;
+            return;
+        }
+
+        bot.outgoing += "batch " + std::to_string(bot.games.size()) + "\n";
+        for (ArenaGame &game : bot.games)
+        {
+            append_move_request(bot.outgoing, game.id, game.gameBoard.get_board_state(),
+                                game.gameBoard.get_current_falling().get_shape_type(),
+                                game.gameBoard.get_next_falling().get_shape_type());
+            game.awaitingReply = true;
+        }
+        bot.pendingReplies = bot.games.size();
+        bot.batchStart = ArenaClock::now();
+        bot.deadline = bot.batchStart + settings.moveBudget * bot.games.size();
+        bot.state = BOT_WAITING;
+        return;
+    }
+
+    /*
+     * Applies a reply to its game.
+     *
+     * @return false if the reply is not valid in the game's current state
+     */
+    bool apply_reply(ArenaGame &game, const BotReply &reply)
+    {
+        GameBoard<HEIGHT, WIDTH> &gameBoard = game.gameBoard;
+        const ShapeType shapeType = gameBoard.get_current_falling().get_shape_type();
+
+        if (reply.kind == BotReply::REPLY_INPUT)
+        {
+            for (const char key : reply.keys)
+            {
+                switch (key)
+                {
+                    case 'l':
+                        gameBoard.move_left_if_valid();
+                        break;
+                    case 'r':
+                        gameBoard.move_right_if_valid();
+                        break;
+                    case 'd':
+                        gameBoard.move_down_if_valid();
+                        break;
+                    case 'c':
+                        gameBoard.rotate_clockwise_if_valid();
+                        break;
+                    default:
+                        gameBoard.rotate_counterclockwise_if_valid();
+                        break;
+                }
+            }
+            gameBoard.hard_drop();
+            return true;
+        }
+
+        Placement placement;
+        if (!find_placement(gameBoard.get_board_state(), shapeType, reply.rotation, reply.column, placement))
+        {
+            return false;
+        }
+        gameBoard.make_move(placement);
+        return true;
+    }
+
+    /*
+     * Handles a complete line received from a bot.
+     */
+    void handle_line(BotProcess &bot, const std::string &line, const ArenaSettings &settings)
+    {
+        if (bot.state == BOT_GREETING)
+        {
+            if (line.compare(0, 5, "ready") != 0)
+            {
+                finish_bot(bot);
+                return;
+            }
+            bot.name = (line.size() > 6) ? line.substr(6) : bot.command;
+            bot.state = BOT_IDLE;
+            return;
+        }
+
+        BotReply reply;
+        if (bot.state != BOT_WAITING || !parse_bot_reply(line, reply))
+        {
+            return; // unknown lines are ignored, e.g. diagnostics
+        }
+
+        const auto game = std::find_if(bot.games.begin(), bot.games.end(), [&reply](const ArenaGame &candidate)
+                                       { return candidate.id == reply.game && candidate.awaitingReply; });
+        if (game == bot.games.end())
+        {
+            return;
+        }
+
+        const std::chrono::duration<double, std::milli> latency = ArenaClock::now() - bot.batchStart;
+        bot.statistics.latencies.push_back(latency.count());
+        game->awaitingReply = false;
+        --bot.pendingReplies;
+
+        if (!apply_reply(*game, reply))
+        {
+            ++bot.statistics.invalidReplies;
+            end_game(bot, *game);
+            return;
+        }
+        ++bot.statistics.moves;
+        ++game->shapes;
+        if (game->gameBoard.is_game_over() || game->shapes >= settings.maxShapes)
+        {
+            end_game(bot, *game);
+        }
+        return;
+    }
+
+    /*
+     * Completes the current batch once all replies have arrived or its deadline has passed.
+     */
+    void complete_batch_if_due(BotProcess &bot, const ArenaClock::time_point now)
+    {
+        if (bot.state == BOT_GREETING && now >= bot.deadline)
+        {
+            finish_bot(bot);
+        }
+        if (bot.state != BOT_WAITING || (bot.pendingReplies > 0 && now < bot.deadline))
+        {
+            return;
+        }
+
+        for (ArenaGame &game : bot.games)
+        {
+            if (game.awaitingReply)
+            {
+                ++bot.statistics.timeouts;
+                end_game(bot, game);
+            }
+        }
+        bot.statistics.busyTime += now - bot.batchStart;
+        bot.state = BOT_IDLE;
+        return;
+    }
+
+    /*
+     * Reads everything available from a bot and handles the complete lines.
+     */
+    void receive(BotProcess &bot, const ArenaSettings &settings)
+    {
+        char buffer[65536];
+        while (bot.output >= 0)
+        {
+            const ssize_t size = read(bot.output, buffer, sizeof(buffer));
+            if (size < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (size < 0 && errno == EAGAIN)
+            {
+                break;
+            }
+            if (size <= 0)
+            {
+                finish_bot(bot); // the bot has terminated
+                break;
+            }
+            bot.incoming.append(buffer, size);
+        }
+
+        std::size_t lineStart = 0;
+        for (std::size_t lineEnd = bot.incoming.find('\n'); lineEnd != std::string::npos && bot.state != BOT_DONE;
+             lineEnd = bot.incoming.find('\n', lineStart))
+        {
+            handle_line(bot, bot.incoming.substr(lineStart, lineEnd - lineStart), settings);
+            lineStart = lineEnd + 1;
+        }
+        bot.incoming.erase(0, lineStart);
+        return;
+    }
+
+    /*
+     * Writes as much pending data to a bot as its pipe accepts.
+     */
+    void transmit(BotProcess &bot)
+    {
+        while (!bot.outgoing.empty() && bot.input >= 0)
+        {
+            const ssize_t size = write(bot.input, bot.outgoing.data(), bot.outgoing.size());
+            if (size < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (size < 0 && errno == EAGAIN)
+            {
+                return;
+            }
+            if (size < 0)
+            {
+                finish_bot(bot);
+                return;
+            }
+            bot.outgoing.erase(0, size);
+        }
+        return;
+    }
+
+    /*
+     * Returns a percentile of sorted values.
+     */
+    double get_percentile(const std::vector<double> &sortedValues, const double percentile)
+    {
+        if (sortedValues.empty())
+        {
+            return 0.0;
+        }
+        const std::size_t index = static_cast<std::size_t>(percentile * (sortedValues.size() - 1) + 0.5);
+        return sortedValues[index];
+    }
+
+    /*
+     * Prints the results of all bots.
+     */
+    void print_report(std::vector<BotProcess> &bots)
+    {
+        for (BotProcess &bot : bots)
+        {
+            BotStatistics &statistics = bot.statistics;
+            std::sort(statistics.latencies.begin(), statistics.latencies.end());
+            const double meanLatency = statistics.latencies.empty() ? 0.0 :
+                [&statistics]() { double sum = 0.0; for (const double latency : statistics.latencies) { sum += latency; }
+                                  return sum / statistics.latencies.size(); }();
+            const double movesPerSecond = (statistics.busyTime.count() > 0.0) ? statistics.moves / statistics.busyTime.count() : 0.0;
+
+            std::printf("%s\n", bot.name.empty() ? bot.command.c_str() : bot.name.c_str());
+            std::printf("  games %u, shapes %llu, line clears %llu (%.1f per game)\n", statistics.finishedGames,
+                        static_cast<unsigned long long>(statistics.moves), static_cast<unsigned long long>(statistics.lineClears),
+                        statistics.finishedGames ? static_cast<double>(statistics.lineClears) / statistics.finishedGames : 0.0);
+            std::printf("  forfeited: %u timeouts, %u invalid replies, %u games lost to termination\n",
+                        statistics.timeouts, statistics.invalidReplies, statistics.crashedGames);
+            std::printf("  throughput %.0f moves/s, latency mean %.3f ms, p50 %.3f ms, p99 %.3f ms, max %.3f ms\n",
+                        movesPerSecond, meanLatency, get_percentile(statistics.latencies, 0.5),
+                        get_percentile(statistics.latencies, 0.99), get_percentile(statistics.latencies, 1.0));
+        }
+        return;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    ArenaSettings settings;
+    bool invalidOption = false;
+    int option = 0;
+    while (!invalidOption && (option = getopt(argc, argv, "g:p:t:n:s:")) != -1)
+    {
+        switch (option)
+        {
+            case 'g':
+                settings.games = static_cast<uint32_t>(std::atoi(optarg));
+                break;
+            case 'p':
+                settings.parallelGames = static_cast<uint32_t>(std::max(1, std::atoi(optarg)));
+                break;
+            case 't':
+                settings.moveBudget = std::chrono::milliseconds(std::max(1, std::atoi(optarg)));
+                break;
+            case 'n':
+                settings.maxShapes = static_cast<uint32_t>(std::max(1, std::atoi(optarg)));
+                break;
+            case 's':
+                settings.seed = static_cast<uint32_t>(std::strtoul(optarg, nullptr, 10));
+                break;
+            default:
+                invalidOption = true;
+                break;
+        }
+    }
+    if (invalidOption || optind >= argc)
+    {
+        std::cerr << "Usage: " << argv[0] << " [-g games = 16] [-p parallel games = 8] [-t move budget in ms = 100]"
+                  << " [-n maximal shapes per game = 1000] [-s seed = 1] <bot command>..." << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    signal(SIGPIPE, SIG_IGN); // terminated bots are detected by failing writes instead
+
+    std::vector<BotProcess> bots(argc - optind);
+    for (std::size_t b = 0; b < bots.size(); ++b)
+    {
+        bots[b].command = argv[optind + b];
+        if (!start_bot(bots[b]))
+        {
+            std::cerr << "Could not start " << bots[b].command << "." << std::endl;
+            finish_bot(bots[b]);
+        }
+    }
+
+    std::vector<pollfd> fileDescriptors;
+    std::vector<std::size_t> owners;
+    while (true)
+    {
+        fileDescriptors.clear();
+        owners.clear();
+        ArenaClock::time_point nextDeadline = ArenaClock::time_point::max();
+        for (std::size_t b = 0; b < bots.size(); ++b)
+        {
+            BotProcess &bot = bots[b];
+            if (bot.state == BOT_IDLE)
+            {
+                send_batch(bot, settings);
+            }
+            transmit(bot);
+            if (bot.state == BOT_DONE && (bot.outgoing.empty() || bot.input < 0 || ArenaClock::now() >= bot.deadline))
+            {
+                finish_bot(bot);
+                continue;
+            }
+
+            // a finished bot is only waited for until it has read the final lines, its replies are not needed
+            if (bot.state != BOT_DONE)
+            {
+                fileDescriptors.push_back({bot.output, POLLIN, 0});
+                owners.push_back(b);
+            }
+            if (!bot.outgoing.empty())
+            {
+                fileDescriptors.push_back({bot.input, POLLOUT, 0});
+                owners.push_back(b);
+            }
+            nextDeadline = std::min(nextDeadline, bot.deadline);
+        }
+        if (fileDescriptors.empty())
+        {
+            break;
+        }
+
+        const auto remaining = std::chrono::ceil<std::chrono::milliseconds>(nextDeadline - ArenaClock::now());
+        const int timeout = (nextDeadline == ArenaClock::time_point::max()) ? -1 :
+                            static_cast<int>(std::max<int64_t>(0, remaining.count()));
+        if (poll(fileDescriptors.data(), fileDescriptors.size(), timeout) < 0 && errno != EINTR)
+        {
+            break;
+        }
+
+        for (std::size_t f = 0; f < fileDescriptors.size(); ++f)
+        {
+            BotProcess &bot = bots[owners[f]];
+            if (fileDescriptors[f].revents != 0 && fileDescriptors[f].events == POLLIN && bot.state != BOT_DONE)
+            {
+                receive(bot, settings);
+            }
+        }
+
+        const ArenaClock::time_point now = ArenaClock::now();
+        for (BotProcess &bot : bots)
+        {
+            complete_batch_if_due(bot, now);
+        }
+    }
+
+    for (BotProcess &bot : bots)
+    {
+        if (bot.pid > 0)
+        {
+            kill(bot.pid, SIGTERM); // bots which did not quit on their own
+            waitpid(bot.pid, nullptr, 0);
+        }
+    }
+    print_report(bots);
+    return EXIT_SUCCESS;
+}
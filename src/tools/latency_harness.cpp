@@ -0,0 +1,465 @@
+/*
+ * Measures the input-to-output latency and the frame pacing of the terminal game end to end.
+ *
+ * Usage: tetris_latency [-n keystrokes] [-i minimal interval in ms] [-p passive seconds] [-r rows] [-c columns]
+ *                       <tetris binary>
+ *
+ * The binary is started on a pseudo-terminal of the given size, with HOME pointing to an empty temporary
+ * directory, so it starts a new game instead of resuming a saved one. Once the first screen has been drawn, the
+ * output is recorded without input for the passive phase, and then the keystrokes are injected: left and right
+ * arrow keys alternately, every fourth one a rotation, each after the output has been quiet for QUIET_TIME and at
+ * least the minimal interval after the previous one. Finally 'q' ends the game.
+ *
+ * Every read of the output is stamped with the time it arrived. Reads less than BURST_GAP apart form one burst,
+ * i.e. one rendered frame, and the output stream is parsed into escape sequences, printed characters and other
+ * control bytes. The report lists percentiles of
+ * - the latency from writing a keystroke to the first byte of output after it,
+ * - the interval between consecutive frames of the passive phase, i.e. the gravity steps, and
+ * - the bytes, escape sequences and printed characters per frame.
+ * A keystroke which changes nothing, e.g. a rotation of the O shape or one blocked at the top, produces no output.
+ * So the gravity steps are assumed to continue with the median interval of the passive phase: a keystroke is
+ * never sent less than GRAVITY_GUARD before the next step is due, and one without output within half of that
+ * guard is reported as silent instead of being counted with the latencies. The game steps gravity in whole
+ * frames, so a step may come a frame earlier than predicted; it then still falls outside the answer window and
+ * corrects the prediction. Without a passive phase, a keystroke is silent if it has no output within
+ * RESPONSE_TIMEOUT, and a gravity step may be mistaken for its answer.
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <dirent.h>
+#include <poll.h>
+#include <pty.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    constexpr std::chrono::milliseconds BURST_GAP{3}; ///< maximal gap between two reads of one frame
+    constexpr std::chrono::milliseconds QUIET_TIME{30}; ///< time without output before a keystroke
+    constexpr std::chrono::milliseconds STARTUP_QUIET_TIME{500}; ///< time without output after which the game has started
+    constexpr std::chrono::seconds RESPONSE_TIMEOUT{1}; ///< time after which a keystroke counts as silent
+    constexpr std::chrono::milliseconds GRAVITY_GUARD{50}; ///< minimal time from a keystroke to the next gravity step
+
+    /*
+     * Output of the game forming one frame.
+     */
+    struct Burst
+    {
+        Clock::time_point start{}; ///< arrival of the first byte
+        Clock::time_point end{}; ///< arrival of the last byte
+        std::size_t bytes{0}; ///< number of bytes
+        std::size_t sequences{0}; ///< number of escape sequences
+        std::size_t characters{0}; ///< number of printed characters
+        bool passive{false}; ///< true if the frame was output during the passive phase
+    };
+
+    /*
+     * Splits the output of the game into escape sequences, printed characters and control bytes.
+     */
+    class OutputParser
+    {
+    public:
+        /*
+         * Parses the bytes of a read and adds them to the counts of a burst.
+         */
+        void parse(const unsigned char *bytes, const std::size_t size, Burst &burst)
+        {
+            for (std::size_t b = 0; b < size; ++b)
+            {
+                const unsigned char byte = bytes[b];
+                switch (_state)
+                {
+                    case PARSER_ESCAPE:
+                        // ESC [ starts a control sequence and ESC O a single shift, anything else ends the sequence
+                        _state = (byte == '[') ? PARSER_CONTROL : (byte == 'O') ? PARSER_SINGLE_SHIFT : PARSER_GROUND;
+                        break;
+                    case PARSER_CONTROL:
+                        _state = (byte >= 0x40 && byte <= 0x7E) ? PARSER_GROUND : PARSER_CONTROL;
+                        break;
+                    case PARSER_SINGLE_SHIFT:
+                        _state = PARSER_GROUND;
+                        break;
+                    default:
+                        if (byte == 0x1B)
+                        {
+                            _state = PARSER_ESCAPE;
+                            ++burst.sequences;
+                        }
+                        else if (byte >= 0x20)
+                        {
+                            ++burst.characters;
+                        }
+                        break;
+                }
+            }
+            burst.bytes += size;
+            return;
+        }
+
+    private:
+        /*
+         * State of parsing escape sequences.
+         */
+        enum ParserState : uint8_t
+        {
+            PARSER_GROUND, ///< no sequence in progress
+            PARSER_ESCAPE, ///< ESC has been read
+            PARSER_CONTROL, ///< ESC [ has been read, the sequence ends with a byte from 0x40 to 0x7E
+            PARSER_SINGLE_SHIFT ///< ESC O has been read, the sequence ends with the next byte
+        };
+
+        ParserState _state{PARSER_GROUND}; ///< progress of the current escape sequence
+    };
+
+    /*
+     * Game running on a pseudo-terminal together with the recording of its output.
+     */
+    struct Session
+    {
+        int master{-1}; ///< master side of the pseudo-terminal
+        pid_t child{-1}; ///< process of the game
+        bool exited{false}; ///< true once the output has ended
+        bool passive{true}; ///< true during the passive phase
+        bool keystrokePending{false}; ///< true while the output caused by a keystroke is awaited
+        Clock::time_point lastGravityFrame{}; ///< start of the last frame which was not caused by a keystroke
+        OutputParser parser{}; ///< parser of the output stream
+        std::vector<Burst> bursts{}; ///< all frames so far, the last one possibly still growing
+    };
+
+    /*
+     * Reads the output which arrives until a deadline or until the first read, and records it.
+     *
+     * @param[in,out] session the session
+     * @param[in] deadline time up to which to wait for output
+     * @param[out] arrival time of the first read, unchanged if nothing arrived
+     * @return true if output arrived
+     */
+    bool read_output(Session &session, const Clock::time_point deadline, Clock::time_point &arrival)
+    {
+        while (!session.exited)
+        {
+            const auto remaining = std::chrono::ceil<std::chrono::milliseconds>(deadline - Clock::now());
+            pollfd descriptor{session.master, POLLIN, 0};
+            const int ready = poll(&descriptor, 1, static_cast<int>(std::max<int64_t>(0, remaining.count())));
+            if (ready < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (ready <= 0)
+            {
+                return false;
+            }
+
+            unsigned char buffer[4096];
+            const ssize_t size = read(session.master, buffer, sizeof(buffer));
+            const Clock::time_point now = Clock::now();
+            if (size < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (size <= 0)
+            {
+                session.exited = true; // EIO once the game has closed the terminal
+                return false;
+            }
+
+            if (session.bursts.empty() || now - session.bursts.back().end > BURST_GAP)
+            {
+                session.bursts.push_back(Burst{now, now, 0, 0, 0, session.passive});
+                session.lastGravityFrame = session.keystrokePending ? session.lastGravityFrame : now;
+            }
+            Burst &burst = session.bursts.back();
+            burst.end = now;
+            session.parser.parse(buffer, static_cast<std::size_t>(size), burst);
+            arrival = now;
+            return true;
+        }
+        return false;
+    }
+
+    /*
+     * Records the output until there has been none for a while.
+     *
+     * @param[in,out] session the session
+     * @param[in] quietTime time without output to wait for
+     * @param[in] timeout maximal time to wait
+     * @return false if the output has not become quiet
+     */
+    bool wait_for_quiet(Session &session, const Clock::duration quietTime, const Clock::duration timeout)
+    {
+        const Clock::time_point deadline = Clock::now() + timeout;
+        Clock::time_point arrival;
+        while (Clock::now() < deadline)
+        {
+            if (!read_output(session, std::min(deadline, Clock::now() + quietTime), arrival))
+            {
+                return !session.exited && Clock::now() < deadline;
+            }
+        }
+        return false;
+    }
+
+    /*
+     * Records the output for a while.
+     */
+    void record_output(Session &session, const Clock::duration duration)
+    {
+        const Clock::time_point deadline = Clock::now() + duration;
+        Clock::time_point arrival;
+        while (!session.exited && Clock::now() < deadline)
+        {
+            read_output(session, deadline, arrival);
+        }
+        return;
+    }
+
+    /*
+     * Returns the time at which the next gravity step is due, assuming steps every period since the last one.
+     */
+    Clock::time_point get_next_gravity_frame(const Session &session, const Clock::duration period)
+    {
+        const Clock::duration elapsed = Clock::now() - session.lastGravityFrame;
+        return session.lastGravityFrame + (elapsed / period + 1) * period;
+    }
+
+    /*
+     * Returns the median of samples, 0 if there are none.
+     */
+    double get_median(std::vector<double> samples)
+    {
+        if (samples.empty())
+        {
+            return 0.0;
+        }
+        std::nth_element(samples.begin(), samples.begin() + samples.size() / 2, samples.end());
+        return samples[samples.size() / 2];
+    }
+
+    /*
+     * Prints the count and the percentiles of samples.
+     */
+    void print_percentiles(const char *name, std::vector<double> samples, const char *unit)
+    {
+        if (samples.empty())
+        {
+            std::printf("%-28s no samples\n", name);
+            return;
+        }
+        std::sort(samples.begin(), samples.end());
+        const auto percentile = [&samples](const double p) {
+            return samples[static_cast<std::size_t>(p * static_cast<double>(samples.size() - 1) + 0.5)];
+        };
+        std::printf("%-28s %6zu samples  min %9.2f  p50 %9.2f  p90 %9.2f  p99 %9.2f  max %9.2f %s\n", name,
+                    samples.size(), samples.front(), percentile(0.5), percentile(0.9), percentile(0.99),
+                    samples.back(), unit);
+        return;
+    }
+
+    /*
+     * Removes a directory and the files in it.
+     */
+    void remove_directory(const std::string &path)
+    {
+        // the game only creates the directory .tetris with files in it
+        for (const std::string &directory : {path + "/.tetris", path})
+        {
+            if (DIR * const stream = opendir(directory.c_str()))
+            {
+                while (const dirent * const entry = readdir(stream))
+                {
+                    if (std::strcmp(entry->d_name, ".") != 0 && std::strcmp(entry->d_name, "..") != 0)
+                    {
+                        std::remove((directory + "/" + entry->d_name).c_str());
+                    }
+                }
+                closedir(stream);
+            }
+        }
+        rmdir(path.c_str());
+        return;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    int keystrokes = 200;
+    int intervalMilliseconds = 100;
+    int passiveSeconds = 3;
+    winsize size{30, 80, 0, 0};
+    bool invalidOption = false;
+    int option = 0;
+    while (!invalidOption && (option = getopt(argc, argv, "n:i:p:r:c:")) != -1)
+    {
+        switch (option)
+        {
+            case 'n':
+                keystrokes = std::max(0, std::atoi(optarg));
+                break;
+            case 'i':
+                intervalMilliseconds = std::max(0, std::atoi(optarg));
+                break;
+            case 'p':
+                passiveSeconds = std::max(0, std::atoi(optarg));
+                break;
+            case 'r':
+                size.ws_row = static_cast<unsigned short>(std::clamp(std::atoi(optarg), 1, 1000));
+                break;
+            case 'c':
+                size.ws_col = static_cast<unsigned short>(std::clamp(std::atoi(optarg), 1, 1000));
+                break;
+            default:
+                invalidOption = true;
+                break;
+        }
+    }
+    if (invalidOption || optind + 1 != argc)
+    {
+        std::cerr << "Usage: " << argv[0] << " [-n keystrokes = 200] [-i minimal interval in ms = 100]"
+                  << " [-p passive seconds = 3] [-r rows = 30] [-c columns = 80] <tetris binary>" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    char home[] = "/tmp/tetris_latency_XXXXXX";
+    if (mkdtemp(home) == nullptr)
+    {
+        std::cerr << "Could not create a temporary home directory." << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    Session session;
+    session.child = forkpty(&session.master, nullptr, nullptr, &size);
+    if (session.child < 0)
+    {
+        remove_directory(home);
+        std::cerr << "Could not create a pseudo-terminal." << std::endl;
+        return EXIT_FAILURE;
+    }
+    if (session.child == 0)
+    {
+        setenv("HOME", home, 1);
+        setenv("TERM", "xterm-256color", 1);
+        execl(argv[optind], argv[optind], static_cast<char*>(nullptr));
+        std::perror("exec");
+        _exit(127);
+    }
+
+    // the initial screen may arrive in several bursts, all before the output becomes quiet
+    bool started = wait_for_quiet(session, STARTUP_QUIET_TIME, std::chrono::seconds(10));
+    const std::size_t startupFrames = session.bursts.size();
+    if (started)
+    {
+        record_output(session, std::chrono::seconds(passiveSeconds));
+        session.passive = false;
+    }
+
+    // the gravity steps of the passive phase predict the following ones
+    std::vector<double> frameIntervals;
+    for (std::size_t f = startupFrames + 1; f < session.bursts.size(); ++f)
+    {
+        frameIntervals.push_back(std::chrono::duration<double, std::milli>(session.bursts[f].start
+                                                                           - session.bursts[f - 1].start).count());
+    }
+    const Clock::duration gravityPeriod = std::chrono::duration_cast<Clock::duration>(
+            std::chrono::duration<double, std::milli>(get_median(frameIntervals)));
+    const Clock::duration gravityGuard = std::min<Clock::duration>(GRAVITY_GUARD, gravityPeriod / 4);
+
+    // left and right alternately keep the shape in place, rotations may be blocked and then cause no output
+    static const char * const KEYS[] = {"\x1b[D", "\x1b[C", "\x1b[D", "r", "\x1b[C", "\x1b[D", "\x1b[C", "u"};
+    std::vector<double> latencies;
+    int silent = 0;
+    Clock::time_point lastKeystroke = Clock::now();
+    for (int k = 0; started && k < keystrokes && !session.exited; ++k)
+    {
+        record_output(session, lastKeystroke + std::chrono::milliseconds(intervalMilliseconds) - Clock::now());
+        bool quiet = wait_for_quiet(session, QUIET_TIME, std::chrono::seconds(5));
+        while (quiet && gravityPeriod.count() > 0
+               && get_next_gravity_frame(session, gravityPeriod) - Clock::now() < gravityGuard)
+        {
+            // too close to the next gravity step, which could be taken for the answer, so it is let pass first
+            record_output(session, gravityGuard);
+            quiet = wait_for_quiet(session, QUIET_TIME, std::chrono::seconds(5));
+        }
+        if (!quiet)
+        {
+            break;
+        }
+
+        const char * const key = KEYS[k % (sizeof(KEYS) / sizeof(KEYS[0]))];
+        lastKeystroke = Clock::now();
+        const Clock::time_point answerDeadline = lastKeystroke
+                                                 + ((gravityPeriod.count() > 0) ? gravityGuard / 2
+                                                                                : Clock::duration(RESPONSE_TIMEOUT));
+        session.keystrokePending = true;
+        if (write(session.master, key, std::strlen(key)) < 0)
+        {
+            break;
+        }
+        Clock::time_point arrival;
+        if (read_output(session, answerDeadline, arrival))
+        {
+            latencies.push_back(std::chrono::duration<double, std::micro>(arrival - lastKeystroke).count());
+        }
+        else
+        {
+            ++silent;
+        }
+        session.keystrokePending = false;
+    }
+
+    // quit and collect the rest of the output
+    const std::size_t frameCount = session.bursts.size();
+    (void) write(session.master, "q", 1);
+    record_output(session, std::chrono::seconds(2));
+    int status = 0;
+    if (waitpid(session.child, &status, WNOHANG) == 0)
+    {
+        kill(session.child, SIGTERM);
+        waitpid(session.child, &status, 0);
+    }
+    close(session.master);
+    remove_directory(home);
+
+    if (!started)
+    {
+        std::cerr << "The game did not start, or its output did not become quiet." << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // the initial screen and the output of quitting are not counted as frames
+    std::size_t initialBytes = 0;
+    for (std::size_t f = 0; f < startupFrames; ++f)
+    {
+        initialBytes += session.bursts[f].bytes;
+    }
+    std::vector<double> bytes;
+    std::vector<double> sequences;
+    std::vector<double> characters;
+    for (std::size_t f = startupFrames; f < frameCount; ++f)
+    {
+        const Burst &burst = session.bursts[f];
+        bytes.push_back(static_cast<double>(burst.bytes));
+        sequences.push_back(static_cast<double>(burst.sequences));
+        characters.push_back(static_cast<double>(burst.characters));
+    }
+
+    std::printf("initial screen %zu bytes, %zu frames, %zu keystrokes answered, %d silent\n", initialBytes,
+                frameCount - startupFrames, latencies.size(), silent);
+    print_percentiles("keystroke latency", latencies, "us");
+    print_percentiles("gravity frame interval", frameIntervals, "ms");
+    print_percentiles("bytes per frame", bytes, "");
+    print_percentiles("escape sequences per frame", sequences, "");
+    print_percentiles("printed characters per frame", characters, "");
+    return EXIT_SUCCESS;
+}
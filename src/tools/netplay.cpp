@@ -0,0 +1,250 @@
+/*
+ * Plays a two-player game with rollback between two local peers over a real transport and checks that both
+ * simulated the same game.
+ *
+ * Usage: tetris_netplay [-x] [-f frames] [-l latency in ms] [-j jitter in ms] [-p loss in percent]
+ *                       [-r inputs in percent of the frames] [-s seed]
+ *
+ * Each peer runs on its own thread at 60 frames per second with a RollbackSession, presses random controls and
+ * exchanges its packets over UDP on the loopback interface, or over Unix datagram sockets with -x. The packets
+ * pass a LatencyInjector, which delays, jitters and drops them as given. At the end, the games of both peers are
+ * compared with a game simulated from the inputs of both players without any rollback; any difference, a
+ * detected desynchronisation or a peer which did not finish makes the tool fail. The rollbacks and the longest
+ * time a frame took including its rollback are reported for each peer.
+ */
+
+#include "tetris/net_transport.h"
+#include "tetris/rollback.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+namespace
+{
+    constexpr SizeType HEIGHT = 24; ///< board height of the games
+    constexpr SizeType WIDTH = 10; ///< board width of the games
+    constexpr std::chrono::seconds FINISH_BUDGET{5}; ///< time the peers have to confirm the last frame
+
+    /*
+     * Settings given on the command line.
+     */
+    struct NetplaySettings
+    {
+        bool unixSockets{false}; ///< true for Unix datagram sockets, false for UDP
+        uint32_t frames{600}; ///< number of frames to play
+        LatencySettings latency{std::chrono::milliseconds(50), std::chrono::milliseconds(20), 5}; ///< injected network conditions
+        uint32_t inputPercent{10}; ///< probability of pressing a control in a frame
+        uint32_t seed{1}; ///< seed of the game
+    };
+
+    /*
+     * Outcome of a peer.
+     */
+    struct PeerResult
+    {
+        std::vector<uint8_t> inputs{}; ///< the peer's inputs of every frame
+        uint32_t checksum{0}; ///< checksum of both game boards after the last frame
+        RollbackStatistics statistics{}; ///< counters of the rollbacks
+        std::chrono::duration<double, std::milli> longestFrame{0}; ///< longest time of advancing a frame
+        bool desynchronised{false}; ///< true if the session detected a divergence
+        bool finished{false}; ///< true if all frames have been confirmed in time
+    };
+
+    /*
+     * Plays the game as one player until both peers have confirmed all frames or the time is up.
+     *
+     * @param[in] transport transport to the other peer
+     * @param[in] player index of the player
+     * @param[in] settings the settings
+     * @param[in,out] finishedPeers number of peers which have confirmed all frames, shared by both peers
+     * @param[out] result the outcome
+     */
+    template<typename Transport>
+    void run_peer(Transport &transport, const uint8_t player, const NetplaySettings &settings,
+                  std::atomic<int> &finishedPeers, PeerResult &result)
+    {
+        using Clock = std::chrono::steady_clock;
+
+        RollbackSession<HEIGHT, WIDTH> session(settings.seed, player);
+        RandomGenerator generator(settings.seed * 2 + player + 1);
+        uint8_t packet[DatagramSocket::MAX_DATAGRAM_SIZE];
+        const Clock::time_point deadline = Clock::now() + std::chrono::duration_cast<Clock::duration>(Frames(settings.frames))
+                                           + FINISH_BUDGET;
+        Clock::time_point nextFrame = Clock::now();
+        while (finishedPeers.load() < 2 && Clock::now() < deadline)
+        {
+            std::this_thread::sleep_until(nextFrame);
+            nextFrame += std::chrono::duration_cast<Clock::duration>(Frames(1));
+
+            for (std::size_t size = transport.receive(packet); size > 0; size = transport.receive(packet))
+            {
+                session.read_packet(packet, size);
+            }
+
+            // the controls of a frame are only decided once the frame can be simulated
+            const Clock::time_point start = Clock::now();
+            if (session.get_frame() == settings.frames)
+            {
+                session.synchronise();
+            }
+            else if (session.can_advance())
+            {
+                const uint8_t inputs = (generator() % 100 < settings.inputPercent)
+                                       ? static_cast<uint8_t>(1 << (generator() % 6)) : 0;
+                session.advance(inputs);
+                result.inputs.push_back(inputs);
+            }
+            else
+            {
+                session.advance(0); // only counts the stall
+            }
+            result.longestFrame = std::max(result.longestFrame, std::chrono::duration<double, std::milli>(Clock::now() - start));
+
+            if (!result.finished && session.get_confirmed_frame() == settings.frames)
+            {
+                result.finished = true;
+                ++finishedPeers;
+            }
+            transport.send(packet, session.write_packet(packet));
+        }
+
+        session.synchronise();
+        result.checksum = get_checksum(session.get_game_board(1), get_checksum(session.get_game_board(0)));
+        result.statistics = session.get_statistics();
+        result.desynchronised = session.is_desynchronised();
+        return;
+    }
+
+    /*
+     * Connects the sockets of both peers to each other.
+     *
+     * @param[in] directory directory for the paths of Unix sockets
+     * @return false if a socket cannot be opened or connected
+     */
+    bool connect_peers(std::array<DatagramSocket, 2> &sockets, const bool unixSockets, const std::string &directory)
+    {
+        if (unixSockets)
+        {
+            const std::string paths[2] = {directory + "/0", directory + "/1"};
+            return sockets[0].open_unix(paths[0]) && sockets[1].open_unix(paths[1])
+                   && sockets[0].connect_unix(paths[1]) && sockets[1].connect_unix(paths[0]);
+        }
+        return sockets[0].open_udp(0) && sockets[1].open_udp(0)
+               && sockets[0].connect_udp(sockets[1].get_port()) && sockets[1].connect_udp(sockets[0].get_port());
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    NetplaySettings settings;
+    bool invalidOption = false;
+    int option = 0;
+    while (!invalidOption && (option = getopt(argc, argv, "xf:l:j:p:r:s:")) != -1)
+    {
+        switch (option)
+        {
+            case 'x':
+                settings.unixSockets = true;
+                break;
+            case 'f':
+                settings.frames = static_cast<uint32_t>(std::max(1, std::atoi(optarg)));
+                break;
+            case 'l':
+                settings.latency.latency = std::chrono::milliseconds(std::max(0, std::atoi(optarg)));
+                break;
+            case 'j':
+                settings.latency.jitter = std::chrono::milliseconds(std::max(0, std::atoi(optarg)));
+                break;
+            case 'p':
+                settings.latency.lossPercent = static_cast<uint32_t>(std::clamp(std::atoi(optarg), 0, 100));
+                break;
+            case 'r':
+                settings.inputPercent = static_cast<uint32_t>(std::clamp(std::atoi(optarg), 0, 100));
+                break;
+            case 's':
+                settings.seed = static_cast<uint32_t>(std::strtoul(optarg, nullptr, 10));
+                break;
+            default:
+                invalidOption = true;
+                break;
+        }
+    }
+    if (invalidOption || optind != argc)
+    {
+        std::cerr << "Usage: " << argv[0] << " [-x] [-f frames = 600] [-l latency in ms = 50] [-j jitter in ms = 20]"
+                  << " [-p loss in percent = 5] [-r inputs in percent of the frames = 10] [-s seed = 1]" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    char directory[] = "/tmp/tetris_netplay_XXXXXX";
+    if (settings.unixSockets && mkdtemp(directory) == nullptr)
+    {
+        std::cerr << "Could not create a directory for the sockets." << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::array<DatagramSocket, 2> sockets;
+    const bool connected = connect_peers(sockets, settings.unixSockets, directory);
+    if (!connected)
+    {
+        std::cerr << "Could not connect the peers." << std::endl;
+    }
+
+    std::array<PeerResult, 2> results;
+    if (connected)
+    {
+        std::atomic<int> finishedPeers{0};
+        std::array<LatencyInjector, 2> injectors = {LatencyInjector(sockets[0], settings.latency, settings.seed + 10),
+                                                    LatencyInjector(sockets[1], settings.latency, settings.seed + 20)};
+        std::thread secondPeer([&]() { run_peer(injectors[1], 1, settings, finishedPeers, results[1]); });
+        run_peer(injectors[0], 0, settings, finishedPeers, results[0]);
+        secondPeer.join();
+    }
+    for (DatagramSocket &socket : sockets)
+    {
+        socket.close();
+    }
+    if (settings.unixSockets)
+    {
+        rmdir(directory);
+    }
+    if (!connected)
+    {
+        return EXIT_FAILURE;
+    }
+
+    // the reference game knows the inputs of both players in advance
+    std::array<GameBoard<HEIGHT, WIDTH>, 2> reference = {GameBoard<HEIGHT, WIDTH>(settings.seed), GameBoard<HEIGHT, WIDTH>(settings.seed)};
+    bool valid = results[0].inputs.size() == settings.frames && results[1].inputs.size() == settings.frames;
+    for (uint32_t frame = 0; valid && frame < settings.frames; ++frame)
+    {
+        for (uint8_t player = 0; player < 2; ++player)
+        {
+            simulate_frame(reference[player], results[player].inputs[frame]);
+        }
+    }
+    const uint32_t referenceChecksum = get_checksum(reference[1], get_checksum(reference[0]));
+
+    for (uint8_t player = 0; player < 2; ++player)
+    {
+        const PeerResult &result = results[player];
+        std::printf("peer %d: %s, %lu rollbacks of %lu frames (at most %u), %lu stalls, longest frame %.3f ms, checksum %08x%s\n",
+                    player, result.finished ? "finished" : "unfinished", static_cast<unsigned long>(result.statistics.rollbacks),
+                    static_cast<unsigned long>(result.statistics.resimulatedFrames), result.statistics.maximalRollback,
+                    static_cast<unsigned long>(result.statistics.stalls), result.longestFrame.count(), result.checksum,
+                    result.desynchronised ? ", desynchronised" : "");
+        valid = valid && result.finished && !result.desynchronised && result.checksum == referenceChecksum;
+    }
+    std::printf("reference checksum %08x, lines %u and %u: %s\n", referenceChecksum, reference[0].get_line_clears(),
+                reference[1].get_line_clears(), valid ? "consistent" : "INCONSISTENT");
+    return valid ? EXIT_SUCCESS : EXIT_FAILURE;
+}
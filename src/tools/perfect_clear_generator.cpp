@@ -0,0 +1,50 @@
+/*
+ * Offline generator of the perfect clear database.
+ *
+ * Usage: tetris_pcdb <output file> [rows] [maximal number of shapes]
+ *
+ * Enumerates all boards of width 10 whose occupied cells lie in the lowest rows and which can be cleared
+ * completely with at most the given number of shapes, and writes them to a file which PerfectClearDatabase
+ * maps into memory.
+ */
+
+#include "tetris/perfect_clear.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+int main(int argc, char *argv[])
+{
+    constexpr SizeType width = 10;
+
+    if (argc < 2)
+    {
+        std::cerr << "Usage: " << argv[0] << " <output file> [rows = 4] [maximal number of shapes = 4]" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    const std::string path = argv[1];
+    const int rows = (argc > 2) ? std::atoi(argv[2]) : MAX_PERFECT_CLEAR_ROWS;
+    const int maxPieceCount = (argc > 3) ? std::atoi(argv[3]) : 4;
+    if (rows < 1 || rows > MAX_PERFECT_CLEAR_ROWS || maxPieceCount < 0 || maxPieceCount > 255)
+    {
+        std::cerr << "Rows must lie between 1 and " << int{MAX_PERFECT_CLEAR_ROWS}
+                  << ", the number of shapes between 0 and 255." << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    ThreadPool threadPool;
+    const auto start = std::chrono::steady_clock::now();
+    const std::vector<PerfectClearEntry> entries = generate_perfect_clears<width>(rows, maxPieceCount, threadPool);
+    const std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
+
+    std::cout << "Found " << entries.size() << " boards in " << duration.count() << " s." << std::endl;
+
+    if (!write_perfect_clear_database(path, width, rows, maxPieceCount, entries))
+    {
+        std::cerr << "Could not write " << path << "." << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
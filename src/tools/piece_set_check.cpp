@@ -0,0 +1,196 @@
+/*
+ * Loads a piece set file, prints its pieces and measures how fast placements of its pieces are generated.
+ *
+ * Usage: tetris_pieces [-g games] [-n maximal shapes per game] [-s seed] <piece set file>
+ *
+ * Every piece is printed in the rotation in which it appears, together with its number of cells, its number of
+ * distinct rotations and its spawn column on a board of width 10. A set of seven pieces is compared with the
+ * built-in shapes. Then the same random games are played three times on a BoardState by placing random pieces at
+ * random reachable placements: with the built-in shapes through generate_placements(ShapeType), with the built-in
+ * shapes loaded as PieceSet and with the pieces of the file. The first two must lead to the same boards, and
+ * their times show the overhead of a PieceSet on the hot path.
+ */
+
+#include "tetris/piece_set.h"
+#include "tetris/random.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+
+#include <unistd.h>
+
+namespace
+{
+    constexpr SizeType HEIGHT = 24; ///< board height of the games
+    constexpr SizeType WIDTH = 10; ///< board width of the games
+
+    /*
+     * Outcome of playing the random games.
+     */
+    struct PlayResult
+    {
+        uint64_t placements{0}; ///< number of generated placements
+        uint64_t shapes{0}; ///< number of placed shapes
+        uint64_t clearedRows{0}; ///< number of cleared rows
+        uint32_t checksum{2166136261u}; ///< FNV-1a hash of the final boards
+        std::chrono::duration<double> duration{0}; ///< time of playing
+    };
+
+    /*
+     * Plays random games, choosing the piece and its placement uniformly at random.
+     *
+     * @param[in] pieceCount number of pieces
+     * @param[in] generate callable with signature PlacementList<WIDTH>(const BoardState<HEIGHT, WIDTH>&, uint8_t piece)
+     * @param[in] getMask callable with signature const auto&(const Placement&), the mask of a placement
+     */
+    template<typename Generate, typename GetMask>
+    PlayResult play_games(const uint32_t games, const uint32_t maxShapes, const uint32_t seed,
+                          const std::size_t pieceCount, const Generate &generate, const GetMask &getMask)
+    {
+        PlayResult result;
+        const auto start = std::chrono::steady_clock::now();
+        for (uint32_t game = 0; game < games; ++game)
+        {
+            RandomGenerator generator(seed + game);
+            BoardState<HEIGHT, WIDTH> boardState;
+            for (uint32_t shape = 0; shape < maxShapes; ++shape)
+            {
+                const PlacementList<WIDTH> placements = generate(boardState, static_cast<uint8_t>(generator() % pieceCount));
+                if (placements.empty())
+                {
+                    break;
+                }
+                const Placement &placement = placements[generator() % placements.size()];
+                result.placements += placements.size();
+                result.clearedRows += boardState.place(getMask(placement), placement.row, placement.column);
+                ++result.shapes;
+            }
+            for (SizeType i = 0; i < HEIGHT; ++i)
+            {
+                result.checksum = (result.checksum ^ boardState.get_row(i)) * 16777619u;
+            }
+        }
+        result.duration = std::chrono::steady_clock::now() - start;
+        return result;
+    }
+
+    /*
+     * Prints the outcome of playing.
+     */
+    void print_result(const char *name, const PlayResult &result)
+    {
+        std::printf("%-24s %10llu shapes %10llu rows %12llu placements %8.3f s %8.2f M placements/s, checksum %08x\n",
+                    name, static_cast<unsigned long long>(result.shapes), static_cast<unsigned long long>(result.clearedRows),
+                    static_cast<unsigned long long>(result.placements), result.duration.count(),
+                    result.placements / result.duration.count() / 1e6, result.checksum);
+        return;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    uint32_t games = 1000;
+    uint32_t maxShapes = 1000;
+    uint32_t seed = 1;
+    int option = 0;
+    while ((option = getopt(argc, argv, "g:n:s:")) != -1)
+    {
+        switch (option)
+        {
+            case 'g':
+                games = static_cast<uint32_t>(std::strtoul(optarg, nullptr, 10));
+                break;
+            case 'n':
+                maxShapes = static_cast<uint32_t>(std::strtoul(optarg, nullptr, 10));
+                break;
+            case 's':
+                seed = static_cast<uint32_t>(std::strtoul(optarg, nullptr, 10));
+                break;
+            default:
+                optind = argc;
+                break;
+        }
+    }
+    if (optind + 1 != argc)
+    {
+        std::cerr << "Usage: " << argv[0] << " [-g games = 1000] [-n maximal shapes per game = 1000] [-s seed = 1]"
+                  << " <piece set file>" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    PieceSet pieceSet;
+    if (!pieceSet.load(argv[optind]))
+    {
+        std::cerr << "Could not load the piece set: " << pieceSet.get_error() << std::endl;
+        return EXIT_FAILURE;
+    }
+    if (!pieceSet.fits_board(HEIGHT, WIDTH))
+    {
+        std::cerr << "The pieces do not fit on a board of width " << int{WIDTH} << "." << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    bool builtinShapes = pieceSet.get_piece_count() == _SHAPE_COUNT;
+    for (uint8_t p = 0; p < pieceSet.get_piece_count(); ++p)
+    {
+        int rotations = 0;
+        for (uint8_t r = 0; r < ROTATION_COUNT; ++r)
+        {
+            rotations += (pieceSet.get_distinct_rotations(p) >> r) & 1;
+            builtinShapes = builtinShapes
+                            && are_same_masks(pieceSet.get_piece_mask(p, static_cast<Rotation>(r)),
+                                              get_polyomino_masks(static_cast<ShapeType>(p))[r]);
+        }
+        std::printf("%s: %d cells, %d rotations, spawn column %d\n", pieceSet.get_name(p).c_str(),
+                    pieceSet.get_cell_count(p), rotations, pieceSet.get_spawn_column(p, WIDTH));
+
+        const PolyominoMask &mask = pieceSet.get_piece_mask(p, ROT_0);
+        for (SizeType i = 0; i < mask.height; ++i)
+        {
+            std::printf("    ");
+            for (SizeType j = 0; j < mask.width; ++j)
+            {
+                std::printf("%c", ((mask.rows[i] >> j) & 1u) ? '#' : '.');
+            }
+            std::printf("\n");
+        }
+    }
+    if (builtinShapes)
+    {
+        std::printf("The pieces are the built-in shapes in all rotations.\n");
+    }
+
+    PieceSet builtinSet;
+    builtinSet.load_builtin_shapes();
+    const PlayResult builtinResult = play_games(games, maxShapes, seed, _SHAPE_COUNT,
+        [](const BoardState<HEIGHT, WIDTH> &boardState, const uint8_t piece) {
+            return generate_placements(boardState, static_cast<ShapeType>(piece));
+        },
+        [](const Placement &placement) -> const PieceMask& {
+            return get_piece_mask(placement.shapeType, placement.rotation);
+        });
+    const auto playSet = [games, maxShapes, seed](const PieceSet &set) {
+        return play_games(games, maxShapes, seed, set.get_piece_count(),
+            [&set](const BoardState<HEIGHT, WIDTH> &boardState, const uint8_t piece) {
+                return generate_placements(boardState, set, piece);
+            },
+            [&set](const Placement &placement) -> const PolyominoMask& {
+                return set.get_piece_mask(placement.shapeType, placement.rotation);
+            });
+    };
+    const PlayResult builtinSetResult = playSet(builtinSet);
+    const PlayResult loadedResult = playSet(pieceSet);
+
+    print_result("built-in shapes", builtinResult);
+    print_result("built-in piece set", builtinSetResult);
+    print_result("loaded piece set", loadedResult);
+
+    if (builtinSetResult.checksum != builtinResult.checksum || builtinSetResult.placements != builtinResult.placements)
+    {
+        std::cerr << "The built-in piece set does not play like the built-in shapes." << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,233 @@
+/*
+ * Generates a dataset of self-play games of the beam search.
+ *
+ * Usage: tetris_selfplay [-g games] [-t threads] [-w beam width] [-d depth] [-n maximal shapes per game]
+ *                        [-s seed] [-c records per chunk] [-v] <dataset file>
+ *
+ * Every thread plays games with its own single-threaded beam search, game i with seed + i, and records the
+ * board, the current and the next shape and the chosen placement of every decision, together with the outcome
+ * of the game. The games of a thread are collected in its own DatasetChunk, which is encoded and handed to the
+ * DatasetWriter once it holds enough records, so the threads share nothing but the counter of started games and
+ * the queue of encoded chunks. With -v, the file is read back afterwards and every record is replayed.
+ */
+
+#include "tetris/beam_search.h"
+#include "tetris/dataset.h"
+#include "tetris/placement.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include <unistd.h>
+
+namespace
+{
+    constexpr SizeType HEIGHT = 24; ///< board height of the games
+    constexpr SizeType WIDTH = 10; ///< board width of the games
+
+    /*
+     * Settings given on the command line.
+     */
+    struct SelfplaySettings
+    {
+        uint32_t games{64}; ///< number of games
+        std::size_t threads{0}; ///< number of playing threads, 0 means one per hardware thread
+        BeamSettings beamSettings{}; ///< settings of the bot
+        uint32_t maxShapes{1000}; ///< number of shapes after which a game is stopped
+        uint32_t seed{1}; ///< seed of the first game
+        std::size_t chunkRecords{1 << 16}; ///< number of records after which a chunk is written
+        bool verify{false}; ///< true if the file is read back and replayed
+    };
+
+    /*
+     * Plays games until all have been started, and hands their records to the writer.
+     *
+     * @param[in,out] nextGame index of the next game to start, shared by all threads
+     * @param[in,out] writer writer of the dataset
+     * @param[in] settings the settings
+     * @return number of records
+     */
+    uint64_t play_games(std::atomic<uint32_t> &nextGame, DatasetWriter &writer, const SelfplaySettings &settings)
+    {
+        ThreadPool threadPool(1);
+        BeamSearch<HEIGHT, WIDTH> search(threadPool, settings.beamSettings);
+        DatasetChunk<HEIGHT, WIDTH> chunk;
+        std::vector<uint8_t> encoded;
+        uint64_t records = 0;
+
+        for (uint32_t game = nextGame++; game < settings.games; game = nextGame++)
+        {
+            const uint32_t seed = settings.seed + game;
+            GameBoard<HEIGHT, WIDTH> gameBoard(seed);
+            chunk.begin_game(seed);
+            for (uint32_t shapes = 0; shapes < settings.maxShapes && !gameBoard.is_game_over(); ++shapes)
+            {
+                const BoardState<HEIGHT, WIDTH> boardState = gameBoard.get_board_state();
+                const ShapeType currentShape = gameBoard.get_current_falling().get_shape_type();
+                const ShapeType nextShape = gameBoard.get_next_falling().get_shape_type();
+                const Placement found = search.find_best_placement(boardState, currentShape, nextShape);
+                Placement placement;
+                if (!find_placement(boardState, currentShape, found.rotation, found.column, placement))
+                {
+                    break; // no placement is left
+                }
+                chunk.add_record(boardState, currentShape, nextShape, placement);
+                gameBoard.make_move(placement);
+            }
+            chunk.end_game(gameBoard);
+
+            if (chunk.get_record_count() >= settings.chunkRecords)
+            {
+                records += chunk.get_record_count();
+                chunk.encode(encoded);
+                chunk.clear();
+                writer.submit(encoded);
+            }
+        }
+        if (chunk.get_record_count() > 0)
+        {
+            records += chunk.get_record_count();
+            chunk.encode(encoded);
+            writer.submit(encoded);
+        }
+        return records;
+    }
+
+    /*
+     * Reads a dataset and replays every game, checking that each recorded board and shape is the one the game
+     * reaches with the recorded placements.
+     *
+     * @return number of records which differ from the replay, or -1 if the file cannot be read
+     */
+    long verify_dataset(const char *path, const uint32_t gameCount, const uint64_t recordCount)
+    {
+        DatasetReader<HEIGHT, WIDTH> reader;
+        if (!reader.open(path))
+        {
+            return -1;
+        }
+        std::vector<DatasetGame> games;
+        std::vector<DatasetRecord<HEIGHT, WIDTH>> records;
+        uint32_t readGames = 0;
+        uint64_t readRecords = 0;
+        long mismatches = 0;
+        while (reader.read_chunk(games, records))
+        {
+            std::size_t r = 0;
+            for (const DatasetGame &game : games)
+            {
+                GameBoard<HEIGHT, WIDTH> gameBoard(game.seed);
+                for (uint32_t n = 0; n < game.recordCount; ++n, ++r)
+                {
+                    const DatasetRecord<HEIGHT, WIDTH> &record = records[r];
+                    mismatches += record.boardState != gameBoard.get_board_state()
+                                  || record.currentShape != gameBoard.get_current_falling().get_shape_type()
+                                  || record.nextShape != gameBoard.get_next_falling().get_shape_type();
+                    gameBoard.make_move(record.placement);
+                }
+                mismatches += gameBoard.get_line_clears() != game.lineClears || gameBoard.get_lock_count() != game.lockCount;
+            }
+            readGames += static_cast<uint32_t>(games.size());
+            readRecords += records.size();
+        }
+        return (readGames == gameCount && readRecords == recordCount) ? mismatches : -1;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    SelfplaySettings settings;
+    bool invalidOption = false;
+    int option = 0;
+    while (!invalidOption && (option = getopt(argc, argv, "g:t:w:d:n:s:c:v")) != -1)
+    {
+        switch (option)
+        {
+            case 'g':
+                settings.games = static_cast<uint32_t>(std::max(1, std::atoi(optarg)));
+                break;
+            case 't':
+                settings.threads = static_cast<std::size_t>(std::max(0, std::atoi(optarg)));
+                break;
+            case 'w':
+                settings.beamSettings.beamWidth = static_cast<std::size_t>(std::max(1, std::atoi(optarg)));
+                break;
+            case 'd':
+                settings.beamSettings.depth = static_cast<uint8_t>(std::clamp(std::atoi(optarg), 1, static_cast<int>(MAX_BEAM_DEPTH)));
+                break;
+            case 'n':
+                settings.maxShapes = static_cast<uint32_t>(std::max(1, std::atoi(optarg)));
+                break;
+            case 's':
+                settings.seed = static_cast<uint32_t>(std::strtoul(optarg, nullptr, 10));
+                break;
+            case 'c':
+                settings.chunkRecords = static_cast<std::size_t>(std::max(1, std::atoi(optarg)));
+                break;
+            case 'v':
+                settings.verify = true;
+                break;
+            default:
+                invalidOption = true;
+                break;
+        }
+    }
+    if (invalidOption || optind + 1 != argc)
+    {
+        std::cerr << "Usage: " << argv[0] << " [-g games = 64] [-t threads = all] [-w beam width = 16] [-d depth = 2]"
+                  << " [-n maximal shapes per game = 1000] [-s seed = 1] [-c records per chunk = 65536] [-v]"
+                  << " <dataset file>" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    DatasetWriter writer;
+    if (!writer.open(argv[optind], HEIGHT, WIDTH))
+    {
+        std::cerr << "Could not create " << argv[optind] << "." << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    ThreadPool threadPool(settings.threads);
+    const std::size_t threadCount = threadPool.get_thread_count();
+    std::vector<uint64_t> records(threadCount, 0);
+    std::atomic<uint32_t> nextGame{0};
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    threadPool.parallel_for(threadCount, [&](const std::size_t thread) {
+        records[thread] = play_games(nextGame, writer, settings);
+    });
+    const bool written = writer.close();
+    const std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
+    if (!written)
+    {
+        std::cerr << "Could not write " << argv[optind] << "." << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    uint64_t recordCount = 0;
+    for (const uint64_t threadRecords : records)
+    {
+        recordCount += threadRecords;
+    }
+    const uint64_t fileBytes = writer.get_written_bytes();
+    std::printf("%u games, %lu samples on %zu threads in %.2f s: %.0f samples/s, %lu bytes (%.2f bytes/sample)\n",
+                settings.games, static_cast<unsigned long>(recordCount), threadCount, duration.count(),
+                recordCount / duration.count(), static_cast<unsigned long>(fileBytes),
+                static_cast<double>(fileBytes) / std::max<uint64_t>(recordCount, 1));
+
+    if (settings.verify)
+    {
+        const long mismatches = verify_dataset(argv[optind], settings.games, recordCount);
+        if (mismatches != 0)
+        {
+            std::printf("verification failed: %ld\n", mismatches);
+            return EXIT_FAILURE;
+        }
+        std::printf("verified %lu samples\n", static_cast<unsigned long>(recordCount));
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,244 @@
+/*
+ * Runs games for a bot on the same machine through the shared-memory interface of shared_game.h.
+ *
+ * Usage: tetris_shared_arena [-g games] [-n maximal shapes per game] [-s seed] <bot command>
+ *
+ * All games are published at once in an anonymous segment. The bot command is run by /bin/sh with the segment's
+ * descriptor inherited; its number is passed in the environment variable TETRIS_SHARED_GAMES. The bot answers
+ * the games in any order and as fast as it likes; the arena polls the move slots, applies each answer and
+ * publishes the next state. Invalid moves forfeit the game. At the end, the results, throughput and the time
+ * from publishing a state until its answer arrived are reported.
+ * The bot runs in its own process group. When the games are over or the arena receives SIGINT or SIGTERM, the
+ * segment is closed, see SharedGameHost::close_games(), and a bot which has not exited within a second is
+ * terminated together with all processes of its group.
+ */
+
+#include "tetris/placement.h"
+#include "tetris/shared_game.h"
+
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace
+{
+    constexpr SizeType HEIGHT = 24; ///< board height of the games
+    constexpr SizeType WIDTH = 10; ///< board width of the games
+
+    using ArenaClock = std::chrono::steady_clock;
+
+    volatile std::sig_atomic_t stopRequested = 0; ///< set by SIGINT and SIGTERM
+
+    /*
+     * Game hosted for the bot.
+     */
+    struct HostedGame
+    {
+        GameBoard<HEIGHT, WIDTH> gameBoard{1}; ///< the game
+        uint32_t shapes{0}; ///< number of placed shapes
+        ArenaClock::time_point published{}; ///< time at which the current state was published
+        bool over{false}; ///< true if the game has ended
+    };
+
+    /*
+     * Starts the bot in a process group of its own with the segment's descriptor inherited.
+     *
+     * @return process identifier, also of the process group, -1 on failure
+     */
+    pid_t start_bot(const std::string &command, const int fileDescriptor)
+    {
+        const pid_t pid = fork();
+        if (pid == 0)
+        {
+            setpgid(0, 0); // the shell may fork the bot, so it is stopped by its group
+            fcntl(fileDescriptor, F_SETFD, 0); // keep the segment open across exec
+            setenv("TETRIS_SHARED_GAMES", std::to_string(fileDescriptor).c_str(), 1);
+            execl("/bin/sh", "sh", "-c", command.c_str(), static_cast<char*>(nullptr));
+            _exit(127);
+        }
+        if (pid > 0)
+        {
+            setpgid(pid, pid); // also in the parent, so the group exists before it may be signalled
+        }
+        return pid;
+    }
+
+    /*
+     * Waits until the bot has exited after the segment was closed, and terminates its process group if it has not
+     * within a second.
+     */
+    void stop_bot(const pid_t pid)
+    {
+        const ArenaClock::time_point deadline = ArenaClock::now() + std::chrono::seconds(1);
+        while (waitpid(pid, nullptr, WNOHANG) == 0)
+        {
+            if (ArenaClock::now() >= deadline)
+            {
+                kill(-pid, SIGTERM);
+                waitpid(pid, nullptr, 0);
+                break;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        kill(-pid, SIGTERM); // processes of the group which outlive the shell
+        return;
+    }
+
+    /*
+     * Requests the arena to stop.
+     */
+    void request_stop(int)
+    {
+        stopRequested = 1;
+        return;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    uint32_t gameCount = 16;
+    uint32_t maxShapes = 1000;
+    uint32_t seed = 1;
+    bool invalidOption = false;
+    int option = 0;
+    while (!invalidOption && (option = getopt(argc, argv, "g:n:s:")) != -1)
+    {
+        switch (option)
+        {
+            case 'g':
+                gameCount = static_cast<uint32_t>(std::max(1, std::atoi(optarg)));
+                break;
+            case 'n':
+                maxShapes = static_cast<uint32_t>(std::max(1, std::atoi(optarg)));
+                break;
+            case 's':
+                seed = static_cast<uint32_t>(std::strtoul(optarg, nullptr, 10));
+                break;
+            default:
+                invalidOption = true;
+                break;
+        }
+    }
+    if (invalidOption || optind >= argc)
+    {
+        std::cerr << "Usage: " << argv[0] << " [-g games = 16] [-n maximal shapes per game = 1000] [-s seed = 1]"
+                  << " <bot command>" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    SharedGameHost<HEIGHT, WIDTH> host;
+    if (!host.create("", gameCount))
+    {
+        std::cerr << "Could not create the shared memory segment." << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::vector<HostedGame> games(gameCount);
+    for (uint32_t g = 0; g < gameCount; ++g)
+    {
+        games[g].gameBoard = GameBoard<HEIGHT, WIDTH>(seed + g);
+        games[g].published = ArenaClock::now();
+        host.publish(g, games[g].gameBoard);
+    }
+
+    const pid_t pid = start_bot(argv[optind], host.get_file_descriptor());
+    if (pid < 0)
+    {
+        std::cerr << "Could not start " << argv[optind] << "." << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::signal(SIGINT, request_stop);
+    std::signal(SIGTERM, request_stop);
+
+    const ArenaClock::time_point start = ArenaClock::now();
+    std::vector<double> latencies;
+    latencies.reserve(static_cast<std::size_t>(gameCount) * maxShapes);
+    uint32_t runningGames = gameCount;
+    uint32_t invalidMoves = 0;
+    bool botTerminated = false;
+    while (runningGames > 0 && !botTerminated && stopRequested == 0)
+    {
+        bool anyMove = false;
+        for (uint32_t g = 0; g < gameCount; ++g)
+        {
+            HostedGame &game = games[g];
+            Rotation rotation = ROT_0;
+            SizeType column = 0;
+            if (game.over || !host.take_move(g, rotation, column))
+            {
+                continue;
+            }
+
+            const ArenaClock::time_point now = ArenaClock::now();
+            const std::chrono::duration<double, std::micro> latency = now - game.published;
+            latencies.push_back(latency.count());
+            anyMove = true;
+
+            Placement placement;
+            if (!find_placement(game.gameBoard.get_board_state(), game.gameBoard.get_current_falling().get_shape_type(),
+                                rotation, column, placement))
+            {
+                ++invalidMoves;
+                game.over = true;
+                --runningGames;
+                continue;
+            }
+            game.gameBoard.make_move(placement);
+            ++game.shapes;
+            game.over = game.gameBoard.is_game_over() || game.shapes >= maxShapes;
+            runningGames -= game.over ? 1 : 0;
+
+            game.published = ArenaClock::now();
+            host.publish(g, game.gameBoard);
+        }
+
+        // polling keeps the latency minimal, the bot is expected to run on another core
+        if (!anyMove)
+        {
+            botTerminated = waitpid(pid, nullptr, WNOHANG) == pid;
+            std::this_thread::yield();
+        }
+    }
+    const std::chrono::duration<double> duration = ArenaClock::now() - start;
+
+    host.close_games();
+    if (!botTerminated)
+    {
+        stop_bot(pid);
+    }
+
+    uint64_t lineClears = 0;
+    for (const HostedGame &game : games)
+    {
+        lineClears += game.gameBoard.get_line_clears();
+    }
+    std::sort(latencies.begin(), latencies.end());
+    double meanLatency = 0.0;
+    for (const double latency : latencies)
+    {
+        meanLatency += latency / latencies.size();
+    }
+    const auto getPercentile = [&latencies](const double percentile) {
+        return latencies.empty() ? 0.0 : latencies[static_cast<std::size_t>(percentile * (latencies.size() - 1) + 0.5)];
+    };
+
+    std::printf("games %u, shapes %zu, line clears %llu (%.1f per game)\n", gameCount, latencies.size(),
+                static_cast<unsigned long long>(lineClears), static_cast<double>(lineClears) / gameCount);
+    std::printf("forfeited: %u invalid moves, %u games unfinished%s\n", invalidMoves, runningGames,
+                botTerminated ? " because the bot terminated" : "");
+    std::printf("throughput %.0f moves/s, latency mean %.2f us, p50 %.2f us, p99 %.2f us, max %.2f us\n",
+                latencies.size() / duration.count(), meanLatency, getPercentile(0.5), getPercentile(0.99),
+                getPercentile(1.0));
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,76 @@
+/*
+ * Reference bot for tetris_shared_arena, playing with the beam search.
+ *
+ * Usage: tetris_shared_bot [beam width] [depth]
+ *
+ * Attaches to the segment named in the environment variable TETRIS_SHARED_GAMES, either an inherited descriptor
+ * number or a POSIX shared memory name, and answers every game whose state requests a move it has not answered
+ * yet. The games are read in place, no messages are exchanged. The bot exits once the arena closes the games,
+ * and, with an inherited descriptor, also when the process which started it dies.
+ */
+
+#include "tetris/beam_search.h"
+#include "tetris/shared_game.h"
+
+#include <algorithm>
+#include <cctype>
+#include <csignal>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include <sys/prctl.h>
+
+int main(int argc, char *argv[])
+{
+    constexpr SizeType height = 24;
+    constexpr SizeType width = 10;
+
+    BeamSettings settings;
+    settings.beamWidth = (argc > 1) ? static_cast<std::size_t>(std::max(1, std::atoi(argv[1]))) : 1;
+    settings.depth = (argc > 2) ? static_cast<uint8_t>(std::max(1, std::atoi(argv[2]))) : 1;
+
+    const char * const segment = std::getenv("TETRIS_SHARED_GAMES");
+    SharedGameClient<height, width> client;
+    const bool attached = segment && (std::isdigit(static_cast<unsigned char>(segment[0])) ? client.attach(std::atoi(segment))
+                                                                                            : client.attach(std::string(segment)));
+    if (!attached)
+    {
+        std::cerr << "Could not attach to the games in TETRIS_SHARED_GAMES." << std::endl;
+        return EXIT_FAILURE;
+    }
+    if (std::isdigit(static_cast<unsigned char>(segment[0])))
+    {
+        prctl(PR_SET_PDEATHSIG, SIGTERM);
+    }
+
+    ThreadPool threadPool(1); // the games are answered one after another, searching in parallel does not pay off
+    BeamSearch<height, width> search(threadPool, settings);
+
+    std::vector<uint32_t> answeredMoves(client.get_game_count(), 0);
+    SharedGameView<height, width> view;
+    while (!client.is_closed())
+    {
+        bool anyMove = false;
+        for (uint32_t g = 0; g < client.get_game_count(); ++g)
+        {
+            client.read_game(g, view);
+            if (view.gameOver || view.moveNumber == answeredMoves[g])
+            {
+                continue;
+            }
+
+            const Placement placement = search.find_best_placement(view.boardState, view.currentShape, view.nextShape);
+            client.post_move(g, view.moveNumber, placement.rotation, placement.column);
+            answeredMoves[g] = view.moveNumber;
+            anyMove = true;
+        }
+
+        if (!anyMove)
+        {
+            std::this_thread::yield();
+        }
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,163 @@
+/*
+ * Explores all boards of a small game board which can be reached by placing shapes, layer by layer.
+ *
+ * Usage: tetris_explore [-H height] [-W width] [-d maximal depth] [-m memory in MiB] [-t threads]
+ *                       [-w work directory]
+ *
+ * Layer k holds the boards first reached with k shapes, for any sequence of shapes. For every layer, the number
+ * of boards, the placements of all shapes on them and the rows cleared by these placements are printed, and how
+ * many boards can still take every shape, only some shapes or no shape at all. The successors of a layer are
+ * deduplicated in memory up to the given limit and beyond it on disk in the work directory, see state_explorer.h,
+ * so the state space may exceed the memory. Only the board sizes listed in VARIANTS are compiled in.
+ */
+
+#include "tetris/state_explorer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+
+#include <unistd.h>
+
+namespace
+{
+    /*
+     * Settings given on the command line.
+     */
+    struct ExplorerSettings
+    {
+        int height{4}; ///< board height
+        int width{6}; ///< board width
+        std::size_t threads{0}; ///< number of threads, 0 means one per hardware thread
+        ExplorationSettings exploration{"", std::size_t{1} << 30, UINT32_MAX}; ///< settings of the exploration
+    };
+
+    /*
+     * Explores the boards of one size and prints the layers.
+     *
+     * @return EXIT_SUCCESS or EXIT_FAILURE
+     */
+    template<SizeType height, SizeType width>
+    int run_exploration(const ExplorerSettings &settings)
+    {
+        ThreadPool threadPool(settings.threads);
+        const auto start = std::chrono::steady_clock::now();
+        std::printf("%5s %14s %14s %16s %14s %14s %14s %14s %5s %9s\n", "depth", "states", "visited", "transitions",
+                    "cleared rows", "all shapes", "some shapes", "no shape", "runs", "time [s]");
+        const bool explored = explore_states<height, width>(settings.exploration, threadPool, [start](const DepthStatistics &statistics) {
+            uint64_t someShapes = 0;
+            for (std::size_t k = 1; k < _SHAPE_COUNT; ++k)
+            {
+                someShapes += statistics.placeableShapes[k];
+            }
+            const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            std::printf("%5u %14llu %14llu %16llu %14llu %14llu %14llu %14llu %5u %9.2f\n", statistics.depth,
+                        static_cast<unsigned long long>(statistics.states),
+                        static_cast<unsigned long long>(statistics.visitedStates),
+                        static_cast<unsigned long long>(statistics.transitions),
+                        static_cast<unsigned long long>(statistics.clearedRows),
+                        static_cast<unsigned long long>(statistics.placeableShapes[_SHAPE_COUNT]),
+                        static_cast<unsigned long long>(someShapes),
+                        static_cast<unsigned long long>(statistics.placeableShapes[0]), statistics.runs, elapsed.count());
+            std::fflush(stdout);
+        });
+        if (!explored)
+        {
+            std::cerr << "Could not read or write the files in " << settings.exploration.directory << "." << std::endl;
+            return EXIT_FAILURE;
+        }
+        return EXIT_SUCCESS;
+    }
+
+    /*
+     * Compiled board size.
+     */
+    struct Variant
+    {
+        int height; ///< board height
+        int width; ///< board width
+        int (*run)(const ExplorerSettings&); ///< exploration of this size
+    };
+
+    constexpr Variant VARIANTS[] = {{4, 6, &run_exploration<4, 6>}, {5, 6, &run_exploration<5, 6>},
+                                    {6, 6, &run_exploration<6, 6>}, {8, 6, &run_exploration<8, 6>},
+                                    {10, 6, &run_exploration<10, 6>}, {4, 7, &run_exploration<4, 7>},
+                                    {6, 7, &run_exploration<6, 7>}, {8, 7, &run_exploration<8, 7>},
+                                    {4, 8, &run_exploration<4, 8>}, {6, 8, &run_exploration<6, 8>},
+                                    {4, 10, &run_exploration<4, 10>}, {6, 10, &run_exploration<6, 10>}};
+}
+
+int main(int argc, char *argv[])
+{
+    ExplorerSettings settings;
+    bool invalidOption = false;
+    int option = 0;
+    while (!invalidOption && (option = getopt(argc, argv, "H:W:d:m:t:w:")) != -1)
+    {
+        switch (option)
+        {
+            case 'H':
+                settings.height = std::atoi(optarg);
+                break;
+            case 'W':
+                settings.width = std::atoi(optarg);
+                break;
+            case 'd':
+                settings.exploration.maxDepth = static_cast<uint32_t>(std::strtoul(optarg, nullptr, 10));
+                break;
+            case 'm':
+                settings.exploration.memoryLimit = std::max<std::size_t>(1, std::strtoull(optarg, nullptr, 10)) << 20;
+                break;
+            case 't':
+                settings.threads = static_cast<std::size_t>(std::max(0, std::atoi(optarg)));
+                break;
+            case 'w':
+                settings.exploration.directory = optarg;
+                break;
+            default:
+                invalidOption = true;
+                break;
+        }
+    }
+    if (invalidOption || optind != argc)
+    {
+        std::cerr << "Usage: " << argv[0] << " [-H height = 4] [-W width = 6] [-d maximal depth] [-m memory in MiB = 1024]"
+                  << " [-t threads] [-w work directory]" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    for (const Variant &variant : VARIANTS)
+    {
+        if (variant.height == settings.height && variant.width == settings.width)
+        {
+            // without a work directory, a temporary one is used
+            char directory[] = "/tmp/tetris_explore_XXXXXX";
+            const bool temporary = settings.exploration.directory.empty();
+            if (temporary && mkdtemp(directory) == nullptr)
+            {
+                std::cerr << "Could not create a work directory." << std::endl;
+                return EXIT_FAILURE;
+            }
+            if (temporary)
+            {
+                settings.exploration.directory = directory;
+            }
+            const int result = variant.run(settings);
+            if (temporary)
+            {
+                rmdir(directory);
+            }
+            return result;
+        }
+    }
+
+    std::cerr << "Supported board sizes (height x width):";
+    for (const Variant &variant : VARIANTS)
+    {
+        std::cerr << " " << variant.height << "x" << variant.width;
+    }
+    std::cerr << std::endl;
+    return EXIT_FAILURE;
+}
@@ -0,0 +1,218 @@
+/*
+ * Verifies the batch kernel of the value network against its scalar reference and measures its throughput.
+ *
+ * Usage: tetris_value_network [-w] [-p] [-s seed] [-b batch size] [-n batches] <network file>
+ *
+ * With -w, a network with random weights is written to the file first. Random boards with ragged stacks and
+ * holes are scored by ValueNetwork::evaluate() in batches and one by one by evaluate_reference(); any
+ * difference is reported and makes the tool fail. Then the batches are scored repeatedly on one thread and the
+ * number of evaluations per millisecond is reported.
+ * The batches consist of unrelated random boards, or with -p, like in a search, of the boards after each
+ * placement of a shape on a random board.
+ */
+
+#include "tetris/placement.h"
+#include "tetris/random.h"
+#include "tetris/value_network.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include <unistd.h>
+
+namespace
+{
+    constexpr SizeType HEIGHT = 24; ///< board height of the network
+    constexpr SizeType WIDTH = 10; ///< board width of the network
+    constexpr std::size_t BOARD_COUNT = 4096; ///< minimal number of distinct boards
+
+    /*
+     * Boards scored together.
+     */
+    struct Batch
+    {
+        std::size_t first{0}; ///< index of the first board
+        std::size_t count{0}; ///< number of boards
+        ShapeType currentShape{SHAPE_O}; ///< type of the current shape
+        ShapeType nextShape{SHAPE_O}; ///< type of the next shape
+    };
+
+    /*
+     * Returns a uniformly distributed number in [-limit, limit].
+     */
+    float get_uniform(RandomGenerator &generator, const float limit)
+    {
+        return limit * (2.0f * generator() / RandomGenerator::MODULUS - 1.0f);
+    }
+
+    /*
+     * Creates a network with random weights, scaled so that the activations neither vanish nor saturate.
+     */
+    ValueNetworkParameters<HEIGHT, WIDTH> create_random_network(RandomGenerator &generator)
+    {
+        ValueNetworkParameters<HEIGHT, WIDTH> parameters;
+        for (float &weight : parameters.inputWeights)
+        {
+            weight = get_uniform(generator, 0.1f);
+        }
+        for (float &bias : parameters.inputBiases)
+        {
+            bias = get_uniform(generator, 0.5f);
+        }
+        for (float &weight : parameters.hiddenWeights)
+        {
+            weight = get_uniform(generator, 0.5f);
+        }
+        for (float &bias : parameters.hiddenBiases)
+        {
+            bias = get_uniform(generator, 0.5f);
+        }
+        for (float &weight : parameters.outputWeights)
+        {
+            weight = get_uniform(generator, 1.0f);
+        }
+        parameters.outputBias = get_uniform(generator, 1.0f);
+        return parameters;
+    }
+
+    /*
+     * Creates a board whose columns are filled up to random heights, with some holes.
+     */
+    BoardState<HEIGHT, WIDTH> create_random_board(RandomGenerator &generator)
+    {
+        BoardState<HEIGHT, WIDTH> boardState;
+        for (SizeType j = 0; j < WIDTH; ++j)
+        {
+            const SizeType columnHeight = static_cast<SizeType>(generator() % (HEIGHT / 2));
+            for (SizeType i = HEIGHT - columnHeight; i < HEIGHT; ++i)
+            {
+                boardState.set_occupied(i, j, generator() % 8 != 0);
+            }
+        }
+        return boardState;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    bool writeRandom = false;
+    bool placementBatches = false;
+    uint32_t seed = 1;
+    std::size_t batchSize = 34; // about the number of placements of a shape
+    std::size_t batchCount = 100000;
+    bool invalidOption = false;
+    int option = 0;
+    while (!invalidOption && (option = getopt(argc, argv, "wps:b:n:")) != -1)
+    {
+        switch (option)
+        {
+            case 'w':
+                writeRandom = true;
+                break;
+            case 'p':
+                placementBatches = true;
+                break;
+            case 's':
+                seed = static_cast<uint32_t>(std::strtoul(optarg, nullptr, 10));
+                break;
+            case 'b':
+                batchSize = static_cast<std::size_t>(std::clamp(std::atoi(optarg), 1, static_cast<int>(BOARD_COUNT)));
+                break;
+            case 'n':
+                batchCount = static_cast<std::size_t>(std::max(1, std::atoi(optarg)));
+                break;
+            default:
+                invalidOption = true;
+                break;
+        }
+    }
+    if (invalidOption || optind + 1 != argc)
+    {
+        std::cerr << "Usage: " << argv[0] << " [-w] [-p] [-s seed = 1] [-b batch size = 34] [-n batches = 100000]"
+                  << " <network file>" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    RandomGenerator generator(seed);
+    if (writeRandom && !write_value_network(argv[optind], create_random_network(generator)))
+    {
+        std::cerr << "Could not write " << argv[optind] << "." << std::endl;
+        return EXIT_FAILURE;
+    }
+    ValueNetwork<HEIGHT, WIDTH> network;
+    if (!network.load(argv[optind]))
+    {
+        std::cerr << "Could not load a network for " << HEIGHT << "x" << WIDTH << " boards from " << argv[optind]
+                  << "." << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::vector<BoardState<HEIGHT, WIDTH>> boardStates;
+    std::vector<Batch> batches;
+    while (boardStates.size() < BOARD_COUNT)
+    {
+        Batch batch;
+        batch.first = boardStates.size();
+        batch.currentShape = static_cast<ShapeType>(generator() % _SHAPE_COUNT);
+        batch.nextShape = static_cast<ShapeType>(generator() % _SHAPE_COUNT);
+        if (placementBatches)
+        {
+            const BoardState<HEIGHT, WIDTH> boardState = create_random_board(generator);
+            for (const Placement &placement : generate_placements(boardState, batch.currentShape))
+            {
+                BoardState<HEIGHT, WIDTH> successor = boardState;
+                successor.place(get_piece_mask(batch.currentShape, placement.rotation), placement.row, placement.column);
+                boardStates.push_back(successor);
+            }
+        }
+        else
+        {
+            for (std::size_t b = 0; b < batchSize; ++b)
+            {
+                boardStates.push_back(create_random_board(generator));
+            }
+        }
+        batch.count = boardStates.size() - batch.first;
+        batches.push_back(batch);
+    }
+
+    // verification
+    std::size_t mismatches = 0;
+    std::vector<float> scores(boardStates.size());
+    float minimalScore = 0;
+    float maximalScore = 0;
+    for (const Batch &batch : batches)
+    {
+        network.evaluate(&boardStates[batch.first], batch.count, batch.currentShape, batch.nextShape,
+                         &scores[batch.first]);
+        for (std::size_t b = batch.first; b < batch.first + batch.count; ++b)
+        {
+            mismatches += scores[b] != network.evaluate_reference(boardStates[b], batch.currentShape, batch.nextShape);
+            minimalScore = std::min(minimalScore, scores[b]);
+            maximalScore = std::max(maximalScore, scores[b]);
+        }
+    }
+    std::printf("verified %zu boards: %zu mismatches, scores in [%.3f, %.3f]\n", boardStates.size(), mismatches,
+                minimalScore, maximalScore);
+
+    // throughput
+    float checksum = 0;
+    std::size_t evaluations = 0;
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (std::size_t n = 0; n < batchCount; ++n)
+    {
+        const Batch &batch = batches[n % batches.size()];
+        network.evaluate(&boardStates[batch.first], batch.count, batch.currentShape, batch.nextShape, scores.data());
+        checksum += scores[0];
+        evaluations += batch.count;
+    }
+    const std::chrono::duration<double, std::milli> duration = std::chrono::steady_clock::now() - start;
+    std::printf("%zu batches of %.1f boards in %.1f ms: %.0f evaluations/ms (checksum %.3f)\n", batchCount,
+                static_cast<double>(evaluations) / batchCount, duration.count(), evaluations / duration.count(),
+                checksum);
+    return mismatches == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}